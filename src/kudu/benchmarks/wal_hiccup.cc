@@ -19,8 +19,10 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <thread>
@@ -61,6 +63,9 @@ DEFINE_bool(fdatasync_at_end, true,
 
 DEFINE_bool(page_align_wal_writes, false,
             "write to the fake WAL with exactly 4KB writes to never cross pages");
+DEFINE_bool(wal_async_sync, false,
+            "fdatasync() the fake WAL on a separate thread, overlapping each sync "
+            "with the next writes as the log does with --log_async_sync");
 
 using std::string;
 using std::thread;
@@ -83,12 +88,25 @@ class WalHiccupBenchmarker {
   void RunOnce();
   void Run();
  protected:
+  // Records the latency of a WAL write which started at 'start_us' and
+  // became durable at 'end_us'.
+  void RecordWALLatency(MicrosecondsInt64 start_us, MicrosecondsInt64 end_us);
+
   CountDownLatch finished_;
   std::vector<HdrHistogram*> wal_histos_;
   HdrHistogram* cur_histo_;
 };
 
 
+void WalHiccupBenchmarker::RecordWALLatency(MicrosecondsInt64 start_us,
+                                            MicrosecondsInt64 end_us) {
+  MicrosecondsInt64 value = end_us - start_us;
+  cur_histo_->IncrementWithExpectedInterval(value, FLAGS_wal_interval_us);
+  if (value > FLAGS_wal_interval_us) {
+    LOG(WARNING) << "slow wal write: " <<  value << "us";
+  }
+}
+
 void WalHiccupBenchmarker::WALThread() {
   string name = "wal";
   if (!FLAGS_file_path.empty()) {
@@ -99,18 +117,58 @@ void WalHiccupBenchmarker::WALThread() {
   char buf[4096];
   memset(buf, 0xFF, sizeof(buf));
   const MonoDelta sleepDelta = MonoDelta::FromMicroseconds(FLAGS_wal_interval_us);
+
+  // With --wal_async_sync, the start times of the writes not yet synced, and
+  // the thread syncing them.
+  std::mutex lock;
+  std::condition_variable cond;
+  vector<MicrosecondsInt64> unsynced_starts;
+  bool done = false;
+  thread sync_thread;
+  if (FLAGS_wal_async_sync) {
+    sync_thread = thread([&]() {
+        vector<MicrosecondsInt64> starts;
+        while (true) {
+          {
+            std::unique_lock<std::mutex> l(lock);
+            cond.wait(l, [&]() { return done || !unsynced_starts.empty(); });
+            if (unsynced_starts.empty()) {
+              return;
+            }
+            starts.swap(unsynced_starts);
+          }
+          PCHECK(fdatasync(fd) == 0);
+          MicrosecondsInt64 et = GetCurrentTimeMicros();
+          for (MicrosecondsInt64 st : starts) {
+            RecordWALLatency(st, et);
+          }
+          starts.clear();
+        }
+      });
+  }
+
   while (finished_.count() > 0) {
     SleepFor(sleepDelta);
     MicrosecondsInt64 st = GetCurrentTimeMicros();
     size_t num_bytes = FLAGS_page_align_wal_writes ? sizeof(buf) : sizeof(buf) - 1;
     PCHECK(write(fd, buf, num_bytes) == num_bytes);
+    if (FLAGS_wal_async_sync) {
+      std::lock_guard<std::mutex> l(lock);
+      unsynced_starts.push_back(st);
+      cond.notify_one();
+      continue;
+    }
     PCHECK(fdatasync(fd) == 0);
-    MicrosecondsInt64 et = GetCurrentTimeMicros();
-    MicrosecondsInt64 value = et - st;
-    cur_histo_->IncrementWithExpectedInterval(value, FLAGS_wal_interval_us);
-    if (value > FLAGS_wal_interval_us) {
-      LOG(WARNING) << "slow wal write: " <<  value << "us";
+    RecordWALLatency(st, GetCurrentTimeMicros());
+  }
+
+  if (FLAGS_wal_async_sync) {
+    {
+      std::lock_guard<std::mutex> l(lock);
+      done = true;
+      cond.notify_one();
     }
+    sync_thread.join();
   }
 }
 
@@ -157,10 +215,11 @@ void SetFlags(uint32_t setup) {
   FLAGS_fdatasync_at_end = setup & (1 << 5);
 
   FLAGS_page_align_wal_writes = setup & (1 << 6);
+  FLAGS_wal_async_sync = setup & (1 << 7);
 }
 
 void WalHiccupBenchmarker::Run() {
-  int num_setups = 1 << 7;
+  int num_setups = 1 << 8;
   wal_histos_.resize(num_setups);
 
   vector<double> total_time;
@@ -239,6 +298,7 @@ void WalHiccupBenchmarker::PrintConfig() {
   LOG(INFO) << "await_writeback_at_end: " << FLAGS_await_writeback_at_end;
   LOG(INFO) << "fdatasync_at_end: " << FLAGS_fdatasync_at_end;
   LOG(INFO) << "page_align_wal_writes: " << FLAGS_page_align_wal_writes;
+  LOG(INFO) << "wal_async_sync: " << FLAGS_wal_async_sync;
 }
 
 void WalHiccupBenchmarker::RunOnce() {
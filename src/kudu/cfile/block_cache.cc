@@ -57,6 +57,15 @@ DEFINE_string(block_cache_type, "DRAM",
               "libmemkind 1.8.0 or newer must be available on the system; "
               "otherwise Kudu will crash.");
 
+DEFINE_string(block_cache_eviction_policy, "LRU",
+              "Which eviction policy to use for the block cache. Valid choices are "
+              "'LRU' or 'SLRU'. LRU, the default, evicts the least recently used "
+              "blocks. 'SLRU' (segmented LRU) protects blocks which were read more "
+              "than once, such as those of frequent point lookups, from being evicted "
+              "by large scans which read each block once. 'SLRU' is only supported with "
+              "--block_cache_type=DRAM.");
+TAG_FLAG(block_cache_eviction_policy, experimental);
+
 using strings::Substitute;
 
 template <class T> class scoped_refptr;
@@ -71,11 +80,19 @@ namespace {
 
 Cache* CreateCache(int64_t capacity) {
   const auto mem_type = BlockCache::GetConfiguredCacheMemoryTypeOrDie();
+  const auto eviction_policy = BlockCache::GetConfiguredEvictionPolicyOrDie();
   switch (mem_type) {
     case Cache::MemoryType::DRAM:
+      if (eviction_policy == Cache::EvictionPolicy::SLRU) {
+        return NewCache<Cache::EvictionPolicy::SLRU, Cache::MemoryType::DRAM>(
+            capacity, "block_cache");
+      }
       return NewCache<Cache::EvictionPolicy::LRU, Cache::MemoryType::DRAM>(
           capacity, "block_cache");
     case Cache::MemoryType::NVM:
+      if (eviction_policy != Cache::EvictionPolicy::LRU) {
+        LOG(FATAL) << "only the LRU eviction policy is supported by the NVM block cache";
+      }
       return NewCache<Cache::EvictionPolicy::LRU, Cache::MemoryType::NVM>(
           capacity, "block_cache");
     default:
@@ -132,6 +149,20 @@ Cache::MemoryType BlockCache::GetConfiguredCacheMemoryTypeOrDie() {
   __builtin_unreachable();
 }
 
+Cache::EvictionPolicy BlockCache::GetConfiguredEvictionPolicyOrDie() {
+  ToUpperCase(FLAGS_block_cache_eviction_policy, &FLAGS_block_cache_eviction_policy);
+  if (FLAGS_block_cache_eviction_policy == "LRU") {
+    return Cache::EvictionPolicy::LRU;
+  }
+  if (FLAGS_block_cache_eviction_policy == "SLRU") {
+    return Cache::EvictionPolicy::SLRU;
+  }
+
+  LOG(FATAL) << "Unknown block cache eviction policy: '"
+             << FLAGS_block_cache_eviction_policy << "' (expected 'LRU' or 'SLRU')";
+  __builtin_unreachable();
+}
+
 BlockCache::BlockCache()
     : BlockCache(FLAGS_block_cache_capacity_mb * 1024 * 1024) {
 }
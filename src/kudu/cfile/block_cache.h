@@ -46,6 +46,10 @@ class BlockCache {
   // invalid.
   static Cache::MemoryType GetConfiguredCacheMemoryTypeOrDie();
 
+  // Parse the gflag which configures the eviction policy of the block cache.
+  // FATALs if the flag is invalid.
+  static Cache::EvictionPolicy GetConfiguredEvictionPolicyOrDie();
+
   // BlockId refers to the unique identifier for a Kudu block, that is, for an
   // entire CFile. This is different than the block cache's notion of a block,
   // which is just a portion of a CFile.
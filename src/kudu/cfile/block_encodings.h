@@ -162,6 +162,10 @@ class BlockDecoder {
   //
   // Modifies *n to contain the number of values fetched.
   //
+  // Decoders should evaluate the predicate on their encoded form where they
+  // can, e.g. once per run or per dictionary entry. The cells of rows which
+  // don't match the predicate may be left unset in 'dst'.
+  //
   // POSTCONDITION: ctx->decoder_eval_supported_ is not kNotSet. State must
   // be consistent throughout the entire column.
   virtual Status CopyNextAndEval(size_t* n,
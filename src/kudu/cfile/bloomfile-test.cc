@@ -22,6 +22,7 @@
 #include <memory>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 #include <gflags/gflags_declare.h>
 #include <glog/logging.h>
@@ -49,6 +50,7 @@ using kudu::fs::CountingReadableBlock;
 using kudu::fs::ReadableBlock;
 using std::shared_ptr;
 using std::unique_ptr;
+using std::vector;
 
 namespace kudu {
 namespace cfile {
@@ -94,6 +96,41 @@ TEST_F(BloomFileTest, TestWriteAndRead) {
   VerifyBloomFile();
 }
 
+// Test that checking a sorted batch of keys at once, spanning many bloom
+// blocks, gives the same results as checking the keys one at a time.
+TEST_F(BloomFileTest, TestCheckKeysPresent) {
+  NO_FATALS(WriteTestBloomFile());
+  ASSERT_OK(OpenBloomFile());
+
+  // Probe each inserted key along with the (not inserted) key right after it,
+  // and go a bit past the end of the file.
+  const uint64_t kNumProbes = 2 * FLAGS_n_keys + 100;
+  vector<uint64_t> keys(kNumProbes);
+  for (uint64_t i = 0; i < kNumProbes; i++) {
+    keys[i] = BigEndian::FromHost64(((i / 2) << kKeyShift) | (i % 2));
+  }
+  vector<BloomKeyProbe> probes;
+  probes.reserve(kNumProbes);
+  for (const auto& key : keys) {
+    probes.emplace_back(Slice(reinterpret_cast<const uint8_t*>(&key), sizeof(key)));
+  }
+  vector<const BloomKeyProbe*> probe_ptrs;
+  for (const auto& probe : probes) {
+    probe_ptrs.push_back(&probe);
+  }
+
+  unique_ptr<bool[]> present(new bool[kNumProbes]);
+  ASSERT_OK(bfr()->CheckKeysPresent(probe_ptrs.data(), kNumProbes, nullptr, present.get()));
+  for (uint64_t i = 0; i < kNumProbes; i++) {
+    bool expected;
+    ASSERT_OK_FAST(bfr()->CheckKeyPresent(probes[i], nullptr, &expected));
+    ASSERT_EQ(expected, present[i]) << "probe " << i;
+    if (i % 2 == 0 && i / 2 < FLAGS_n_keys) {
+      ASSERT_TRUE(present[i]) << "inserted key " << i / 2;
+    }
+  }
+}
+
 #ifdef NDEBUG
 TEST_F(BloomFileTest, Benchmark) {
   NO_FATALS(WriteTestBloomFile());
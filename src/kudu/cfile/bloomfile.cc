@@ -288,6 +288,14 @@ Status BloomFileReader::ParseBlockHeader(const Slice& block,
 Status BloomFileReader::CheckKeyPresent(const BloomKeyProbe &probe,
                                         const IOContext* io_context,
                                         bool *maybe_present) {
+  const BloomKeyProbe* probes[] = { &probe };
+  return CheckKeysPresent(probes, 1, io_context, maybe_present);
+}
+
+Status BloomFileReader::CheckKeysPresent(const BloomKeyProbe* const* probes,
+                                         size_t n_probes,
+                                         const IOContext* io_context,
+                                         bool* maybe_present) {
   DCHECK(init_once_.init_succeeded());
 
   // Since we frequently will access the same BloomFile many times in a row
@@ -306,38 +314,60 @@ Status BloomFileReader::CheckKeyPresent(const BloomKeyProbe &probe,
       << "Cached index reader does not match expected instance";
 
   IndexTreeIterator* index_iter = &bci->index_iter;
-  Status s = index_iter->SeekAtOrBefore(probe.key());
-  if (PREDICT_FALSE(s.IsNotFound())) {
-    // Seek to before the first entry in the file.
-    *maybe_present = false;
-    return Status::OK();
-  }
-  RETURN_NOT_OK(s);
-
-  // Successfully found the pointer to the bloom block.
-  BlockPointer bblk_ptr = index_iter->GetCurrentBlockPointer();
-
-  // If the previous lookup from this bloom on this thread seeked to a different
-  // block in the BloomFile, we need to read the correct block and re-hydrate the
-  // BloomFilter instance.
-  if (!bci->cur_block_pointer.Equals(bblk_ptr)) {
-    BlockHandle dblk_data;
-    RETURN_NOT_OK(reader_->ReadBlock(io_context, bblk_ptr,
-                                     CFileReader::CACHE_BLOCK, &dblk_data));
-
-    // Parse the header in the block.
-    BloomBlockHeaderPB hdr;
-    Slice bloom_data;
-    RETURN_NOT_OK(ParseBlockHeader(dblk_data.data(), &hdr, &bloom_data));
-
-    // Save the data back into our threadlocal cache.
-    bci->cur_bloom = BloomFilter(bloom_data, hdr.num_hash_functions());
-    bci->cur_block_pointer = bblk_ptr;
-    bci->cur_block_handle = std::move(dblk_data);
-  }
+  size_t i = 0;
+  while (i < n_probes) {
+    DCHECK(i == 0 || probes[i - 1]->key().compare(probes[i]->key()) <= 0)
+        << "probes must be sorted by key";
+    Status s = index_iter->SeekAtOrBefore(probes[i]->key());
+    if (PREDICT_FALSE(s.IsNotFound())) {
+      // Seek to before the first entry in the file.
+      maybe_present[i++] = false;
+      continue;
+    }
+    RETURN_NOT_OK(s);
+
+    // Successfully found the pointer to the bloom block.
+    BlockPointer bblk_ptr = index_iter->GetCurrentBlockPointer();
+
+    // If the previous lookup from this bloom on this thread seeked to a different
+    // block in the BloomFile, we need to read the correct block and re-hydrate the
+    // BloomFilter instance.
+    if (!bci->cur_block_pointer.Equals(bblk_ptr)) {
+      BlockHandle dblk_data;
+      RETURN_NOT_OK(reader_->ReadBlock(io_context, bblk_ptr,
+                                       CFileReader::CACHE_BLOCK, &dblk_data));
+
+      // Parse the header in the block.
+      BloomBlockHeaderPB hdr;
+      Slice bloom_data;
+      RETURN_NOT_OK(ParseBlockHeader(dblk_data.data(), &hdr, &bloom_data));
+
+      // Save the data back into our threadlocal cache.
+      bci->cur_bloom = BloomFilter(bloom_data, hdr.num_hash_functions());
+      bci->cur_block_pointer = bblk_ptr;
+      bci->cur_block_handle = std::move(dblk_data);
+    }
 
-  // Actually check the bloom filter.
-  *maybe_present = bci->cur_bloom.MayContainKey(probe);
+    // The block covers every key up to the first key of the next block, so
+    // all the probes before that key are checked against it without seeking
+    // the index again.
+    size_t end = i + 1;
+    if (end < n_probes) {
+      if (index_iter->HasNext()) {
+        RETURN_NOT_OK(index_iter->Next());
+        Slice next_block_key = index_iter->GetCurrentKey();
+        while (end < n_probes && probes[end]->key().compare(next_block_key) < 0) {
+          end++;
+        }
+      } else {
+        end = n_probes;
+      }
+    }
+
+    // Actually check the bloom filter.
+    bci->cur_bloom.MayContainKeys(&probes[i], end - i, &maybe_present[i]);
+    i = end;
+  }
   return Status::OK();
 }
 
@@ -117,6 +117,14 @@ class BloomFileReader {
                          const fs::IOContext* io_context,
                          bool* maybe_present);
 
+  // Batched version of CheckKeyPresent(): sets maybe_present[i] for each of
+  // the 'n_probes' probes. The probes must be sorted by key, so that the
+  // bloom index is sought once per bloom block rather than once per key.
+  Status CheckKeysPresent(const BloomKeyProbe* const* probes,
+                          size_t n_probes,
+                          const fs::IOContext* io_context,
+                          bool* maybe_present);
+
   // Can be called before Init().
   uint64_t FileSize() const {
     return reader_->file_size();
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdint>
+#include <memory>
 #include <ostream>
 #include <vector>
 
@@ -36,8 +37,11 @@
 #include "kudu/cfile/bitshuffle_arch_wrapper.h"
 #include "kudu/cfile/block_encodings.h"
 #include "kudu/cfile/cfile_util.h"
+#include "kudu/common/column_materialization_context.h"
+#include "kudu/common/column_predicate.h"
 #include "kudu/common/columnblock.h"
 #include "kudu/common/common.pb.h"
+#include "kudu/common/rowblock.h"
 #include "kudu/common/rowid.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/types.h"
@@ -331,6 +335,66 @@ class BShufBlockDecoder final : public BlockDecoder {
     return CopyNextValuesToArray(n, dst->data());
   }
 
+  // Evaluates the predicate on the unpacked values before copying them into
+  // 'dst', so that nothing is copied if no value matches.
+  Status CopyNextAndEval(size_t* n,
+                         ColumnMaterializationContext* ctx,
+                         SelectionVectorView* sel,
+                         ColumnDataView* dst) OVERRIDE {
+    DCHECK(parsed_);
+    DCHECK_LE(*n, dst->nrows());
+    DCHECK_EQ(dst->stride(), sizeof(CppType));
+
+    ctx->SetDecoderEvalSupported();
+    if (PREDICT_FALSE(*n == 0 || cur_idx_ >= num_elems_)) {
+      *n = 0;
+      return Status::OK();
+    }
+
+    size_t max_fetch = std::min(*n, static_cast<size_t>(num_elems_ - cur_idx_));
+    // Values stored narrower than their type must be expanded before they can
+    // be evaluated, so copy them first in that case.
+    const bool expanded = size_of_elem_ != size_of_type;
+    uint8_t* values;
+    if (expanded) {
+      RETURN_NOT_OK(CopyNextValuesToArray(&max_fetch, dst->data()));
+      values = dst->data();
+    } else {
+      values = &decoded_[cur_idx_ * size_of_type];
+    }
+
+    // The selection vector is allocated once per block and reused by every
+    // batch read from it.
+    if (!matches_) {
+      matches_.reset(new SelectionVector(num_elems_));
+    }
+    SelectionVector& matches = *matches_;
+    matches.Resize(max_fetch);
+    matches.SetAllTrue();
+    ColumnBlock values_block(dst->type_info(), nullptr, values, max_fetch, dst->arena());
+    ctx->pred()->Evaluate(values_block, &matches);
+
+    // Mark the rows which don't match as not being returned.
+    SelectionVectorView matches_view(&matches);
+    for (size_t i = 0; i < max_fetch;) {
+      bool matched;
+      size_t run = matches_view.GetRun(i, max_fetch - i, &matched);
+      if (!matched) {
+        sel->ClearBits(run, i);
+      }
+      i += run;
+    }
+
+    if (!expanded) {
+      if (matches.AnySelected()) {
+        memcpy(dst->data(), values, max_fetch * size_of_type);
+      }
+      cur_idx_ += max_fetch;
+    }
+    *n = max_fetch;
+    return Status::OK();
+  }
+
   // Copy the codewords to a temporary buffer.
   // This API provides a more convenient way for the dictionary decoder to copy out
   // integer codewords and then look up the strings. If we use the CopyNextValuesToArray()
@@ -415,6 +479,9 @@ class BShufBlockDecoder final : public BlockDecoder {
 
   size_t cur_idx_;
   faststring decoded_;
+
+  // Scratch space for the rows matching the predicate in CopyNextAndEval().
+  std::unique_ptr<SelectionVector> matches_;
 };
 
 template<>
@@ -75,9 +75,14 @@
 #include "kudu/util/stopwatch.h"
 #include "kudu/util/test_macros.h"
 #include "kudu/util/test_util.h"
+#include "kudu/util/threadpool.h"
 
 DECLARE_bool(cfile_write_checksums);
+DECLARE_int32(cfile_compression_dictionary_sample_size);
+DECLARE_int32(cfile_compression_dictionary_size);
 DECLARE_bool(cfile_verify_checksums);
+DECLARE_int32(cfile_readahead_max_blocks);
+DECLARE_int32(cfile_readahead_min_latency_us);
 DECLARE_string(block_cache_type);
 DECLARE_bool(force_block_cache_capacity);
 DECLARE_int64(block_cache_capacity_mb);
@@ -254,6 +259,54 @@ class TestCFile : public CFileTestBase {
     TimeSeekAndReadFileWithNulls(generator, block_id, n);
   }
 
+  // Scans a file in batches whose selection vectors have runs of unselected
+  // rows of various lengths, checking that the selected rows are materialized
+  // correctly when the unselected ones are skipped.
+  template <class DataGeneratorType>
+  void TestScanSelectedRows(DataGeneratorType* generator, EncodingType encoding) {
+    const size_t kNumRows = 10000;
+    const size_t kBatchSize = 1000;
+    BlockId block_id;
+    WriteTestFile(generator, encoding, NO_COMPRESSION, kNumRows, SMALL_BLOCKSIZE, &block_id);
+
+    unique_ptr<ReadableBlock> block;
+    ASSERT_OK(fs_manager_->OpenBlock(block_id, &block));
+    unique_ptr<CFileReader> reader;
+    ASSERT_OK(CFileReader::Open(std::move(block), ReaderOptions(), &reader));
+    unique_ptr<CFileIterator> iter;
+    ASSERT_OK(reader->NewIterator(&iter, CFileReader::CACHE_BLOCK, nullptr));
+    ASSERT_OK(iter->SeekToFirst());
+
+    ScopedColumnBlock<DataGeneratorType::kDataType> cb(kBatchSize,
+                                                       DataGeneratorType::has_nulls());
+    SelectionVector sel(kBatchSize);
+    for (size_t offset = 0; offset < kNumRows; offset += kBatchSize) {
+      // Long runs of unselected rows are broken up by single selected rows.
+      for (size_t i = 0; i < kBatchSize; i++) {
+        size_t row = offset + i;
+        BitmapChange(sel.mutable_bitmap(), i, (row / 100) % 3 == 0 || row % 37 == 0);
+      }
+      ColumnMaterializationContext ctx(0, nullptr, &cb, &sel);
+      ctx.SetSkipUnselectedRows();
+      size_t n = kBatchSize;
+      ASSERT_OK(iter->CopyNextValues(&n, &ctx));
+      ASSERT_EQ(kBatchSize, n);
+
+      generator->Build(offset, kBatchSize);
+      for (size_t i = 0; i < kBatchSize; i++) {
+        if (!sel.IsRowSelected(i)) continue;
+        size_t row = offset + i;
+        if (DataGeneratorType::has_nulls()) {
+          ASSERT_EQ(generator->TestValueShouldBeNull(row), cb.is_null(i)) << row;
+          if (cb.is_null(i)) continue;
+        }
+        ASSERT_EQ((*generator)[i], cb[i]) << row;
+      }
+      cb.arena()->Reset();
+    }
+    ASSERT_FALSE(iter->HasNext());
+  }
+
   void TestReadWriteRawBlocks(CompressionType compression, int num_entries) {
     // Test Write
     unique_ptr<WritableBlock> sink;
@@ -319,7 +372,8 @@ class TestCFile : public CFileTestBase {
   }
 
   void TestReadWriteStrings(EncodingType encoding,
-                            std::function<string(size_t)> formatter);
+                            std::function<string(size_t)> formatter,
+                            CompressionType compression = NO_COMPRESSION);
 
 #ifdef NDEBUG
   void TestWrite100MFileStrings(EncodingType encoding) {
@@ -611,13 +665,14 @@ void EncodeStringKey(const Schema& schema,
 }
 
 void TestCFile::TestReadWriteStrings(EncodingType encoding,
-                                     std::function<string(size_t)> formatter) {
+                                     std::function<string(size_t)> formatter,
+                                     CompressionType compression) {
   Schema schema({ ColumnSchema("key", STRING) }, 1);
 
   const int nrows = 10000;
   BlockId block_id;
   StringDataGenerator<false> generator(formatter);
-  WriteTestFile(&generator, encoding, NO_COMPRESSION, nrows,
+  WriteTestFile(&generator, encoding, compression, nrows,
                 SMALL_BLOCKSIZE | WRITE_VALIDX, &block_id);
 
   unique_ptr<ReadableBlock> block;
@@ -740,6 +795,38 @@ TEST_P(TestCFileBothCacheMemoryTypes, TestReadWriteStringsDictEncoding) {
   TestReadWriteStrings(DICT_ENCODING);
 }
 
+// Test a file whose blocks are compressed with a trained dictionary. The
+// sample size is small enough that both the blocks buffered for training and
+// the blocks written after it are exercised.
+TEST_P(TestCFileBothCacheMemoryTypes, TestReadWriteStringsCompressionDictionary) {
+  RETURN_IF_NO_NVM_CACHE(GetParam());
+  FLAGS_cfile_compression_dictionary_sample_size = 32 * 1024;
+  auto formatter = [](size_t val) {
+    return StringPrintf("%08zd GET /api/v1/items?page=%zd HTTP/1.1 200", val, val % 37);
+  };
+  for (auto encoding : { PLAIN_ENCODING, PREFIX_ENCODING }) {
+    NO_FATALS(TestReadWriteStrings(encoding, formatter, ZSTD));
+  }
+
+  for (int dict_size : { 0, 16 * 1024 }) {
+    FLAGS_cfile_compression_dictionary_size = dict_size;
+    BlockId block_id;
+    StringDataGenerator<false> generator(formatter);
+    NO_FATALS(WriteTestFile(&generator, PLAIN_ENCODING, ZSTD, 10000,
+                            SMALL_BLOCKSIZE, &block_id));
+    unique_ptr<ReadableBlock> block;
+    ASSERT_OK(fs_manager_->OpenBlock(block_id, &block));
+    unique_ptr<CFileReader> reader;
+    ASSERT_OK(CFileReader::Open(std::move(block), ReaderOptions(), &reader));
+    ASSERT_EQ(dict_size > 0, reader->footer().has_compression_dictionary());
+    ASSERT_EQ(dict_size > 0, (reader->footer().incompatible_features() &
+                              IncompatibleFeatures::COMPRESSION_DICTIONARY) != 0);
+    size_t rdrows;
+    NO_FATALS(TimeReadFile(fs_manager_.get(), block_id, &rdrows));
+    ASSERT_EQ(10000, rdrows);
+  }
+}
+
 // Regression test for properly handling cells that are larger
 // than the index block and/or data block size.
 //
@@ -866,6 +953,7 @@ TEST_P(TestCFileBothCacheMemoryTypes, TestAppendRaw) {
   TestReadWriteRawBlocks(SNAPPY, 1000);
   TestReadWriteRawBlocks(LZ4, 1000);
   TestReadWriteRawBlocks(ZLIB, 1000);
+  TestReadWriteRawBlocks(ZSTD, 1000);
 }
 
 TEST_P(TestCFileBothCacheMemoryTypes, TestChecksumFlags) {
@@ -930,6 +1018,21 @@ TEST_P(TestCFileBothCacheMemoryTypes, TestNullInts) {
   TestNullTypes(&generator, RLE, LZ4);
 }
 
+TEST_P(TestCFileBothCacheMemoryTypes, TestScanSkipsUnselectedRows) {
+  RETURN_IF_NO_NVM_CACHE(GetParam());
+
+  for (auto encoding : { PLAIN_ENCODING, BIT_SHUFFLE, RLE }) {
+    UInt32DataGenerator<false> generator;
+    NO_FATALS(TestScanSelectedRows(&generator, encoding));
+    UInt32DataGenerator<true> nullable_generator;
+    NO_FATALS(TestScanSelectedRows(&nullable_generator, encoding));
+  }
+  for (auto encoding : { PLAIN_ENCODING, PREFIX_ENCODING, DICT_ENCODING }) {
+    StringDataGenerator<true> generator("hello %zu");
+    NO_FATALS(TestScanSelectedRows(&generator, encoding));
+  }
+}
+
 TEST_P(TestCFileBothCacheMemoryTypes, TestNullFloats) {
   RETURN_IF_NO_NVM_CACHE(GetParam());
 
@@ -963,6 +1066,69 @@ TEST_P(TestCFileBothCacheMemoryTypes, TestNullDictStrings) {
   TestNullTypes(&generator, DICT_ENCODING, LZ4);
 }
 
+// Test that scanning with readahead returns the same data, and accounts for
+// the blocks read ahead in the iterator's statistics.
+TEST_P(TestCFileBothCacheMemoryTypes, TestReadahead) {
+  RETURN_IF_NO_NVM_CACHE(GetParam());
+  FLAGS_cfile_readahead_max_blocks = 4;
+  // Never consider the blocks cached, so that the readahead doesn't shrink.
+  FLAGS_cfile_readahead_min_latency_us = 0;
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("readahead").set_max_threads(4).Build(&pool));
+
+  const int kNumRows = 10000;
+  for (auto cache_control : { CFileReader::CACHE_BLOCK, CFileReader::DONT_CACHE_BLOCK }) {
+    UInt32DataGenerator<true> generator;
+    BlockId block_id;
+    WriteTestFile(&generator, BIT_SHUFFLE, NO_COMPRESSION, kNumRows, SMALL_BLOCKSIZE,
+                  &block_id);
+
+    unique_ptr<ReadableBlock> block;
+    ASSERT_OK(fs_manager_->OpenBlock(block_id, &block));
+    ReaderOptions opts;
+    opts.readahead_pool = pool.get();
+    unique_ptr<CFileReader> reader;
+    ASSERT_OK(CFileReader::Open(std::move(block), std::move(opts), &reader));
+    unique_ptr<CFileIterator> iter;
+    ASSERT_OK(reader->NewIterator(&iter, cache_control, nullptr));
+    ASSERT_OK(iter->SeekToOrdinal(0));
+
+    ScopedColumnBlock<UINT32> out(100);
+    SelectionVector sel(out.nrows());
+    UInt32DataGenerator<true> expected;
+    size_t fetched = 0;
+    while (iter->HasNext()) {
+      size_t n = out.nrows();
+      ColumnMaterializationContext ctx = CreateNonDecoderEvalContext(&out, &sel);
+      ASSERT_OK(iter->CopyNextValues(&n, &ctx));
+      for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(expected.TestValueShouldBeNull(fetched + i), out.is_null(i));
+        if (!out.is_null(i)) {
+          ASSERT_EQ(expected.BuildTestValue(0, fetched + i), out[i]);
+        }
+      }
+      fetched += n;
+    }
+    ASSERT_EQ(kNumRows, fetched);
+
+    // Only the first block is read synchronously: the rest were read ahead.
+    const IteratorStats& stats = iter->io_statistics();
+    ASSERT_GT(stats.blocks_read, 1);
+    ASSERT_EQ(1, stats.readahead_misses);
+    ASSERT_EQ(stats.blocks_read - 1, stats.readahead_hits);
+    ASSERT_EQ(0, stats.readahead_wasted);
+
+    // Seeking back to the start of the file discards whatever was read ahead
+    // of the middle of the file.
+    ASSERT_OK(iter->SeekToOrdinal(kNumRows / 2));
+    size_t n = out.nrows();
+    ColumnMaterializationContext ctx = CreateNonDecoderEvalContext(&out, &sel);
+    ASSERT_OK(iter->CopyNextValues(&n, &ctx));
+    ASSERT_OK(iter->SeekToOrdinal(0));
+    ASSERT_GT(iter->io_statistics().readahead_wasted, 0);
+  }
+}
+
 TEST_P(TestCFileBothCacheMemoryTypes, TestReleaseBlock) {
   RETURN_IF_NO_NVM_CACHE(GetParam());
 
@@ -1105,7 +1271,7 @@ class TestCFileDifferentCodecs : public TestCFile,
 };
 
 INSTANTIATE_TEST_CASE_P(Codecs, TestCFileDifferentCodecs,
-                        ::testing::Values(NO_COMPRESSION, SNAPPY, LZ4, ZLIB));
+                        ::testing::Values(NO_COMPRESSION, SNAPPY, LZ4, ZLIB, ZSTD));
 
 // Read/write a file with uncompressible data (random int32s)
 TEST_P(TestCFileDifferentCodecs, TestUncompressible) {
@@ -34,8 +34,10 @@
 #include "kudu/cfile/cfile.pb.h"
 #include "kudu/cfile/cfile_util.h"
 #include "kudu/cfile/cfile_writer.h" // for kMagicString
+#include "kudu/cfile/column_bloom_filter.h"
 #include "kudu/cfile/index_btree.h"
 #include "kudu/cfile/type_encodings.h"
+#include "kudu/cfile/zone_map.h"
 #include "kudu/common/column_materialization_context.h"
 #include "kudu/common/column_predicate.h"
 #include "kudu/common/columnblock.h"
@@ -51,9 +53,11 @@
 #include "kudu/gutil/strings/substitute.h"
 #include "kudu/util/array_view.h"
 #include "kudu/util/bitmap.h"
+#include "kudu/util/block_bloom_filter.pb.h"
 #include "kudu/util/cache.h"
 #include "kudu/util/coding.h"
 #include "kudu/util/compression/compression_codec.h"
+#include "kudu/util/countdown_latch.h"
 #include "kudu/util/crc.h"
 #include "kudu/util/debug/trace_event.h"
 #include "kudu/util/fault_injection.h"
@@ -62,11 +66,13 @@
 #include "kudu/util/malloc.h"
 #include "kudu/util/memory/arena.h"
 #include "kudu/util/memory/overwrite.h"
+#include "kudu/util/monotime.h"
 #include "kudu/util/object_pool.h"
 #include "kudu/util/pb_util.h"
 #include "kudu/util/rle-encoding.h"
 #include "kudu/util/slice.h"
 #include "kudu/util/status.h"
+#include "kudu/util/threadpool.h"
 #include "kudu/util/trace.h"
 
 DEFINE_bool(cfile_lazy_open, true,
@@ -82,11 +88,27 @@ DEFINE_double(cfile_inject_corruption, 0,
               "with a corruption status");
 TAG_FLAG(cfile_inject_corruption, hidden);
 
+DEFINE_int32(cfile_readahead_max_blocks, 0,
+             "Maximum number of data blocks of each column read ahead of a scan, in the "
+             "background, while the current blocks are decoded. The number of blocks "
+             "read ahead adapts to the observed I/O latency, up to this maximum. If 0, "
+             "blocks are only read when the scan reaches them.");
+TAG_FLAG(cfile_readahead_max_blocks, experimental);
+TAG_FLAG(cfile_readahead_max_blocks, runtime);
+
+DEFINE_int32(cfile_readahead_min_latency_us, 200,
+             "Data blocks read faster than this many microseconds are assumed to have been "
+             "served from a cache, and reduce the number of blocks read ahead of a scan. "
+             "Only used if --cfile_readahead_max_blocks is positive.");
+TAG_FLAG(cfile_readahead_min_latency_us, experimental);
+TAG_FLAG(cfile_readahead_min_latency_us, runtime);
+
 using kudu::fault_injection::MaybeTrue;
 using kudu::fs::ErrorHandlerType;
 using kudu::fs::IOContext;
 using kudu::fs::ReadableBlock;
 using kudu::pb_util::SecureDebugString;
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using std::vector;
@@ -136,10 +158,14 @@ CFileReader::CFileReader(ReaderOptions options,
   block_(std::move(block)),
   file_size_(file_size),
   codec_(nullptr),
+  readahead_pool_(options.readahead_pool),
   mem_consumption_(std::move(options.parent_mem_tracker),
                    memory_footprint()) {
 }
 
+CFileReader::~CFileReader() {
+}
+
 Status CFileReader::Open(unique_ptr<ReadableBlock> block,
                          ReaderOptions options,
                          unique_ptr<CFileReader>* reader) {
@@ -316,6 +342,12 @@ Status CFileReader::ReadAndParseFooter() {
   if (footer_->compression() != NO_COMPRESSION) {
     RETURN_NOT_OK_PREPEND(GetCompressionCodec(footer_->compression(), &codec_),
                           "failed to load CFile compression codec");
+    if (footer_->has_compression_dictionary()) {
+      RETURN_NOT_OK_PREPEND(codec_->CreateDictionaryCodec(footer_->compression_dictionary(),
+                                                          &dictionary_codec_),
+                            "failed to load CFile compression dictionary");
+      codec_ = dictionary_codec_.get();
+    }
   }
 
   VLOG(2) << "Read footer: " << SecureDebugString(*footer_);
@@ -596,6 +628,73 @@ Status CFileReader::NewIterator(unique_ptr<CFileIterator>* iter,
   return Status::OK();
 }
 
+Status CFileReader::ReadZoneMap(const IOContext* io_context) {
+  // The zone map is kept in memory once parsed, so there is no point in
+  // also caching the raw block.
+  BlockHandle handle;
+  RETURN_NOT_OK_PREPEND(ReadBlock(io_context, BlockPointer(footer().zone_map_ptr()),
+                                  DONT_CACHE_BLOCK, &handle),
+                        "couldn't read zone map block");
+  ZoneMapPB pb;
+  const Slice data = handle.data();
+  if (PREDICT_FALSE(!pb.ParseFromArray(data.data(), data.size()))) {
+    HandleCorruption(io_context);
+    return Status::Corruption("invalid zone map in cfile", ToString());
+  }
+  Status s = ZoneMap::Create(pb, type_info_, footer().num_values(), &zone_map_);
+  if (PREDICT_FALSE(!s.ok())) {
+    HandleCorruption(io_context);
+    return s.CloneAndPrepend(Substitute("invalid zone map in cfile $0", ToString()));
+  }
+  mem_consumption_.Reset(memory_footprint());
+  return Status::OK();
+}
+
+Status CFileReader::GetZoneMap(const IOContext* io_context, const ZoneMap** zone_map) {
+  DCHECK(init_once_.init_succeeded());
+  if (!has_zone_map()) {
+    *zone_map = nullptr;
+    return Status::OK();
+  }
+  RETURN_NOT_OK(zone_map_once_.Init([this, io_context] { return ReadZoneMap(io_context); }));
+  *zone_map = zone_map_.get();
+  return Status::OK();
+}
+
+Status CFileReader::ReadBloomFilter(const IOContext* io_context) {
+  BlockHandle handle;
+  RETURN_NOT_OK_PREPEND(ReadBlock(io_context, BlockPointer(footer().bloom_filter_ptr()),
+                                  DONT_CACHE_BLOCK, &handle),
+                        "couldn't read bloom filter block");
+  BlockBloomFilterPB pb;
+  const Slice data = handle.data();
+  if (PREDICT_FALSE(!pb.ParseFromArray(data.data(), data.size()))) {
+    HandleCorruption(io_context);
+    return Status::Corruption("invalid bloom filter in cfile", ToString());
+  }
+  Status s = ColumnBloomFilter::Create(pb, type_info_, &bloom_filter_);
+  if (PREDICT_FALSE(!s.ok())) {
+    HandleCorruption(io_context);
+    return s.CloneAndPrepend(Substitute("invalid bloom filter in cfile $0", ToString()));
+  }
+  mem_consumption_.Reset(memory_footprint());
+  return Status::OK();
+}
+
+Status CFileReader::GetBloomFilter(const IOContext* io_context,
+                                   const ColumnBloomFilter** bloom_filter) {
+  DCHECK(init_once_.init_succeeded());
+  if (!has_bloom_filter()) {
+    *bloom_filter = nullptr;
+    return Status::OK();
+  }
+  RETURN_NOT_OK(bloom_filter_once_.Init([this, io_context] {
+    return ReadBloomFilter(io_context);
+  }));
+  *bloom_filter = bloom_filter_.get();
+  return Status::OK();
+}
+
 size_t CFileReader::memory_footprint() const {
   size_t size = kudu_malloc_usable_size(this);
   size += block_->memory_footprint();
@@ -610,6 +709,14 @@ size_t CFileReader::memory_footprint() const {
   if (footer_) {
     size += footer_->SpaceUsedLong();
   }
+  size += zone_map_once_.memory_footprint_excluding_this();
+  if (zone_map_) {
+    size += zone_map_->memory_footprint();
+  }
+  size += bloom_filter_once_.memory_footprint_excluding_this();
+  if (bloom_filter_) {
+    size += bloom_filter_->memory_footprint();
+  }
   return size;
 }
 
@@ -674,6 +781,21 @@ Status DefaultColumnValueIterator::FinishBatch() {
 ////////////////////////////////////////////////////////////
 // Iterator
 ////////////////////////////////////////////////////////////
+struct CFileIterator::ReadaheadBlock {
+  explicit ReadaheadBlock(const BlockPointer& ptr)
+      : ptr(ptr),
+        done(1) {
+  }
+
+  const BlockPointer ptr;
+
+  // Counted down once the fields below are set.
+  CountDownLatch done;
+  Status status;
+  BlockHandle data;
+  MonoDelta read_time;
+};
+
 CFileIterator::CFileIterator(CFileReader* reader,
                              CFileReader::CacheControl cache_control,
                              const IOContext* io_context)
@@ -683,10 +805,17 @@ CFileIterator::CFileIterator(CFileReader* reader,
     cache_control_(cache_control),
     last_prepare_idx_(-1),
     last_prepare_count_(-1),
-    io_context_(io_context) {
+    io_context_(io_context),
+    readahead_iter_valid_(false),
+    readahead_depth_(1) {
 }
 
 CFileIterator::~CFileIterator() {
+  // Wait for any blocks still being read ahead, since the reads use 'reader_'
+  // and 'io_context_'.
+  if (readahead_token_) {
+    readahead_token_->Shutdown();
+  }
 }
 
 Status CFileIterator::SeekToOrdinal(rowid_t ord_idx) {
@@ -825,14 +954,7 @@ Status CFileIterator::SeekAtOrAfter(const EncodedKey &key,
     prepared_block_pool_.Construct());
   RETURN_NOT_OK(ReadCurrentDataBlock(*validx_iter_, b.get()));
 
-  Status dblk_seek_status;
-  if (key.num_key_columns() > 1) {
-    Slice slice = key.encoded_key();
-    dblk_seek_status = b->dblk_->SeekAtOrAfterValue(&slice, exact_match);
-  } else {
-    dblk_seek_status = b->dblk_->SeekAtOrAfterValue(key.raw_keys()[0],
-                                                    exact_match);
-  }
+  Status dblk_seek_status = SeekToValueInBlock(key, b.get(), exact_match);
 
   // If seeking within the data block results in NotFound, then that indicates that the
   // value we're looking for fell after all the data in that block.
@@ -864,6 +986,39 @@ Status CFileIterator::SeekAtOrAfter(const EncodedKey &key,
   return Status::OK();
 }
 
+Status CFileIterator::SeekAtOrAfterInOrder(const EncodedKey &key,
+                                           bool *exact_match) {
+  // If the previous seek was a value seek which left a single block prepared,
+  // that block starts at or before the previous key, and therefore at or before
+  // 'key'. Unless 'key' is after all of the block's values, the block alone
+  // decides where 'key' would be: the values of the following blocks are all
+  // larger than the ones in this block.
+  if (seeked_ != nullptr && seeked_ == validx_iter_.get() &&
+      prepared_blocks_.size() == 1 && last_prepare_count_ == 0) {
+    PreparedBlock *b = prepared_blocks_[0];
+    Status s = SeekToValueInBlock(key, b, exact_match);
+    if (s.ok()) {
+      last_prepare_idx_ = b->first_row_idx() + b->dblk_->GetCurrentIndex();
+      return Status::OK();
+    }
+    if (!s.IsNotFound()) {
+      return s;
+    }
+    // The key is after the block: fall back to a full seek.
+  }
+  return SeekAtOrAfter(key, exact_match);
+}
+
+Status CFileIterator::SeekToValueInBlock(const EncodedKey &key,
+                                         PreparedBlock *pb,
+                                         bool *exact_match) {
+  if (key.num_key_columns() > 1) {
+    Slice slice = key.encoded_key();
+    return pb->dblk_->SeekAtOrAfterValue(&slice, exact_match);
+  }
+  return pb->dblk_->SeekAtOrAfterValue(key.raw_keys()[0], exact_match);
+}
+
 Status CFileIterator::PrepareForNewSeek() {
   // Fully open the CFileReader if it was lazily opened earlier.
   //
@@ -898,6 +1053,7 @@ Status CFileIterator::PrepareForNewSeek() {
   }
 
   seeked_ = nullptr;
+  DiscardReadahead();
   for (PreparedBlock *pb : prepared_blocks_) {
     prepared_block_pool_.Destroy(pb);
   }
@@ -918,6 +1074,91 @@ string CFileIterator::PreparedBlock::ToString() const {
                       last_row_idx());
 }
 
+Status CFileIterator::ReadDataBlock(const IndexTreeIterator& idx_iter,
+                                    const BlockPointer& ptr,
+                                    BlockHandle* data) {
+  // Only sequential scans through the positional index are read ahead.
+  const int max_depth = FLAGS_cfile_readahead_max_blocks;
+  if (max_depth <= 0 || !reader_->readahead_pool() || &idx_iter != posidx_iter_.get()) {
+    DiscardReadahead();
+    return reader_->ReadBlock(io_context_, ptr, cache_control_, data);
+  }
+
+  const MonoDelta min_latency =
+      MonoDelta::FromMicroseconds(FLAGS_cfile_readahead_min_latency_us);
+  if (!readahead_blocks_.empty() && readahead_blocks_.front()->ptr.offset() == ptr.offset()) {
+    shared_ptr<ReadaheadBlock> b = std::move(readahead_blocks_.front());
+    readahead_blocks_.pop_front();
+    bool waited = b->done.count() > 0;
+    b->done.Wait();
+    io_stats_.readahead_hits++;
+    if (waited) {
+      // The scan caught up with the readahead: read further ahead.
+      readahead_depth_ *= 2;
+    } else if (b->read_time < min_latency) {
+      // The block was likely cached, so reading ahead gains little.
+      readahead_depth_ = std::max(readahead_depth_ - 1, 0);
+    }
+    RETURN_NOT_OK(b->status);
+    *data = std::move(b->data);
+  } else {
+    // The block wasn't read ahead, e.g. because this is the first block after
+    // a seek. Read it now and restart the readahead after it.
+    DiscardReadahead();
+    io_stats_.readahead_misses++;
+    MonoTime start = MonoTime::Now();
+    RETURN_NOT_OK(reader_->ReadBlock(io_context_, ptr, cache_control_, data));
+    if (MonoTime::Now() - start >= min_latency) {
+      readahead_depth_ = std::max(readahead_depth_ * 2, 1);
+    }
+  }
+  readahead_depth_ = std::min(readahead_depth_, max_depth);
+  return IssueReadahead(idx_iter);
+}
+
+Status CFileIterator::IssueReadahead(const IndexTreeIterator& idx_iter) {
+  if (readahead_blocks_.size() >= static_cast<size_t>(readahead_depth_)) {
+    return Status::OK();
+  }
+  if (!readahead_iter_valid_) {
+    if (!readahead_iter_) {
+      readahead_iter_.reset(IndexTreeIterator::Create(io_context_, reader_,
+                                                      reader_->posidx_root()));
+    }
+    RETURN_NOT_OK(readahead_iter_->SeekAtOrBefore(idx_iter.GetCurrentKey()));
+    readahead_iter_valid_ = true;
+  }
+  if (!readahead_token_) {
+    readahead_token_ =
+        reader_->readahead_pool()->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+  }
+
+  while (readahead_blocks_.size() < static_cast<size_t>(readahead_depth_) &&
+         readahead_iter_->HasNext()) {
+    RETURN_NOT_OK(readahead_iter_->Next());
+    shared_ptr<ReadaheadBlock> b =
+        std::make_shared<ReadaheadBlock>(readahead_iter_->GetCurrentBlockPointer());
+    const CFileReader* reader = reader_;
+    const IOContext* io_context = io_context_;
+    CFileReader::CacheControl cache_control = cache_control_;
+    RETURN_NOT_OK(readahead_token_->Submit([b, reader, io_context, cache_control]() {
+      MonoTime start = MonoTime::Now();
+      b->status = reader->ReadBlock(io_context, b->ptr, cache_control, &b->data);
+      b->read_time = MonoTime::Now() - start;
+      b->done.CountDown();
+    }));
+    readahead_blocks_.emplace_back(std::move(b));
+  }
+  return Status::OK();
+}
+
+void CFileIterator::DiscardReadahead() {
+  // Blocks still being read are freed by their readahead tasks.
+  io_stats_.readahead_wasted += readahead_blocks_.size();
+  readahead_blocks_.clear();
+  readahead_iter_valid_ = false;
+}
+
 // Decode the null header in the beginning of the data block
 Status DecodeNullInfo(Slice *data_block, uint32_t *num_rows_in_block, Slice *non_null_bitmap) {
   if (!GetVarint32(data_block, num_rows_in_block)) {
@@ -937,8 +1178,7 @@ Status DecodeNullInfo(Slice *data_block, uint32_t *num_rows_in_block, Slice *non
 Status CFileIterator::ReadCurrentDataBlock(const IndexTreeIterator &idx_iter,
                                            PreparedBlock *prep_block) {
   prep_block->dblk_ptr_ = idx_iter.GetCurrentBlockPointer();
-  RETURN_NOT_OK(reader_->ReadBlock(io_context_, prep_block->dblk_ptr_,
-                                   cache_control_, &prep_block->dblk_data_));
+  RETURN_NOT_OK(ReadDataBlock(idx_iter, prep_block->dblk_ptr_, &prep_block->dblk_data_));
 
   uint32_t num_rows_in_block = 0;
   Slice data_block = prep_block->dblk_data_.data();
@@ -1108,6 +1348,7 @@ Status CFileIterator::Scan(ColumnMaterializationContext* ctx) {
       }
     }
   }
+  const bool skip_unselected = ctx->skip_unselected_rows();
   for (PreparedBlock *pb : prepared_blocks_) {
     if (pb->needs_rewind_) {
       // Seek back to the saved position.
@@ -1138,6 +1379,8 @@ Status CFileIterator::Scan(ColumnMaterializationContext* ctx) {
                                                      ctx,
                                                      &remaining_sel,
                                                      &remaining_dst));
+          } else if (skip_unselected) {
+            RETURN_NOT_OK(CopySelectedValues(pb, this_batch, remaining_sel, remaining_dst));
           } else {
             RETURN_NOT_OK(pb->dblk_->CopyNextValues(&this_batch, &remaining_dst));
           }
@@ -1169,6 +1412,9 @@ Status CFileIterator::Scan(ColumnMaterializationContext* ctx) {
 
       if (ctx->DecoderEvalNotDisabled()) {
         RETURN_NOT_OK(pb->dblk_->CopyNextAndEval(&this_batch, ctx, &remaining_sel, &remaining_dst));
+      } else if (skip_unselected) {
+        this_batch = std::min<size_t>(rem, pb->num_rows_in_block_ - pb->idx_in_block_);
+        RETURN_NOT_OK(CopySelectedValues(pb, this_batch, remaining_sel, remaining_dst));
       } else {
         RETURN_NOT_OK(pb->dblk_->CopyNextValues(&this_batch, &remaining_dst));
       }
@@ -1200,6 +1446,53 @@ Status CFileIterator::Scan(ColumnMaterializationContext* ctx) {
   return Status::OK();
 }
 
+Status CFileIterator::CopySelectedValues(PreparedBlock* pb,
+                                         size_t n,
+                                         const SelectionVectorView& sel,
+                                         const ColumnDataView& dst) {
+  // Seeking has some fixed cost in most decoders, so short runs of unselected
+  // rows are cheaper to decode along with the rows around them.
+  static const size_t kMinRowsToSkip = 16;
+
+  ColumnDataView cur_dst(dst);
+  size_t idx = 0;
+  while (idx < n) {
+    bool selected;
+    size_t run = sel.GetRun(idx, n - idx, &selected);
+    if (!selected && run >= kMinRowsToSkip) {
+#ifndef NDEBUG
+      kudu::OverwriteWithPattern(reinterpret_cast<char *>(cur_dst.data()),
+                                 cur_dst.stride() * run,
+                                 "UNSELECTEDUNSELECTED");
+#endif
+      pb->dblk_->SeekToPositionInBlock(pb->dblk_->GetCurrentIndex() + run);
+      cur_dst.Advance(run);
+      idx += run;
+      continue;
+    }
+
+    // Decode this run along with any following runs of selected rows and
+    // short runs of unselected rows.
+    size_t to_copy = run;
+    while (idx + to_copy < n) {
+      size_t next_run = sel.GetRun(idx + to_copy, n - idx - to_copy, &selected);
+      if (!selected && next_run >= kMinRowsToSkip) {
+        break;
+      }
+      to_copy += next_run;
+    }
+    size_t copied = to_copy;
+    RETURN_NOT_OK(pb->dblk_->CopyNextValues(&copied, &cur_dst));
+    if (PREDICT_FALSE(copied != to_copy)) {
+      return Status::Corruption(Substitute("Unexpected end of data block: expected $0 more values",
+                                           to_copy - copied));
+    }
+    cur_dst.Advance(to_copy);
+    idx += to_copy;
+  }
+  return Status::OK();
+}
+
 Status CFileIterator::CopyNextValues(size_t* n, ColumnMaterializationContext* ctx) {
   RETURN_NOT_OK(PrepareBatch(n));
   RETURN_NOT_OK(Scan(ctx));
@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,10 +46,14 @@
 
 namespace kudu {
 
+class ColumnDataView;
 class ColumnMaterializationContext;
 class CompressionCodec;
 class EncodedKey;
 class SelectionVector;
+class SelectionVectorView;
+class ThreadPool;
+class ThreadPoolToken;
 class TypeInfo;
 
 namespace fs {
@@ -63,6 +68,8 @@ class BinaryPlainBlockDecoder;
 class CFileIterator;
 class IndexTreeIterator;
 class TypeEncodingInfo;
+class ColumnBloomFilter;
+class ZoneMap;
 struct ReaderOptions;
 
 class CFileReader {
@@ -84,6 +91,8 @@ class CFileReader {
                            ReaderOptions options,
                            std::unique_ptr<CFileReader>* reader);
 
+  ~CFileReader();
+
   // Fully opens a previously lazily opened cfile, parsing and validating
   // its contents.
   //
@@ -167,6 +176,9 @@ class CFileReader {
     return BlockPointer(footer().posidx_info().root_block());
   }
 
+  // Returns the pool used to read data blocks ahead of scans, if any.
+  ThreadPool* readahead_pool() const { return readahead_pool_; }
+
   // Return true if there is a value-based index on this file.
   bool has_validx() const { return footer().has_validx_info(); }
   BlockPointer validx_root() const {
@@ -174,6 +186,21 @@ class CFileReader {
     return BlockPointer(footer().validx_info().root_block());
   }
 
+  // Returns true if the file has a zone map.
+  bool has_zone_map() const { return footer().has_zone_map_ptr(); }
+
+  // Returns the zone map of the file in '*zone_map', reading it on first use.
+  // The zone map remains owned by the reader. Sets '*zone_map' to nullptr if
+  // the file has no zone map.
+  Status GetZoneMap(const fs::IOContext* io_context, const ZoneMap** zone_map);
+
+  // Returns true if the file has a column bloom filter.
+  bool has_bloom_filter() const { return footer().has_bloom_filter_ptr(); }
+
+  // Like GetZoneMap(), but for the column bloom filter of the file.
+  Status GetBloomFilter(const fs::IOContext* io_context,
+                        const ColumnBloomFilter** bloom_filter);
+
   // Returns true if the file has checksums on the header, footer, and data blocks.
   bool has_checksums() const;
 
@@ -198,6 +225,12 @@ class CFileReader {
   Status ReadAndParseFooter();
   Status VerifyChecksum(ArrayView<const Slice> data, const Slice& checksum) const;
 
+  // Callback used in 'zone_map_once_' to read the zone map.
+  Status ReadZoneMap(const fs::IOContext* io_context);
+
+  // Callback used in 'bloom_filter_once_' to read the column bloom filter.
+  Status ReadBloomFilter(const fs::IOContext* io_context);
+
   // Returns the memory usage of the object including the object itself.
   size_t memory_footprint() const;
 
@@ -212,11 +245,22 @@ class CFileReader {
   std::unique_ptr<CFileHeaderPB> header_;
   std::unique_ptr<CFileFooterPB> footer_;
   const CompressionCodec* codec_;
+  // Set if the blocks of the file were compressed with a dictionary, in
+  // which case 'codec_' points to it.
+  std::unique_ptr<CompressionCodec> dictionary_codec_;
   const TypeInfo *type_info_;
   const TypeEncodingInfo *type_encoding_info_;
 
   KuduOnceLambda init_once_;
 
+  std::unique_ptr<ZoneMap> zone_map_;
+  KuduOnceLambda zone_map_once_;
+
+  std::unique_ptr<ColumnBloomFilter> bloom_filter_;
+  KuduOnceLambda bloom_filter_once_;
+
+  ThreadPool* const readahead_pool_;
+
   ScopedTrackedConsumption mem_consumption_;
 };
 
@@ -341,6 +385,15 @@ class CFileIterator : public ColumnIterator {
   Status SeekAtOrAfter(const EncodedKey &encoded_key,
                        bool *exact_match);
 
+  // Same as SeekAtOrAfter(), for callers which seek to keys in increasing
+  // order: if the key falls within the data block of the previous seek, only
+  // that block is searched, skipping the value index and the block read.
+  //
+  // REQUIRES: 'encoded_key' is no smaller than the key of the previous seek
+  // on this iterator, if any, and no batch was prepared since that seek.
+  Status SeekAtOrAfterInOrder(const EncodedKey &encoded_key,
+                              bool *exact_match);
+
   // Return true if this reader is currently seeked.
   // If the iterator is not seeked, it is an error to call any functions except
   // for seek (including GetCurrentOrdinal).
@@ -442,9 +495,39 @@ class CFileIterator : public ColumnIterator {
     std::string ToString() const;
   };
 
+  // Seek the data block of the given PreparedBlock to 'key', or to the first
+  // value after it. Returns NotFound if 'key' is after all values in the block.
+  Status SeekToValueInBlock(const EncodedKey &key, PreparedBlock *pb,
+                            bool *exact_match);
+
   // Seek the given PreparedBlock to the given index within it.
   void SeekToPositionInBlock(PreparedBlock *pb, uint32_t idx_in_block);
 
+  // Copy the next 'n' non-null values of the given PreparedBlock into 'dst',
+  // decoding only the values of the rows selected in 'sel'. The decoder is
+  // seeked past long runs of unselected rows, whose cells are left unset.
+  Status CopySelectedValues(PreparedBlock* pb,
+                            size_t n,
+                            const SelectionVectorView& sel,
+                            const ColumnDataView& dst);
+
+  // A data block read ahead of the scan by the readahead pool.
+  struct ReadaheadBlock;
+
+  // Reads the data block at 'ptr' into 'data', using a block read ahead by
+  // the readahead pool if there is one, and then issues readahead for the
+  // blocks following it in 'idx_iter'.
+  Status ReadDataBlock(const IndexTreeIterator& idx_iter,
+                       const BlockPointer& ptr,
+                       BlockHandle* data);
+
+  // Issues reads for the blocks following the one 'idx_iter' is seeked to,
+  // until 'readahead_depth_' blocks are outstanding.
+  Status IssueReadahead(const IndexTreeIterator& idx_iter);
+
+  // Discards any blocks read ahead, e.g. because the iterator is seeking.
+  void DiscardReadahead();
+
   // Read the data block currently pointed to by idx_iter_
   // into the given PreparedBlock structure.
   //
@@ -502,6 +585,20 @@ class CFileIterator : public ColumnIterator {
 
   const fs::IOContext* io_context_;
 
+  // Readahead state, only used if --cfile_readahead_max_blocks is positive.
+  //
+  // Blocks are read ahead of the scan, in file order, by tasks submitted via
+  // 'readahead_token_'. 'readahead_iter_' is a positional index iterator seeked
+  // to the last block in 'readahead_blocks_', or invalid if that's empty and
+  // the iterator must be re-seeked. The number of blocks kept outstanding,
+  // 'readahead_depth_', grows while the scan waits on I/O and shrinks while
+  // blocks are read faster than --cfile_readahead_min_latency_us.
+  std::unique_ptr<ThreadPoolToken> readahead_token_;
+  std::unique_ptr<IndexTreeIterator> readahead_iter_;
+  bool readahead_iter_valid_;
+  std::deque<std::shared_ptr<ReadaheadBlock>> readahead_blocks_;
+  int readahead_depth_;
+
   // a temporary buffer for encoding
   faststring tmp_buf_;
 };
@@ -31,6 +31,7 @@
 namespace kudu {
 
 class MemTracker;
+class ThreadPool;
 class faststring;
 
 namespace fs {
@@ -49,7 +50,10 @@ enum IncompatibleFeatures {
   // Write a crc32 checksum at the end of each cfile block
   CHECKSUM = 1 << 0,
 
-  SUPPORTED = NONE | CHECKSUM
+  // Blocks are compressed with the dictionary stored in the footer
+  COMPRESSION_DICTIONARY = 1 << 1,
+
+  SUPPORTED = NONE | CHECKSUM | COMPRESSION_DICTIONARY
 };
 
 typedef std::function<void(const void*, faststring*)> ValidxKeyEncoder;
@@ -79,6 +83,10 @@ struct WriterOptions {
   // instead of entire keys.
   bool optimize_index_keys;
 
+  // Whether to write a zone map: a summary of the values of each data block,
+  // used by readers to skip blocks which cannot satisfy a predicate.
+  bool write_zone_map;
+
   // Column storage attributes.
   //
   // Default: all default values as specified in the constructor in
@@ -104,6 +112,13 @@ struct ReaderOptions {
   //
   // Default: the root tracker.
   std::shared_ptr<MemTracker> parent_mem_tracker;
+
+  // The pool used by this reader's iterators to read data blocks ahead of
+  // sequential scans. Must outlive the iterators. If null, or if
+  // --cfile_readahead_max_blocks isn't positive, blocks aren't read ahead.
+  //
+  // Default: nullptr
+  ThreadPool* readahead_pool = nullptr;
 };
 
 // Dumps the contents of a cfile to 'out'; 'reader' and 'iterator'
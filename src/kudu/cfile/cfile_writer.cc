@@ -17,6 +17,7 @@
 
 #include "kudu/cfile/cfile_writer.h"
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <numeric>
@@ -32,14 +33,17 @@
 #include "kudu/cfile/block_pointer.h"
 #include "kudu/cfile/cfile.pb.h"
 #include "kudu/cfile/cfile_util.h"
+#include "kudu/cfile/column_bloom_filter.h"
 #include "kudu/cfile/index_btree.h"
 #include "kudu/cfile/type_encodings.h"
+#include "kudu/cfile/zone_map.h"
 #include "kudu/common/common.pb.h"
 #include "kudu/common/key_encoder.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/types.h"
 #include "kudu/gutil/port.h"
 #include "kudu/util/array_view.h" // IWYU pragma: keep
+#include "kudu/util/block_bloom_filter.pb.h"
 #include "kudu/util/coding.h"
 #include "kudu/util/coding-inl.h"
 #include "kudu/util/compression/compression_codec.h"
@@ -61,6 +65,24 @@ DEFINE_bool(cfile_write_checksums, true,
             "Write CRC32 checksums for each block");
 TAG_FLAG(cfile_write_checksums, evolving);
 
+DEFINE_double(cfile_bloom_filter_fp_rate, 0.01,
+              "Target false positive rate of the bloom filters written for "
+              "columns with the bloom filter storage attribute");
+TAG_FLAG(cfile_bloom_filter_fp_rate, advanced);
+
+DEFINE_int32(cfile_compression_dictionary_size, 16 * 1024,
+             "Maximum size in bytes of the compression dictionary trained for "
+             "each cfile compressed with a codec which supports dictionaries. "
+             "Set to 0 to compress without dictionaries.");
+TAG_FLAG(cfile_compression_dictionary_size, experimental);
+TAG_FLAG(cfile_compression_dictionary_size, runtime);
+
+DEFINE_int32(cfile_compression_dictionary_sample_size, 1024 * 1024,
+             "Amount of data block bytes from the start of each cfile which are "
+             "buffered to train its compression dictionary.");
+TAG_FLAG(cfile_compression_dictionary_sample_size, experimental);
+TAG_FLAG(cfile_compression_dictionary_sample_size, runtime);
+
 using google::protobuf::RepeatedPtrField;
 using kudu::fs::BlockCreationTransaction;
 using kudu::fs::BlockManager;
@@ -81,6 +103,13 @@ const size_t kChecksumSize = sizeof(uint32_t);
 
 static const size_t kMinBlockSize = 512;
 
+// The data blocks buffered for dictionary training are split into samples of
+// this size, since the trainer works best with many small samples.
+static const size_t kDictionarySampleChunkSize = 4 * 1024;
+
+// Dictionaries smaller than this aren't worth training.
+static const size_t kMinDictionarySize = 1024;
+
 ////////////////////////////////////////////////////////////
 // CFileWriter
 ////////////////////////////////////////////////////////////
@@ -96,6 +125,8 @@ CFileWriter::CFileWriter(WriterOptions options,
     options_(std::move(options)),
     is_nullable_(is_nullable),
     typeinfo_(typeinfo),
+    sampling_for_dictionary_(false),
+    pending_blocks_size_(0),
     state_(kWriterInitialized) {
   EncodingType encoding = options_.storage_attributes.encoding;
   Status s = TypeEncodingInfo::Get(typeinfo_, encoding, &type_encoding_info_);
@@ -138,6 +169,15 @@ CFileWriter::CFileWriter(WriterOptions options,
 
     validx_builder_.reset(new IndexTreeBuilder(&options_, this));
   }
+
+  if (options_.write_zone_map) {
+    zone_map_builder_.reset(new ZoneMapBuilder(typeinfo_));
+  }
+
+  if (options_.storage_attributes.bloom_filter) {
+    bloom_filter_builder_.reset(new ColumnBloomFilterBuilder(typeinfo_,
+                                                             FLAGS_cfile_bloom_filter_fp_rate));
+  }
 }
 
 CFileWriter::~CFileWriter() {
@@ -152,6 +192,8 @@ Status CFileWriter::Start() {
     const CompressionCodec* codec;
     RETURN_NOT_OK(GetCompressionCodec(compression_, &codec));
     block_compressor_.reset(new CompressedBlockBuilder(codec));
+    sampling_for_dictionary_ = codec->SupportsDictionary() &&
+                               FLAGS_cfile_compression_dictionary_size > 0;
   }
 
   CFileHeaderPB header;
@@ -207,6 +249,7 @@ Status CFileWriter::FinishAndReleaseBlock(BlockCreationTransaction* transaction)
 
   // Write out any pending values as the last data block.
   RETURN_NOT_OK(FinishCurDataBlock());
+  RETURN_NOT_OK(FinishDictionarySampling());
 
   state_ = kWriterFinished;
 
@@ -214,6 +257,9 @@ Status CFileWriter::FinishAndReleaseBlock(BlockCreationTransaction* transaction)
   if (FLAGS_cfile_write_checksums) {
     incompatible_features |= IncompatibleFeatures::CHECKSUM;
   }
+  if (!compression_dictionary_.empty()) {
+    incompatible_features |= IncompatibleFeatures::COMPRESSION_DICTIONARY;
+  }
 
   // Start preparing the footer.
   CFileFooterPB footer;
@@ -223,6 +269,9 @@ Status CFileWriter::FinishAndReleaseBlock(BlockCreationTransaction* transaction)
   footer.set_num_values(value_count_);
   footer.set_compression(compression_);
   footer.set_incompatible_features(incompatible_features);
+  if (!compression_dictionary_.empty()) {
+    footer.set_compression_dictionary(compression_dictionary_);
+  }
 
   // Write out any pending positional index blocks.
   if (options_.write_posidx) {
@@ -238,6 +287,30 @@ Status CFileWriter::FinishAndReleaseBlock(BlockCreationTransaction* transaction)
     footer.mutable_validx_info()->CopyFrom(validx_info);
   }
 
+  if (zone_map_builder_) {
+    ZoneMapPB zone_map;
+    zone_map_builder_->Finish(&zone_map);
+    faststring zone_map_str;
+    pb_util::SerializeToString(zone_map, &zone_map_str);
+    BlockPointer zone_map_ptr;
+    RETURN_NOT_OK_PREPEND(AddBlock({ Slice(zone_map_str) }, &zone_map_ptr, "zone map block"),
+                          "Couldn't write zone map");
+    zone_map_ptr.CopyToPB(footer.mutable_zone_map_ptr());
+  }
+
+  if (bloom_filter_builder_ && !bloom_filter_builder_->has_nan()) {
+    BlockBloomFilterPB bloom_filter;
+    RETURN_NOT_OK_PREPEND(bloom_filter_builder_->Finish(&bloom_filter),
+                          "Couldn't build bloom filter");
+    faststring bloom_filter_str;
+    pb_util::SerializeToString(bloom_filter, &bloom_filter_str);
+    BlockPointer bloom_filter_ptr;
+    RETURN_NOT_OK_PREPEND(AddBlock({ Slice(bloom_filter_str) }, &bloom_filter_ptr,
+                                   "bloom filter block"),
+                          "Couldn't write bloom filter");
+    bloom_filter_ptr.CopyToPB(footer.mutable_bloom_filter_ptr());
+  }
+
   // Optionally append extra information to the end of cfile.
   // Example: dictionary block for dictionary encoding
   RETURN_NOT_OK(data_block_->AppendExtraInfo(this, &footer));
@@ -305,6 +378,12 @@ Status CFileWriter::AppendEntries(const void *entries, size_t count) {
   while (rem > 0) {
     int n = data_block_->Add(ptr, rem);
     DCHECK_GE(n, 0);
+    if (zone_map_builder_) {
+      zone_map_builder_->AddValues(ptr, n);
+    }
+    if (bloom_filter_builder_) {
+      bloom_filter_builder_->AddValues(ptr, n);
+    }
 
     ptr += typeinfo_->size() * n;
     rem -= n;
@@ -335,6 +414,12 @@ Status CFileWriter::AppendNullableEntries(const uint8_t *bitmap,
       do {
         int n = data_block_->Add(ptr, rem);
         DCHECK_GE(n, 0);
+        if (zone_map_builder_) {
+          zone_map_builder_->AddValues(ptr, n);
+        }
+        if (bloom_filter_builder_) {
+          bloom_filter_builder_->AddValues(ptr, n);
+        }
 
         non_null_bitmap_builder_->AddRun(true, n);
         ptr += n * typeinfo_->size();
@@ -348,6 +433,9 @@ Status CFileWriter::AppendNullableEntries(const uint8_t *bitmap,
       } while (rem > 0);
     } else {
       non_null_bitmap_builder_->AddRun(false, nitems);
+      if (zone_map_builder_) {
+        zone_map_builder_->AddNulls(nitems);
+      }
       ptr += nitems * typeinfo_->size();
       value_count_ += nitems;
     }
@@ -370,6 +458,10 @@ Status CFileWriter::FinishCurDataBlock() {
   VLOG(1) << "Appending data block for values " <<
     first_elem_ord << "-" << value_count_;
 
+  if (zone_map_builder_) {
+    zone_map_builder_->FinishBlock(first_elem_ord);
+  }
+
   // The current data block is full, need to push it
   // into the file, and add to index
   vector<Slice> data_slices;
@@ -394,10 +486,31 @@ Status CFileWriter::FinishCurDataBlock() {
     v.push_back(non_null_bitmap);
   }
   std::move(data_slices.begin(), data_slices.end(), std::back_inserter(v));
-  Status s = AppendRawBlock(v, first_elem_ord,
-                            reinterpret_cast<const void *>(key_tmp_space),
-                            Slice(last_key_),
-                            "data block");
+  Status s;
+  if (sampling_for_dictionary_) {
+    // Hold on to the block until the dictionary it'll be compressed with is
+    // trained. The block builder is reused, so the block and its index key
+    // must be copied out of it.
+    PendingDataBlock block;
+    for (const Slice& slice : v) {
+      block.data.append(slice.data(), slice.size());
+    }
+    block.first_ordinal = first_elem_ord;
+    if (validx_builder_ != nullptr) {
+      EncodeValidxKey(key_tmp_space, Slice(last_key_), &block.validx_key);
+    }
+    pending_blocks_size_ += block.data.size();
+    pending_blocks_.emplace_back(std::move(block));
+    if (pending_blocks_size_ >=
+        static_cast<size_t>(FLAGS_cfile_compression_dictionary_sample_size)) {
+      s = FinishDictionarySampling();
+    }
+  } else {
+    s = AppendRawBlock(v, first_elem_ord,
+                       reinterpret_cast<const void *>(key_tmp_space),
+                       Slice(last_key_),
+                       "data block");
+  }
 
   if (is_nullable_) {
     non_null_bitmap_builder_->Reset();
@@ -419,6 +532,9 @@ Status CFileWriter::AppendRawBlock(const vector<Slice>& data_slices,
                                    const char *name_for_log) {
   CHECK_EQ(state_, kWriterWriting);
 
+  // Any buffered data blocks precede this one in the file.
+  RETURN_NOT_OK(FinishDictionarySampling());
+
   BlockPointer ptr;
   Status s = AddBlock(data_slices, &ptr, name_for_log);
   if (!s.ok()) {
@@ -426,7 +542,26 @@ Status CFileWriter::AppendRawBlock(const vector<Slice>& data_slices,
     return s;
   }
 
-  // Now add to the index blocks
+  faststring validx_key;
+  if (validx_builder_ != nullptr) {
+    CHECK(validx_curr != nullptr) <<
+      "must pass a key for raw block if validx is configured";
+    EncodeValidxKey(validx_curr, validx_prev, &validx_key);
+  }
+  return AppendIndexEntries(ptr, ordinal_pos, Slice(validx_key));
+}
+
+void CFileWriter::EncodeValidxKey(const void* key, const Slice& prev, faststring* buf) const {
+  (*options_.validx_key_encoder)(key, buf);
+  if (options_.optimize_index_keys) {
+    Slice idx_key(*buf);
+    GetSeparatingKey(prev, &idx_key);
+    buf->resize(idx_key.size());
+  }
+}
+
+Status CFileWriter::AppendIndexEntries(const BlockPointer& ptr, rowid_t ordinal_pos,
+                                       const Slice& validx_key) {
   if (posidx_builder_ != nullptr) {
     tmp_buf_.clear();
     KeyEncoderTraits<UINT32, faststring>::Encode(ordinal_pos, &tmp_buf_);
@@ -434,24 +569,66 @@ Status CFileWriter::AppendRawBlock(const vector<Slice>& data_slices,
   }
 
   if (validx_builder_ != nullptr) {
-    CHECK(validx_curr != nullptr) <<
-      "must pass a key for raw block if validx is configured";
-
-    (*options_.validx_key_encoder)(validx_curr, &tmp_buf_);
-    Slice idx_key = Slice(tmp_buf_);
-    if (options_.optimize_index_keys) {
-      GetSeparatingKey(validx_prev, &idx_key);
-    }
     VLOG(1) << "Appending validx entry\n" <<
-            kudu::HexDump(idx_key);
-    s = validx_builder_->Append(idx_key, ptr);
+            kudu::HexDump(validx_key);
+    Status s = validx_builder_->Append(validx_key, ptr);
     if (!s.ok()) {
       LOG(WARNING) << "Unable to append to value index: " << s.ToString();
       return s;
     }
   }
 
-  return s;
+  return Status::OK();
+}
+
+Status CFileWriter::FinishDictionarySampling() {
+  if (!sampling_for_dictionary_) {
+    return Status::OK();
+  }
+  sampling_for_dictionary_ = false;
+
+  // Leave room for the dictionary to pay for itself across the blocks.
+  size_t max_dict_size = std::min<size_t>(FLAGS_cfile_compression_dictionary_size,
+                                          pending_blocks_size_ / 8);
+  if (max_dict_size >= kMinDictionarySize) {
+    vector<Slice> samples;
+    for (const auto& block : pending_blocks_) {
+      for (size_t off = 0; off < block.data.size(); off += kDictionarySampleChunkSize) {
+        samples.emplace_back(block.data.data() + off,
+                             std::min(kDictionarySampleChunkSize, block.data.size() - off));
+      }
+    }
+    const CompressionCodec* codec;
+    RETURN_NOT_OK(GetCompressionCodec(compression_, &codec));
+    string dictionary;
+    Status s = codec->TrainDictionary(samples, max_dict_size, &dictionary);
+    if (s.ok()) {
+      s = codec->CreateDictionaryCodec(Slice(dictionary), &dictionary_codec_);
+    }
+    if (s.ok()) {
+      compression_dictionary_ = std::move(dictionary);
+      block_compressor_.reset(new CompressedBlockBuilder(dictionary_codec_.get()));
+    } else {
+      // Training fails when the samples are too few or too uniform, which
+      // isn't worth more than a note: the blocks are compressed as usual.
+      VLOG(1) << "Not using a compression dictionary for " << ToString()
+              << ": " << s.ToString();
+    }
+  }
+
+  vector<PendingDataBlock> blocks;
+  blocks.swap(pending_blocks_);
+  pending_blocks_size_ = 0;
+  for (const auto& block : blocks) {
+    BlockPointer ptr;
+    Status s = AddBlock({ Slice(block.data) }, &ptr, "data block");
+    if (!s.ok()) {
+      LOG(WARNING) << "Unable to append block to file: " << s.ToString();
+      return s;
+    }
+    RETURN_NOT_OK(AppendIndexEntries(ptr, block.first_ordinal, Slice(block.validx_key)));
+  }
+  return Status::OK();
 }
 
 Status CFileWriter::AddBlock(const vector<Slice> &data_slices,
@@ -37,16 +37,19 @@
 
 namespace kudu {
 
+class CompressionCodec;
 class TypeInfo;
 
 namespace cfile {
 
 class BlockBuilder;
 class BlockPointer;
+class ColumnBloomFilterBuilder;
 class CompressedBlockBuilder;
 class FileMetadataPairPB;
 class IndexTreeBuilder;
 class TypeEncodingInfo;
+class ZoneMapBuilder;
 
 // Magic used in header/footer
 extern const char kMagicStringV1[];
@@ -154,7 +157,7 @@ class CFileWriter {
     // This is a low estimate, but that's OK -- this is checked after every block
     // write during flush/compact, so better to give a fast slightly-inaccurate result
     // than spend a lot of effort trying to improve accuracy by a few KB.
-    return off_;
+    return off_ + pending_blocks_size_;
   }
 
   // Return the number of values written to the file.
@@ -191,6 +194,22 @@ class CFileWriter {
 
   Status FinishCurDataBlock();
 
+  // Encode the value index key of a block whose first key is 'key' into
+  // 'buf', given 'prev', the encoded last key of the previous block.
+  void EncodeValidxKey(const void* key, const Slice& prev, faststring* buf) const;
+
+  // Add the entries for the block at 'ptr' to the positional and value
+  // indexes. 'validx_key' is ignored if there is no value index.
+  Status AppendIndexEntries(const BlockPointer& ptr, rowid_t ordinal_pos,
+                            const Slice& validx_key);
+
+  // Train a compression dictionary from the data blocks buffered so far,
+  // switch to compressing with it, and write out the buffered blocks.
+  //
+  // If no dictionary can be trained, the blocks are compressed without one.
+  // Does nothing if the writer isn't sampling blocks for a dictionary.
+  Status FinishDictionarySampling();
+
   // Flush the current unflushed_metadata_ entries into the given protobuf
   // field, clearing the buffer.
   void FlushMetadataToPB(google::protobuf::RepeatedPtrField<FileMetadataPairPB> *field);
@@ -227,6 +246,27 @@ class CFileWriter {
   std::unique_ptr<IndexTreeBuilder> validx_builder_;
   std::unique_ptr<NullBitmapBuilder> non_null_bitmap_builder_;
   std::unique_ptr<CompressedBlockBuilder> block_compressor_;
+  std::unique_ptr<ZoneMapBuilder> zone_map_builder_;
+  std::unique_ptr<ColumnBloomFilterBuilder> bloom_filter_builder_;
+
+  // A data block which has been encoded but not yet compressed and written,
+  // because it may be used to train the compression dictionary.
+  struct PendingDataBlock {
+    faststring data;
+    rowid_t first_ordinal;
+    faststring validx_key;
+  };
+
+  // Whether data blocks are being buffered in 'pending_blocks_' to train a
+  // compression dictionary for the file.
+  bool sampling_for_dictionary_;
+  std::vector<PendingDataBlock> pending_blocks_;
+  size_t pending_blocks_size_;
+
+  // The compression dictionary of the file and the codec which compresses
+  // with it, if one has been trained.
+  std::string compression_dictionary_;
+  std::unique_ptr<CompressionCodec> dictionary_codec_;
 
   enum State {
     kWriterInitialized,
@@ -0,0 +1,168 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/cfile/column_bloom_filter.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "kudu/common/column_predicate.h"
+#include "kudu/common/common.pb.h"
+#include "kudu/common/schema.h"
+#include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/block_bloom_filter.pb.h"
+#include "kudu/util/slice.h"
+#include "kudu/util/test_macros.h"
+#include "kudu/util/test_util.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace kudu {
+namespace cfile {
+
+class ColumnBloomFilterTest : public KuduTest {
+ protected:
+  static void BuildFilter(const ColumnSchema& col,
+                          const void* cells,
+                          size_t count,
+                          unique_ptr<ColumnBloomFilter>* filter) {
+    ColumnBloomFilterBuilder builder(col.type_info(), 0.01);
+    builder.AddValues(cells, count);
+    BlockBloomFilterPB pb;
+    ASSERT_OK(builder.Finish(&pb));
+    ASSERT_OK(ColumnBloomFilter::Create(pb, col.type_info(), filter));
+  }
+};
+
+TEST_F(ColumnBloomFilterTest, TestInt64) {
+  // Many duplicates, so the hashes are deduplicated while they're added.
+  const int kNumValues = 200000;
+  const int kNumDistinct = 1000;
+  ColumnSchema col("c", INT64);
+  vector<int64_t> values;
+  for (int i = 0; i < kNumValues; i++) {
+    values.push_back((i % kNumDistinct) * 2);
+  }
+  unique_ptr<ColumnBloomFilter> filter;
+  NO_FATALS(BuildFilter(col, values.data(), values.size(), &filter));
+
+  int false_positives = 0;
+  for (int64_t i = 0; i < kNumDistinct; i++) {
+    int64_t present = i * 2;
+    ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Equality(col, &present)));
+    int64_t absent = i * 2 + 1;
+    if (filter->MayMatch(ColumnPredicate::Equality(col, &absent))) {
+      false_positives++;
+    }
+  }
+  ASSERT_LT(false_positives, kNumDistinct / 20);
+
+  // An IN-list may match if any of its values may match.
+  int64_t in_values[] = { 1, 3, 5, 10 };
+  vector<const void*> in_list = { &in_values[0], &in_values[1], &in_values[2], &in_values[3] };
+  auto in_list_pred = ColumnPredicate::InList(col, &in_list);
+  ASSERT_EQ(PredicateType::InList, in_list_pred.predicate_type());
+  ASSERT_TRUE(filter->MayMatch(in_list_pred));
+
+  // Range predicates are not about specific values.
+  int64_t lower = 1;
+  int64_t upper = 2;
+  ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Range(col, &lower, &upper)));
+}
+
+TEST_F(ColumnBloomFilterTest, TestBinary) {
+  ColumnSchema col("c", STRING);
+  vector<string> strs;
+  for (int i = 0; i < 100; i++) {
+    strs.push_back(strings::Substitute("trace-$0", i));
+  }
+  vector<Slice> values(strs.begin(), strs.end());
+  unique_ptr<ColumnBloomFilter> filter;
+  NO_FATALS(BuildFilter(col, values.data(), values.size(), &filter));
+
+  for (const auto& value : values) {
+    ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Equality(col, &value)));
+  }
+  int false_positives = 0;
+  for (int i = 100; i < 1100; i++) {
+    string str = strings::Substitute("trace-$0", i);
+    Slice value(str);
+    if (filter->MayMatch(ColumnPredicate::Equality(col, &value))) {
+      false_positives++;
+    }
+  }
+  ASSERT_LT(false_positives, 50);
+}
+
+// Floating point values which compare equal must match, whatever their bits.
+TEST_F(ColumnBloomFilterTest, TestFloatingPoint) {
+  ColumnSchema col("c", DOUBLE);
+  vector<double> values = { 0.0, 1.5 };
+  unique_ptr<ColumnBloomFilter> filter;
+  NO_FATALS(BuildFilter(col, values.data(), values.size(), &filter));
+  double negative_zero = -0.0;
+  ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Equality(col, &negative_zero)));
+  // NaN compares equal to every value.
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Equality(col, &nan)));
+
+  ColumnSchema float_col("f", FLOAT);
+  vector<float> float_values = { -0.0F };
+  NO_FATALS(BuildFilter(float_col, float_values.data(), float_values.size(), &filter));
+  float zero = 0.0F;
+  ASSERT_TRUE(filter->MayMatch(ColumnPredicate::Equality(float_col, &zero)));
+
+  // A file containing a NaN may match every value, so it can't have a filter.
+  ColumnBloomFilterBuilder builder(col.type_info(), 0.01);
+  builder.AddValues(values.data(), values.size());
+  ASSERT_FALSE(builder.has_nan());
+  builder.AddValues(&nan, 1);
+  ASSERT_TRUE(builder.has_nan());
+}
+
+// A file of only NULLs has an empty filter, which matches no value.
+TEST_F(ColumnBloomFilterTest, TestEmpty) {
+  ColumnSchema col("c", INT32, /*is_nullable=*/true);
+  unique_ptr<ColumnBloomFilter> filter;
+  NO_FATALS(BuildFilter(col, nullptr, 0, &filter));
+  int32_t value = 0;
+  ASSERT_FALSE(filter->MayMatch(ColumnPredicate::Equality(col, &value)));
+  ASSERT_TRUE(filter->MayMatch(ColumnPredicate::IsNull(col)));
+}
+
+TEST_F(ColumnBloomFilterTest, TestCorruptFilter) {
+  ColumnSchema col("c", INT32);
+  unique_ptr<ColumnBloomFilter> filter;
+  BlockBloomFilterPB pb;
+  ASSERT_TRUE(ColumnBloomFilter::Create(pb, col.type_info(), &filter).IsCorruption());
+
+  // The filter data must be as large as its claimed size.
+  pb.set_log_space_bytes(20);
+  pb.set_bloom_data(string(64, '\0'));
+  pb.set_always_false(false);
+  ASSERT_TRUE(ColumnBloomFilter::Create(pb, col.type_info(), &filter).IsCorruption());
+}
+
+} // namespace cfile
+} // namespace kudu
@@ -0,0 +1,206 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/cfile/column_bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <glog/logging.h>
+
+#include "kudu/common/column_predicate.h"
+#include "kudu/common/common.pb.h"
+#include "kudu/common/types.h"
+#include "kudu/gutil/port.h"
+#include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/block_bloom_filter.pb.h"
+#include "kudu/util/hash.pb.h"
+#include "kudu/util/hash_util.h"
+#include "kudu/util/malloc.h"
+#include "kudu/util/slice.h"
+
+using std::unique_ptr;
+using strings::Substitute;
+
+namespace kudu {
+namespace cfile {
+
+namespace {
+
+// Values are hashed the same way BlockBloomFilter::Find(const Slice&) hashes
+// its keys.
+const HashAlgorithm kHashAlgorithm = FAST_HASH;
+const uint32_t kHashSeed = 0;
+
+// The minimum number of hashes accumulated before they're first deduplicated.
+const size_t kMinDedupThreshold = 64 * 1024;
+
+// Returns true if 'cell' of type 'type_info' is a floating point NaN.
+bool IsNaN(const TypeInfo* type_info, const void* cell) {
+  switch (type_info->physical_type()) {
+    case FLOAT:
+      return std::isnan(UnalignedLoad<float>(cell));
+    case DOUBLE:
+      return std::isnan(UnalignedLoad<double>(cell));
+    default:
+      return false;
+  }
+}
+
+// Returns the floating point cell 'cell' with -0.0 folded into +0.0: values
+// which compare equal must hash the same.
+template<typename T>
+T CanonicalZero(const void* cell) {
+  T value = UnalignedLoad<T>(cell);
+  return value == 0 ? 0 : value;
+}
+
+// Returns the bytes of the cell 'cell' of type 'type_info' that are hashed
+// into the filter. Floating point cells are canonicalized into 'scratch', and
+// must not be NaN.
+Slice CellSlice(const TypeInfo* type_info, const void* cell, uint8_t* scratch) {
+  switch (type_info->physical_type()) {
+    case BINARY:
+      return *reinterpret_cast<const Slice*>(cell);
+    case FLOAT: {
+      float value = CanonicalZero<float>(cell);
+      memcpy(scratch, &value, sizeof(value));
+      return Slice(scratch, sizeof(value));
+    }
+    case DOUBLE: {
+      double value = CanonicalZero<double>(cell);
+      memcpy(scratch, &value, sizeof(value));
+      return Slice(scratch, sizeof(value));
+    }
+    default:
+      return Slice(reinterpret_cast<const uint8_t*>(cell), type_info->size());
+  }
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////
+// ColumnBloomFilterBuilder
+////////////////////////////////////////////////////////////
+
+ColumnBloomFilterBuilder::ColumnBloomFilterBuilder(const TypeInfo* type_info, double fp_rate)
+    : type_info_(type_info),
+      fp_rate_(fp_rate),
+      dedup_threshold_(kMinDedupThreshold),
+      has_nan_(false) {
+}
+
+void ColumnBloomFilterBuilder::AddValues(const void* cells, size_t count) {
+  const uint8_t* cell = reinterpret_cast<const uint8_t*>(cells);
+  uint8_t scratch[sizeof(double)];
+  for (size_t i = 0; i < count; i++, cell += type_info_->size()) {
+    if (PREDICT_FALSE(IsNaN(type_info_, cell))) {
+      has_nan_ = true;
+      continue;
+    }
+    hashes_.push_back(HashUtil::ComputeHash32(CellSlice(type_info_, cell, scratch),
+                                              kHashAlgorithm, kHashSeed));
+  }
+  if (hashes_.size() >= dedup_threshold_) {
+    DedupHashes();
+    // Don't deduplicate again until the number of hashes doubles, so that
+    // high-cardinality columns are sorted a logarithmic number of times.
+    dedup_threshold_ = std::max(kMinDedupThreshold, hashes_.size() * 2);
+  }
+}
+
+void ColumnBloomFilterBuilder::DedupHashes() {
+  std::sort(hashes_.begin(), hashes_.end());
+  hashes_.erase(std::unique(hashes_.begin(), hashes_.end()), hashes_.end());
+}
+
+Status ColumnBloomFilterBuilder::Finish(BlockBloomFilterPB* pb) {
+  DedupHashes();
+  BlockBloomFilter filter(DefaultBlockBloomFilterBufferAllocator::GetSingleton());
+  RETURN_NOT_OK(filter.Init(BlockBloomFilter::MinLogSpace(hashes_.size(), fp_rate_),
+                            kHashAlgorithm, kHashSeed));
+  for (uint32_t hash : hashes_) {
+    filter.Insert(hash);
+  }
+  filter.CopyToPB(pb);
+  hashes_.clear();
+  hashes_.shrink_to_fit();
+  return Status::OK();
+}
+
+////////////////////////////////////////////////////////////
+// ColumnBloomFilter
+////////////////////////////////////////////////////////////
+
+ColumnBloomFilter::ColumnBloomFilter(const TypeInfo* type_info)
+    : type_info_(type_info),
+      filter_(DefaultBlockBloomFilterBufferAllocator::GetSingleton()) {
+}
+
+Status ColumnBloomFilter::Create(const BlockBloomFilterPB& pb,
+                                 const TypeInfo* type_info,
+                                 unique_ptr<ColumnBloomFilter>* filter) {
+  // Check the size before initializing the filter, which allocates its
+  // directory according to 'log_space_bytes'.
+  if (PREDICT_FALSE(pb.log_space_bytes() < 0 || pb.log_space_bytes() > 32 ||
+                    pb.bloom_data().size() < (1ULL << pb.log_space_bytes()))) {
+    return Status::Corruption(Substitute("bloom filter of $0 bytes has invalid log space $1",
+                                         pb.bloom_data().size(), pb.log_space_bytes()));
+  }
+  unique_ptr<ColumnBloomFilter> ret(new ColumnBloomFilter(type_info));
+  Status s = ret->filter_.InitFromPB(pb);
+  if (PREDICT_FALSE(!s.ok())) {
+    return Status::Corruption("invalid bloom filter", s.message());
+  }
+  *filter = std::move(ret);
+  return Status::OK();
+}
+
+bool ColumnBloomFilter::ValueMayMatch(const void* value) const {
+  // NaN compares equal to every value, so it may match any file with values.
+  // Files containing a NaN have no filter at all.
+  if (PREDICT_FALSE(IsNaN(type_info_, value))) {
+    return !filter_.always_false();
+  }
+  uint8_t scratch[sizeof(double)];
+  return filter_.Find(CellSlice(type_info_, value, scratch));
+}
+
+bool ColumnBloomFilter::MayMatch(const ColumnPredicate& pred) const {
+  DCHECK_EQ(type_info_->physical_type(), pred.column().type_info()->physical_type());
+  switch (pred.predicate_type()) {
+    case PredicateType::Equality:
+      return ValueMayMatch(pred.raw_lower());
+    case PredicateType::InList:
+      return std::any_of(pred.raw_values().begin(), pred.raw_values().end(),
+                         [this](const void* value) { return ValueMayMatch(value); });
+    default:
+      // Bloom filter predicates can't be checked against another bloom filter
+      // of a different size, and the other predicate types aren't about
+      // specific values.
+      return true;
+  }
+}
+
+size_t ColumnBloomFilter::memory_footprint() const {
+  return kudu_malloc_usable_size(this) + filter_.GetSpaceUsed();
+}
+
+} // namespace cfile
+} // namespace kudu
@@ -0,0 +1,114 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "kudu/gutil/macros.h"
+#include "kudu/util/block_bloom_filter.h"
+#include "kudu/util/status.h"
+
+namespace kudu {
+
+class BlockBloomFilterPB;
+class ColumnPredicate;
+class TypeInfo;
+
+namespace cfile {
+
+// A column bloom filter is a BlockBloomFilter of the distinct non-NULL values
+// of a cfile. Unlike the key bloom filters of a DiskRowSet, it is not indexed
+// by key: it summarizes the whole file, and is used by readers to skip files
+// which can't contain any of the values of an equality or IN-list predicate.
+
+// Accumulates the column bloom filter of a cfile as its values are written.
+//
+// The filter is sized once the number of distinct values is known, so the
+// builder keeps a 32-bit hash of every distinct value until Finish().
+//
+// This class is not thread-safe.
+class ColumnBloomFilterBuilder {
+ public:
+  // 'fp_rate' is the target false positive rate of the filter.
+  ColumnBloomFilterBuilder(const TypeInfo* type_info, double fp_rate);
+
+  // Adds 'count' non-NULL cells, laid out contiguously starting at 'cells'.
+  void AddValues(const void* cells, size_t count);
+
+  // Returns true if a floating point NaN was added. NaN compares equal to every
+  // value, so a cfile containing one must be written without a filter.
+  bool has_nan() const {
+    return has_nan_;
+  }
+
+  // Builds the filter of all the values added so far into 'pb'.
+  Status Finish(BlockBloomFilterPB* pb);
+
+ private:
+  // Sorts and deduplicates 'hashes_'.
+  void DedupHashes();
+
+  const TypeInfo* const type_info_;
+  const double fp_rate_;
+
+  std::vector<uint32_t> hashes_;
+
+  // The size 'hashes_' may grow to before it is next deduplicated.
+  size_t dedup_threshold_;
+
+  bool has_nan_;
+
+  DISALLOW_COPY_AND_ASSIGN(ColumnBloomFilterBuilder);
+};
+
+// The column bloom filter of a cfile, as read back from disk.
+//
+// This class is immutable and thread-safe once created.
+class ColumnBloomFilter {
+ public:
+  // Decodes 'pb', the bloom filter of a cfile of values of type 'type_info'.
+  // Returns Corruption if 'pb' is malformed.
+  static Status Create(const BlockBloomFilterPB& pb,
+                       const TypeInfo* type_info,
+                       std::unique_ptr<ColumnBloomFilter>* filter);
+
+  // Returns false if no value of the cfile can satisfy 'pred', and true if
+  // some might. Only equality and IN-list predicates are ever rejected.
+  //
+  // 'pred' must be over a column of the same type as the cfile.
+  bool MayMatch(const ColumnPredicate& pred) const;
+
+  // Returns the memory usage of this object including the object itself.
+  size_t memory_footprint() const;
+
+ private:
+  explicit ColumnBloomFilter(const TypeInfo* type_info);
+
+  // Returns false if the cfile doesn't contain the cell 'value'.
+  bool ValueMayMatch(const void* value) const;
+
+  const TypeInfo* const type_info_;
+  BlockBloomFilter filter_;
+
+  DISALLOW_COPY_AND_ASSIGN(ColumnBloomFilter);
+};
+
+} // namespace cfile
+} // namespace kudu
@@ -39,8 +39,11 @@
 #include "kudu/cfile/block_encodings.h"
 #include "kudu/cfile/cfile_util.h"
 #include "kudu/cfile/type_encodings.h"
+#include "kudu/common/column_materialization_context.h"
+#include "kudu/common/column_predicate.h"
 #include "kudu/common/columnblock.h"
 #include "kudu/common/common.pb.h"
+#include "kudu/common/rowblock.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/types.h"
 #include "kudu/gutil/port.h"
@@ -699,6 +702,82 @@ class TestEncoding : public KuduTest {
     }
   }
 
+  // Encode 'values' and decode them again with CopyNextAndEval() in batches
+  // of random sizes, checking that exactly the rows matching 'pred' remain
+  // selected and that their values are copied out.
+  template <DataType Type>
+  void TestCopyNextAndEval(EncodingType encoding,
+                           const typename TypeTraits<Type>::cpp_type* values,
+                           size_t count,
+                           const ColumnPredicate& pred) {
+    typedef typename TypeTraits<Type>::cpp_type CppType;
+    SCOPED_TRACE(pred.ToString());
+    auto bb = CreateBlockBuilderOrDie(Type, encoding);
+    size_t added = 0;
+    while (added < count) {
+      int n = bb->Add(reinterpret_cast<const uint8_t*>(values + added), count - added);
+      ASSERT_GT(n, 0);
+      added += n;
+    }
+    Slice s = FinishAndMakeContiguous(bb.get(), 0);
+    auto bd = CreateBlockDecoderOrDie(Type, encoding, s);
+    ASSERT_OK(bd->ParseHeader());
+
+    unique_ptr<CppType[]> decoded(new CppType[count]);
+    ColumnBlock cb(GetTypeInfo(Type), nullptr, decoded.get(), count, &arena_);
+    SelectionVector sel(count);
+    sel.SetAllTrue();
+    ColumnMaterializationContext ctx(0, &pred, &cb, &sel);
+    ColumnDataView dst(&cb);
+    SelectionVectorView sel_view(&sel);
+    Random rand(SeedRandom());
+    size_t decoded_count = 0;
+    while (bd->HasNext()) {
+      size_t n = std::min<size_t>(count - decoded_count, rand.Uniform(100) + 1);
+      ASSERT_OK(bd->CopyNextAndEval(&n, &ctx, &sel_view, &dst));
+      ASSERT_GT(n, 0);
+      decoded_count += n;
+      dst.Advance(n);
+      sel_view.Advance(n);
+    }
+    ASSERT_EQ(count, decoded_count);
+    if (ctx.DecoderEvalNotSupported()) {
+      pred.Evaluate(cb, &sel);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      bool matches = pred.EvaluateCell<Type>(&values[i]);
+      ASSERT_EQ(matches, sel.IsRowSelected(i)) << "row " << i;
+      if (matches) {
+        ASSERT_EQ(values[i], decoded[i]) << "row " << i;
+      }
+    }
+  }
+
+  // Test CopyNextAndEval() with a range of predicates over a column of few
+  // distinct values, stored in runs.
+  template <DataType IntType>
+  void TestIntCopyNextAndEval(EncodingType encoding) {
+    typedef typename TypeTraits<IntType>::cpp_type CppType;
+    vector<CppType> values;
+    for (int i = 0; i < 10000; i++) {
+      values.push_back(static_cast<CppType>(i / 7 % 5));
+    }
+    ColumnSchema col("c", IntType);
+    const CppType one = 1;
+    const CppType three = 3;
+    const CppType absent = 100;
+    NO_FATALS(TestCopyNextAndEval<IntType>(encoding, values.data(), values.size(),
+                                           ColumnPredicate::Range(col, &one, &three)));
+    NO_FATALS(TestCopyNextAndEval<IntType>(encoding, values.data(), values.size(),
+                                           ColumnPredicate::Equality(col, &three)));
+    NO_FATALS(TestCopyNextAndEval<IntType>(encoding, values.data(), values.size(),
+                                           ColumnPredicate::Equality(col, &absent)));
+    vector<const void*> in_list = { &one, &absent };
+    NO_FATALS(TestCopyNextAndEval<IntType>(encoding, values.data(), values.size(),
+                                           ColumnPredicate::InList(col, &in_list)));
+  }
+
   Arena arena_;
   faststring contiguous_buf_;
   WriterOptions default_write_options_;
@@ -808,6 +887,22 @@ TEST_F(TestEncoding, TestRleBitMapRoundTrip) {
   TestBoolBlockRoundTrip(RLE);
 }
 
+TEST_F(TestEncoding, TestRleBitMapCopyNextAndEval) {
+  const int kNumValues = 10000;
+  unique_ptr<bool[]> values(new bool[kNumValues]);
+  for (int i = 0; i < kNumValues; i++) {
+    values[i] = i / 13 % 3 == 0;
+  }
+  ColumnSchema col("c", BOOL);
+  const bool kTrue = true;
+  NO_FATALS(TestCopyNextAndEval<BOOL>(RLE, values.get(), kNumValues,
+                                      ColumnPredicate::Equality(col, &kTrue)));
+  // The decoders only see the non-NULL cells of nullable columns.
+  ColumnSchema nullable_col("c", BOOL, /*is_nullable=*/true);
+  NO_FATALS(TestCopyNextAndEval<BOOL>(RLE, values.get(), kNumValues,
+                                      ColumnPredicate::IsNull(nullable_col)));
+}
+
 // Test seeking to a value in a small block.
 // Regression test for a bug seen in development where this would
 // infinite loop when there are no 'restarts' in a given block.
@@ -917,6 +1012,15 @@ TEST_P(IntEncodingTest, TestRoundTrip) {
   // this->template DoIntRoundTripTest<INT128>();
 }
 
+TEST_P(IntEncodingTest, TestCopyNextAndEval) {
+  this->template TestIntCopyNextAndEval<INT8>(GetParam());
+  this->template TestIntCopyNextAndEval<UINT16>(GetParam());
+  this->template TestIntCopyNextAndEval<INT32>(GetParam());
+  // Bitshuffle stores small UINT32 values narrower than 32 bits.
+  this->template TestIntCopyNextAndEval<UINT32>(GetParam());
+  this->template TestIntCopyNextAndEval<INT64>(GetParam());
+}
+
 #ifdef NDEBUG
 TEST_P(IntEncodingTest, IntSeekBenchmark) {
   this->template DoIntSeekTest<INT32>(32768, 10000, false);
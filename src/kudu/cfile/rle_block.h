@@ -43,6 +43,45 @@ enum {
   kRleBitmapBlockHeaderSize = 8
 };
 
+// Copies the next 'n' values from 'decoder' to 'dst', evaluating the
+// predicate of 'ctx' once per run of equal values rather than once per cell.
+// The rows of runs which don't match are cleared in 'sel' and their cells are
+// left unset.
+//
+// The result for the last value evaluated is remembered, so columns with few
+// distinct values are evaluated about once per value rather than once per run.
+template <DataType Type>
+void CopyRunsAndEval(size_t n,
+                     RleDecoder<typename TypeTraits<Type>::cpp_type>* decoder,
+                     ColumnMaterializationContext* ctx,
+                     SelectionVectorView* sel,
+                     uint8_t* dst) {
+  typedef typename TypeTraits<Type>::cpp_type CppType;
+  CppType* out = reinterpret_cast<CppType*>(dst);
+  bool evaluated = false;
+  CppType last_val = CppType();
+  bool last_matched = false;
+  size_t row_offset = 0;
+  while (row_offset < n) {
+    CppType val = CppType();
+    const size_t num_read = decoder->GetNextRun(&val, n - row_offset);
+    DCHECK_GT(num_read, 0);
+    DCHECK_LE(num_read, n - row_offset);
+    if (!evaluated || val != last_val) {
+      last_matched = ctx->pred()->EvaluateCell<Type>(static_cast<const void*>(&val));
+      last_val = val;
+      evaluated = true;
+    }
+    if (last_matched) {
+      std::fill(out + row_offset, out + row_offset + num_read, val);
+    } else {
+      // Mark that the rows will not be returned.
+      sel->ClearBits(num_read, row_offset);
+    }
+    row_offset += num_read;
+  }
+}
+
 //
 // RLE encoder for the BOOL datatype: uses an RLE-encoded bitmap to
 // represent a bool column.
@@ -193,6 +232,28 @@ class RleBitMapBlockDecoder final : public BlockDecoder {
     return Status::OK();
   }
 
+  Status CopyNextAndEval(size_t* n,
+                         ColumnMaterializationContext* ctx,
+                         SelectionVectorView* sel,
+                         ColumnDataView* dst) override {
+    DCHECK(parsed_);
+
+    DCHECK_LE(*n, dst->nrows());
+    DCHECK_EQ(dst->stride(), sizeof(bool));
+
+    ctx->SetDecoderEvalSupported();
+    if (PREDICT_FALSE(*n == 0 || cur_idx_ >= num_elems_)) {
+      *n = 0;
+      return Status::OK();
+    }
+
+    const size_t bits_to_fetch = std::min(*n, static_cast<size_t>(num_elems_ - cur_idx_));
+    CopyRunsAndEval<BOOL>(bits_to_fetch, &rle_decoder_, ctx, sel, dst->data());
+    cur_idx_ += bits_to_fetch;
+    *n = bits_to_fetch;
+    return Status::OK();
+  }
+
   virtual Status SeekAtOrAfterValue(const void *value,
                                     bool *exact_match) OVERRIDE {
     return Status::NotSupported("BOOL keys are not supported!");
@@ -440,33 +501,7 @@ class RleIntBlockDecoder final : public BlockDecoder {
     }
 
     const size_t to_fetch = std::min(*n, static_cast<size_t>(num_elems_ - cur_idx_));
-    size_t remaining = to_fetch;
-    uint8_t* data_ptr = dst->data();
-    size_t row_offset = 0;
-    while (remaining > 0) {
-      CppType val = 0;
-      const size_t num_read = rle_decoder_.GetNextRun(&val, remaining);
-      DCHECK(num_read > 0);
-      DCHECK_LE(num_read, remaining);
-      if (ctx->pred()->EvaluateCell<IntType>(static_cast<const void*>(&val))) {
-        // Copy data for matching predicate
-        for (size_t row_idx = row_offset; row_idx < row_offset + num_read;
-             ++row_idx, data_ptr += kCppTypeSize) {
-          // Skip copying if the row has already been cleared.
-          if (!sel->TestBit(row_idx)) {
-            continue;
-          }
-          *(reinterpret_cast<CppType *>(data_ptr)) = val;
-        }
-      } else {
-        // Mark that the rows will not be returned.
-        sel->ClearBits(num_read, row_offset);
-        data_ptr += num_read * kCppTypeSize;
-      }
-      remaining -= num_read;
-      row_offset += num_read;
-    }
-
+    CopyRunsAndEval<IntType>(to_fetch, &rle_decoder_, ctx, sel, dst->data());
     cur_idx_ += to_fetch;
     *n = to_fetch;
 
@@ -0,0 +1,175 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/cfile/zone_map.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "kudu/cfile/cfile.pb.h"
+#include "kudu/common/column_predicate.h"
+#include "kudu/common/common.pb.h"
+#include "kudu/common/schema.h"
+#include "kudu/common/types.h"
+#include "kudu/util/slice.h"
+#include "kudu/util/test_macros.h"
+#include "kudu/util/test_util.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace kudu {
+namespace cfile {
+
+class ZoneMapTest : public KuduTest {
+ protected:
+  // Builds the zone map of a cfile with one block per entry of 'blocks',
+  // where a null entry of a block is a NULL value.
+  template<typename T>
+  static void BuildZoneMap(const ColumnSchema& col,
+                           const vector<vector<const T*>>& blocks,
+                           unique_ptr<ZoneMap>* zone_map) {
+    ZoneMapBuilder builder(col.type_info());
+    rowid_t ordinal = 0;
+    for (const auto& block : blocks) {
+      for (const T* value : block) {
+        if (value) {
+          builder.AddValues(value, 1);
+        } else {
+          builder.AddNulls(1);
+        }
+      }
+      builder.FinishBlock(ordinal);
+      ordinal += block.size();
+    }
+    ZoneMapPB pb;
+    builder.Finish(&pb);
+    ASSERT_EQ(blocks.size(), pb.entries_size());
+    ASSERT_OK(ZoneMap::Create(pb, col.type_info(), ordinal, zone_map));
+  }
+};
+
+TEST_F(ZoneMapTest, TestInt32) {
+  ColumnSchema col("c", INT32, /*is_nullable=*/true);
+  const int32_t v[] = { 0, 10, 20, 30, 40, 50 };
+  // Block 0: [0, 10]; block 1: [20, 30] plus a NULL; block 2: all NULL;
+  // block 3: [40, 50].
+  unique_ptr<ZoneMap> zm;
+  NO_FATALS(BuildZoneMap<int32_t>(col, {
+      { &v[1], &v[0] },
+      { &v[2], nullptr, &v[3] },
+      { nullptr, nullptr },
+      { &v[5], &v[4] } }, &zm));
+  ASSERT_EQ(4, zm->num_blocks());
+
+  int32_t lower = 11;
+  int32_t upper = 20;
+  auto gap = ColumnPredicate::Range(col, &lower, &upper);
+  ASSERT_FALSE(zm->MayMatch(gap, 0, 9));
+  ASSERT_TRUE(zm->MayMatch(gap));
+
+  upper = 21;
+  auto range = ColumnPredicate::Range(col, &lower, &upper);
+  ASSERT_FALSE(zm->MayMatch(range, 0, 2));
+  ASSERT_TRUE(zm->MayMatch(range, 0, 3));
+  ASSERT_TRUE(zm->MayMatch(range, 2, 5));
+  ASSERT_FALSE(zm->MayMatch(range, 5, 9));
+
+  int32_t value = 50;
+  auto eq = ColumnPredicate::Equality(col, &value);
+  ASSERT_TRUE(zm->MayMatch(eq, 8, 9));
+  ASSERT_FALSE(zm->MayMatch(eq, 0, 7));
+  value = 51;
+  auto eq_outside = ColumnPredicate::Equality(col, &value);
+  ASSERT_FALSE(zm->MayMatch(eq_outside));
+
+  const int32_t in_values[] = { -5, 25, 60 };
+  vector<const void*> in_list_values = { &in_values[0], &in_values[1], &in_values[2] };
+  auto in_list = ColumnPredicate::InList(col, &in_list_values);
+  ASSERT_EQ(PredicateType::InList, in_list.predicate_type());
+  ASSERT_TRUE(zm->MayMatch(in_list));
+  ASSERT_FALSE(zm->MayMatch(in_list, 0, 2));
+  ASSERT_TRUE(zm->MayMatch(in_list, 0, 3));
+
+  auto is_null = ColumnPredicate::IsNull(col);
+  ASSERT_FALSE(zm->MayMatch(is_null, 0, 2));
+  ASSERT_TRUE(zm->MayMatch(is_null, 3, 4));
+  auto is_not_null = ColumnPredicate::IsNotNull(col);
+  ASSERT_FALSE(zm->MayMatch(is_not_null, 5, 7));
+  ASSERT_TRUE(zm->MayMatch(is_not_null, 5, 8));
+}
+
+// NaN is unordered, so a block containing it has unknown bounds.
+TEST_F(ZoneMapTest, TestDoubleNaN) {
+  ColumnSchema col("c", DOUBLE);
+  const double v[] = { 1.0, NAN, 2.0 };
+  unique_ptr<ZoneMap> zm;
+  NO_FATALS(BuildZoneMap<double>(col, { { &v[0] }, { &v[0], &v[1], &v[2] } }, &zm));
+
+  double lower = 5.0;
+  auto range = ColumnPredicate::Range(col, &lower, nullptr);
+  ASSERT_FALSE(zm->MayMatch(range, 0, 1));
+  ASSERT_TRUE(zm->MayMatch(range, 1, 4));
+  ASSERT_TRUE(zm->MayMatch(range));
+}
+
+// Long BINARY bounds are truncated or dropped.
+TEST_F(ZoneMapTest, TestBinary) {
+  ColumnSchema col("c", STRING);
+  const string long_str(ZoneMapBuilder::kMaxBinaryBoundLength * 2, 'x');
+  const Slice v[] = { "a", "c", Slice(long_str), "y" };
+  unique_ptr<ZoneMap> zm;
+  NO_FATALS(BuildZoneMap<Slice>(col, { { &v[1], &v[0] }, { &v[2] }, { &v[3] } }, &zm));
+
+  Slice lower("b");
+  Slice upper("x");
+  auto range = ColumnPredicate::Range(col, &lower, &upper);
+  ASSERT_TRUE(zm->MayMatch(range, 0, 2));
+  ASSERT_FALSE(zm->MayMatch(range, 3, 4));
+
+  // The block with the long value has a truncated lower bound and no upper
+  // bound, so it can't be skipped for values above it.
+  Slice value("z");
+  auto eq = ColumnPredicate::Equality(col, &value);
+  ASSERT_FALSE(zm->MayMatch(eq, 0, 2));
+  ASSERT_TRUE(zm->MayMatch(eq, 2, 3));
+  ASSERT_FALSE(zm->MayMatch(eq, 3, 4));
+}
+
+TEST_F(ZoneMapTest, TestCorruptZoneMap) {
+  ColumnSchema col("c", INT32);
+  ZoneMapPB pb;
+  pb.add_entries()->set_first_ordinal(0);
+  pb.add_entries()->set_first_ordinal(0);
+  unique_ptr<ZoneMap> zm;
+  ASSERT_TRUE(ZoneMap::Create(pb, col.type_info(), 10, &zm).IsCorruption());
+
+  pb.Clear();
+  auto* entry = pb.add_entries();
+  entry->set_first_ordinal(0);
+  entry->set_min_value("x");
+  ASSERT_TRUE(ZoneMap::Create(pb, col.type_info(), 10, &zm).IsCorruption());
+}
+
+} // namespace cfile
+} // namespace kudu
@@ -0,0 +1,373 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/cfile/zone_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <glog/logging.h>
+
+#include "kudu/common/column_predicate.h"
+#include "kudu/common/common.pb.h"
+#include "kudu/common/schema.h"
+#include "kudu/common/types.h"
+#include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/int128.h"
+#include "kudu/util/malloc.h"
+#include "kudu/util/slice.h"
+
+using std::string;
+using std::unique_ptr;
+using strings::Substitute;
+
+namespace kudu {
+namespace cfile {
+
+static_assert(sizeof(Slice) <= 16, "a Slice must fit in a zone map bound");
+
+const size_t ZoneMapBuilder::kMaxBinaryBoundLength = 64;
+
+namespace {
+
+template<typename T>
+bool IsNaN(T /*v*/, std::false_type /*is_floating_point*/) {
+  return false;
+}
+
+template<typename T>
+bool IsNaN(T v, std::true_type /*is_floating_point*/) {
+  return std::isnan(v);
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////
+// ZoneMapBuilder
+////////////////////////////////////////////////////////////
+
+ZoneMapBuilder::ZoneMapBuilder(const TypeInfo* type_info)
+    : type_info_(type_info) {
+  ResetBlock();
+}
+
+void ZoneMapBuilder::ResetBlock() {
+  null_count_ = 0;
+  has_bounds_ = false;
+  bounds_unknown_ = false;
+  min_.clear();
+  max_.clear();
+}
+
+template<typename CppType>
+void ZoneMapBuilder::AddFixedValues(const void* cells, size_t count) {
+  const CppType* values = reinterpret_cast<const CppType*>(cells);
+  CppType min;
+  CppType max;
+  if (has_bounds_) {
+    memcpy(&min, min_.data(), sizeof(min));
+    memcpy(&max, max_.data(), sizeof(max));
+  } else {
+    min = max = values[0];
+  }
+  for (size_t i = 0; i < count; i++) {
+    const CppType v = values[i];
+    if (IsNaN(v, std::is_floating_point<CppType>())) {
+      // NaN is unordered, and would poison the bounds.
+      bounds_unknown_ = true;
+      return;
+    }
+    if (v < min) min = v;
+    if (v > max) max = v;
+  }
+  min_.assign(reinterpret_cast<const char*>(&min), sizeof(min));
+  max_.assign(reinterpret_cast<const char*>(&max), sizeof(max));
+  has_bounds_ = true;
+}
+
+void ZoneMapBuilder::AddBinaryValues(const void* cells, size_t count) {
+  const Slice* values = reinterpret_cast<const Slice*>(cells);
+  size_t i = 0;
+  if (!has_bounds_) {
+    min_ = values[0].ToString();
+    max_ = values[0].ToString();
+    has_bounds_ = true;
+    i++;
+  }
+  for (; i < count; i++) {
+    const Slice& v = values[i];
+    if (v.compare(min_) < 0) {
+      min_.assign(reinterpret_cast<const char*>(v.data()), v.size());
+    } else if (v.compare(max_) > 0) {
+      max_.assign(reinterpret_cast<const char*>(v.data()), v.size());
+    }
+  }
+}
+
+void ZoneMapBuilder::AddValues(const void* cells, size_t count) {
+  if (count == 0 || bounds_unknown_) {
+    return;
+  }
+  switch (type_info_->physical_type()) {
+    case BOOL: AddFixedValues<bool>(cells, count); break;
+    case INT8: AddFixedValues<int8_t>(cells, count); break;
+    case UINT8: AddFixedValues<uint8_t>(cells, count); break;
+    case INT16: AddFixedValues<int16_t>(cells, count); break;
+    case UINT16: AddFixedValues<uint16_t>(cells, count); break;
+    case INT32: AddFixedValues<int32_t>(cells, count); break;
+    case UINT32: AddFixedValues<uint32_t>(cells, count); break;
+    case INT64: AddFixedValues<int64_t>(cells, count); break;
+    case UINT64: AddFixedValues<uint64_t>(cells, count); break;
+    case INT128: AddFixedValues<int128_t>(cells, count); break;
+    case FLOAT: AddFixedValues<float>(cells, count); break;
+    case DOUBLE: AddFixedValues<double>(cells, count); break;
+    case BINARY: AddBinaryValues(cells, count); break;
+    default:
+      // Don't summarize types we don't know how to order.
+      bounds_unknown_ = true;
+  }
+}
+
+void ZoneMapBuilder::FinishBlock(rowid_t first_ordinal) {
+  ZoneMapEntryPB* entry = pb_.add_entries();
+  entry->set_first_ordinal(first_ordinal);
+  if (null_count_ > 0) {
+    entry->set_null_count(null_count_);
+  }
+  if (has_bounds_ && !bounds_unknown_) {
+    if (type_info_->physical_type() == BINARY) {
+      // A prefix of the minimum is still a lower bound, but there is no
+      // cheap upper bound for a long maximum.
+      entry->set_min_value(min_.substr(0, kMaxBinaryBoundLength));
+      if (max_.size() <= kMaxBinaryBoundLength) {
+        entry->set_max_value(max_);
+      }
+    } else {
+      entry->set_min_value(min_);
+      entry->set_max_value(max_);
+    }
+  }
+  ResetBlock();
+}
+
+void ZoneMapBuilder::Finish(ZoneMapPB* pb) {
+  DCHECK(!has_bounds_ && null_count_ == 0) << "unfinished block";
+  pb->Swap(&pb_);
+  pb_.Clear();
+}
+
+////////////////////////////////////////////////////////////
+// ZoneMap
+////////////////////////////////////////////////////////////
+
+ZoneMap::ZoneMap(const TypeInfo* type_info, rowid_t num_rows)
+    : type_info_(type_info),
+      num_rows_(num_rows) {
+}
+
+Status ZoneMap::Create(const ZoneMapPB& pb,
+                       const TypeInfo* type_info,
+                       rowid_t num_rows,
+                       unique_ptr<ZoneMap>* zone_map) {
+  unique_ptr<ZoneMap> zm(new ZoneMap(type_info, num_rows));
+  const bool is_binary = type_info->physical_type() == BINARY;
+  const size_t cell_size = type_info->size();
+
+  // Copy the BINARY bounds up front: the Slices point into the strings, so
+  // they must not move once the entries are built.
+  if (is_binary) {
+    zm->bound_data_.reserve(pb.entries_size() * 2);
+    for (const auto& entry_pb : pb.entries()) {
+      zm->bound_data_.emplace_back(entry_pb.min_value());
+      zm->bound_data_.emplace_back(entry_pb.max_value());
+    }
+  }
+
+  zm->entries_.reserve(pb.entries_size());
+  Entry& file = zm->file_entry_;
+  file.first_ordinal = 0;
+  file.null_count = 0;
+  file.has_min = true;
+  file.has_max = true;
+  bool has_file_bounds = false;
+  for (int i = 0; i < pb.entries_size(); i++) {
+    const ZoneMapEntryPB& entry_pb = pb.entries(i);
+    const rowid_t prev_ordinal = zm->entries_.empty() ? 0 : zm->entries_.back().first_ordinal;
+    if (PREDICT_FALSE(entry_pb.first_ordinal() >= num_rows ||
+                      (!zm->entries_.empty() && entry_pb.first_ordinal() <= prev_ordinal) ||
+                      (zm->entries_.empty() && entry_pb.first_ordinal() != 0))) {
+      return Status::Corruption(Substitute("zone map entry $0 has bad first ordinal $1",
+                                           i, entry_pb.first_ordinal()));
+    }
+    Entry entry;
+    entry.first_ordinal = entry_pb.first_ordinal();
+    entry.null_count = entry_pb.null_count();
+    entry.has_min = entry_pb.has_min_value();
+    entry.has_max = entry_pb.has_max_value();
+    if (is_binary) {
+      Slice min(zm->bound_data_[i * 2]);
+      Slice max(zm->bound_data_[i * 2 + 1]);
+      memcpy(entry.min, &min, sizeof(min));
+      memcpy(entry.max, &max, sizeof(max));
+    } else {
+      if (PREDICT_FALSE((entry.has_min && entry_pb.min_value().size() != cell_size) ||
+                        (entry.has_max && entry_pb.max_value().size() != cell_size))) {
+        return Status::Corruption(Substitute("zone map entry $0 has bounds of bad size", i));
+      }
+      if (entry.has_min) memcpy(entry.min, entry_pb.min_value().data(), cell_size);
+      if (entry.has_max) memcpy(entry.max, entry_pb.max_value().data(), cell_size);
+    }
+
+    // Fold the entry into the file-wide summary. An all-NULL block has no
+    // bounds, but doesn't widen the file's bounds either.
+    const rowid_t block_end = i + 1 < pb.entries_size() ?
+        pb.entries(i + 1).first_ordinal() : num_rows;
+    file.null_count += entry.null_count;
+    if (entry.first_ordinal + entry.null_count < block_end) {
+      if (!entry.has_min) {
+        file.has_min = false;
+      } else if (file.has_min &&
+                 (!has_file_bounds || type_info->Compare(entry.min, file.min) < 0)) {
+        memcpy(file.min, entry.min, sizeof(file.min));
+      }
+      if (!entry.has_max) {
+        file.has_max = false;
+      } else if (file.has_max &&
+                 (!has_file_bounds || type_info->Compare(entry.max, file.max) > 0)) {
+        memcpy(file.max, entry.max, sizeof(file.max));
+      }
+      has_file_bounds = true;
+    }
+    zm->entries_.emplace_back(entry);
+  }
+  if (!has_file_bounds) {
+    // The file is empty or entirely NULL.
+    file.has_min = false;
+    file.has_max = false;
+  }
+  *zone_map = std::move(zm);
+  return Status::OK();
+}
+
+bool ZoneMap::RangeMayMatch(const Entry& entry, const void* lower, const void* upper) const {
+  if (lower && entry.has_max && type_info_->Compare(entry.max, lower) < 0) {
+    return false;
+  }
+  if (upper && entry.has_min && type_info_->Compare(entry.min, upper) >= 0) {
+    return false;
+  }
+  return true;
+}
+
+bool ZoneMap::ValueMayMatch(const Entry& entry, const void* value) const {
+  if (entry.has_min && type_info_->Compare(value, entry.min) < 0) {
+    return false;
+  }
+  if (entry.has_max && type_info_->Compare(value, entry.max) > 0) {
+    return false;
+  }
+  return true;
+}
+
+bool ZoneMap::EntryMayMatch(const ColumnPredicate& pred,
+                            const Entry& entry,
+                            rowid_t num_rows) const {
+  switch (pred.predicate_type()) {
+    case PredicateType::None:
+      return false;
+    case PredicateType::IsNull:
+      return entry.null_count > 0;
+    case PredicateType::IsNotNull:
+      return entry.null_count < num_rows;
+    default:
+      break;
+  }
+  // The remaining predicates never match NULL.
+  if (entry.null_count >= num_rows) {
+    return false;
+  }
+  switch (pred.predicate_type()) {
+    case PredicateType::Equality:
+      return ValueMayMatch(entry, pred.raw_lower());
+    case PredicateType::Range:
+    case PredicateType::InBloomFilter:
+      return RangeMayMatch(entry, pred.raw_lower(), pred.raw_upper());
+    case PredicateType::InList: {
+      // The values are sorted: find the first one which isn't below the
+      // minimum, and check it against the maximum.
+      const auto& values = pred.raw_values();
+      auto it = values.begin();
+      if (entry.has_min) {
+        it = std::lower_bound(values.begin(), values.end(), entry.min,
+                              [this](const void* v, const void* min) {
+                                return type_info_->Compare(v, min) < 0;
+                              });
+      }
+      return it != values.end() &&
+          (!entry.has_max || type_info_->Compare(*it, entry.max) <= 0);
+    }
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::MayMatch(const ColumnPredicate& pred) const {
+  return EntryMayMatch(pred, file_entry_, num_rows_);
+}
+
+bool ZoneMap::MayMatch(const ColumnPredicate& pred, rowid_t start, rowid_t end) const {
+  DCHECK_EQ(pred.column().type_info()->physical_type(), type_info_->physical_type());
+  DCHECK_LE(start, end);
+  if (start >= end || entries_.empty()) {
+    return start < end;
+  }
+  // Most calls ask about files which don't match at all, or which do, so
+  // check the file-wide summary first.
+  if (!MayMatch(pred)) {
+    return false;
+  }
+  // Find the last block starting at or before 'start'.
+  auto it = std::upper_bound(entries_.begin(), entries_.end(), start,
+                             [](rowid_t ord, const Entry& e) {
+                               return ord < e.first_ordinal;
+                             });
+  DCHECK(it != entries_.begin());
+  --it;
+  for (; it != entries_.end() && it->first_ordinal < end; ++it) {
+    const rowid_t block_end = (it + 1) == entries_.end() ? num_rows_ : (it + 1)->first_ordinal;
+    if (EntryMayMatch(pred, *it, block_end - it->first_ordinal)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t ZoneMap::memory_footprint() const {
+  size_t size = kudu_malloc_usable_size(this);
+  size += entries_.capacity() * sizeof(Entry);
+  size += bound_data_.capacity() * sizeof(string);
+  for (const auto& s : bound_data_) {
+    size += s.capacity();
+  }
+  return size;
+}
+
+} // namespace cfile
+} // namespace kudu
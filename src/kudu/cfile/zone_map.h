@@ -0,0 +1,161 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "kudu/cfile/cfile.pb.h"
+#include "kudu/common/rowid.h"
+#include "kudu/gutil/macros.h"
+#include "kudu/util/status.h"
+
+namespace kudu {
+
+class ColumnPredicate;
+class TypeInfo;
+
+namespace cfile {
+
+// A zone map summarizes the values of each data block of a cfile: the number
+// of NULLs in the block, and the smallest and largest non-NULL values. Readers
+// use it to skip data blocks, or entire files, whose values cannot satisfy a
+// column predicate, without reading them.
+
+// Accumulates the zone map of a cfile as its values are written.
+//
+// This class is not thread-safe.
+class ZoneMapBuilder {
+ public:
+  // BINARY bounds longer than this are not stored: the lower bound is
+  // truncated to this length, and the upper bound is left unknown.
+  static const size_t kMaxBinaryBoundLength;
+
+  explicit ZoneMapBuilder(const TypeInfo* type_info);
+
+  // Folds 'count' non-NULL cells, laid out contiguously starting at 'cells',
+  // into the summary of the current block.
+  void AddValues(const void* cells, size_t count);
+
+  // Adds 'count' NULL values to the summary of the current block.
+  void AddNulls(size_t count) {
+    null_count_ += count;
+  }
+
+  // Finishes the summary of the current block, whose first value has ordinal
+  // index 'first_ordinal', and starts a new block.
+  void FinishBlock(rowid_t first_ordinal);
+
+  // Moves the summaries of all finished blocks into 'pb'.
+  void Finish(ZoneMapPB* pb);
+
+ private:
+  template<typename CppType>
+  void AddFixedValues(const void* cells, size_t count);
+  void AddBinaryValues(const void* cells, size_t count);
+
+  void ResetBlock();
+
+  const TypeInfo* const type_info_;
+  ZoneMapPB pb_;
+
+  // Summary of the current block.
+  uint32_t null_count_;
+  bool has_bounds_;
+  bool bounds_unknown_;
+  std::string min_;
+  std::string max_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneMapBuilder);
+};
+
+// The zone map of a cfile, as read back from disk.
+//
+// This class is immutable and thread-safe once created.
+class ZoneMap {
+ public:
+  // Decodes 'pb', the zone map of a cfile of 'num_rows' values of type
+  // 'type_info'. Returns Corruption if 'pb' is malformed.
+  static Status Create(const ZoneMapPB& pb,
+                       const TypeInfo* type_info,
+                       rowid_t num_rows,
+                       std::unique_ptr<ZoneMap>* zone_map);
+
+  // Returns false if no row in the ordinal range [start, end) can satisfy
+  // 'pred', and true if some might.
+  //
+  // 'pred' must be over a column of the same type as the cfile.
+  bool MayMatch(const ColumnPredicate& pred, rowid_t start, rowid_t end) const;
+
+  // Returns false if no row of the cfile can satisfy 'pred'.
+  bool MayMatch(const ColumnPredicate& pred) const;
+
+  size_t num_blocks() const {
+    return entries_.size();
+  }
+
+  // Returns the memory usage of this object including the object itself.
+  size_t memory_footprint() const;
+
+ private:
+  // The summary of a run of rows: a single data block, or the entire file.
+  struct Entry {
+    rowid_t first_ordinal;
+    uint32_t null_count;
+
+    // The bounds are cells of the cfile's type. BINARY cells are Slices
+    // pointing into 'bound_data_'.
+    bool has_min;
+    bool has_max;
+    uint8_t min[16];
+    uint8_t max[16];
+  };
+
+  ZoneMap(const TypeInfo* type_info, rowid_t num_rows);
+
+  // Returns false if none of the 'num_rows' rows summarized by 'entry' can
+  // satisfy 'pred'.
+  bool EntryMayMatch(const ColumnPredicate& pred, const Entry& entry, rowid_t num_rows) const;
+
+  // Returns false if no non-NULL value summarized by 'entry' can lie in
+  // [lower, upper). Either bound may be null, meaning unbounded.
+  bool RangeMayMatch(const Entry& entry, const void* lower, const void* upper) const;
+
+  // Returns false if the non-NULL values summarized by 'entry' cannot be
+  // equal to 'value'.
+  bool ValueMayMatch(const Entry& entry, const void* value) const;
+
+  const TypeInfo* const type_info_;
+  const rowid_t num_rows_;
+
+  // One entry per data block, in ordinal order.
+  std::vector<Entry> entries_;
+
+  // The union of 'entries_'.
+  Entry file_entry_;
+
+  // Storage for the BINARY bounds.
+  std::vector<std::string> bound_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneMap);
+};
+
+} // namespace cfile
+} // namespace kudu
@@ -291,6 +291,9 @@ WriteRpc::WriteRpc(const scoped_refptr<Batcher>& batcher,
       LOG(FATAL) << "Unsupported consistency mode: " << batcher->external_consistency_mode();
 
   }
+  if (batcher->bulk_load()) {
+    req_.set_bulk_load(true);
+  }
   // If set, propagate the latest observed timestamp.
   if (PREDICT_TRUE(propagated_timestamp != KuduClient::kNoTimestamp)) {
     req_.set_propagated_timestamp(propagated_timestamp);
@@ -306,9 +309,28 @@ WriteRpc::WriteRpc(const scoped_refptr<Batcher>& batcher,
   FetchCachedAuthzToken();
   RowOperationsPB* requested = req_.mutable_row_operations();
 
+  // Operations may only be sent column by column if they're all inserts or
+  // upserts of the same type, setting every column.
+  bool columnar = batcher->columnar_encoding() && !ops_.empty();
+  const KuduWriteOperation::Type type = ops_.empty() ? KuduWriteOperation::INSERT :
+      ops_[0]->write_op->type();
+  if (columnar) {
+    columnar = type == KuduWriteOperation::INSERT ||
+               type == KuduWriteOperation::INSERT_IGNORE ||
+               type == KuduWriteOperation::UPSERT;
+    for (auto it = ops_.begin(); columnar && it != ops_.end(); ++it) {
+      columnar = (*it)->write_op->type() == type && (*it)->write_op->row().AllColumnsSet();
+    }
+  }
+
   // Add the rows
   int ctr = 0;
   RowOperationsPBEncoder enc(requested);
+  unique_ptr<ColumnarRowOperationsPBEncoder> columnar_enc;
+  if (columnar) {
+    columnar_enc.reset(new ColumnarRowOperationsPBEncoder(
+        ToInternalWriteType(type), schema, requested->mutable_columnar()));
+  }
   for (InFlightOp* op : ops_) {
 #ifndef NDEBUG
     const Partition& partition = op->tablet->partition();
@@ -321,7 +343,11 @@ WriteRpc::WriteRpc(const scoped_refptr<Batcher>& batcher,
         << " not in partition " << partition_schema.PartitionDebugString(partition, *schema);
 #endif
 
-    enc.Add(ToInternalWriteType(op->write_op->type()), op->write_op->row());
+    if (columnar_enc) {
+      columnar_enc->Add(op->write_op->row());
+    } else {
+      enc.Add(ToInternalWriteType(op->write_op->type()), op->write_op->row());
+    }
 
     // Set the state now, even though we haven't yet sent it -- at this point
     // there is no return, and we're definitely going to send it. If we waited
@@ -419,6 +445,10 @@ string WriteRpc::ToString() const {
 
 void WriteRpc::Try(RemoteTabletServer* replica, const ResponseCallback& callback) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica " << replica->ToString();
+  if (req_.row_operations().has_columnar()) {
+    mutable_retrier()->mutable_controller()->RequireServerFeature(
+        tserver::TabletServerFeatures::COLUMNAR_WRITE);
+  }
   replica->proxy()->WriteAsync(req_, &resp_,
                                mutable_retrier()->mutable_controller(),
                                callback);
@@ -580,11 +610,15 @@ void WriteRpc::GotNewAuthzTokenRetryCb(const Status& status) {
 Batcher::Batcher(KuduClient* client,
                  scoped_refptr<ErrorCollector> error_collector,
                  sp::weak_ptr<KuduSession> session,
-                 kudu::client::KuduSession::ExternalConsistencyMode consistency_mode)
+                 kudu::client::KuduSession::ExternalConsistencyMode consistency_mode,
+                 bool bulk_load,
+                 bool columnar_encoding)
   : state_(kGatheringOps),
     client_(client),
     weak_session_(std::move(session)),
     consistency_mode_(consistency_mode),
+    bulk_load_(bulk_load),
+    columnar_encoding_(columnar_encoding),
     error_collector_(std::move(error_collector)),
     had_errors_(false),
     flush_callback_(nullptr),
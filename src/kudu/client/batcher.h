@@ -70,7 +70,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   Batcher(KuduClient* client,
           scoped_refptr<ErrorCollector> error_collector,
           client::sp::weak_ptr<KuduSession> session,
-          kudu::client::KuduSession::ExternalConsistencyMode consistency_mode);
+          kudu::client::KuduSession::ExternalConsistencyMode consistency_mode,
+          bool bulk_load,
+          bool columnar_encoding);
 
   // Abort the current batch. Any writes that were buffered and not yet sent are
   // discarded. Those that were sent may still be delivered.  If there is a pending Flush
@@ -111,6 +113,17 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
     return consistency_mode_;
   }
 
+  // Returns whether the batcher's writes are bulk loads.
+  bool bulk_load() const {
+    return bulk_load_;
+  }
+
+  // Returns whether the batcher's writes are sent column by column where
+  // possible.
+  bool columnar_encoding() const {
+    return columnar_encoding_;
+  }
+
   // Get time of the first operation in the batch.  If no operations are in
   // there yet, the returned MonoTime object is not initialized
   // (i.e. MonoTime::Initialized() returns false).
@@ -187,6 +200,12 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // The consistency mode set in the session.
   kudu::client::KuduSession::ExternalConsistencyMode consistency_mode_;
 
+  // Whether the session is in bulk load mode.
+  const bool bulk_load_;
+
+  // Whether the session sends its writes column by column where possible.
+  const bool columnar_encoding_;
+
   // Errors are reported into this error collector.
   scoped_refptr<ErrorCollector> error_collector_;
 
@@ -106,6 +106,7 @@
 #include "kudu/util/array_view.h"
 #include "kudu/util/async_util.h"
 #include "kudu/util/barrier.h"
+#include "kudu/util/bitmap.h"
 #include "kudu/util/countdown_latch.h"
 #include "kudu/util/locks.h"  // IWYU pragma: keep
 #include "kudu/util/metrics.h"
@@ -1260,6 +1261,75 @@ TEST_F(ClientTest, TestScanEmptyProjection) {
   }
 }
 
+// Test evaluating aggregates on the tablet servers and merging them across
+// the tablets of the table.
+TEST_F(ClientTest, TestScanWithAggregates) {
+  {
+    // Aggregating an empty table without grouping still yields a row.
+    KuduScanner scanner(client_table_.get());
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_COUNT, ""));
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_SUM, "int_val"));
+    ASSERT_OK(scanner.Open());
+    vector<KuduPartialRow> rows;
+    ASSERT_OK(scanner.GetAggregateResults(&rows));
+    ASSERT_EQ(1, rows.size());
+    int64_t count;
+    ASSERT_OK(rows[0].GetInt64("count(*)", &count));
+    ASSERT_EQ(0, count);
+    ASSERT_TRUE(rows[0].IsNull("sum(int_val)"));
+  }
+
+  NO_FATALS(InsertTestRows(client_table_.get(), FLAGS_test_scan_num_rows));
+  const int64_t kNumRows = FLAGS_test_scan_num_rows;
+  {
+    KuduScanner scanner(client_table_.get());
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_COUNT, ""));
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_SUM, "int_val"));
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_MIN, "key"));
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_MAX, "key"));
+    ASSERT_OK(scanner.Open());
+    vector<KuduPartialRow> rows;
+    ASSERT_OK(scanner.GetAggregateResults(&rows));
+    ASSERT_EQ(1, rows.size());
+    int64_t count;
+    ASSERT_OK(rows[0].GetInt64("count(*)", &count));
+    ASSERT_EQ(kNumRows, count);
+    int64_t sum;
+    ASSERT_OK(rows[0].GetInt64("sum(int_val)", &sum));
+    ASSERT_EQ(kNumRows * (kNumRows - 1), sum);
+    int32_t key;
+    ASSERT_OK(rows[0].GetInt32("min(key)", &key));
+    ASSERT_EQ(0, key);
+    ASSERT_OK(rows[0].GetInt32("max(key)", &key));
+    ASSERT_EQ(kNumRows - 1, key);
+  }
+  {
+    // Group a handful of rows by a column which is unique per row.
+    KuduScanner scanner(client_table_.get());
+    ASSERT_OK(scanner.AddConjunctPredicate(client_table_->NewComparisonPredicate(
+        "key", KuduPredicate::LESS, KuduValue::FromInt(10))));
+    ASSERT_OK(scanner.SetGroupByColumns({ "int_val" }));
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_COUNT, ""));
+    ASSERT_OK(scanner.Open());
+    vector<KuduPartialRow> rows;
+    ASSERT_OK(scanner.GetAggregateResults(&rows));
+    ASSERT_EQ(10, rows.size());
+    for (const auto& row : rows) {
+      int64_t count;
+      ASSERT_OK(row.GetInt64("count(*)", &count));
+      ASSERT_EQ(1, count);
+    }
+  }
+  {
+    KuduScanner scanner(client_table_.get());
+    ASSERT_TRUE(scanner.AddAggregate(KuduScanner::AGG_SUM, "").IsInvalidArgument());
+    ASSERT_TRUE(scanner.AddAggregate(KuduScanner::AGG_SUM, "missing").IsNotFound());
+    ASSERT_OK(scanner.AddAggregate(KuduScanner::AGG_SUM, "string_val"));
+    Status s = scanner.Open();
+    ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+  }
+}
+
 TEST_F(ClientTest, TestProjectInvalidColumn) {
   KuduScanner scanner(client_table_.get());
   Status s = scanner.SetProjectedColumnNames({ "column-doesnt-exist" });
@@ -2532,6 +2602,139 @@ TEST_F(ClientTest, TestInsertIgnore) {
   }
 }
 
+// Test that a session in bulk load mode inserts rows regardless of their order,
+// that they survive a restart, and that only inserts are allowed.
+TEST_F(ClientTest, TestBulkLoad) {
+  constexpr int kNumRows = 1000;
+  shared_ptr<KuduSession> session = client_->NewSession();
+  session->SetTimeoutMillis(60000);
+  ASSERT_OK(session->SetFlushMode(KuduSession::MANUAL_FLUSH));
+  ASSERT_OK(session->SetBulkLoadMode(true));
+
+  // Rows don't need to be applied in key order.
+  for (int i = kNumRows - 1; i >= 0; i--) {
+    ASSERT_OK(session->Apply(BuildTestInsert(client_table_.get(), i).release()));
+  }
+  // The mode can't change while the rows are buffered.
+  ASSERT_TRUE(session->SetBulkLoadMode(false).IsIllegalState());
+  ASSERT_OK(session->Flush());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_.get()));
+
+  // Duplicate keys fail as they do outside of bulk load mode, unless they're
+  // inserted with INSERT IGNORE.
+  ASSERT_OK(session->Apply(BuildTestInsertIgnore(client_table_.get(), 1).release()));
+  ASSERT_OK(session->Apply(BuildTestInsert(client_table_.get(), 2).release()));
+  ASSERT_OK(session->Apply(BuildTestInsert(client_table_.get(), kNumRows).release()));
+  Status s = session->Flush();
+  ASSERT_TRUE(s.IsIOError()) << s.ToString();
+  {
+    vector<KuduError*> errors;
+    ElementDeleter drop(&errors);
+    bool overflowed;
+    session->GetPendingErrors(&errors, &overflowed);
+    EXPECT_FALSE(overflowed);
+    ASSERT_EQ(1, errors.size());
+    EXPECT_TRUE(errors[0]->status().IsAlreadyPresent());
+  }
+  ASSERT_EQ(kNumRows + 1, CountRowsFromClient(client_table_.get()));
+
+  // Other operations are rejected.
+  unique_ptr<KuduUpdate> update(client_table_->NewUpdate());
+  ASSERT_OK(update->mutable_row()->SetInt32("key", 1));
+  ASSERT_OK(update->mutable_row()->SetInt32("int_val", 2));
+  s = session->Apply(update.release());
+  ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+  {
+    vector<KuduError*> errors;
+    ElementDeleter drop(&errors);
+    bool overflowed;
+    session->GetPendingErrors(&errors, &overflowed);
+    ASSERT_EQ(1, errors.size());
+  }
+
+  // The bulk loaded rows are durable.
+  for (int i = 0; i < cluster_->num_tablet_servers(); i++) {
+    MiniTabletServer* ts = cluster_->mini_tablet_server(i);
+    ts->Shutdown();
+    ASSERT_OK(ts->Restart());
+    ASSERT_OK(ts->WaitStarted());
+  }
+  ASSERT_EQ(kNumRows + 1, CountRowsFromClient(client_table_.get()));
+}
+
+// Test that rows applied in columnar form are written, whether or not they're
+// also sent in columnar form, and that malformed batches are rejected.
+TEST_F(ClientTest, TestApplyColumnar) {
+  constexpr int kNumRows = 100;
+  shared_ptr<KuduSession> session = client_->NewSession();
+  session->SetTimeoutMillis(60000);
+  ASSERT_OK(session->SetFlushMode(KuduSession::MANUAL_FLUSH));
+
+  // Build the columns: every other row has a NULL string_val.
+  vector<int32_t> keys;
+  vector<int32_t> int_vals;
+  vector<uint32_t> offsets = { 0 };
+  string strings;
+  vector<uint8_t> non_null(BitmapSize(kNumRows), 0);
+  for (int i = 0; i < kNumRows; i++) {
+    keys.push_back(i);
+    int_vals.push_back(i * 2);
+    if (i % 2 == 0) {
+      strings += Substitute("hello $0", i);
+      BitmapSet(non_null.data(), i);
+    }
+    offsets.push_back(strings.size());
+  }
+  const vector<Slice> data = {
+    Slice(reinterpret_cast<const uint8_t*>(keys.data()), keys.size() * sizeof(int32_t)),
+    Slice(reinterpret_cast<const uint8_t*>(int_vals.data()), int_vals.size() * sizeof(int32_t)),
+    Slice(reinterpret_cast<const uint8_t*>(offsets.data()), offsets.size() * sizeof(uint32_t)),
+    Slice(reinterpret_cast<const uint8_t*>(int_vals.data()), int_vals.size() * sizeof(int32_t))
+  };
+  const vector<Slice> varlen_data = { Slice(), Slice(), Slice(strings), Slice() };
+  const vector<Slice> bitmaps = { Slice(), Slice(), Slice(non_null.data(), non_null.size()),
+                                  Slice() };
+
+  // Apply the same columns once with each encoding, shifting the keys.
+  ASSERT_OK(session->ApplyColumnar(client_table_.get(), KuduWriteOperation::INSERT,
+                                   kNumRows, data, varlen_data, bitmaps));
+  ASSERT_OK(session->Flush());
+  for (auto& k : keys) {
+    k += kNumRows;
+  }
+  ASSERT_OK(session->SetColumnarEncoding(true));
+  ASSERT_OK(session->ApplyColumnar(client_table_.get(), KuduWriteOperation::INSERT,
+                                   kNumRows, data, varlen_data, bitmaps));
+  // The setting can't change while the rows are buffered.
+  ASSERT_TRUE(session->SetColumnarEncoding(false).IsIllegalState());
+  ASSERT_OK(session->Flush());
+
+  vector<string> expected_rows;
+  for (int i = 0; i < 2 * kNumRows; i++) {
+    const int r = i % kNumRows;
+    expected_rows.emplace_back(Substitute(
+        "(int32 key=$0, int32 int_val=$1, string string_val=$2, int32 non_null_with_default=$1)",
+        i, r * 2, r % 2 == 0 ? Substitute("\"hello $0\"", r) : "NULL"));
+  }
+  std::sort(expected_rows.begin(), expected_rows.end());
+  vector<string> rows;
+  ASSERT_OK(ScanTableToStrings(client_table_.get(), &rows, ScannedRowsOrder::kSorted));
+  ASSERT_EQ(expected_rows, rows);
+
+  // Malformed batches are rejected without applying any row.
+  Status s = session->ApplyColumnar(client_table_.get(), KuduWriteOperation::UPDATE,
+                                    kNumRows, data, varlen_data, bitmaps);
+  ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+  s = session->ApplyColumnar(client_table_.get(), KuduWriteOperation::UPSERT,
+                             kNumRows + 1, data, varlen_data, bitmaps);
+  ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+  offsets.back() = strings.size() + 1;
+  s = session->ApplyColumnar(client_table_.get(), KuduWriteOperation::UPSERT,
+                             kNumRows, data, varlen_data, bitmaps);
+  ASSERT_STR_CONTAINS(s.ToString(), "bad offsets");
+  ASSERT_FALSE(session->HasPendingOperations());
+}
+
 TEST_F(ClientTest, TestInsertAutoFlushSync) {
   shared_ptr<KuduSession> session = client_->NewSession();
   ASSERT_FALSE(session->HasPendingOperations());
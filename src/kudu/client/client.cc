@@ -62,13 +62,16 @@
 #include "kudu/common/partial_row.h"
 #include "kudu/common/partition.h"
 #include "kudu/common/partition_pruner.h"
+#include "kudu/common/row_aggregator.h"
 #include "kudu/common/row_operations.h"
 #include "kudu/common/scan_spec.h"
 #include "kudu/common/schema.h"
+#include "kudu/common/types.h"
 #include "kudu/common/wire_protocol.h"
 #include "kudu/common/wire_protocol.pb.h"
 #include "kudu/consensus/metadata.pb.h"
 #include "kudu/gutil/casts.h"
+#include "kudu/gutil/port.h"
 #include "kudu/gutil/ref_counted.h"
 #include "kudu/gutil/stl_util.h"
 #include "kudu/gutil/strings/numbers.h"
@@ -89,6 +92,7 @@
 #include "kudu/tserver/tserver.pb.h"
 #include "kudu/tserver/tserver_service.proxy.h"
 #include "kudu/util/async_util.h"
+#include "kudu/util/bitmap.h"
 #include "kudu/util/debug-util.h"
 #include "kudu/util/init.h"
 #include "kudu/util/logging.h"
@@ -1177,6 +1181,14 @@ Status KuduSession::SetExternalConsistencyMode(ExternalConsistencyMode m) {
   return data_->SetExternalConsistencyMode(m);
 }
 
+Status KuduSession::SetBulkLoadMode(bool enable) {
+  return data_->SetBulkLoadMode(enable);
+}
+
+Status KuduSession::SetColumnarEncoding(bool enable) {
+  return data_->SetColumnarEncoding(enable);
+}
+
 Status KuduSession::SetMutationBufferSpace(size_t size) {
   return data_->SetBufferBytesLimit(size);
 }
@@ -1221,6 +1233,110 @@ Status KuduSession::Apply(KuduWriteOperation* write_op) {
   return Status::OK();
 }
 
+Status KuduSession::ApplyColumnar(KuduTable* table,
+                                  KuduWriteOperation::Type type,
+                                  int num_rows,
+                                  const vector<Slice>& data,
+                                  const vector<Slice>& varlen_data,
+                                  const vector<Slice>& non_null_bitmaps) {
+  if (PREDICT_FALSE(type != KuduWriteOperation::INSERT &&
+                    type != KuduWriteOperation::INSERT_IGNORE &&
+                    type != KuduWriteOperation::UPSERT)) {
+    return Status::InvalidArgument(
+        "only INSERT, INSERT_IGNORE and UPSERT operations may be applied in columnar form");
+  }
+  if (PREDICT_FALSE(num_rows < 0)) {
+    return Status::InvalidArgument(Substitute("bad number of rows: $0", num_rows));
+  }
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+  const auto new_op = [&]() -> KuduWriteOperation* {
+    switch (type) {
+      case KuduWriteOperation::INSERT: return table->NewInsert();
+      case KuduWriteOperation::INSERT_IGNORE: return table->NewInsertIgnore();
+      default: return table->NewUpsert();
+    }
+  };
+
+  // Validate the layout of every column before applying any row, so that a
+  // malformed batch is rejected as a whole.
+  unique_ptr<KuduWriteOperation> op(new_op());
+  const Schema& schema = *op->row().schema();
+  const size_t num_cols = schema.num_columns();
+  if (PREDICT_FALSE(data.size() != num_cols ||
+                    varlen_data.size() != num_cols ||
+                    non_null_bitmaps.size() != num_cols)) {
+    return Status::InvalidArgument(Substitute(
+        "expected data for $0 columns, got $1 data, $2 varlen_data and $3 bitmaps",
+        num_cols, data.size(), varlen_data.size(), non_null_bitmaps.size()));
+  }
+  for (size_t i = 0; i < num_cols; i++) {
+    const ColumnSchema& col = schema.column(i);
+    const bool is_binary = col.type_info()->physical_type() == BINARY;
+    const size_t expected_size = is_binary ?
+        (num_rows + 1) * sizeof(uint32_t) : num_rows * col.type_info()->size();
+    if (PREDICT_FALSE(data[i].size() != expected_size)) {
+      return Status::InvalidArgument(Substitute(
+          "column $0: expected $1 bytes of data, got $2",
+          col.name(), expected_size, data[i].size()));
+    }
+    if (is_binary) {
+      const uint8_t* offsets = data[i].data();
+      for (int r = 0; r < num_rows; r++) {
+        const uint32_t start = UnalignedLoad<uint32_t>(offsets + r * sizeof(uint32_t));
+        const uint32_t end = UnalignedLoad<uint32_t>(offsets + (r + 1) * sizeof(uint32_t));
+        if (PREDICT_FALSE(start > end || end > varlen_data[i].size())) {
+          return Status::InvalidArgument(Substitute(
+              "column $0: bad offsets for row $1", col.name(), r));
+        }
+      }
+    }
+    if (!non_null_bitmaps[i].empty()) {
+      if (PREDICT_FALSE(!col.is_nullable())) {
+        return Status::InvalidArgument(Substitute(
+            "column $0: non-null bitmap specified for a non-nullable column", col.name()));
+      }
+      if (PREDICT_FALSE(non_null_bitmaps[i].size() < BitmapSize(num_rows))) {
+        return Status::InvalidArgument(Substitute(
+            "column $0: non-null bitmap too short for $1 rows", col.name(), num_rows));
+      }
+    }
+  }
+
+  // Each row still becomes its own operation: the rows are routed to their
+  // tablets and their errors reported one by one. The batcher encodes them
+  // back into columns when the session enables the columnar encoding.
+  for (int r = 0; r < num_rows; r++) {
+    if (!op) {
+      op.reset(new_op());
+    }
+    KuduPartialRow* row = op->mutable_row();
+    for (size_t i = 0; i < num_cols; i++) {
+      if (!non_null_bitmaps[i].empty() && !BitmapTest(non_null_bitmaps[i].data(), r)) {
+        RETURN_NOT_OK(row->SetNull(i));
+        continue;
+      }
+      const ColumnSchema& col = schema.column(i);
+      if (col.type_info()->physical_type() == BINARY) {
+        const uint8_t* offsets = data[i].data() + r * sizeof(uint32_t);
+        const uint32_t start = UnalignedLoad<uint32_t>(offsets);
+        const uint32_t end = UnalignedLoad<uint32_t>(offsets + sizeof(uint32_t));
+        Slice cell(varlen_data[i].data() + start, end - start);
+        RETURN_NOT_OK(row->Set(i, reinterpret_cast<const uint8_t*>(&cell)));
+      } else {
+        RETURN_NOT_OK(row->Set(i, data[i].data() + r * col.type_info()->size()));
+      }
+    }
+    RETURN_NOT_OK(data_->ApplyWriteOp(op.release()));
+  }
+  // See the thread-safety note in Apply() above.
+  if (data_->flush_mode_ == AUTO_FLUSH_SYNC) {
+    RETURN_NOT_OK(data_->Flush());
+  }
+  return Status::OK();
+}
+
 int KuduSession::CountBufferedOperations() const {
   return data_->CountBufferedOperations();
 }
@@ -1515,6 +1631,20 @@ Status KuduScanner::SetDiffScan(uint64_t start_timestamp, uint64_t end_timestamp
   return data_->mutable_configuration()->SetDiffScan(start_timestamp, end_timestamp);
 }
 
+Status KuduScanner::AddAggregate(AggregateFunction function, const string& col_name) {
+  if (data_->open_) {
+    return Status::IllegalState("Aggregates must be added before Open()");
+  }
+  return data_->mutable_configuration()->AddAggregate(function, col_name);
+}
+
+Status KuduScanner::SetGroupByColumns(const vector<string>& col_names) {
+  if (data_->open_) {
+    return Status::IllegalState("Group-by columns must be set before Open()");
+  }
+  return data_->mutable_configuration()->SetGroupByColumns(col_names);
+}
+
 Status KuduScanner::SetSelection(KuduClient::ReplicaSelection selection) {
   if (data_->open_) {
     return Status::IllegalState("Replica selection must be set before Open()");
@@ -1637,6 +1767,14 @@ Status KuduScanner::Open() {
   if (data_->configuration().has_start_timestamp()) {
     RETURN_NOT_OK(data_->mutable_configuration()->AddIsDeletedColumn());
   }
+  if (data_->configuration().has_aggregation()) {
+    if (data_->configuration().spec().has_limit()) {
+      return Status::InvalidArgument("a limit cannot be combined with an aggregation");
+    }
+    RETURN_NOT_OK(RowAggregator::Create(data_->configuration().aggregation(),
+                                        *data_->configuration().projection(),
+                                        &data_->aggregator_));
+  }
   data_->mutable_configuration()->OptimizeScanSpec();
   data_->partition_pruner_.Init(*data_->table_->schema().schema_,
                                 data_->table_->partition_schema(),
@@ -1706,6 +1844,22 @@ void KuduScanner::Close() {
   return;
 }
 
+Status KuduScanner::GetAggregateResults(vector<KuduPartialRow>* rows) {
+  if (!data_->open_) {
+    return Status::IllegalState("Scanner must be open to get aggregate results");
+  }
+  if (!data_->aggregator_) {
+    return Status::IllegalState("Scanner has no aggregates");
+  }
+  // The partial aggregates are merged as each response arrives, so it's
+  // enough to drain the scan.
+  KuduScanBatch batch;
+  while (HasMoreRows()) {
+    RETURN_NOT_OK(NextBatch(&batch));
+  }
+  return data_->aggregator_->GetResultRows(rows);
+}
+
 bool KuduScanner::HasMoreRows() const {
   CHECK(data_->open_);
   return !data_->short_circuit_ &&                 // The scan is not short circuited
@@ -1924,6 +2078,15 @@ Status KuduScanTokenBuilder::SetDiffScan(uint64_t start_timestamp, uint64_t end_
   return data_->mutable_configuration()->SetDiffScan(start_timestamp, end_timestamp);
 }
 
+Status KuduScanTokenBuilder::AddAggregate(KuduScanner::AggregateFunction function,
+                                          const string& col_name) {
+  return data_->mutable_configuration()->AddAggregate(function, col_name);
+}
+
+Status KuduScanTokenBuilder::SetGroupByColumns(const vector<string>& col_names) {
+  return data_->mutable_configuration()->SetGroupByColumns(col_names);
+}
+
 Status KuduScanTokenBuilder::SetSnapshotRaw(uint64_t snapshot_timestamp) {
   data_->mutable_configuration()->SetSnapshotRaw(snapshot_timestamp);
   return Status::OK();
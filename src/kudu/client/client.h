@@ -39,6 +39,7 @@
 #include "kudu/client/scan_predicate.h"
 #include "kudu/client/schema.h"
 #include "kudu/client/shared_ptr.h" // IWYU pragma: keep
+#include "kudu/client/write_op.h"
 #ifdef KUDU_HEADERS_NO_STUBS
 #include <gtest/gtest_prod.h>
 
@@ -1747,6 +1748,41 @@ class KUDU_EXPORT KuduSession : public sp::enable_shared_from_this<KuduSession>
   Status SetExternalConsistencyMode(ExternalConsistencyMode m)
     WARN_UNUSED_RESULT;
 
+  /// Set whether the session bulk loads its writes.
+  ///
+  /// In bulk load mode, the tablet servers sort each batch of rows sent to a
+  /// tablet by primary key and write it straight into new on-disk rowsets,
+  /// rather than buffering the rows in memory to be flushed and compacted
+  /// later. This is intended for the initial load or the backfill of large
+  /// amounts of data whose primary keys don't overlap with the existing data
+  /// of the table: larger batches make for larger and fewer rowsets, so it's
+  /// best combined with the @c MANUAL_FLUSH mode and a large mutation buffer.
+  ///
+  /// Only @c INSERT and @c INSERT_IGNORE operations may be applied in bulk
+  /// load mode. Rows whose keys are already present fail as usual.
+  ///
+  /// @param [in] enable
+  ///   Whether to enable bulk load mode. It's disabled by default.
+  /// @return Operation result status. The mode can't be changed while there
+  ///   are buffered operations.
+  Status SetBulkLoadMode(bool enable) WARN_UNUSED_RESULT;
+
+  /// Set whether the session may encode its writes column by column.
+  ///
+  /// With the columnar encoding, a write RPC whose operations are all of the
+  /// same type (@c INSERT, @c INSERT_IGNORE or @c UPSERT) and which all set
+  /// every column of the table is sent as one contiguous array per column
+  /// rather than as a sequence of rows. This makes the request cheaper to
+  /// decode for the tablet server. Other write RPCs are encoded row by row
+  /// as usual. Writes sent in columnar form fail on tablet servers which
+  /// don't support it.
+  ///
+  /// @param [in] enable
+  ///   Whether to enable the columnar encoding. It's disabled by default.
+  /// @return Operation result status. The setting can't be changed while
+  ///   there are buffered operations.
+  Status SetColumnarEncoding(bool enable) WARN_UNUSED_RESULT;
+
   /// Set the amount of buffer space used by this session for outbound writes.
   ///
   /// The effect of the buffer size varies based on the flush mode of
@@ -1877,6 +1913,42 @@ class KUDU_EXPORT KuduSession : public sp::enable_shared_from_this<KuduSession>
   /// @return Operation result status.
   Status Apply(KuduWriteOperation* write_op) WARN_UNUSED_RESULT;
 
+  /// Apply a batch of rows given in columnar form.
+  ///
+  /// The layout of the columns is the one returned by KuduColumnarScanBatch:
+  /// for each column of the table's schema, 'data' holds the little-endian
+  /// packed cells of a fixed-length column, or the @c num_rows + 1 32-bit
+  /// offsets into 'varlen_data' of a variable-length column. The 'varlen_data'
+  /// of fixed-length columns is ignored. A set bit in the non-null bitmap of
+  /// a column indicates a non-null cell; the bitmap of a column without null
+  /// cells may be left empty.
+  ///
+  /// Every row is applied as if by a separate call to Apply(), and is
+  /// reported through the session's error collector if it fails. Combined
+  /// with SetColumnarEncoding(), the rows are also sent to the tablet servers
+  /// in columnar form.
+  ///
+  /// @param [in] table
+  ///   The table to write to.
+  /// @param [in] type
+  ///   The type of the operations: @c INSERT, @c INSERT_IGNORE or @c UPSERT.
+  /// @param [in] num_rows
+  ///   The number of rows in the batch.
+  /// @param [in] data
+  ///   The cells or offsets of each column.
+  /// @param [in] varlen_data
+  ///   The variable-length data of each column.
+  /// @param [in] non_null_bitmaps
+  ///   The non-null bitmap of each column.
+  /// @return Operation result status. If the batch is malformed, none of its
+  ///   rows are applied.
+  Status ApplyColumnar(KuduTable* table,
+                       KuduWriteOperation::Type type,
+                       int num_rows,
+                       const std::vector<Slice>& data,
+                       const std::vector<Slice>& varlen_data,
+                       const std::vector<Slice>& non_null_bitmaps) WARN_UNUSED_RESULT;
+
   /// Flush any pending writes.
   ///
   /// This method initiates flushing of the current batch of buffered
@@ -2417,6 +2489,60 @@ class KUDU_EXPORT KuduScanner {
   Status SetDiffScan(uint64_t start_timestamp, uint64_t end_timestamp)
       WARN_UNUSED_RESULT KUDU_NO_EXPORT;
 
+  /// Aggregate functions which may be evaluated by the tablet servers.
+  enum AggregateFunction {
+    /// The number of rows, or the number of non-NULL cells of a column.
+    AGG_COUNT,
+    /// The sum of the non-NULL cells of an integer or floating point column.
+    AGG_SUM,
+    /// The smallest non-NULL cell of a column.
+    AGG_MIN,
+    /// The largest non-NULL cell of a column.
+    AGG_MAX
+  };
+
+  /// Add an aggregate to evaluate over the scanned rows.
+  ///
+  /// Once any aggregate is added, the tablet servers aggregate the rows they
+  /// scan and return partial aggregates instead of rows. Retrieve the merged
+  /// result with GetAggregateResults() rather than NextBatch().
+  ///
+  /// Private API.
+  ///
+  /// @param [in] function
+  ///   The aggregate function.
+  /// @param [in] col_name
+  ///   The aggregated column, which must be part of the projection. May be
+  ///   empty for @c AGG_COUNT, which then counts rows.
+  /// @return Operation result status.
+  Status AddAggregate(AggregateFunction function, const std::string& col_name)
+      WARN_UNUSED_RESULT KUDU_NO_EXPORT;
+
+  /// Group the aggregates by the values of the given columns, which must be
+  /// part of the projection.
+  ///
+  /// Private API.
+  ///
+  /// @param [in] col_names
+  ///   Names of the group-by columns.
+  /// @return Operation result status.
+  Status SetGroupByColumns(const std::vector<std::string>& col_names)
+      WARN_UNUSED_RESULT KUDU_NO_EXPORT;
+
+  /// Scan all remaining rows and return the merged aggregates, one row per
+  /// group. The rows hold the group-by columns followed by one column per
+  /// aggregate, named after the function and the column, e.g. "sum(x)" or
+  /// "count(*)". The rows refer to a schema owned by the scanner and must not
+  /// outlive it.
+  ///
+  /// Private API.
+  ///
+  /// @param [out] rows
+  ///   The aggregated rows.
+  /// @return Operation result status.
+  Status GetAggregateResults(std::vector<KuduPartialRow>* rows)
+      WARN_UNUSED_RESULT KUDU_NO_EXPORT;
+
   /// @endcond
 
   /// Set the maximum time that Open() and NextBatch() are allowed to take.
@@ -2685,6 +2811,14 @@ class KUDU_EXPORT KuduScanTokenBuilder {
   /// @copydoc KuduScanner::SetDiffScan
   Status SetDiffScan(uint64_t start_timestamp, uint64_t end_timestamp)
       WARN_UNUSED_RESULT KUDU_NO_EXPORT;
+
+  /// @copydoc KuduScanner::AddAggregate
+  Status AddAggregate(KuduScanner::AggregateFunction function, const std::string& col_name)
+      WARN_UNUSED_RESULT KUDU_NO_EXPORT;
+
+  /// @copydoc KuduScanner::SetGroupByColumns
+  Status SetGroupByColumns(const std::vector<std::string>& col_names)
+      WARN_UNUSED_RESULT KUDU_NO_EXPORT;
   /// @endcond
 
   /// @copydoc KuduScanner::SetTimeoutMillis
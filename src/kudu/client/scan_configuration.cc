@@ -213,6 +213,53 @@ Status ScanConfiguration::SetLimit(int64_t limit) {
   return Status::OK();
 }
 
+Status ScanConfiguration::AddAggregate(KuduScanner::AggregateFunction function,
+                                       const string& col_name) {
+  AggregatePB::Function pb_function;
+  switch (function) {
+    case KuduScanner::AGG_COUNT: pb_function = AggregatePB::COUNT; break;
+    case KuduScanner::AGG_SUM: pb_function = AggregatePB::SUM; break;
+    case KuduScanner::AGG_MIN: pb_function = AggregatePB::MIN; break;
+    case KuduScanner::AGG_MAX: pb_function = AggregatePB::MAX; break;
+    default:
+      return Status::InvalidArgument(strings::Substitute(
+          "unknown aggregate function: $0", function));
+  }
+  if (col_name.empty() && pb_function != AggregatePB::COUNT) {
+    return Status::InvalidArgument("only COUNT may be applied without a column");
+  }
+  if (!col_name.empty() &&
+      table_->schema().schema_->find_column(col_name) == Schema::kColumnNotFound) {
+    return Status::NotFound(strings::Substitute(
+        "Column: \"$0\" was not found in the table schema.", col_name));
+  }
+  AggregatePB* agg = aggregation_.add_aggregates();
+  agg->set_function(pb_function);
+  if (!col_name.empty()) {
+    agg->set_column(col_name);
+  }
+  return Status::OK();
+}
+
+Status ScanConfiguration::SetGroupByColumns(const vector<string>& col_names) {
+  const Schema& schema = *table_->schema().schema_;
+  for (const string& col_name : col_names) {
+    if (schema.find_column(col_name) == Schema::kColumnNotFound) {
+      return Status::NotFound(strings::Substitute(
+          "Column: \"$0\" was not found in the table schema.", col_name));
+    }
+  }
+  aggregation_.clear_group_by_columns();
+  for (const string& col_name : col_names) {
+    aggregation_.add_group_by_columns(col_name);
+  }
+  return Status::OK();
+}
+
+void ScanConfiguration::SetAggregation(AggregationSpecPB aggregation) {
+  aggregation_ = std::move(aggregation);
+}
+
 Status ScanConfiguration::AddIsDeletedColumn() {
   CHECK(has_start_timestamp());
   CHECK(has_snapshot_timestamp());
@@ -25,6 +25,7 @@
 
 #include "kudu/client/client.h"
 #include "kudu/client/schema.h"
+#include "kudu/common/common.pb.h"
 #include "kudu/common/scan_spec.h"
 #include "kudu/gutil/port.h"
 #include "kudu/util/auto_release_pool.h"
@@ -99,6 +100,13 @@ class ScanConfiguration {
 
   Status SetLimit(int64_t limit);
 
+  Status AddAggregate(KuduScanner::AggregateFunction function, const std::string& col_name);
+
+  Status SetGroupByColumns(const std::vector<std::string>& col_names);
+
+  // Replaces the aggregation wholesale, e.g. when deserializing a scan token.
+  void SetAggregation(AggregationSpecPB aggregation);
+
   // Adds an IS_DELETED virtual column to the projection.
   //
   // Can only be used with diff scans.
@@ -184,6 +192,15 @@ class ScanConfiguration {
     return row_format_flags_;
   }
 
+  // Returns true if the tablet servers should aggregate the scanned rows.
+  bool has_aggregation() const {
+    return aggregation_.aggregates_size() > 0;
+  }
+
+  const AggregationSpecPB& aggregation() const {
+    return aggregation_;
+  }
+
   Arena* arena() {
     return &arena_;
   }
@@ -236,6 +253,10 @@ class ScanConfiguration {
   AutoReleasePool pool_;
 
   uint64_t row_format_flags_;
+
+  // The aggregates to evaluate and the columns to group them by. Empty if the
+  // scan returns rows.
+  AggregationSpecPB aggregation_;
 };
 
 } // namespace client
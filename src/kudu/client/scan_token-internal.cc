@@ -310,6 +310,10 @@ Status KuduScanToken::Data::PBIntoScanner(KuduClient* client,
     scan_builder->SetTimeoutMillis(message.scan_request_timeout_ms());
   }
 
+  if (message.has_aggregation()) {
+    configuration->SetAggregation(message.aggregation());
+  }
+
   *scanner = scan_builder.release();
   return Status::OK();
 }
@@ -430,6 +434,10 @@ Status KuduScanTokenBuilder::Data::Build(vector<KuduScanToken*>* tokens) {
     pb.set_batch_size_bytes(configuration_.batch_size_bytes());
   }
 
+  if (configuration_.has_aggregation()) {
+    *pb.mutable_aggregation() = configuration_.aggregation();
+  }
+
   MonoTime deadline = MonoTime::Now() + client->default_admin_operation_timeout();
 
   PartitionPruner pruner;
@@ -35,6 +35,7 @@
 #include "kudu/client/scan_configuration.h"
 #include "kudu/client/shared_ptr.h" // IWYU pragma: keep
 #include "kudu/common/partition_pruner.h"
+#include "kudu/common/row_aggregator.h"
 #include "kudu/common/wire_protocol.pb.h"
 #include "kudu/gutil/macros.h"
 #include "kudu/gutil/ref_counted.h"
@@ -248,6 +249,10 @@ class KuduScanner::Data {
   // Number of rows already returned.
   int64_t num_rows_returned_;
 
+  // Merges the partial aggregates returned by the tablet servers, if the scan
+  // has an aggregation.
+  std::unique_ptr<RowAggregator> aggregator_;
+
   // The deprecated "NextBatch(vector<KuduRowResult>*) API requires some local
   // storage for the actual row data. If that API is used, this member keeps the
   // actual storage for the batch that is returned.
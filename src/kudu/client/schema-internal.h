@@ -81,6 +81,7 @@ class KuduColumnSpec::Data {
   boost::optional<KuduColumnStorageAttributes::EncodingType> encoding;
   boost::optional<KuduColumnStorageAttributes::CompressionType> compression;
   boost::optional<int32_t> block_size;
+  boost::optional<bool> bloom_filter;
   boost::optional<bool> nullable;
   bool primary_key;
   boost::optional<KuduValue*> default_val;  // Owned.
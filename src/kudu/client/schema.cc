@@ -53,7 +53,7 @@ MAKE_ENUM_LIMITS(kudu::client::KuduColumnStorageAttributes::EncodingType,
 
 MAKE_ENUM_LIMITS(kudu::client::KuduColumnStorageAttributes::CompressionType,
                  kudu::client::KuduColumnStorageAttributes::DEFAULT_COMPRESSION,
-                 kudu::client::KuduColumnStorageAttributes::ZLIB);
+                 kudu::client::KuduColumnStorageAttributes::ZSTD);
 
 MAKE_ENUM_LIMITS(kudu::client::KuduColumnSchema::DataType,
                  kudu::client::KuduColumnSchema::INT8,
@@ -101,6 +101,7 @@ kudu::CompressionType ToInternalCompressionType(KuduColumnStorageAttributes::Com
     case KuduColumnStorageAttributes::SNAPPY: return kudu::SNAPPY;
     case KuduColumnStorageAttributes::LZ4: return kudu::LZ4;
     case KuduColumnStorageAttributes::ZLIB: return kudu::ZLIB;
+    case KuduColumnStorageAttributes::ZSTD: return kudu::ZSTD;
     default: LOG(FATAL) << "Unexpected compression type" << type;
   }
 }
@@ -113,6 +114,7 @@ KuduColumnStorageAttributes::CompressionType FromInternalCompressionType(
     case kudu::SNAPPY: return KuduColumnStorageAttributes::SNAPPY;
     case kudu::LZ4: return KuduColumnStorageAttributes::LZ4;
     case kudu::ZLIB: return KuduColumnStorageAttributes::ZLIB;
+    case kudu::ZSTD: return KuduColumnStorageAttributes::ZSTD;
     default: LOG(FATAL) << "Unexpected internal compression type: " << type;
   }
 }
@@ -264,6 +266,8 @@ Status KuduColumnStorageAttributes::StringToCompressionType(
     *type = KuduColumnStorageAttributes::LZ4;
   } else if (compression_uc == "ZLIB") {
     *type = KuduColumnStorageAttributes::ZLIB;
+  } else if (compression_uc == "ZSTD") {
+    *type = KuduColumnStorageAttributes::ZSTD;
   } else {
     s = Status::InvalidArgument(Substitute(
         "compression type $0 is not supported", compression));
@@ -314,6 +318,11 @@ KuduColumnSpec* KuduColumnSpec::BlockSize(int32_t block_size) {
   return this;
 }
 
+KuduColumnSpec* KuduColumnSpec::BloomFilter(bool enabled) {
+  data_->bloom_filter = enabled;
+  return this;
+}
+
 KuduColumnSpec* KuduColumnSpec::Precision(int8_t precision) {
   data_->precision = precision;
   return this;
@@ -479,6 +488,14 @@ Status KuduColumnSpec::ToColumnSchema(KuduColumnSchema* col) const {
                           data_->comment ? data_->comment.value() : "");
 #pragma GCC diagnostic pop
 
+  // The bloom filter attribute isn't part of KuduColumnStorageAttributes,
+  // so it's set on the underlying column schema directly.
+  if (data_->bloom_filter) {
+    ColumnSchemaDelta delta(data_->name);
+    delta.bloom_filter = data_->bloom_filter;
+    RETURN_NOT_OK(col->col_->ApplyDelta(delta));
+  }
+
   return Status::OK();
 }
 
@@ -515,6 +532,7 @@ Status KuduColumnSpec::ToColumnSchemaDelta(ColumnSchemaDelta* col_delta) const {
 
   col_delta->new_name = std::move(data_->rename_to);
   col_delta->cfile_block_size = std::move(data_->block_size);
+  col_delta->bloom_filter = std::move(data_->bloom_filter);
   col_delta->new_comment = std::move(data_->comment);
   return Status::OK();
 }
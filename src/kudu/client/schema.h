@@ -146,6 +146,7 @@ class KUDU_EXPORT KuduColumnStorageAttributes {
     SNAPPY = 2,
     LZ4 = 3,
     ZLIB = 4,
+    ZSTD = 5,
   };
 
 
@@ -387,6 +388,21 @@ class KUDU_EXPORT KuduColumnSpec {
   /// @return Pointer to the modified object.
   KuduColumnSpec* BlockSize(int32_t block_size);
 
+  /// Set whether to store a bloom filter of the column's values.
+  ///
+  /// With a bloom filter, scans with an equality or IN-list predicate on the
+  /// column can skip the parts of the table which don't contain any of the
+  /// predicate's values without reading them. This is most useful for
+  /// high-cardinality columns which are not part of the primary key, such as
+  /// trace or user identifiers. Bloom filters are built as data is flushed
+  /// and compacted, so enabling one on an existing column only applies to
+  /// data written afterwards.
+  ///
+  /// @param [in] enabled
+  ///   Whether to store a bloom filter for the column.
+  /// @return Pointer to the modified object.
+  KuduColumnSpec* BloomFilter(bool enabled);
+
   /// @name Operations only relevant for decimal columns.
   ///
   ///@{
@@ -57,6 +57,8 @@ KuduSession::Data::Data(shared_ptr<KuduClient> client,
       messenger_(std::move(messenger)),
       error_collector_(new ErrorCollector()),
       external_consistency_mode_(CLIENT_PROPAGATED),
+      bulk_load_(false),
+      columnar_encoding_(false),
       flush_interval_(MonoDelta::FromMilliseconds(1000)),
       flush_task_active_(false),
       flush_mode_(AUTO_FLUSH_SYNC),
@@ -120,6 +122,30 @@ Status KuduSession::Data::SetExternalConsistencyMode(
   return Status::OK();
 }
 
+Status KuduSession::Data::SetBulkLoadMode(bool enable) {
+  std::lock_guard<Mutex> l(mutex_);
+  if (HasPendingOperationsUnlocked()) {
+    // Every operation in a batch has to be sent in the same mode.
+    return Status::IllegalState(
+        "Cannot change bulk load mode when writes are buffered");
+  }
+  // Thread-safety note: like external_consistency_mode_, the bulk_load_ is
+  // only accessed from the thread using the kudu::KuduSession interface.
+  bulk_load_ = enable;
+  return Status::OK();
+}
+
+Status KuduSession::Data::SetColumnarEncoding(bool enable) {
+  std::lock_guard<Mutex> l(mutex_);
+  if (HasPendingOperationsUnlocked()) {
+    return Status::IllegalState(
+        "Cannot change columnar encoding when writes are buffered");
+  }
+  // Thread-safety note: same as for bulk_load_ above.
+  columnar_encoding_ = enable;
+  return Status::OK();
+}
+
 Status KuduSession::Data::SetFlushMode(FlushMode mode) {
   {
     std::lock_guard<Mutex> l(mutex_);
@@ -365,6 +391,15 @@ Status CheckForNonNullableColumns(const KuduWriteOperation& op) {
 
 Status KuduSession::Data::ValidateWriteOperation(KuduWriteOperation* op) const {
   RETURN_NOT_OK_ADD_ERROR(CheckForPrimaryKey, op, error_collector_);
+  if (PREDICT_FALSE(bulk_load_ &&
+                    op->type() != KuduWriteOperation::INSERT &&
+                    op->type() != KuduWriteOperation::INSERT_IGNORE)) {
+    Status s = Status::InvalidArgument(
+        "only INSERT and INSERT_IGNORE operations may be applied in bulk load mode",
+        op->ToString());
+    error_collector_->AddError(unique_ptr<KuduError>(new KuduError(op, s)));
+    return s;
+  }
   switch (op->type()) {
     case KuduWriteOperation::INSERT:
     case KuduWriteOperation::UPSERT:
@@ -475,7 +510,7 @@ Status KuduSession::Data::ApplyWriteOp(KuduWriteOperation* write_op) {
       // no thread-safety is advertised for the kudu::KuduSession interface.
       scoped_refptr<Batcher> batcher(
           new Batcher(client_.get(), error_collector_, session_,
-                      external_consistency_mode_));
+                      external_consistency_mode_, bulk_load_, columnar_encoding_));
       if (timeout_.Initialized()) {
         batcher->SetTimeout(timeout_);
       }
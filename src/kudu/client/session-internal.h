@@ -81,6 +81,12 @@ class KuduSession::Data {
   // Set external consistency mode for the session.
   Status SetExternalConsistencyMode(KuduSession::ExternalConsistencyMode m);
 
+  // Set whether the session's writes are bulk loads.
+  Status SetBulkLoadMode(bool enable);
+
+  // Set whether the session's write RPCs may use the columnar encoding.
+  Status SetColumnarEncoding(bool enable);
+
   // Set limit on buffer space consumed by buffered write operations.
   Status SetBufferBytesLimit(size_t size);
 
@@ -184,6 +190,12 @@ class KuduSession::Data {
 
   kudu::client::KuduSession::ExternalConsistencyMode external_consistency_mode_;
 
+  // Whether the writes of the session are bulk loads.
+  bool bulk_load_;
+
+  // Whether write RPCs of the session may use the columnar encoding.
+  bool columnar_encoding_;
+
   // Timeout for the next batch.
   MonoDelta timeout_;
 
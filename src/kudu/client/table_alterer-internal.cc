@@ -118,6 +118,7 @@ Status KuduTableAlterer::Data::ToRequest(AlterTableRequestPB* req) {
             !s.spec->data_->encoding &&
             !s.spec->data_->compression &&
             !s.spec->data_->block_size &&
+            !s.spec->data_->bloom_filter &&
             !s.spec->data_->comment) {
           return Status::InvalidArgument("no alter operation specified",
                                          s.spec->data_->name);
@@ -130,6 +131,7 @@ Status KuduTableAlterer::Data::ToRequest(AlterTableRequestPB* req) {
             !s.spec->data_->encoding &&
             !s.spec->data_->compression &&
             !s.spec->data_->block_size &&
+            !s.spec->data_->bloom_filter &&
             !s.spec->data_->comment) {
           pb_step->set_type(AlterTableRequestPB::RENAME_COLUMN);
           pb_step->mutable_rename_column()->set_old_name(s.spec->data_->name);
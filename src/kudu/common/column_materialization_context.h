@@ -38,7 +38,8 @@ class ColumnMaterializationContext {
       pred_(pred),
       block_(block),
       sel_(sel),
-      decoder_eval_status_(kNotSet) {
+      decoder_eval_status_(kNotSet),
+      skip_unselected_rows_(false) {
       if (!pred_ || !sel || !block) {
         decoder_eval_status_ = kDecoderEvalNotSupported;
       }
@@ -110,6 +111,20 @@ class ColumnMaterializationContext {
     decoder_eval_status_ = kDecoderEvalNotSupported;
   }
 
+  // Checked by CFileIterator::Scan() to determine whether rows already
+  // cleared in the selection vector may be skipped rather than copied into
+  // the block. The cells of skipped rows are left unset.
+  bool skip_unselected_rows() const {
+    return skip_unselected_rows_;
+  }
+
+  // Set by callers which only look at the selected rows of the block, e.g.
+  // after predicates on other columns have been evaluated.
+  void SetSkipUnselectedRows() {
+    DCHECK(sel_ != nullptr);
+    skip_unselected_rows_ = true;
+  }
+
  private:
   enum DecoderEvalStatus {
     // During scan, will try to evaluate with the decoder, after which the
@@ -139,6 +154,8 @@ class ColumnMaterializationContext {
   SelectionVector* const sel_;
 
   DecoderEvalStatus decoder_eval_status_;
+
+  bool skip_unselected_rows_;
 };
 
 } // namespace kudu
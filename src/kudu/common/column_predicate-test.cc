@@ -22,6 +22,7 @@
 #include <cstdlib>
 #include <functional>
 #include <initializer_list>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -52,6 +53,8 @@
 
 using std::vector;
 
+DECLARE_bool(disable_column_predicate_avx2);
+
 namespace kudu {
 
 class TestColumnPredicate : public KuduTest {
@@ -1466,6 +1469,114 @@ TEST_F(TestColumnPredicate, TestEquals) {
   ASSERT_NE(ColumnPredicate::None(c1), ColumnPredicate::None(c1dflt));
 }
 
+// Tests that evaluating predicates over whole blocks, with or without AVX2,
+// gives the same results as evaluating them one cell at a time.
+template<typename TypeParam>
+class ColumnPredicateEvaluateTest : public KuduTest {
+ protected:
+  typedef typename TypeParam::cpp_type cpp_type;
+  static constexpr auto kColType = TypeParam::physical_type;
+
+  ColumnPredicateEvaluateTest() : rand_(SeedRandom()) {}
+
+  // Returns a random value: mostly small values, which the test predicates
+  // match some of, but also the extremes of the type and NaN, which is
+  // just zero for integer types.
+  cpp_type RandomValue() {
+    switch (rand_.Uniform(8)) {
+      case 0: return std::numeric_limits<cpp_type>::lowest();
+      case 1: return std::numeric_limits<cpp_type>::max();
+      case 2: return std::numeric_limits<cpp_type>::quiet_NaN();
+      default: return static_cast<cpp_type>(rand_.Uniform(6));
+    }
+  }
+
+  void CheckEvaluate(const ColumnPredicate& pred) {
+    SCOPED_TRACE(pred.ToString());
+    for (int nrows : { 1, 7, 8, 31, 32, 33, 100, 1024, 1031 }) {
+      for (bool nullable : { false, true }) {
+        ScopedColumnBlock<kColType> b(nrows, nullable);
+        vector<bool> selected(nrows);
+        for (int i = 0; i < nrows; i++) {
+          b[i] = RandomValue();
+          if (nullable) {
+            b.SetCellIsNull(i, rand_.OneIn(5));
+          }
+          selected[i] = !rand_.OneIn(4);
+        }
+
+        for (bool disable_avx2 : { false, true }) {
+          FLAGS_disable_column_predicate_avx2 = disable_avx2;
+          SelectionVector sel(nrows);
+          sel.SetAllTrue();
+          for (int i = 0; i < nrows; i++) {
+            if (!selected[i]) sel.SetRowUnselected(i);
+          }
+          pred.Evaluate(b, &sel);
+          for (int i = 0; i < nrows; i++) {
+            bool expected = selected[i];
+            if (nullable && b.is_null(i)) {
+              expected &= pred.predicate_type() == PredicateType::IsNull;
+            } else {
+              expected &= pred.EvaluateCell<kColType>(b.cell_ptr(i));
+            }
+            ASSERT_EQ(expected, sel.IsRowSelected(i))
+                << "row " << i << " of " << nrows << (nullable ? " nullable" : "")
+                << (disable_avx2 ? " without" : " with") << " AVX2";
+          }
+        }
+      }
+    }
+  }
+
+  Random rand_;
+};
+
+using evaluate_test_types = ::testing::Types<
+  DataTypeTraits<INT8>,
+  DataTypeTraits<INT16>,
+  DataTypeTraits<INT32>,
+  DataTypeTraits<INT64>,
+  DataTypeTraits<UINT8>,
+  DataTypeTraits<UINT16>,
+  DataTypeTraits<UINT32>,
+  DataTypeTraits<UINT64>,
+  DataTypeTraits<FLOAT>,
+  DataTypeTraits<DOUBLE>>;
+
+TYPED_TEST_CASE(ColumnPredicateEvaluateTest, evaluate_test_types);
+
+TYPED_TEST(ColumnPredicateEvaluateTest, TestEvaluate) {
+  typedef typename TypeParam::cpp_type cpp_type;
+  ColumnSchema cs("c", TypeParam::physical_type, /*is_nullable=*/true);
+  const cpp_type one = 1;
+  const cpp_type three = 3;
+  const cpp_type max = std::numeric_limits<cpp_type>::max();
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::Range(cs, &one, &three)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::Range(cs, &one, nullptr)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::Range(cs, nullptr, &three)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::Equality(cs, &three)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::Equality(cs, &max)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::IsNull(cs)));
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::IsNotNull(cs)));
+
+  // IN-lists short enough for the vectorized kernels and longer ones.
+  vector<cpp_type> values = { 0, 2, 4, max };
+  vector<const void*> short_list;
+  for (const auto& v : values) {
+    short_list.push_back(&v);
+  }
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::InList(cs, &short_list)));
+  for (int i = 10; i < 20; i++) {
+    values.push_back(static_cast<cpp_type>(i));
+  }
+  vector<const void*> long_list;
+  for (const auto& v : values) {
+    long_list.push_back(&v);
+  }
+  NO_FATALS(this->CheckEvaluate(ColumnPredicate::InList(cs, &long_list)));
+}
+
 using TestColumnPredicateDeathTest = TestColumnPredicate;
 
 // Ensure that ColumnPredicate::Merge(other) requires the 'other' predicate to
@@ -1521,23 +1632,28 @@ class ColumnPredicateBenchmark : public KuduTest {
          }
        }
 
-       SelectionVector selvec(kNumRows);
-       int64_t tot_cycles = 0;
-       Stopwatch sw;
-       sw.start();
-       for (int i = 0; i < num_iters; i++) {
-         selvec.SetAllTrue();
-         int64_t cycles_start = CycleClock::Now();
-         pred.Evaluate(b, &selvec);
-         tot_cycles += CycleClock::Now() - cycles_start;
+       // Compare the AVX2 kernels with their scalar fallbacks.
+       for (bool disable_avx2 : {true, false}) {
+         FLAGS_disable_column_predicate_avx2 = disable_avx2;
+         SelectionVector selvec(kNumRows);
+         int64_t tot_cycles = 0;
+         Stopwatch sw;
+         sw.start();
+         for (int i = 0; i < num_iters; i++) {
+           selvec.SetAllTrue();
+           int64_t cycles_start = CycleClock::Now();
+           pred.Evaluate(b, &selvec);
+           tot_cycles += CycleClock::Now() - cycles_start;
+         }
+         sw.stop();
+         LOG(INFO) << StringPrintf(
+               "%-6s %-10s %-7s (%s) %.1fM evals/sec\t%.2f cycles/eval",
+               TypeParam::name(), nullable ? "NULL" : "NOT NULL",
+               disable_avx2 ? "scalar" : "AVX2",
+               pred.ToString().c_str(),
+               num_evals / sw.elapsed().user_cpu_seconds() / 1000000,
+               static_cast<double>(tot_cycles) / num_evals);
        }
-       sw.stop();
-       LOG(INFO) << StringPrintf(
-             "%-6s %-10s (%s) %.1fM evals/sec\t%.2f cycles/eval",
-             TypeParam::name(), nullable ? "NULL" : "NOT NULL",
-             pred.ToString().c_str(),
-             num_evals / sw.elapsed().user_cpu_seconds() / 1000000,
-             static_cast<double>(tot_cycles) / num_evals);
      }
    }
 };
@@ -1550,6 +1666,7 @@ using test_types = ::testing::Types<
   DataTypeTraits<INT16>,
   DataTypeTraits<INT32>,
   DataTypeTraits<INT64>,
+  DataTypeTraits<UINT32>,
   DataTypeTraits<FLOAT>,
   DataTypeTraits<DOUBLE>>;
 
@@ -1574,6 +1691,14 @@ TYPED_TEST(RangePredicateBenchmark, TestRange) {
       [&](const ColumnSchema& cs) { return ColumnPredicate::Range(cs, &lower, &upper); });
 }
 
+TYPED_TEST(RangePredicateBenchmark, TestInList) {
+  const typename TypeParam::cpp_type values[] = { 0, 2, 5 };
+  RangePredicateBenchmark<TypeParam>::DoTest([&](const ColumnSchema& cs) {
+    vector<const void*> in_list = { &values[0], &values[1], &values[2] };
+    return ColumnPredicate::InList(cs, &in_list);
+  });
+}
+
 // IS NULL and IS NOT NULL predicates don't look at the data itself, so no need
 // to type-parameterize them.
 class NullPredicateBenchmark : public ColumnPredicateBenchmark<DataTypeTraits<INT32>> {};
@@ -24,6 +24,7 @@
 
 #include <boost/optional/optional.hpp>
 
+#include "kudu/common/column_predicate_kernels.h"
 #include "kudu/common/columnblock.h"
 #include "kudu/common/key_util.h"
 #include "kudu/common/rowblock.h"
@@ -687,17 +688,10 @@ int ApplyPredicatePrimitive(const ColumnBlock& block, uint8_t* __restrict__ sel_
 }
 
 
+// Evaluates 'p' on the cells of 'block' from 'start_idx' on, one at a time.
 template <DataType PhysicalType, typename P>
-void ApplyPredicate(const ColumnBlock& block, SelectionVector* sel, P p) {
+void ApplyPredicateFrom(const ColumnBlock& block, size_t start_idx, SelectionVector* sel, P p) {
   using cpp_type = typename DataTypeTraits<PhysicalType>::cpp_type;
-  int start_idx = 0;
-  if (std::is_fundamental<cpp_type>::value) {
-    start_idx = ApplyPredicatePrimitive<PhysicalType>(block, sel->mutable_bitmap(), p);
-    if (PREDICT_TRUE(start_idx == block.nrows())) return;
-    // If we couldn't process the whole block unrolled by 8, fall through to the
-    // remainder.
-  }
-
   const cpp_type* data = reinterpret_cast<const cpp_type*>(block.data());
   if (block.is_nullable()) {
     for (size_t i = start_idx; i < block.nrows(); i++) {
@@ -718,14 +712,86 @@ void ApplyPredicate(const ColumnBlock& block, SelectionVector* sel, P p) {
   }
 }
 
-template<bool IS_NOT_NULL>
-void ApplyNullPredicate(const ColumnBlock& block, uint8_t* __restrict__ sel_vec) {
-  int n_bytes = KUDU_ALIGN_UP(block.nrows(), 8) / 8;
-  for (int i = 0; i < n_bytes; i++) {
-    uint8_t non_null_byte = block.non_null_bitmap()[i];
-    if (!IS_NOT_NULL) non_null_byte = ~non_null_byte;
-    sel_vec[i] &= non_null_byte;
+template <DataType PhysicalType, typename P>
+void ApplyPredicate(const ColumnBlock& block, SelectionVector* sel, P p) {
+  using cpp_type = typename DataTypeTraits<PhysicalType>::cpp_type;
+  int start_idx = 0;
+  if (std::is_fundamental<cpp_type>::value) {
+    start_idx = ApplyPredicatePrimitive<PhysicalType>(block, sel->mutable_bitmap(), p);
+    if (PREDICT_TRUE(start_idx == block.nrows())) return;
+    // If we couldn't process the whole block unrolled by 8, fall through to the
+    // remainder.
   }
+  ApplyPredicateFrom<PhysicalType>(block, start_idx, sel, p);
+}
+
+// Evaluates 'pred' using the ColumnPredicateKernels, which produce the
+// selection bitmap for all but the last few cells of the block directly.
+//
+// Returns false if 'pred' isn't of a kind the kernels evaluate, in which case
+// the caller must evaluate it.
+template <DataType PhysicalType>
+bool ApplyPredicateKernels(const ColumnPredicate& pred, const ColumnBlock& block,
+                           SelectionVector* sel, std::true_type /* has_kernels */) {
+  using cpp_type = typename DataTypeTraits<PhysicalType>::cpp_type;
+  using Kernels = ColumnPredicateKernels<cpp_type>;
+  const cpp_type* data = reinterpret_cast<const cpp_type*>(block.data());
+  const size_t nrows = block.nrows();
+  uint8_t* sel_bitmap = sel->mutable_bitmap();
+
+  size_t start_idx;
+  switch (pred.predicate_type()) {
+    case PredicateType::Range: {
+      const cpp_type* lower = static_cast<const cpp_type*>(pred.raw_lower());
+      const cpp_type* upper = static_cast<const cpp_type*>(pred.raw_upper());
+      if (lower == nullptr) {
+        start_idx = Kernels::EvaluateUpperBound(data, nrows, *upper, sel_bitmap);
+      } else if (upper == nullptr) {
+        start_idx = Kernels::EvaluateLowerBound(data, nrows, *lower, sel_bitmap);
+      } else {
+        start_idx = Kernels::EvaluateRange(data, nrows, *lower, *upper, sel_bitmap);
+      }
+      break;
+    }
+    case PredicateType::Equality: {
+      start_idx = Kernels::EvaluateEquality(
+          data, nrows, *static_cast<const cpp_type*>(pred.raw_lower()), sel_bitmap);
+      break;
+    }
+    case PredicateType::InList: {
+      const auto& raw_values = pred.raw_values();
+      if (raw_values.size() > Kernels::kMaxInListValues) return false;
+      cpp_type values[Kernels::kMaxInListValues];
+      for (size_t i = 0; i < raw_values.size(); i++) {
+        values[i] = *static_cast<const cpp_type*>(raw_values[i]);
+      }
+      start_idx = Kernels::EvaluateInList(data, nrows, values, raw_values.size(), sel_bitmap);
+      break;
+    }
+    default:
+      return false;
+  }
+
+  // The kernels evaluate NULL cells as if they were values, so deselect them.
+  if (block.is_nullable()) {
+    EvaluateNullPredicateKernel(block.non_null_bitmap(), start_idx / 8, /*is_null=*/false,
+                                sel_bitmap);
+  }
+  ApplyPredicateFrom<PhysicalType>(block, start_idx, sel, [&pred] (const void* cell) {
+    return pred.EvaluateCell<PhysicalType>(cell);
+  });
+  return true;
+}
+
+template <DataType PhysicalType>
+bool ApplyPredicateKernels(const ColumnPredicate& /* pred */, const ColumnBlock& /* block */,
+                           SelectionVector* /* sel */, std::false_type /* has_kernels */) {
+  return false;
+}
+
+void ApplyNullPredicate(const ColumnBlock& block, bool is_null, SelectionVector* sel) {
+  EvaluateNullPredicateKernel(block.non_null_bitmap(), KUDU_ALIGN_UP(block.nrows(), 8) / 8,
+                              is_null, sel->mutable_bitmap());
 }
 } // anonymous namespace
 
@@ -735,6 +801,11 @@ void ColumnPredicate::EvaluateForPhysicalType(const ColumnBlock& block,
   using traits = DataTypeTraits<PhysicalType>;
   using cpp_type = typename traits::cpp_type;
 
+  if (ApplyPredicateKernels<PhysicalType>(*this, block, sel,
+                                          HasColumnPredicateKernels<cpp_type>())) {
+    return;
+  }
+
   switch (predicate_type()) {
     case PredicateType::Range: {
       cpp_type local_lower = lower_ ? *static_cast<const cpp_type*>(lower_) : cpp_type();
@@ -765,7 +836,7 @@ void ColumnPredicate::EvaluateForPhysicalType(const ColumnBlock& block,
     };
     case PredicateType::IsNotNull: {
       if (!block.is_nullable()) return;
-      ApplyNullPredicate<true>(block, sel->mutable_bitmap());
+      ApplyNullPredicate(block, /*is_null=*/false, sel);
       return;
     };
     case PredicateType::IsNull: {
@@ -773,7 +844,7 @@ void ColumnPredicate::EvaluateForPhysicalType(const ColumnBlock& block,
         BitmapChangeBits(sel->mutable_bitmap(), 0, block.nrows(), false);
         return;
       }
-      ApplyNullPredicate<false>(block, sel->mutable_bitmap());
+      ApplyNullPredicate(block, /*is_null=*/true, sel);
       return;
     }
     case PredicateType::InList: {
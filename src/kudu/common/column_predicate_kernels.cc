@@ -0,0 +1,207 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/common/column_predicate_kernels.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "kudu/gutil/cpu.h"
+#include "kudu/gutil/port.h"
+#include "kudu/util/flag_tags.h"
+
+DEFINE_bool(disable_column_predicate_avx2, false,
+            "Disable AVX2 operations when evaluating column predicates. This flag has no "
+            "effect if the target CPU doesn't support AVX2 at run-time or Kudu was built "
+            "with a compiler that doesn't support AVX2.");
+TAG_FLAG(disable_column_predicate_avx2, hidden);
+TAG_FLAG(disable_column_predicate_avx2, runtime);
+
+namespace kudu {
+
+namespace column_predicate_internal {
+
+bool UseAvx2() {
+  static const base::CPU kCpu;
+  return !FLAGS_disable_column_predicate_avx2 && kCpu.has_avx2();
+}
+
+} // namespace column_predicate_internal
+
+#ifdef USE_AVX2
+using column_predicate_internal::ColumnPredicateKernelsAvx2;
+#endif
+using column_predicate_internal::UseAvx2;
+
+namespace {
+
+// The scalar comparisons, matching DataTypeTraits::Compare(), which is
+// written in terms of operator<.
+template <typename T>
+struct LowerBoundOp {
+  T lower;
+  bool operator()(T cell) const { return !(cell < lower); }
+};
+
+template <typename T>
+struct UpperBoundOp {
+  T upper;
+  bool operator()(T cell) const { return cell < upper; }
+};
+
+template <typename T>
+struct RangeOp {
+  T lower;
+  T upper;
+  bool operator()(T cell) const { return !(cell < lower) && cell < upper; }
+};
+
+template <typename T>
+struct EqualityOp {
+  T value;
+  bool operator()(T cell) const { return !(cell < value) && !(value < cell); }
+};
+
+template <typename T>
+struct InListOp {
+  const T* values;
+  size_t num_values;
+  bool operator()(T cell) const {
+    bool match = false;
+    for (size_t i = 0; i < num_values; i++) {
+      match |= !(cell < values[i]) && !(values[i] < cell);
+    }
+    return match;
+  }
+};
+
+// Evaluates 'op' over the cells of 'data' eight at a time, building each
+// byte of the bitmap without branches so that compilers may vectorize it.
+template <typename T, typename Op>
+size_t EvaluateScalar(const T* __restrict__ data, size_t n, uint8_t* __restrict__ sel_bitmap,
+                      const Op& op) {
+  const size_t n_chunks = n / 8;
+  for (size_t i = 0; i < n_chunks; i++) {
+    uint8_t res_8 = 0;
+    for (int j = 0; j < 8; j++) {
+      res_8 |= op(*data++) << j;
+    }
+    sel_bitmap[i] &= res_8;
+  }
+  return n_chunks * 8;
+}
+
+} // anonymous namespace
+
+template <typename T>
+constexpr size_t ColumnPredicateKernels<T>::kMaxInListValues;
+
+template <typename T>
+size_t ColumnPredicateKernels<T>::EvaluateLowerBound(const T* data, size_t n, T lower,
+                                                     uint8_t* sel_bitmap) {
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = ColumnPredicateKernelsAvx2<T>::EvaluateLowerBound(data, n, lower, sel_bitmap);
+  }
+#endif
+  return done + EvaluateScalar(data + done, n - done, sel_bitmap + done / 8,
+                               LowerBoundOp<T>{ lower });
+}
+
+template <typename T>
+size_t ColumnPredicateKernels<T>::EvaluateUpperBound(const T* data, size_t n, T upper,
+                                                     uint8_t* sel_bitmap) {
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = ColumnPredicateKernelsAvx2<T>::EvaluateUpperBound(data, n, upper, sel_bitmap);
+  }
+#endif
+  return done + EvaluateScalar(data + done, n - done, sel_bitmap + done / 8,
+                               UpperBoundOp<T>{ upper });
+}
+
+template <typename T>
+size_t ColumnPredicateKernels<T>::EvaluateRange(const T* data, size_t n, T lower, T upper,
+                                                uint8_t* sel_bitmap) {
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = ColumnPredicateKernelsAvx2<T>::EvaluateRange(data, n, lower, upper, sel_bitmap);
+  }
+#endif
+  return done + EvaluateScalar(data + done, n - done, sel_bitmap + done / 8,
+                               RangeOp<T>{ lower, upper });
+}
+
+template <typename T>
+size_t ColumnPredicateKernels<T>::EvaluateEquality(const T* data, size_t n, T value,
+                                                   uint8_t* sel_bitmap) {
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = ColumnPredicateKernelsAvx2<T>::EvaluateEquality(data, n, value, sel_bitmap);
+  }
+#endif
+  return done + EvaluateScalar(data + done, n - done, sel_bitmap + done / 8,
+                               EqualityOp<T>{ value });
+}
+
+template <typename T>
+size_t ColumnPredicateKernels<T>::EvaluateInList(const T* data, size_t n,
+                                                 const T* values, size_t num_values,
+                                                 uint8_t* sel_bitmap) {
+  DCHECK_LE(num_values, kMaxInListValues);
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = ColumnPredicateKernelsAvx2<T>::EvaluateInList(data, n, values, num_values,
+                                                         sel_bitmap);
+  }
+#endif
+  return done + EvaluateScalar(data + done, n - done, sel_bitmap + done / 8,
+                               InListOp<T>{ values, num_values });
+}
+
+void EvaluateNullPredicateKernel(const uint8_t* non_null_bitmap, size_t n_bytes, bool is_null,
+                                 uint8_t* sel_bitmap) {
+  size_t done = 0;
+#ifdef USE_AVX2
+  if (UseAvx2()) {
+    done = column_predicate_internal::EvaluateNullPredicateKernelAvx2(
+        non_null_bitmap, n_bytes, is_null, sel_bitmap);
+  }
+#endif
+  const uint8_t flip = is_null ? 0xff : 0;
+  for (size_t i = done; i < n_bytes; i++) {
+    sel_bitmap[i] &= non_null_bitmap[i] ^ flip;
+  }
+}
+
+template class ColumnPredicateKernels<int8_t>;
+template class ColumnPredicateKernels<uint8_t>;
+template class ColumnPredicateKernels<int16_t>;
+template class ColumnPredicateKernels<uint16_t>;
+template class ColumnPredicateKernels<int32_t>;
+template class ColumnPredicateKernels<uint32_t>;
+template class ColumnPredicateKernels<int64_t>;
+template class ColumnPredicateKernels<uint64_t>;
+template class ColumnPredicateKernels<float>;
+template class ColumnPredicateKernels<double>;
+
+} // namespace kudu
@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace kudu {
+
+// Vectorized kernels used by ColumnPredicate::Evaluate() to evaluate range,
+// equality and small IN-list predicates over blocks of fixed-width cells.
+//
+// Each kernel evaluates a predicate over the cells data[0, n) and ANDs the
+// results into 'sel_bitmap', one bit per cell, without looking at NULLs.
+// Kernels only write whole bytes of the bitmap: they return the number of
+// cells evaluated, a multiple of 8, and leave the rest to the caller.
+//
+// The cells are compared the way DataTypeTraits::Compare() compares them. In
+// particular, a floating point NaN is neither less than nor greater than any
+// other value, so it satisfies a lower bound and equals every value.
+//
+// AVX2 instructions are used if both the compiler and the CPU support them.
+// Otherwise the cells are evaluated eight at a time by scalar code.
+template <typename T>
+class ColumnPredicateKernels {
+ public:
+  // The maximum number of values of an IN-list evaluated by EvaluateInList().
+  // Longer lists are better evaluated with a binary search per cell.
+  static constexpr size_t kMaxInListValues = 8;
+
+  // Evaluates 'lower <= cell'.
+  static size_t EvaluateLowerBound(const T* data, size_t n, T lower, uint8_t* sel_bitmap);
+
+  // Evaluates 'cell < upper'.
+  static size_t EvaluateUpperBound(const T* data, size_t n, T upper, uint8_t* sel_bitmap);
+
+  // Evaluates 'lower <= cell < upper'.
+  static size_t EvaluateRange(const T* data, size_t n, T lower, T upper, uint8_t* sel_bitmap);
+
+  // Evaluates 'cell == value'.
+  static size_t EvaluateEquality(const T* data, size_t n, T value, uint8_t* sel_bitmap);
+
+  // Evaluates 'cell IN (values[0], ..., values[num_values - 1])'. There must be
+  // no more than kMaxInListValues values.
+  static size_t EvaluateInList(const T* data, size_t n, const T* values, size_t num_values,
+                               uint8_t* sel_bitmap);
+};
+
+// Whether ColumnPredicateKernels are implemented for cells of type T: the
+// fixed-width integer and floating point types.
+template <typename T>
+struct HasColumnPredicateKernels : std::integral_constant<bool,
+    std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value ||
+    std::is_same<T, int16_t>::value || std::is_same<T, uint16_t>::value ||
+    std::is_same<T, int32_t>::value || std::is_same<T, uint32_t>::value ||
+    std::is_same<T, int64_t>::value || std::is_same<T, uint64_t>::value ||
+    std::is_same<T, float>::value || std::is_same<T, double>::value> {
+};
+
+// ANDs the 'n_bytes' bytes of the non-NULL bitmap 'non_null_bitmap', or its
+// complement if 'is_null' is true, into 'sel_bitmap'. This evaluates IS NOT
+// NULL and IS NULL predicates.
+void EvaluateNullPredicateKernel(const uint8_t* non_null_bitmap, size_t n_bytes, bool is_null,
+                                 uint8_t* sel_bitmap);
+
+namespace column_predicate_internal {
+
+// Returns true if the AVX2 kernels may be used.
+bool UseAvx2();
+
+#ifdef USE_AVX2
+// The AVX2 implementations of the kernels. They have the same contracts as
+// the kernels above, but evaluate cells 32 at a time.
+template <typename T>
+class ColumnPredicateKernelsAvx2 {
+ public:
+  static size_t EvaluateLowerBound(const T* data, size_t n, T lower, uint8_t* sel_bitmap)
+      __attribute__((target("avx2")));
+  static size_t EvaluateUpperBound(const T* data, size_t n, T upper, uint8_t* sel_bitmap)
+      __attribute__((target("avx2")));
+  static size_t EvaluateRange(const T* data, size_t n, T lower, T upper, uint8_t* sel_bitmap)
+      __attribute__((target("avx2")));
+  static size_t EvaluateEquality(const T* data, size_t n, T value, uint8_t* sel_bitmap)
+      __attribute__((target("avx2")));
+  static size_t EvaluateInList(const T* data, size_t n, const T* values, size_t num_values,
+                               uint8_t* sel_bitmap) __attribute__((target("avx2")));
+};
+
+// Returns the number of bytes processed, a multiple of 32.
+size_t EvaluateNullPredicateKernelAvx2(const uint8_t* non_null_bitmap, size_t n_bytes,
+                                       bool is_null, uint8_t* sel_bitmap)
+    __attribute__((target("avx2")));
+#endif
+
+} // namespace column_predicate_internal
+} // namespace kudu
@@ -24,6 +24,7 @@
 #include <memory>
 #include <ostream>
 #include <random>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -61,6 +62,7 @@
 #include "kudu/util/stopwatch.h"
 #include "kudu/util/test_macros.h"
 #include "kudu/util/test_util.h"
+#include "kudu/util/threadpool.h"
 
 DEFINE_int32(num_lists, 3, "Number of lists to merge");
 DEFINE_int32(num_rows, 1000, "Number of entries per list");
@@ -69,6 +71,7 @@ DECLARE_bool(materializing_iterator_do_pushdown);
 DECLARE_int32(predicate_effectivess_num_skip_blocks);
 
 using std::map;
+using std::multiset;
 using std::pair;
 using std::string;
 using std::unique_ptr;
@@ -506,6 +509,108 @@ TEST(TestMergeIterator, TestDeDupGhostRows) {
                       /*include_deleted_rows=*/true));
 }
 
+// Builds 'num_lists' materializing iterators over consecutive ranges of
+// FLAGS_num_rows integers, with some rows deselected. Returns the selected
+// integers in 'expected'.
+static vector<IterWithBounds> BuildParallelUnionInput(
+    int num_lists, const TestIntRangePredicate& predicate,
+    vector<unique_ptr<SelectionVector>>* svs, multiset<int64_t>* expected) {
+  Random prng(SeedRandom());
+  vector<IterWithBounds> input;
+  for (int i = 0; i < num_lists; i++) {
+    vector<int64_t> ints;
+    unique_ptr<SelectionVector> sv(new SelectionVector(FLAGS_num_rows));
+    for (int j = 0; j < FLAGS_num_rows; j++) {
+      int64_t val = static_cast<int64_t>(i) * FLAGS_num_rows + j;
+      ints.emplace_back(val);
+      bool row_selected = prng.Uniform(8) > 0;
+      if (row_selected) {
+        sv->SetRowSelected(j);
+      } else {
+        sv->SetRowUnselected(j);
+      }
+      if (row_selected && val >= predicate.lower_ && val < predicate.upper_) {
+        expected->insert(val);
+      }
+    }
+    unique_ptr<VectorIterator> vec_it(new VectorIterator(ints));
+    vec_it->set_block_size(prng.Uniform(64) + 1);
+    vec_it->set_selection_vector(sv.get());
+    svs->emplace_back(std::move(sv));
+    IterWithBounds iwb;
+    iwb.iter = NewMaterializingIterator(std::move(vec_it));
+    input.emplace_back(std::move(iwb));
+  }
+  return input;
+}
+
+static void TestParallelUnion(int parallelism, int dst_capacity,
+                              const TestIntRangePredicate& predicate) {
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("scan").set_max_threads(4).Build(&pool));
+
+  vector<unique_ptr<SelectionVector>> svs;
+  multiset<int64_t> expected;
+  unique_ptr<RowwiseIterator> iter(NewParallelUnionIterator(
+      BuildParallelUnionInput(FLAGS_num_lists * 3, predicate, &svs, &expected),
+      pool.get(), parallelism));
+  ScanSpec spec;
+  spec.AddPredicate(predicate.pred_);
+  ASSERT_OK(iter->Init(&spec));
+
+  multiset<int64_t> results;
+  Arena arena(1024);
+  RowBlock dst(&kIntSchema, dst_capacity, &arena);
+  while (iter->HasNext()) {
+    ASSERT_OK(iter->NextBlock(&dst));
+    ASSERT_GT(dst.nrows(), 0) << "if HasNext() returns true, must return some rows";
+    for (int i = 0; i < dst.nrows(); i++) {
+      if (dst.selection_vector()->IsRowSelected(i)) {
+        results.insert(*kIntSchema.ExtractColumnFromRow<INT64>(dst.row(i), kValColIdx));
+      }
+    }
+  }
+  ASSERT_EQ(expected, results);
+}
+
+// Test that a ParallelUnionIterator returns the same rows as its sub-iterators
+// regardless of the parallelism and the size of the caller's blocks.
+TEST(TestParallelUnionIterator, TestUnion) {
+  TestIntRangePredicate match_all(0, MathLimits<int64_t>::kMax);
+  for (int parallelism : { 1, 2, 8 }) {
+    for (int dst_capacity : { 1, 100, 2048 }) {
+      SCOPED_TRACE(Substitute("parallelism $0, block capacity $1",
+                              parallelism, dst_capacity));
+      NO_FATALS(TestParallelUnion(parallelism, dst_capacity, match_all));
+    }
+  }
+}
+
+TEST(TestParallelUnionIterator, TestUnionPredicate) {
+  TestIntRangePredicate predicate(FLAGS_num_rows / 2, FLAGS_num_rows * 2);
+  NO_FATALS(TestParallelUnion(4, 128, predicate));
+}
+
+// Tests that a ParallelUnionIterator destroyed before it's fully consumed
+// stops its scan tasks.
+TEST(TestParallelUnionIterator, TestNotConsumedCleanup) {
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("scan").set_max_threads(4).Build(&pool));
+  TestIntRangePredicate match_all(0, MathLimits<int64_t>::kMax);
+  vector<unique_ptr<SelectionVector>> svs;
+  multiset<int64_t> expected;
+  unique_ptr<RowwiseIterator> iter(NewParallelUnionIterator(
+      BuildParallelUnionInput(10, match_all, &svs, &expected), pool.get(), 4));
+  ASSERT_OK(iter->Init(nullptr));
+  ASSERT_TRUE(iter->HasNext());
+  RowBlock dst(&kIntSchema, 1, nullptr);
+  ASSERT_OK(iter->NextBlock(&dst));
+  ASSERT_EQ(1, dst.nrows());
+
+  // Let the iterator go out of scope with its scan tasks still prefetching.
+  iter.reset();
+}
+
 // Test that the MaterializingIterator properly evaluates predicates when they apply
 // to single columns.
 TEST(TestMaterializingIterator, TestMaterializingPredicatePushdown) {
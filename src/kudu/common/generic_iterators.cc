@@ -57,10 +57,13 @@
 #include "kudu/gutil/port.h"
 #include "kudu/gutil/strings/join.h"
 #include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/condition_variable.h"
 #include "kudu/util/flag_tags.h"
 #include "kudu/util/locks.h"
 #include "kudu/util/memory/arena.h"
+#include "kudu/util/mutex.h"
 #include "kudu/util/object_pool.h"
+#include "kudu/util/threadpool.h"
 
 namespace boost {
 namespace heap {
@@ -83,6 +86,12 @@ DEFINE_bool(materializing_iterator_decoder_eval, true,
             "Should MaterializingIterator do decoder-level evaluation");
 TAG_FLAG(materializing_iterator_decoder_eval, hidden);
 TAG_FLAG(materializing_iterator_decoder_eval, runtime);
+DEFINE_bool(materializing_iterator_late_materialization, true,
+            "Should MaterializingIterator only materialize the rows of a column "
+            "which are still selected after evaluating the predicates on the "
+            "columns before it");
+TAG_FLAG(materializing_iterator_late_materialization, hidden);
+TAG_FLAG(materializing_iterator_late_materialization, runtime);
 
 namespace kudu {
 namespace {
@@ -1115,6 +1124,339 @@ unique_ptr<RowwiseIterator> NewUnionIterator(vector<IterWithBounds> iters) {
   return unique_ptr<RowwiseIterator>(new UnionIterator(std::move(iters)));
 }
 
+////////////////////////////////////////////////////////////
+// ParallelUnionIterator
+////////////////////////////////////////////////////////////
+
+// The number of rows in each block prefetched by a ParallelUnionIterator.
+static const int kParallelUnionRowBuffer = 1024;
+
+// An iterator which, like the UnionIterator, returns the rows of all of its
+// sub-iterators, but scans several of them at once on a thread pool.
+//
+// Each task on the pool claims sub-iterators one at a time and reads their
+// blocks into a fixed set of prefetch buffers, which NextBlock() copies out
+// of. Once all buffers are full, a task pauses its sub-iterator and returns
+// its thread to the pool rather than blocking it; NextBlock() resubmits a
+// task whenever it frees a buffer. This bounds the memory used when the
+// consumer is slow, and keeps idle scanners from starving the shared pool.
+class ParallelUnionIterator : public RowwiseIterator {
+ public:
+  ParallelUnionIterator(vector<IterWithBounds> iters, ThreadPool* pool, int parallelism);
+
+  ~ParallelUnionIterator();
+
+  Status Init(ScanSpec *spec) OVERRIDE;
+
+  bool HasNext() const OVERRIDE;
+
+  string ToString() const OVERRIDE;
+
+  const Schema &schema() const OVERRIDE {
+    CHECK(initted_);
+    return *CHECK_NOTNULL(schema_.get());
+  }
+
+  // Only includes the statistics of sub-iterators which have been fully
+  // scanned, since the others may be in use by the scan tasks.
+  virtual void GetIteratorStats(vector<IteratorStats>* stats) const OVERRIDE;
+
+  virtual Status NextBlock(RowBlock* dst) OVERRIDE;
+
+ private:
+  // A block of rows read from one of the sub-iterators.
+  struct PrefetchBuffer {
+    explicit PrefetchBuffer(const Schema* schema)
+        : arena(32 * 1024),
+          block(schema, kParallelUnionRowBuffer, &arena) {
+    }
+
+    Arena arena;
+    RowBlock block;
+  };
+
+  // Reads blocks from paused or unclaimed sub-iterators until there are none
+  // left, all buffers are full, the iterator is being destroyed, or a scan
+  // fails.
+  void ScanTask();
+
+  // Submits another scan task if fewer than 'max_tasks_' are running and
+  // there are sub-iterators left to scan. 'lock_' must be held.
+  void MaybeSubmitScanTaskUnlocked();
+
+  // Waits until there's a prefetched block to return, all scan tasks have
+  // finished, or a scan has failed. 'lock_' must be held.
+  void WaitForPrefetchedBlockUnlocked() const;
+
+  vector<IterWithBounds> iters_;
+  ThreadPool* const pool_;
+  const int parallelism_;
+
+  // The maximum number of concurrent scan tasks: initialized during Init().
+  int max_tasks_;
+
+  // Schema: initialized during Init()
+  unique_ptr<Schema> schema_;
+
+  bool initted_;
+
+  // See UnionIterator::scan_spec_copies_.
+  ObjectPool<ScanSpec> scan_spec_copies_;
+
+  // The scan tasks are submitted via this token, so that the destructor can
+  // wait for them.
+  unique_ptr<ThreadPoolToken> token_;
+
+  // Protects the state below, and is signaled whenever it changes.
+  mutable Mutex lock_;
+  mutable ConditionVariable cond_;
+
+  // The index in 'iters_' of the next sub-iterator to be scanned.
+  size_t next_iter_idx_;
+
+  // Sub-iterators which a scan task started but paused because all buffers
+  // were full.
+  vector<RowwiseIterator*> paused_iters_;
+
+  // The number of scan tasks which haven't finished yet.
+  int num_running_tasks_;
+
+  // Set by the destructor to make the scan tasks finish early.
+  bool stopping_;
+
+  // The first error hit by a scan task.
+  Status status_;
+
+  // Buffers holding prefetched rows, in the order they were read, and buffers
+  // ready to be read into.
+  deque<unique_ptr<PrefetchBuffer>> prefetched_;
+  vector<unique_ptr<PrefetchBuffer>> free_buffers_;
+
+  // Statistics (keyed by projection column index) accumulated so far by any
+  // fully-scanned sub-iterators.
+  vector<IteratorStats> finished_iter_stats_by_col_;
+
+  // The buffer rows are currently being returned from, and the index of the
+  // next row to return. Only used by the thread calling NextBlock().
+  unique_ptr<PrefetchBuffer> cur_buffer_;
+  size_t cur_row_idx_;
+};
+
+ParallelUnionIterator::ParallelUnionIterator(vector<IterWithBounds> iters,
+                                             ThreadPool* pool,
+                                             int parallelism)
+  : iters_(std::move(iters)),
+    pool_(pool),
+    parallelism_(parallelism),
+    max_tasks_(0),
+    initted_(false),
+    cond_(&lock_),
+    next_iter_idx_(0),
+    num_running_tasks_(0),
+    stopping_(false),
+    cur_row_idx_(0) {
+  CHECK_GT(iters_.size(), 0);
+  CHECK_GT(parallelism_, 0);
+}
+
+ParallelUnionIterator::~ParallelUnionIterator() {
+  {
+    MutexLock l(lock_);
+    stopping_ = true;
+    cond_.Broadcast();
+  }
+  // Wait for the scan tasks, which use the sub-iterators and buffers.
+  if (token_) {
+    token_->Shutdown();
+  }
+}
+
+Status ParallelUnionIterator::Init(ScanSpec *spec) {
+  CHECK(!initted_);
+
+  // Initialize the underlying iterators as the UnionIterator does.
+  for (auto& i : iters_) {
+    ScanSpec *spec_copy = spec != nullptr ? scan_spec_copies_.Construct(*spec) : nullptr;
+    RETURN_NOT_OK(InitAndMaybeWrap(&i.iter, spec_copy));
+    i.encoded_bounds.reset();
+  }
+  if (spec != nullptr) {
+    spec->RemovePredicates();
+  }
+
+  schema_.reset(new Schema(iters_.front().iter->schema()));
+  finished_iter_stats_by_col_.resize(schema_->num_columns());
+#ifndef NDEBUG
+  for (const auto& i : iters_) {
+    if (!i.iter->schema().Equals(*schema_)) {
+      return Status::InvalidArgument(
+          Substitute("Schemas do not match: $0 vs. $1",
+                     schema_->ToString(), i.iter->schema().ToString()));
+    }
+  }
+#endif
+
+  // Two buffers per task let each task read a block while the previous one is
+  // waiting to be returned.
+  max_tasks_ = std::min<int>(parallelism_, iters_.size());
+  for (int i = 0; i < 2 * max_tasks_; i++) {
+    free_buffers_.emplace_back(new PrefetchBuffer(schema_.get()));
+  }
+  initted_ = true;
+
+  token_ = pool_->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+  MutexLock l(lock_);
+  for (int i = 0; i < max_tasks_; i++) {
+    MaybeSubmitScanTaskUnlocked();
+  }
+  return status_;
+}
+
+void ParallelUnionIterator::MaybeSubmitScanTaskUnlocked() {
+  lock_.AssertAcquired();
+  if (num_running_tasks_ == max_tasks_ || stopping_ || !status_.ok() ||
+      (paused_iters_.empty() && next_iter_idx_ == iters_.size())) {
+    return;
+  }
+  Status s = token_->Submit([this]() { this->ScanTask(); });
+  if (PREDICT_FALSE(!s.ok())) {
+    status_ = s.CloneAndPrepend("unable to submit scan task");
+    return;
+  }
+  num_running_tasks_++;
+}
+
+void ParallelUnionIterator::ScanTask() {
+  RowwiseIterator* iter = nullptr;
+  MutexLock l(lock_);
+  while (!stopping_ && status_.ok()) {
+    if (!iter) {
+      if (!paused_iters_.empty()) {
+        iter = paused_iters_.back();
+        paused_iters_.pop_back();
+      } else if (next_iter_idx_ < iters_.size()) {
+        iter = iters_[next_iter_idx_++].iter.get();
+        if (!iter->HasNext()) {
+          AddIterStats(*iter, &finished_iter_stats_by_col_);
+          iter = nullptr;
+          continue;
+        }
+      } else {
+        break;
+      }
+    }
+    if (free_buffers_.empty()) {
+      paused_iters_.push_back(iter);
+      iter = nullptr;
+      break;
+    }
+    unique_ptr<PrefetchBuffer> buf = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+
+    // Read the block without holding the lock.
+    l.Unlock();
+    buf->arena.Reset();
+    Status s = iter->NextBlock(&buf->block);
+    bool iter_done = !s.ok() || !iter->HasNext();
+    l.Lock();
+
+    if (s.ok() && buf->block.selection_vector()->AnySelected()) {
+      prefetched_.emplace_back(std::move(buf));
+      cond_.Broadcast();
+    } else {
+      free_buffers_.emplace_back(std::move(buf));
+    }
+    if (PREDICT_FALSE(!s.ok() && status_.ok())) {
+      status_ = s;
+    }
+    if (iter_done) {
+      AddIterStats(*iter, &finished_iter_stats_by_col_);
+      iter = nullptr;
+    }
+  }
+  if (iter) {
+    paused_iters_.push_back(iter);
+  }
+  num_running_tasks_--;
+  cond_.Broadcast();
+}
+
+void ParallelUnionIterator::WaitForPrefetchedBlockUnlocked() const {
+  lock_.AssertAcquired();
+  while (prefetched_.empty() && num_running_tasks_ > 0 && status_.ok()) {
+    cond_.Wait();
+  }
+}
+
+bool ParallelUnionIterator::HasNext() const {
+  CHECK(initted_);
+  if (cur_buffer_) {
+    return true;
+  }
+  MutexLock l(lock_);
+  WaitForPrefetchedBlockUnlocked();
+  // On failure, NextBlock() returns the error.
+  return !prefetched_.empty() || !status_.ok();
+}
+
+Status ParallelUnionIterator::NextBlock(RowBlock* dst) {
+  CHECK(initted_);
+  if (!cur_buffer_) {
+    MutexLock l(lock_);
+    WaitForPrefetchedBlockUnlocked();
+    RETURN_NOT_OK(status_);
+    if (prefetched_.empty()) {
+      dst->Resize(0);
+      return Status::OK();
+    }
+    cur_buffer_ = std::move(prefetched_.front());
+    prefetched_.pop_front();
+    cur_row_idx_ = 0;
+  }
+
+  if (dst->arena()) {
+    dst->arena()->Reset();
+  }
+
+  // 'dst' may be smaller than the prefetched block, in which case the rest of
+  // it is returned by the following calls.
+  const RowBlock& src = cur_buffer_->block;
+  size_t num_rows = std::min(dst->row_capacity(), src.nrows() - cur_row_idx_);
+  dst->Resize(num_rows);
+  RETURN_NOT_OK(src.CopyTo(dst, cur_row_idx_, 0, num_rows));
+  cur_row_idx_ += num_rows;
+
+  if (cur_row_idx_ == src.nrows()) {
+    MutexLock l(lock_);
+    free_buffers_.emplace_back(std::move(cur_buffer_));
+    MaybeSubmitScanTaskUnlocked();
+  }
+  return Status::OK();
+}
+
+string ParallelUnionIterator::ToString() const {
+  string s;
+  s.append(Substitute("ParallelUnion[$0](", parallelism_));
+  s += JoinMapped(iters_, [](const IterWithBounds& i) {
+      return i.iter->ToString();
+    }, ",");
+  s.append(")");
+  return s;
+}
+
+void ParallelUnionIterator::GetIteratorStats(vector<IteratorStats>* stats) const {
+  CHECK(initted_);
+  MutexLock l(lock_);
+  *stats = finished_iter_stats_by_col_;
+}
+
+unique_ptr<RowwiseIterator> NewParallelUnionIterator(vector<IterWithBounds> iters,
+                                                     ThreadPool* pool,
+                                                     int parallelism) {
+  return unique_ptr<RowwiseIterator>(
+      new ParallelUnionIterator(std::move(iters), pool, parallelism));
+}
+
 ////////////////////////////////////////////////////////////
 // MaterializingIterator
 ////////////////////////////////////////////////////////////
@@ -1264,6 +1606,10 @@ Status MaterializingIterator::MaterializeBlock(RowBlock *dst) {
     return Status::OK();
   }
 
+  // Once a column has been filtered by a predicate, the other columns only
+  // need to be materialized for the rows which are still selected.
+  const bool late_materialization = FLAGS_materializing_iterator_late_materialization;
+
   predicates_effectiveness_ctx_.IncrementNextBlockCount();
   for (int i = 0; i < col_idx_predicates_.size(); i++) {
     const auto& col_pred = col_idx_predicates_[i];
@@ -1295,6 +1641,9 @@ Status MaterializingIterator::MaterializeBlock(RowBlock *dst) {
       // evaluation.
       ctx.SetDecoderEvalNotSupported();
     }
+    if (late_materialization) {
+      ctx.SetSkipUnselectedRows();
+    }
 
     // Determine the number of rows filtered out by this predicate, if disableable.
     //
@@ -1334,6 +1683,9 @@ Status MaterializingIterator::MaterializeBlock(RowBlock *dst) {
                                      nullptr,
                                      &dst_col,
                                      dst->selection_vector());
+    if (late_materialization) {
+      ctx.SetSkipUnselectedRows();
+    }
     RETURN_NOT_OK(iter_->MaterializeColumn(&ctx));
   }
 
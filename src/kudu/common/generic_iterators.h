@@ -30,6 +30,7 @@ namespace kudu {
 
 class ColumnPredicate;
 class ScanSpec;
+class ThreadPool;
 
 // Encapsulates a rowwise-iterator along with the (encoded) lower and upper
 // bounds for the rowset that the iterator belongs to.
@@ -63,6 +64,16 @@ std::unique_ptr<RowwiseIterator> NewMergeIterator(
 // The iterators must have matching schemas and should not yet be initialized.
 std::unique_ptr<RowwiseIterator> NewUnionIterator(std::vector<IterWithBounds> iters);
 
+// Constructs a ParallelUnionIterator of the given iterators, which scans up to
+// 'parallelism' of them at a time on 'pool' and prefetches their rows. Like a
+// UnionIterator, it returns rows in no particular order.
+//
+// The iterators must have matching schemas and should not yet be initialized.
+// 'pool' must outlive the returned iterator.
+std::unique_ptr<RowwiseIterator> NewParallelUnionIterator(std::vector<IterWithBounds> iters,
+                                                          ThreadPool* pool,
+                                                          int parallelism);
+
 // Constructs a MaterializingIterator of the given ColumnwiseIterator.
 std::unique_ptr<RowwiseIterator> NewMaterializingIterator(
     std::unique_ptr<ColumnwiseIterator> iter);
@@ -30,12 +30,17 @@ IteratorStats::IteratorStats()
     : cells_read(0),
       bytes_read(0),
       blocks_read(0),
-      predicates_disabled(0) {
+      predicates_disabled(0),
+      readahead_hits(0),
+      readahead_misses(0),
+      readahead_wasted(0) {
 }
 
 string IteratorStats::ToString() const {
-  return Substitute("cells_read=$0 bytes_read=$1 blocks_read=$2 predicates_disabled=$3",
-                    cells_read, bytes_read, blocks_read, predicates_disabled);
+  return Substitute("cells_read=$0 bytes_read=$1 blocks_read=$2 predicates_disabled=$3 "
+                    "readahead_hits=$4 readahead_misses=$5 readahead_wasted=$6",
+                    cells_read, bytes_read, blocks_read, predicates_disabled,
+                    readahead_hits, readahead_misses, readahead_wasted);
 }
 
 IteratorStats& IteratorStats::operator+=(const IteratorStats& other) {
@@ -43,6 +48,9 @@ IteratorStats& IteratorStats::operator+=(const IteratorStats& other) {
   bytes_read += other.bytes_read;
   blocks_read += other.blocks_read;
   predicates_disabled += other.predicates_disabled;
+  readahead_hits += other.readahead_hits;
+  readahead_misses += other.readahead_misses;
+  readahead_wasted += other.readahead_wasted;
   DCheckNonNegative();
   return *this;
 }
@@ -52,6 +60,9 @@ IteratorStats& IteratorStats::operator-=(const IteratorStats& other) {
   bytes_read -= other.bytes_read;
   blocks_read -= other.blocks_read;
   predicates_disabled -= other.predicates_disabled;
+  readahead_hits -= other.readahead_hits;
+  readahead_misses -= other.readahead_misses;
+  readahead_wasted -= other.readahead_wasted;
   DCheckNonNegative();
   return *this;
 }
@@ -73,5 +84,8 @@ void IteratorStats::DCheckNonNegative() const {
   DCHECK_GE(bytes_read, 0);
   DCHECK_GE(blocks_read, 0);
   DCHECK_GE(predicates_disabled, 0);
+  DCHECK_GE(readahead_hits, 0);
+  DCHECK_GE(readahead_misses, 0);
+  DCHECK_GE(readahead_wasted, 0);
 }
 } // namespace kudu
@@ -43,6 +43,18 @@ struct IteratorStats {
   // Using an integer helps the stat work well when aggregating or computing delta.
   int64_t predicates_disabled;
 
+  // The number of CFile data blocks which were read ahead of the scan and then
+  // used by it.
+  int64_t readahead_hits;
+
+  // The number of CFile data blocks which had to be read synchronously while
+  // readahead was enabled, because they hadn't been read ahead.
+  int64_t readahead_misses;
+
+  // The number of CFile data blocks which were read ahead but never used, for
+  // example because the scan seeked elsewhere or stopped early.
+  int64_t readahead_wasted;
+
   // Add statistics contained 'other' to this object (for each field
   // in this object, increment it by the value of the equivalent field
   // in 'other').
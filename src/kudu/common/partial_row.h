@@ -43,6 +43,7 @@ namespace kudu {
 class ColumnSchema;
 namespace client {
 class ClientTest_TestProjectionPredicatesFuzz_Test;
+class KuduSession;
 class KuduWriteOperation;
 namespace internal {
 class WriteRpc;
@@ -592,10 +593,13 @@ class KUDU_EXPORT KuduPartialRow {
   const Schema* schema() const { return schema_; }
 
  private:
+  friend class client::KuduSession;          // for Set().
   friend class client::KuduWriteOperation;   // for row_data_.
   friend class client::internal::WriteRpc;   // for row_data_.
+  friend class ColumnarRowOperationsPBEncoder;
   friend class KeyUtilTest;
   friend class PartitionSchema;
+  friend class RowAggregator;
   friend class RowOperationsPBDecoder;
   friend class RowOperationsPBEncoder;
   friend class tools::TableScanner;
@@ -0,0 +1,358 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/common/row_aggregator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "kudu/common/common.pb.h"
+#include "kudu/common/partial_row.h"
+#include "kudu/common/rowblock.h"
+#include "kudu/common/schema.h"
+#include "kudu/gutil/map-util.h"
+#include "kudu/util/memory/arena.h"
+#include "kudu/util/slice.h"
+#include "kudu/util/status.h"
+#include "kudu/util/test_macros.h"
+#include "kudu/util/test_util.h"
+
+using std::map;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace kudu {
+
+class RowAggregatorTest : public KuduTest {
+ public:
+  RowAggregatorTest()
+      : schema_({ ColumnSchema("key", INT32),
+                  ColumnSchema("grp", STRING, /* is_nullable=*/true),
+                  ColumnSchema("val", INT64, /* is_nullable=*/true),
+                  ColumnSchema("dbl", DOUBLE) },
+                1),
+        arena_(4096) {
+  }
+
+ protected:
+  // Fills 'block' with rows where 'grp' cycles through "a", "b" and NULL,
+  // 'val' is the row index or NULL for every fifth row, and every seventh
+  // row is unselected.
+  void FillBlock(RowBlock* block, int start) {
+    static const char* const kGroups[] = { "a", "b", nullptr };
+    block->selection_vector()->SetAllTrue();
+    for (int i = 0; i < block->nrows(); i++) {
+      const int key = start + i;
+      RowBlockRow row = block->row(i);
+      *reinterpret_cast<int32_t*>(row.mutable_cell_ptr(0)) = key;
+      const char* grp = kGroups[key % 3];
+      row.cell(1).set_null(grp == nullptr);
+      if (grp) {
+        CHECK(arena_.RelocateSlice(grp, reinterpret_cast<Slice*>(row.mutable_cell_ptr(1))));
+      }
+      row.cell(2).set_null(key % 5 == 0);
+      *reinterpret_cast<int64_t*>(row.mutable_cell_ptr(2)) = key;
+      *reinterpret_cast<double*>(row.mutable_cell_ptr(3)) = key / 2.0;
+      if (key % 7 == 0) {
+        block->selection_vector()->SetRowUnselected(i);
+      }
+    }
+  }
+
+  static AggregationSpecPB MakeSpec(const vector<string>& group_by) {
+    AggregationSpecPB spec;
+    for (const auto& col : group_by) {
+      spec.add_group_by_columns(col);
+    }
+    spec.add_aggregates()->set_function(AggregatePB::COUNT);
+    auto* agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::COUNT);
+    agg->set_column("val");
+    agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::SUM);
+    agg->set_column("val");
+    agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::MIN);
+    agg->set_column("val");
+    agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::MAX);
+    agg->set_column("dbl");
+    return spec;
+  }
+
+  Schema schema_;
+  Arena arena_;
+};
+
+TEST_F(RowAggregatorTest, TestInvalidSpecs) {
+  unique_ptr<RowAggregator> agg;
+  AggregationSpecPB spec;
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+
+  spec = MakeSpec({ "missing" });
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+
+  spec = MakeSpec({ "grp", "grp" });
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+
+  spec = MakeSpec({});
+  auto* sum = spec.add_aggregates();
+  sum->set_function(AggregatePB::SUM);
+  sum->set_column("grp");
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+
+  spec = MakeSpec({});
+  spec.add_aggregates()->set_function(AggregatePB::MIN);
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+
+  // Duplicate aggregates yield duplicate result column names.
+  spec = MakeSpec({});
+  spec.add_aggregates()->set_function(AggregatePB::COUNT);
+  ASSERT_TRUE(RowAggregator::Create(spec, schema_, &agg).IsInvalidArgument());
+  ASSERT_TRUE(RowAggregator::Validate(spec, schema_).IsInvalidArgument());
+
+  // Validate() accepts what Create() accepts.
+  spec = MakeSpec({ "grp" });
+  ASSERT_OK(RowAggregator::Validate(spec, schema_));
+  ASSERT_OK(RowAggregator::Create(spec, schema_, &agg));
+}
+
+// Without grouping, aggregating an empty input yields a single row.
+TEST_F(RowAggregatorTest, TestEmptyInput) {
+  unique_ptr<RowAggregator> agg;
+  ASSERT_OK(RowAggregator::Create(MakeSpec({}), schema_, &agg));
+  vector<KuduPartialRow> rows;
+  ASSERT_OK(agg->GetResultRows(&rows));
+  ASSERT_EQ(1, rows.size());
+  int64_t count;
+  ASSERT_OK(rows[0].GetInt64(0, &count));
+  ASSERT_EQ(0, count);
+  ASSERT_OK(rows[0].GetInt64(1, &count));
+  ASSERT_EQ(0, count);
+  ASSERT_TRUE(rows[0].IsNull(2));
+  ASSERT_TRUE(rows[0].IsNull(3));
+  ASSERT_TRUE(rows[0].IsNull(4));
+
+  // The rows refer to the result schema of the aggregator.
+  rows.clear();
+  ASSERT_OK(RowAggregator::Create(MakeSpec({ "grp" }), schema_, &agg));
+  ASSERT_OK(agg->GetResultRows(&rows));
+  ASSERT_TRUE(rows.empty());
+}
+
+// Aggregates several blocks split across multiple partial aggregators and
+// checks that the merged result matches a row-by-row computation.
+TEST_F(RowAggregatorTest, TestGroupByAndMerge) {
+  const AggregationSpecPB spec = MakeSpec({ "grp" });
+  const int kNumBlocks = 4;
+  const int kRowsPerBlock = 100;
+
+  struct Expected {
+    int64_t count = 0;
+    int64_t count_val = 0;
+    int64_t sum_val = 0;
+    int64_t min_val = INT64_MAX;
+    double max_dbl = -1;
+  };
+  map<string, Expected> expected;
+
+  unique_ptr<RowAggregator> merged;
+  ASSERT_OK(RowAggregator::Create(spec, schema_, &merged));
+  for (int b = 0; b < kNumBlocks; b++) {
+    unique_ptr<RowAggregator> partial;
+    ASSERT_OK(RowAggregator::Create(spec, schema_, &partial));
+    RowBlock block(&schema_, kRowsPerBlock, &arena_);
+    FillBlock(&block, b * kRowsPerBlock);
+    partial->AddRowBlock(block);
+
+    for (int i = 0; i < kRowsPerBlock; i++) {
+      if (!block.selection_vector()->IsRowSelected(i)) continue;
+      const RowBlockRow row = block.row(i);
+      const string grp = row.is_null(1) ? "<null>" :
+          reinterpret_cast<const Slice*>(row.cell_ptr(1))->ToString();
+      Expected& e = expected[grp];
+      e.count++;
+      if (!row.is_null(2)) {
+        int64_t v = *reinterpret_cast<const int64_t*>(row.cell_ptr(2));
+        e.count_val++;
+        e.sum_val += v;
+        e.min_val = std::min(e.min_val, v);
+      }
+      e.max_dbl = std::max(e.max_dbl, *reinterpret_cast<const double*>(row.cell_ptr(3)));
+    }
+
+    AggregateResultPB pb;
+    partial->TakeResultPB(&pb);
+    ASSERT_EQ(0, partial->num_groups());
+    ASSERT_OK(merged->MergeFromPB(pb));
+  }
+
+  vector<KuduPartialRow> rows;
+  ASSERT_OK(merged->GetResultRows(&rows));
+  ASSERT_EQ(expected.size(), rows.size());
+  for (const auto& row : rows) {
+    string grp = "<null>";
+    if (!row.IsNull(0)) {
+      Slice s;
+      ASSERT_OK(row.GetString(0, &s));
+      grp = s.ToString();
+    }
+    SCOPED_TRACE(grp);
+    const Expected& e = FindOrDie(expected, grp);
+    int64_t v;
+    ASSERT_OK(row.GetInt64("count(*)", &v));
+    ASSERT_EQ(e.count, v);
+    ASSERT_OK(row.GetInt64("count(val)", &v));
+    ASSERT_EQ(e.count_val, v);
+    ASSERT_OK(row.GetInt64("sum(val)", &v));
+    ASSERT_EQ(e.sum_val, v);
+    ASSERT_OK(row.GetInt64("min(val)", &v));
+    ASSERT_EQ(e.min_val, v);
+    double d;
+    ASSERT_OK(row.GetDouble("max(dbl)", &d));
+    ASSERT_EQ(e.max_dbl, d);
+  }
+}
+
+// NaN orders after every other value for MIN and MAX, wherever it appears in
+// the input and whether the values are folded directly or merged.
+TEST_F(RowAggregatorTest, TestMinMaxWithNaN) {
+  const double kNaN = std::numeric_limits<double>::quiet_NaN();
+  const vector<vector<double>> kInputs = {
+    { kNaN, 2, 1 },
+    { 2, kNaN, 1 },
+    { 2, 1, kNaN },
+    { kNaN, kNaN },
+  };
+  for (const auto& group_by : vector<vector<string>>{ {}, { "grp" } }) {
+    AggregationSpecPB spec;
+    for (const auto& col : group_by) {
+      spec.add_group_by_columns(col);
+    }
+    auto* agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::MIN);
+    agg->set_column("dbl");
+    agg = spec.add_aggregates();
+    agg->set_function(AggregatePB::MAX);
+    agg->set_column("dbl");
+    const int min_idx = group_by.size();
+
+    // Fills 'block' with rows of the "a" group whose 'dbl' cells are 'values'.
+    auto fill_block = [&](const vector<double>& values, RowBlock* block) {
+      FillBlock(block, 1);
+      block->selection_vector()->SetAllTrue();
+      for (size_t i = 0; i < values.size(); i++) {
+        RowBlockRow row = block->row(i);
+        row.cell(1).set_null(false);
+        CHECK(arena_.RelocateSlice("a", reinterpret_cast<Slice*>(row.mutable_cell_ptr(1))));
+        *reinterpret_cast<double*>(row.mutable_cell_ptr(3)) = values[i];
+      }
+    };
+
+    for (const auto& input : kInputs) {
+      // Fold all the values into one aggregator, and merge the results of
+      // one aggregator per value into another one.
+      unique_ptr<RowAggregator> folded;
+      ASSERT_OK(RowAggregator::Create(spec, schema_, &folded));
+      RowBlock block(&schema_, input.size(), &arena_);
+      fill_block(input, &block);
+      folded->AddRowBlock(block);
+
+      unique_ptr<RowAggregator> merged;
+      ASSERT_OK(RowAggregator::Create(spec, schema_, &merged));
+      for (double v : input) {
+        unique_ptr<RowAggregator> partial;
+        ASSERT_OK(RowAggregator::Create(spec, schema_, &partial));
+        RowBlock single(&schema_, 1, &arena_);
+        fill_block({ v }, &single);
+        partial->AddRowBlock(single);
+        AggregateResultPB pb;
+        partial->TakeResultPB(&pb);
+        ASSERT_OK(merged->MergeFromPB(pb));
+      }
+
+      const bool all_nan = std::all_of(input.begin(), input.end(),
+                                       [](double d) { return std::isnan(d); });
+      for (const auto* result : { folded.get(), merged.get() }) {
+        vector<KuduPartialRow> rows;
+        ASSERT_OK(result->GetResultRows(&rows));
+        ASSERT_EQ(1, rows.size());
+        double min;
+        ASSERT_OK(rows[0].GetDouble(min_idx, &min));
+        double max;
+        ASSERT_OK(rows[0].GetDouble(min_idx + 1, &max));
+        if (all_nan) {
+          ASSERT_TRUE(std::isnan(min));
+        } else {
+          ASSERT_EQ(1, min);
+        }
+        ASSERT_TRUE(std::isnan(max));
+      }
+    }
+  }
+}
+
+// The estimated result size must account for the BINARY MIN and MAX values.
+TEST_F(RowAggregatorTest, TestResultSizeWithBinaryValues) {
+  AggregationSpecPB spec;
+  spec.add_group_by_columns("key");
+  auto* agg = spec.add_aggregates();
+  agg->set_function(AggregatePB::MAX);
+  agg->set_column("grp");
+  unique_ptr<RowAggregator> aggregator;
+  ASSERT_OK(RowAggregator::Create(spec, schema_, &aggregator));
+
+  const int kNumRows = 100;
+  const string kValue(1000, 'x');
+  RowBlock block(&schema_, kNumRows, &arena_);
+  FillBlock(&block, 0);
+  block.selection_vector()->SetAllTrue();
+  for (int i = 0; i < kNumRows; i++) {
+    RowBlockRow row = block.row(i);
+    row.cell(1).set_null(false);
+    CHECK(arena_.RelocateSlice(kValue, reinterpret_cast<Slice*>(row.mutable_cell_ptr(1))));
+  }
+  aggregator->AddRowBlock(block);
+
+  const size_t estimate = aggregator->ResultSizeBytes();
+  ASSERT_GT(estimate, kNumRows * kValue.size());
+  AggregateResultPB pb;
+  aggregator->TakeResultPB(&pb);
+  ASSERT_GE(estimate, pb.ByteSizeLong());
+  ASSERT_EQ(0, aggregator->ResultSizeBytes());
+}
+
+// Partial results must match the aggregation spec they are merged into.
+TEST_F(RowAggregatorTest, TestMergeMismatchedResult) {
+  unique_ptr<RowAggregator> agg;
+  ASSERT_OK(RowAggregator::Create(MakeSpec({ "grp" }), schema_, &agg));
+  AggregateResultPB pb;
+  pb.add_groups()->add_keys()->set_value("a");
+  ASSERT_TRUE(agg->MergeFromPB(pb).IsInvalidArgument());
+}
+
+} // namespace kudu
@@ -0,0 +1,679 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "kudu/common/row_aggregator.h"
+
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include <glog/logging.h>
+
+#include "kudu/common/columnblock.h"
+#include "kudu/common/partial_row.h"
+#include "kudu/common/rowblock.h"
+#include "kudu/common/types.h"
+#include "kudu/gutil/map-util.h"
+#include "kudu/gutil/port.h"
+#include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/bitmap.h"
+#include "kudu/util/slice.h"
+
+using std::string;
+using std::unique_ptr;
+using std::unordered_set;
+using std::vector;
+using strings::Substitute;
+
+namespace kudu {
+
+namespace {
+
+const char* FunctionName(AggregatePB::Function function) {
+  switch (function) {
+    case AggregatePB::COUNT: return "count";
+    case AggregatePB::SUM: return "sum";
+    case AggregatePB::MIN: return "min";
+    case AggregatePB::MAX: return "max";
+    default: return "unknown";
+  }
+}
+
+bool IsSummable(DataType type) {
+  switch (type) {
+    case INT8:
+    case INT16:
+    case INT32:
+    case INT64:
+    case FLOAT:
+    case DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsFloatingPoint(DataType physical_type) {
+  return physical_type == FLOAT || physical_type == DOUBLE;
+}
+
+// Returns whether 'a' orders before 'b' for MIN and MAX. NaN orders after
+// every other value and equal to itself, as in most SQL engines, so that the
+// result doesn't depend on the order in which the values are folded.
+template<typename CppType>
+bool MinMaxLess(CppType a, CppType b) {
+  if (std::is_floating_point<CppType>::value && std::isnan(b)) {
+    return !std::isnan(a);
+  }
+  return a < b;
+}
+
+template<typename CppType>
+int MinMaxCompare(const void* lhs, const void* rhs) {
+  const CppType a = UnalignedLoad<CppType>(lhs);
+  const CppType b = UnalignedLoad<CppType>(rhs);
+  if (MinMaxLess(a, b)) {
+    return -1;
+  }
+  return MinMaxLess(b, a) ? 1 : 0;
+}
+
+// Like TypeInfo::Compare(), but with the MIN and MAX ordering of NaN.
+int MinMaxCompare(const TypeInfo* type, const void* lhs, const void* rhs) {
+  switch (type->physical_type()) {
+    case FLOAT:
+      return MinMaxCompare<float>(lhs, rhs);
+    case DOUBLE:
+      return MinMaxCompare<double>(lhs, rhs);
+    default:
+      return type->Compare(lhs, rhs);
+  }
+}
+
+// Integer sums wrap around on overflow rather than invoking undefined behavior.
+inline int64_t AddToSum(int64_t sum, int64_t v) {
+  return static_cast<int64_t>(static_cast<uint64_t>(sum) + static_cast<uint64_t>(v));
+}
+
+inline double AddToSum(double sum, double v) {
+  return sum + v;
+}
+
+// Calls 'func(i, value)' for the i-th selected row of 'cb', for each selected
+// row whose cell is not NULL.
+template<typename CppType, typename F>
+void ForEachNonNullCell(const ColumnBlock& cb, const vector<uint16_t>& sel_rows, F func) {
+  const CppType* data = reinterpret_cast<const CppType*>(cb.data());
+  const size_t n_sel = sel_rows.size();
+  if (!cb.is_nullable()) {
+    for (size_t i = 0; i < n_sel; i++) {
+      func(i, data[sel_rows[i]]);
+    }
+    return;
+  }
+  const uint8_t* non_null_bitmap = cb.non_null_bitmap();
+  for (size_t i = 0; i < n_sel; i++) {
+    const uint16_t row = sel_rows[i];
+    if (BitmapTest(non_null_bitmap, row)) {
+      func(i, data[row]);
+    }
+  }
+}
+
+// Appends a group-by cell to an encoded group key. For BINARY physical types
+// 'data' and 'size' refer to the referenced data, and otherwise to the
+// in-memory cell. The encoding is unambiguous, but not order-preserving.
+void AppendKeyCell(bool is_null, bool is_binary, const void* data, size_t size,
+                   string* key) {
+  if (is_null) {
+    key->push_back('\0');
+    return;
+  }
+  key->push_back('\1');
+  if (is_binary) {
+    uint32_t len = size;
+    key->append(reinterpret_cast<const char*>(&len), sizeof(len));
+  }
+  key->append(reinterpret_cast<const char*>(data), size);
+}
+
+} // anonymous namespace
+
+RowAggregator::RowAggregator(Schema input_schema)
+    : input_schema_(std::move(input_schema)) {
+}
+
+Status RowAggregator::SetCell(const AggregateResultPB::CellPB& cell,
+                              int col_idx,
+                              KuduPartialRow* row) {
+  if (!cell.has_value()) {
+    return row->SetNull(col_idx);
+  }
+  const TypeInfo* type = row->schema()->column(col_idx).type_info();
+  if (type->physical_type() == BINARY) {
+    Slice value(cell.value());
+    return row->Set(col_idx, reinterpret_cast<const uint8_t*>(&value));
+  }
+  if (PREDICT_FALSE(cell.value().size() != type->size())) {
+    return Status::InvalidArgument(Substitute("invalid value size for column $0",
+                                              row->schema()->column(col_idx).name()));
+  }
+  alignas(16) uint8_t buf[16];
+  memcpy(buf, cell.value().data(), type->size());
+  return row->Set(col_idx, buf);
+}
+
+Status RowAggregator::Create(const AggregationSpecPB& spec,
+                             const Schema& schema,
+                             unique_ptr<RowAggregator>* aggregator) {
+  unique_ptr<RowAggregator> agg(new RowAggregator(schema));
+  RETURN_NOT_OK(Resolve(spec, schema, &agg->group_by_col_idxs_, &agg->aggregates_,
+                        &agg->result_schema_));
+  *aggregator = std::move(agg);
+  return Status::OK();
+}
+
+Status RowAggregator::Validate(const AggregationSpecPB& spec, const Schema& schema) {
+  vector<int> group_by_col_idxs;
+  vector<Aggregate> aggregates;
+  Schema result_schema;
+  return Resolve(spec, schema, &group_by_col_idxs, &aggregates, &result_schema);
+}
+
+Status RowAggregator::Resolve(const AggregationSpecPB& spec,
+                              const Schema& schema,
+                              vector<int>* group_by_col_idxs,
+                              vector<Aggregate>* aggregates,
+                              Schema* result_schema) {
+  if (spec.aggregates().empty()) {
+    return Status::InvalidArgument("aggregation must specify at least one aggregate");
+  }
+  vector<ColumnSchema> result_cols;
+
+  unordered_set<int> group_by_cols;
+  for (const auto& col_name : spec.group_by_columns()) {
+    int idx = schema.find_column(col_name);
+    if (idx == Schema::kColumnNotFound) {
+      return Status::InvalidArgument("unknown group-by column", col_name);
+    }
+    if (!group_by_cols.insert(idx).second) {
+      return Status::InvalidArgument("duplicate group-by column", col_name);
+    }
+    const ColumnSchema& col = schema.column(idx);
+    group_by_col_idxs->push_back(idx);
+    result_cols.emplace_back(col.name(), col.type_info()->type(), col.is_nullable(),
+                             nullptr, nullptr, ColumnStorageAttributes(),
+                             col.type_attributes());
+  }
+
+  for (const auto& agg_pb : spec.aggregates()) {
+    Aggregate a;
+    a.function = agg_pb.function();
+    a.col_idx = -1;
+    a.type = nullptr;
+    if (a.function != AggregatePB::COUNT &&
+        a.function != AggregatePB::SUM &&
+        a.function != AggregatePB::MIN &&
+        a.function != AggregatePB::MAX) {
+      return Status::InvalidArgument("unknown aggregate function");
+    }
+    if (!agg_pb.has_column()) {
+      if (a.function != AggregatePB::COUNT) {
+        return Status::InvalidArgument(
+            Substitute("$0 requires a column", FunctionName(a.function)));
+      }
+      result_cols.emplace_back("count(*)", INT64);
+      aggregates->push_back(a);
+      continue;
+    }
+
+    a.col_idx = schema.find_column(agg_pb.column());
+    if (a.col_idx == Schema::kColumnNotFound) {
+      return Status::InvalidArgument("unknown aggregated column", agg_pb.column());
+    }
+    const ColumnSchema& col = schema.column(a.col_idx);
+    if (col.type_info()->is_virtual()) {
+      return Status::InvalidArgument("cannot aggregate virtual column", col.name());
+    }
+    a.type = col.type_info();
+    string result_name = Substitute("$0($1)", FunctionName(a.function), col.name());
+    switch (a.function) {
+      case AggregatePB::COUNT:
+        result_cols.emplace_back(std::move(result_name), INT64);
+        break;
+      case AggregatePB::SUM:
+        if (!IsSummable(a.type->type())) {
+          return Status::InvalidArgument(
+              Substitute("cannot sum column $0 of type $1", col.name(), a.type->name()));
+        }
+        result_cols.emplace_back(std::move(result_name),
+                                 IsFloatingPoint(a.type->physical_type()) ? DOUBLE : INT64,
+                                 /*is_nullable=*/true);
+        break;
+      default:
+        result_cols.emplace_back(std::move(result_name), a.type->type(), /*is_nullable=*/true,
+                                 nullptr, nullptr, ColumnStorageAttributes(),
+                                 col.type_attributes());
+        break;
+    }
+    aggregates->push_back(a);
+  }
+
+  RETURN_NOT_OK_PREPEND(result_schema->Reset(std::move(result_cols), 0),
+                        "invalid aggregation");
+  return Status::OK();
+}
+
+uint32_t RowAggregator::FindOrAddGroup(const string& encoded_key,
+                                       vector<AggregateResultPB::CellPB> key_cells) {
+  auto inserted = group_ids_by_key_.emplace(encoded_key, group_keys_.size());
+  if (inserted.second) {
+    group_keys_.emplace_back(std::move(key_cells));
+    group_key_bytes_ += encoded_key.size();
+    states_.resize(states_.size() + aggregates_.size());
+  }
+  return inserted.first->second;
+}
+
+void RowAggregator::AddRowBlock(const RowBlock& block) {
+  DCHECK_EQ(block.schema()->num_columns(), input_schema_.num_columns());
+  SelectedRows selected = block.selection_vector()->GetSelectedRows();
+  if (selected.num_selected() == 0) {
+    return;
+  }
+  const vector<uint16_t> sel_rows = std::move(selected).ToRowIndexes();
+  ResolveGroups(block, sel_rows, &group_ids_scratch_);
+  for (int i = 0; i < aggregates_.size(); i++) {
+    FoldColumn(block, i, sel_rows, group_ids_scratch_);
+  }
+}
+
+void RowAggregator::ResolveGroups(const RowBlock& block,
+                                  const vector<uint16_t>& sel_rows,
+                                  vector<uint32_t>* group_ids) {
+  if (group_by_col_idxs_.empty()) {
+    group_ids->assign(sel_rows.size(), FindOrAddGroup("", {}));
+    return;
+  }
+
+  vector<ColumnBlock> cbs;
+  cbs.reserve(group_by_col_idxs_.size());
+  for (int idx : group_by_col_idxs_) {
+    cbs.emplace_back(block.column_block(idx));
+  }
+
+  group_ids->resize(sel_rows.size());
+  for (size_t i = 0; i < sel_rows.size(); i++) {
+    const uint16_t row = sel_rows[i];
+    key_scratch_.clear();
+    for (const auto& cb : cbs) {
+      bool is_null = cb.is_nullable() && cb.is_null(row);
+      if (cb.type_info()->physical_type() == BINARY) {
+        const Slice* s = reinterpret_cast<const Slice*>(cb.cell_ptr(row));
+        AppendKeyCell(is_null, true, s->data(), s->size(), &key_scratch_);
+      } else {
+        AppendKeyCell(is_null, false, cb.cell_ptr(row), cb.stride(), &key_scratch_);
+      }
+    }
+    const uint32_t* existing = FindOrNull(group_ids_by_key_, key_scratch_);
+    if (existing) {
+      (*group_ids)[i] = *existing;
+      continue;
+    }
+
+    // This is the first row of a new group: copy out its key cells.
+    vector<AggregateResultPB::CellPB> key_cells(cbs.size());
+    for (int c = 0; c < cbs.size(); c++) {
+      const auto& cb = cbs[c];
+      if (cb.is_nullable() && cb.is_null(row)) {
+        continue;
+      }
+      if (cb.type_info()->physical_type() == BINARY) {
+        const Slice* s = reinterpret_cast<const Slice*>(cb.cell_ptr(row));
+        key_cells[c].set_value(s->data(), s->size());
+      } else {
+        key_cells[c].set_value(cb.cell_ptr(row), cb.stride());
+      }
+    }
+    (*group_ids)[i] = FindOrAddGroup(key_scratch_, std::move(key_cells));
+  }
+}
+
+template<typename CppType, typename AccType>
+void RowAggregator::FoldSum(const ColumnBlock& cb,
+                            int agg_idx,
+                            AccType AggState::* acc,
+                            const vector<uint16_t>& sel_rows,
+                            const vector<uint32_t>& group_ids) {
+  if (group_by_col_idxs_.empty()) {
+    // Without grouping, reduce into a local accumulator so that the loop
+    // carries no stores into the aggregate state.
+    AccType sum = 0;
+    bool any = false;
+    ForEachNonNullCell<CppType>(cb, sel_rows, [&](size_t /*i*/, CppType v) {
+      sum = AddToSum(sum, static_cast<AccType>(v));
+      any = true;
+    });
+    if (any) {
+      AggState* s = state(0, agg_idx);
+      s->*acc = AddToSum(s->*acc, sum);
+      s->is_set = true;
+    }
+    return;
+  }
+  ForEachNonNullCell<CppType>(cb, sel_rows, [&](size_t i, CppType v) {
+    AggState* s = state(group_ids[i], agg_idx);
+    s->*acc = AddToSum(s->*acc, static_cast<AccType>(v));
+    s->is_set = true;
+  });
+}
+
+template<typename CppType>
+void RowAggregator::FoldNativeMinMax(const ColumnBlock& cb,
+                                     int agg_idx,
+                                     const vector<uint16_t>& sel_rows,
+                                     const vector<uint32_t>& group_ids) {
+  const bool is_min = aggregates_[agg_idx].function == AggregatePB::MIN;
+  auto fold = [is_min](CppType v, AggState* s) {
+    if (s->is_set) {
+      CppType cur;
+      memcpy(&cur, s->cell, sizeof(cur));
+      if (is_min ? !MinMaxLess(v, cur) : !MinMaxLess(cur, v)) {
+        return;
+      }
+    }
+    memcpy(s->cell, &v, sizeof(v));
+    s->is_set = true;
+  };
+
+  if (group_by_col_idxs_.empty()) {
+    bool any = false;
+    CppType best = CppType();
+    ForEachNonNullCell<CppType>(cb, sel_rows, [&](size_t /*i*/, CppType v) {
+      if (!any || (is_min ? MinMaxLess(v, best) : MinMaxLess(best, v))) {
+        best = v;
+        any = true;
+      }
+    });
+    if (any) {
+      fold(best, state(0, agg_idx));
+    }
+    return;
+  }
+  ForEachNonNullCell<CppType>(cb, sel_rows, [&](size_t i, CppType v) {
+    fold(v, state(group_ids[i], agg_idx));
+  });
+}
+
+void RowAggregator::FoldColumn(const RowBlock& block,
+                               int agg_idx,
+                               const vector<uint16_t>& sel_rows,
+                               const vector<uint32_t>& group_ids) {
+  const Aggregate& agg = aggregates_[agg_idx];
+  if (agg.col_idx < 0) {
+    // COUNT(*).
+    for (size_t i = 0; i < sel_rows.size(); i++) {
+      AggState* s = state(group_ids[i], agg_idx);
+      s->i64++;
+      s->is_set = true;
+    }
+    return;
+  }
+
+  const ColumnBlock cb = block.column_block(agg.col_idx);
+  switch (agg.function) {
+    case AggregatePB::COUNT:
+      for (size_t i = 0; i < sel_rows.size(); i++) {
+        if (cb.is_nullable() && cb.is_null(sel_rows[i])) {
+          continue;
+        }
+        AggState* s = state(group_ids[i], agg_idx);
+        s->i64++;
+        s->is_set = true;
+      }
+      return;
+    case AggregatePB::SUM:
+      switch (agg.type->physical_type()) {
+        case INT8:
+          return FoldSum<int8_t>(cb, agg_idx, &AggState::i64, sel_rows, group_ids);
+        case INT16:
+          return FoldSum<int16_t>(cb, agg_idx, &AggState::i64, sel_rows, group_ids);
+        case INT32:
+          return FoldSum<int32_t>(cb, agg_idx, &AggState::i64, sel_rows, group_ids);
+        case INT64:
+          return FoldSum<int64_t>(cb, agg_idx, &AggState::i64, sel_rows, group_ids);
+        case FLOAT:
+          return FoldSum<float>(cb, agg_idx, &AggState::dbl, sel_rows, group_ids);
+        case DOUBLE:
+          return FoldSum<double>(cb, agg_idx, &AggState::dbl, sel_rows, group_ids);
+        default:
+          LOG(FATAL) << "unexpected SUM type: " << agg.type->name();
+      }
+      return;
+    default:
+      break;
+  }
+
+  // MIN and MAX.
+  switch (agg.type->physical_type()) {
+    case BOOL:
+      return FoldNativeMinMax<bool>(cb, agg_idx, sel_rows, group_ids);
+    case INT8:
+      return FoldNativeMinMax<int8_t>(cb, agg_idx, sel_rows, group_ids);
+    case INT16:
+      return FoldNativeMinMax<int16_t>(cb, agg_idx, sel_rows, group_ids);
+    case INT32:
+      return FoldNativeMinMax<int32_t>(cb, agg_idx, sel_rows, group_ids);
+    case INT64:
+      return FoldNativeMinMax<int64_t>(cb, agg_idx, sel_rows, group_ids);
+    case FLOAT:
+      return FoldNativeMinMax<float>(cb, agg_idx, sel_rows, group_ids);
+    case DOUBLE:
+      return FoldNativeMinMax<double>(cb, agg_idx, sel_rows, group_ids);
+    default:
+      break;
+  }
+  // Types without a native comparison (BINARY and INT128) fall back to the
+  // generic comparator.
+  for (size_t i = 0; i < sel_rows.size(); i++) {
+    const uint16_t row = sel_rows[i];
+    if (cb.is_nullable() && cb.is_null(row)) {
+      continue;
+    }
+    FoldMinMax(agg, cb.cell_ptr(row), state(group_ids[i], agg_idx));
+  }
+}
+
+void RowAggregator::FoldMinMax(const Aggregate& agg, const void* value, AggState* state) {
+  const bool is_binary = agg.type->physical_type() == BINARY;
+  if (state->is_set) {
+    int cmp;
+    if (is_binary) {
+      Slice cur(state->var);
+      cmp = agg.type->Compare(value, &cur);
+    } else {
+      alignas(16) uint8_t cur[16];
+      memcpy(cur, state->cell, agg.type->size());
+      alignas(16) uint8_t v[16];
+      memcpy(v, value, agg.type->size());
+      cmp = MinMaxCompare(agg.type, v, cur);
+    }
+    if (agg.function == AggregatePB::MIN ? cmp >= 0 : cmp <= 0) {
+      return;
+    }
+  }
+  if (is_binary) {
+    const Slice* s = reinterpret_cast<const Slice*>(value);
+    binary_value_bytes_ += s->size();
+    binary_value_bytes_ -= state->var.size();
+    state->var.assign(reinterpret_cast<const char*>(s->data()), s->size());
+  } else {
+    memcpy(state->cell, value, agg.type->size());
+  }
+  state->is_set = true;
+}
+
+Status RowAggregator::MergeCell(const Aggregate& agg,
+                                const AggregateResultPB::CellPB& cell,
+                                AggState* state) {
+  if (!cell.has_value()) {
+    if (agg.function == AggregatePB::COUNT) {
+      return Status::InvalidArgument("COUNT result must not be NULL");
+    }
+    return Status::OK();
+  }
+  const string& value = cell.value();
+  if (agg.function == AggregatePB::COUNT || agg.function == AggregatePB::SUM) {
+    if (PREDICT_FALSE(value.size() != sizeof(int64_t))) {
+      return Status::InvalidArgument(
+          Substitute("invalid $0 result size: $1", FunctionName(agg.function), value.size()));
+    }
+    if (agg.function == AggregatePB::SUM && IsFloatingPoint(agg.type->physical_type())) {
+      double v;
+      memcpy(&v, value.data(), sizeof(v));
+      state->dbl = AddToSum(state->dbl, v);
+    } else {
+      int64_t v;
+      memcpy(&v, value.data(), sizeof(v));
+      state->i64 = AddToSum(state->i64, v);
+    }
+    state->is_set = true;
+    return Status::OK();
+  }
+
+  if (agg.type->physical_type() == BINARY) {
+    Slice v(value);
+    FoldMinMax(agg, &v, state);
+    return Status::OK();
+  }
+  if (PREDICT_FALSE(value.size() != agg.type->size())) {
+    return Status::InvalidArgument(
+        Substitute("invalid $0 result size: $1", FunctionName(agg.function), value.size()));
+  }
+  FoldMinMax(agg, value.data(), state);
+  return Status::OK();
+}
+
+Status RowAggregator::MergeFromPB(const AggregateResultPB& pb) {
+  for (const auto& group : pb.groups()) {
+    if (PREDICT_FALSE(group.keys_size() != group_by_col_idxs_.size() ||
+                      group.values_size() != aggregates_.size())) {
+      return Status::InvalidArgument("aggregate result does not match aggregation spec");
+    }
+    key_scratch_.clear();
+    for (int c = 0; c < group.keys_size(); c++) {
+      const auto& key = group.keys(c);
+      const TypeInfo* type = input_schema_.column(group_by_col_idxs_[c]).type_info();
+      const bool is_binary = type->physical_type() == BINARY;
+      if (PREDICT_FALSE(key.has_value() && !is_binary && key.value().size() != type->size())) {
+        return Status::InvalidArgument("invalid group-by value size");
+      }
+      AppendKeyCell(!key.has_value(), is_binary, key.value().data(), key.value().size(),
+                    &key_scratch_);
+    }
+    vector<AggregateResultPB::CellPB> key_cells(group.keys().begin(), group.keys().end());
+    uint32_t group_id = FindOrAddGroup(key_scratch_, std::move(key_cells));
+    for (int a = 0; a < aggregates_.size(); a++) {
+      RETURN_NOT_OK(MergeCell(aggregates_[a], group.values(a), state(group_id, a)));
+    }
+  }
+  return Status::OK();
+}
+
+void RowAggregator::StateToCell(const Aggregate& agg, const AggState& state,
+                                AggregateResultPB::CellPB* cell) {
+  if (agg.function == AggregatePB::COUNT) {
+    cell->set_value(&state.i64, sizeof(state.i64));
+    return;
+  }
+  if (!state.is_set) {
+    return;
+  }
+  if (agg.function == AggregatePB::SUM) {
+    if (IsFloatingPoint(agg.type->physical_type())) {
+      cell->set_value(&state.dbl, sizeof(state.dbl));
+    } else {
+      cell->set_value(&state.i64, sizeof(state.i64));
+    }
+  } else if (agg.type->physical_type() == BINARY) {
+    cell->set_value(state.var);
+  } else {
+    cell->set_value(state.cell, agg.type->size());
+  }
+}
+
+void RowAggregator::TakeResultPB(AggregateResultPB* pb) {
+  pb->Clear();
+  for (uint32_t g = 0; g < group_keys_.size(); g++) {
+    auto* group = pb->add_groups();
+    for (auto& key : group_keys_[g]) {
+      *group->add_keys() = std::move(key);
+    }
+    for (int a = 0; a < aggregates_.size(); a++) {
+      StateToCell(aggregates_[a], *state(g, a), group->add_values());
+    }
+  }
+  group_ids_by_key_.clear();
+  group_keys_.clear();
+  group_key_bytes_ = 0;
+  binary_value_bytes_ = 0;
+  states_.clear();
+}
+
+Status RowAggregator::GetResultRows(vector<KuduPartialRow>* rows) const {
+  rows->clear();
+  const int num_keys = group_by_col_idxs_.size();
+  if (group_keys_.empty() && num_keys == 0) {
+    // An aggregation without grouping yields a single row even over no input.
+    KuduPartialRow row(&result_schema_);
+    for (int a = 0; a < aggregates_.size(); a++) {
+      if (aggregates_[a].function == AggregatePB::COUNT) {
+        RETURN_NOT_OK(row.SetInt64(a, 0));
+      } else {
+        RETURN_NOT_OK(row.SetNull(a));
+      }
+    }
+    rows->emplace_back(std::move(row));
+    return Status::OK();
+  }
+
+  rows->reserve(group_keys_.size());
+  for (uint32_t g = 0; g < group_keys_.size(); g++) {
+    KuduPartialRow row(&result_schema_);
+    for (int c = 0; c < num_keys; c++) {
+      RETURN_NOT_OK(SetCell(group_keys_[g][c], c, &row));
+    }
+    for (int a = 0; a < aggregates_.size(); a++) {
+      AggregateResultPB::CellPB cell;
+      StateToCell(aggregates_[a], *state(g, a), &cell);
+      RETURN_NOT_OK(SetCell(cell, num_keys + a, &row));
+    }
+    rows->emplace_back(std::move(row));
+  }
+  return Status::OK();
+}
+
+size_t RowAggregator::ResultSizeBytes() const {
+  // Each serialized aggregate value takes at most a 16-byte cell plus the
+  // protobuf framing, in addition to the contents of BINARY MIN/MAX values.
+  return group_key_bytes_ + binary_value_bytes_ + states_.size() * 20;
+}
+
+} // namespace kudu
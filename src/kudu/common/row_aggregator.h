@@ -0,0 +1,226 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kudu/common/common.pb.h"
+#include "kudu/common/schema.h"
+#include "kudu/gutil/macros.h"
+#include "kudu/util/status.h"
+
+namespace kudu {
+
+class ColumnBlock;
+class KuduPartialRow;
+class RowBlock;
+class TypeInfo;
+
+// Evaluates an AggregationSpecPB over RowBlocks, and merges partial results
+// produced by other aggregators over the same spec.
+//
+// The tablet server feeds the RowBlocks produced by a scan into an aggregator
+// and returns its partial results to the client in place of the rows. The
+// client merges the partial results of every tablet into its own aggregator
+// and materializes the final rows from it.
+//
+// Each RowBlock is processed a column at a time: the group of every selected
+// row is resolved once, and then each aggregate is folded over its column in
+// a tight, type-specialized loop.
+//
+// This class is not thread-safe.
+class RowAggregator {
+ public:
+  // Creates an aggregator evaluating 'spec' over rows of 'schema'.
+  //
+  // Returns InvalidArgument if the spec refers to columns which are not part
+  // of 'schema', or applies an aggregate function to a column of an
+  // unsupported type.
+  static Status Create(const AggregationSpecPB& spec,
+                       const Schema& schema,
+                       std::unique_ptr<RowAggregator>* aggregator);
+
+  // Checks that 'spec' can be evaluated over rows of 'schema', without
+  // creating an aggregator. Returns the errors Create() would return.
+  static Status Validate(const AggregationSpecPB& spec, const Schema& schema);
+
+  // Returns the schema of the aggregated rows: the group-by columns followed
+  // by one column per aggregate.
+  const Schema& result_schema() const {
+    return result_schema_;
+  }
+
+  // Folds the selected rows of 'block' into the aggregates. 'block' must have
+  // the schema this aggregator was created with.
+  void AddRowBlock(const RowBlock& block);
+
+  // Merges partial results produced by another aggregator with the same spec.
+  Status MergeFromPB(const AggregateResultPB& pb);
+
+  // Serializes the accumulated partial results into 'pb' and resets the
+  // aggregator to its initial state.
+  void TakeResultPB(AggregateResultPB* pb);
+
+  // Materializes one row per group into 'rows', using result_schema().
+  //
+  // If there are no group-by columns, exactly one row is produced even if no
+  // input rows were aggregated, as with a SQL aggregation without GROUP BY.
+  Status GetResultRows(std::vector<KuduPartialRow>* rows) const;
+
+  // Returns the number of distinct groups accumulated so far.
+  size_t num_groups() const {
+    return group_keys_.size();
+  }
+
+  // Returns the approximate size in bytes of the serialized partial results.
+  size_t ResultSizeBytes() const;
+
+ private:
+  // The running state of one aggregate for one group.
+  struct AggState {
+    // Whether any value has been folded into the state. An unset state of
+    // SUM, MIN or MAX is NULL.
+    bool is_set = false;
+
+    // COUNT and integer SUM.
+    int64_t i64 = 0;
+
+    // Floating point SUM.
+    double dbl = 0;
+
+    // MIN and MAX over fixed-width types: the cell in its in-memory format.
+    uint8_t cell[16];
+
+    // MIN and MAX over BINARY physical types: the cell contents.
+    std::string var;
+  };
+
+  struct Aggregate {
+    AggregatePB::Function function;
+
+    // Index of the aggregated column in the input schema, or -1 for COUNT(*).
+    int col_idx;
+
+    // Type of the aggregated column, or nullptr for COUNT(*).
+    const TypeInfo* type;
+  };
+
+  explicit RowAggregator(Schema input_schema);
+
+  // Resolves the columns of 'spec' against 'schema' into the indexes of the
+  // group-by columns, the aggregates, and the schema of the aggregated rows.
+  static Status Resolve(const AggregationSpecPB& spec,
+                        const Schema& schema,
+                        std::vector<int>* group_by_col_idxs,
+                        std::vector<Aggregate>* aggregates,
+                        Schema* result_schema);
+
+  // Returns the index of the group with the given encoded key, adding a new
+  // group with the given key cells if necessary.
+  uint32_t FindOrAddGroup(const std::string& encoded_key,
+                          std::vector<AggregateResultPB::CellPB> key_cells);
+
+  // Resolves the group of each selected row of 'block' into 'group_ids'.
+  void ResolveGroups(const RowBlock& block,
+                     const std::vector<uint16_t>& sel_rows,
+                     std::vector<uint32_t>* group_ids);
+
+  // Folds the selected rows of 'block' into the states of aggregate
+  // 'agg_idx'.
+  void FoldColumn(const RowBlock& block,
+                  int agg_idx,
+                  const std::vector<uint16_t>& sel_rows,
+                  const std::vector<uint32_t>& group_ids);
+
+  // Folds the selected non-NULL cells of 'cb' into the SUM states of
+  // aggregate 'agg_idx', accumulating into the state member 'acc'.
+  template<typename CppType, typename AccType>
+  void FoldSum(const ColumnBlock& cb,
+               int agg_idx,
+               AccType AggState::* acc,
+               const std::vector<uint16_t>& sel_rows,
+               const std::vector<uint32_t>& group_ids);
+
+  // Folds the selected non-NULL cells of 'cb' into the MIN or MAX states of
+  // aggregate 'agg_idx', comparing the cells as values of 'CppType'.
+  template<typename CppType>
+  void FoldNativeMinMax(const ColumnBlock& cb,
+                        int agg_idx,
+                        const std::vector<uint16_t>& sel_rows,
+                        const std::vector<uint32_t>& group_ids);
+
+  // Merges the serialized aggregate value 'cell' into 'state'.
+  Status MergeCell(const Aggregate& agg,
+                   const AggregateResultPB::CellPB& cell,
+                   AggState* state);
+
+  // Folds the non-NULL cell 'value' into the MIN or MAX 'state'.
+  void FoldMinMax(const Aggregate& agg, const void* value, AggState* state);
+
+  // Sets column 'col_idx' of 'row' to the serialized cell 'cell'.
+  static Status SetCell(const AggregateResultPB::CellPB& cell,
+                        int col_idx,
+                        KuduPartialRow* row);
+
+  // Serializes 'state' into 'cell'.
+  static void StateToCell(const Aggregate& agg, const AggState& state,
+                          AggregateResultPB::CellPB* cell);
+
+  AggState* state(uint32_t group_id, int agg_idx) {
+    return &states_[group_id * aggregates_.size() + agg_idx];
+  }
+
+  const AggState* state(uint32_t group_id, int agg_idx) const {
+    return &states_[group_id * aggregates_.size() + agg_idx];
+  }
+
+  const Schema input_schema_;
+  Schema result_schema_;
+
+  // Indexes of the group-by columns in the input schema.
+  std::vector<int> group_by_col_idxs_;
+  std::vector<Aggregate> aggregates_;
+
+  // Maps the encoded group-by key of each group to its group ID.
+  std::unordered_map<std::string, uint32_t> group_ids_by_key_;
+
+  // The group-by cells of each group, indexed by group ID.
+  std::vector<std::vector<AggregateResultPB::CellPB>> group_keys_;
+
+  // The total size of the encoded group-by keys.
+  size_t group_key_bytes_ = 0;
+
+  // The total size of the values held by the MIN and MAX states of BINARY
+  // columns.
+  size_t binary_value_bytes_ = 0;
+
+  // The aggregate states, indexed by group ID and then aggregate index.
+  std::vector<AggState> states_;
+
+  // Scratch space reused across calls to AddRowBlock().
+  std::vector<uint32_t> group_ids_scratch_;
+  std::string key_scratch_;
+
+  DISALLOW_COPY_AND_ASSIGN(RowAggregator);
+};
+
+} // namespace kudu
@@ -975,4 +975,128 @@ TEST_F(RowOperationsTest, ExceedCellLimit) {
   }
 }
 
+// Test that rows encoded column by column decode to the same operations as
+// when they're encoded row by row, including projection onto a server schema
+// with an extra column and NULL handling.
+TEST_F(RowOperationsTest, ColumnarRoundTrip) {
+  int32_t extra_default = 42;
+  SchemaBuilder b(schema_);
+  ASSERT_OK(b.AddColumn("extra", INT32, false, &extra_default, &extra_default));
+  Schema server_schema = b.Build();
+
+  constexpr int kNumRows = 100;
+  vector<string> strings;
+  for (int i = 0; i < kNumRows; i++) {
+    strings.emplace_back(i % 5 == 0 ? "" : Substitute("hello $0", i));
+  }
+  for (auto type : { RowOperationsPB::INSERT,
+                     RowOperationsPB::INSERT_IGNORE,
+                     RowOperationsPB::UPSERT }) {
+    RowOperationsPB row_pb;
+    RowOperationsPBEncoder row_enc(&row_pb);
+    RowOperationsPB columnar_pb;
+    ColumnarRowOperationsPBEncoder columnar_enc(type, &schema_without_ids_,
+                                                columnar_pb.mutable_columnar());
+    for (int i = 0; i < kNumRows; i++) {
+      KuduPartialRow row(&schema_without_ids_);
+      ASSERT_OK(row.SetInt32("key", i));
+      ASSERT_OK(row.SetInt32("int_val", i * 2));
+      if (i % 3 == 0) {
+        ASSERT_OK(row.SetNull("string_val"));
+      } else {
+        ASSERT_OK(row.SetStringNoCopy("string_val", strings[i]));
+      }
+      row_enc.Add(type, row);
+      columnar_enc.Add(row);
+    }
+
+    vector<DecodedRowOperation> row_ops;
+    RowOperationsPBDecoder row_dec(&row_pb, &schema_without_ids_, &server_schema, &arena_);
+    ASSERT_OK(row_dec.DecodeOperations<DecoderMode::WRITE_OPS>(&row_ops));
+    vector<DecodedRowOperation> columnar_ops;
+    RowOperationsPBDecoder columnar_dec(&columnar_pb, &schema_without_ids_, &server_schema,
+                                        &arena_);
+    ASSERT_OK(columnar_dec.DecodeOperations<DecoderMode::WRITE_OPS>(&columnar_ops));
+
+    ASSERT_EQ(kNumRows, row_ops.size());
+    ASSERT_EQ(kNumRows, columnar_ops.size());
+    for (int i = 0; i < kNumRows; i++) {
+      ASSERT_OK(columnar_ops[i].result);
+      ASSERT_EQ(row_ops[i].type, columnar_ops[i].type);
+      ASSERT_EQ(row_ops[i].ToString(server_schema), columnar_ops[i].ToString(server_schema));
+      for (int col_idx = 0; col_idx < server_schema.num_columns(); col_idx++) {
+        ASSERT_EQ(BitmapTest(row_ops[i].isset_bitmap, col_idx),
+                  BitmapTest(columnar_ops[i].isset_bitmap, col_idx));
+      }
+    }
+    ASSERT_STR_CONTAINS(columnar_ops[3].ToString(server_schema),
+                        "(int32 key=3, int32 int_val=6, string string_val=NULL, int32 extra=42)");
+  }
+}
+
+// Test that malformed columnar row operations are rejected rather than
+// crashing the decoder, and that invalid cells fail only their own rows.
+TEST_F(RowOperationsTest, ColumnarBadInput) {
+  RowOperationsPB pb;
+  ColumnarRowOperationsPBEncoder enc(RowOperationsPB::INSERT, &schema_without_ids_,
+                                     pb.mutable_columnar());
+  for (int i = 0; i < 10; i++) {
+    KuduPartialRow row(&schema_without_ids_);
+    ASSERT_OK(row.SetInt32("key", i));
+    ASSERT_OK(row.SetInt32("int_val", i));
+    ASSERT_OK(row.SetStringCopy("string_val", Substitute("val $0", i)));
+    enc.Add(row);
+  }
+  const auto decode = [&](const RowOperationsPB& pb, vector<DecodedRowOperation>* ops) {
+    arena_.Reset();
+    ops->clear();
+    RowOperationsPBDecoder dec(&pb, &schema_without_ids_, &schema_, &arena_);
+    return dec.DecodeOperations<DecoderMode::WRITE_OPS>(ops);
+  };
+  vector<DecodedRowOperation> ops;
+  ASSERT_OK(decode(pb, &ops));
+  ASSERT_EQ(10, ops.size());
+
+  // Only inserts and upserts may be columnar.
+  {
+    RowOperationsPB bad_pb(pb);
+    bad_pb.mutable_columnar()->set_type(RowOperationsPB::DELETE);
+    Status s = decode(bad_pb, &ops);
+    ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+  }
+  // The data must match the number of rows.
+  {
+    RowOperationsPB bad_pb(pb);
+    bad_pb.mutable_columnar()->set_num_rows(11);
+    Status s = decode(bad_pb, &ops);
+    ASSERT_TRUE(s.IsCorruption()) << s.ToString();
+  }
+  // Binary offsets must point into the varlen data.
+  {
+    RowOperationsPB bad_pb(pb);
+    bad_pb.mutable_columnar()->mutable_columns(2)->mutable_varlen_data()->resize(3);
+    Status s = decode(bad_pb, &ops);
+    ASSERT_TRUE(s.IsCorruption()) << s.ToString();
+  }
+  // A NULL in a non-nullable column only fails its row.
+  {
+    RowOperationsPB bad_pb(pb);
+    string bitmap(BitmapSize(10), '\xff');
+    BitmapClear(reinterpret_cast<uint8_t*>(&bitmap[0]), 4);
+    bad_pb.mutable_columnar()->mutable_columns(1)->set_non_null_bitmap(bitmap);
+    ASSERT_OK(decode(bad_pb, &ops));
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(i != 4, ops[i].result.ok()) << i;
+    }
+  }
+  // Random corruption of the column data shouldn't crash the decoder.
+  for (int i = 0; i < 1000; i++) {
+    RowOperationsPB bad_pb(pb);
+    auto* col_pb = bad_pb.mutable_columnar()->mutable_columns(random() % 3);
+    DoRandomMutation(random() % 2 == 0 || col_pb->varlen_data().empty() ?
+                     col_pb->mutable_data() : col_pb->mutable_varlen_data());
+    CheckDecodeDoesntCrash(schema_without_ids_, schema_, bad_pb);
+  }
+}
+
 } // namespace kudu
@@ -18,6 +18,7 @@
 #include "kudu/common/row_operations.h"
 
 #include <cstring>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -182,6 +183,77 @@ void RowOperationsPBEncoder::RemoveLast() {
   prev_rows_size_ = string::npos;
 }
 
+ColumnarRowOperationsPBEncoder::ColumnarRowOperationsPBEncoder(RowOperationsPB::Type type,
+                                                               const Schema* schema,
+                                                               ColumnarRowOperationsPB* pb)
+    : schema_(schema),
+      pb_(pb) {
+  DCHECK(type == RowOperationsPB::INSERT ||
+         type == RowOperationsPB::INSERT_IGNORE ||
+         type == RowOperationsPB::UPSERT) << RowOperationsPB_Type_Name(type);
+  pb_->Clear();
+  pb_->set_type(type);
+  pb_->set_num_rows(0);
+  for (int i = 0; i < schema_->num_columns(); i++) {
+    ColumnarRowOperationsPB::Column* col_pb = pb_->add_columns();
+    if (schema_->column(i).type_info()->physical_type() == BINARY) {
+      // The offsets of binary cells start with the offset of the first cell.
+      const uint32_t first_offset = 0;
+      col_pb->mutable_data()->append(reinterpret_cast<const char*>(&first_offset),
+                                     sizeof(first_offset));
+    }
+  }
+}
+
+ColumnarRowOperationsPBEncoder::~ColumnarRowOperationsPBEncoder() {
+}
+
+size_t ColumnarRowOperationsPBEncoder::Add(const KuduPartialRow& partial_row) {
+  DCHECK(schema_->Equals(*partial_row.schema()));
+  DCHECK(partial_row.AllColumnsSet());
+
+  // See wire_protocol.proto for a description of the format.
+  const int64_t row_idx = pb_->num_rows();
+  size_t size_delta = 0;
+  ContiguousRow row(schema_, partial_row.row_data_);
+  for (int i = 0; i < schema_->num_columns(); i++) {
+    const ColumnSchema& col = schema_->column(i);
+    ColumnarRowOperationsPB::Column* col_pb = pb_->mutable_columns(i);
+
+    const bool is_null = col.is_nullable() && row.is_null(i);
+    if (col.is_nullable()) {
+      string* bitmap = col_pb->mutable_non_null_bitmap();
+      if (bitmap->size() < BitmapSize(row_idx + 1)) {
+        bitmap->push_back(0);
+        size_delta++;
+      }
+      BitmapChange(reinterpret_cast<uint8_t*>(&(*bitmap)[0]), row_idx, !is_null);
+    }
+
+    if (col.type_info()->physical_type() == BINARY) {
+      string* varlen_data = col_pb->mutable_varlen_data();
+      if (!is_null) {
+        const Slice* val = reinterpret_cast<const Slice*>(row.cell_ptr(i));
+        varlen_data->append(reinterpret_cast<const char*>(val->data()), val->size());
+        size_delta += val->size();
+      }
+      DCHECK_LE(varlen_data->size(), std::numeric_limits<uint32_t>::max());
+      const uint32_t end_offset = varlen_data->size();
+      col_pb->mutable_data()->append(reinterpret_cast<const char*>(&end_offset),
+                                     sizeof(end_offset));
+      size_delta += sizeof(end_offset);
+    } else {
+      // NULL cells are copied as well: that's cheaper than skipping them, and
+      // their contents are ignored when decoding.
+      const size_t size = col.type_info()->size();
+      col_pb->mutable_data()->append(reinterpret_cast<const char*>(row.cell_ptr(i)), size);
+      size_delta += size;
+    }
+  }
+  pb_->set_num_rows(row_idx + 1);
+  return size_delta;
+}
+
 size_t RowOperationsPBEncoder::GetRowsFieldSizeEstimate(
     const KuduPartialRow& partial_row,
     size_t* isset_bitmap_size,
@@ -651,6 +723,133 @@ Status RowOperationsPBDecoder::DecodeSplitRow(const ClientServerMapping& mapping
   return Status::OK();
 }
 
+Status RowOperationsPBDecoder::DecodeColumnarOperations(const uint8_t* prototype_row_storage,
+                                                        const ClientServerMapping& mapping,
+                                                        vector<DecodedRowOperation>* ops) {
+  const ColumnarRowOperationsPB& pb = pb_->columnar();
+  if (PREDICT_FALSE(!src_.empty() || !pb_->indirect_data().empty())) {
+    return Status::Corruption("Row operations are both row-wise and columnar");
+  }
+  const RowOperationsPB::Type type = pb.type();
+  if (PREDICT_FALSE(type != RowOperationsPB::INSERT &&
+                    type != RowOperationsPB::INSERT_IGNORE &&
+                    type != RowOperationsPB::UPSERT)) {
+    return Status::InvalidArgument(Substitute("Invalid columnar write operation type $0",
+                                              RowOperationsPB_Type_Name(type)));
+  }
+  if (PREDICT_FALSE(pb.columns_size() != client_schema_->num_columns())) {
+    return Status::Corruption(Substitute("Expected $0 columns, got $1",
+                                         client_schema_->num_columns(), pb.columns_size()));
+  }
+  const int64_t num_rows = pb.num_rows();
+  if (PREDICT_FALSE(num_rows < 0 || num_rows > std::numeric_limits<int32_t>::max())) {
+    return Status::Corruption(Substitute("Bad number of rows: $0", num_rows));
+  }
+
+  // Check the sizes of the columns' data up front, so that the loops over the
+  // cells below only need to check the binary offsets.
+  for (int client_col_idx = 0; client_col_idx < pb.columns_size(); client_col_idx++) {
+    const ColumnarRowOperationsPB::Column& col_pb = pb.columns(client_col_idx);
+    const ColumnSchema& col = client_schema_->column(client_col_idx);
+    const int64_t expected_size = col.type_info()->physical_type() == BINARY ?
+        (num_rows + 1) * sizeof(uint32_t) : num_rows * col.type_info()->size();
+    if (PREDICT_FALSE(static_cast<int64_t>(col_pb.data().size()) != expected_size)) {
+      return Status::Corruption(Substitute(
+          "Bad data size for column $0: expected $1 bytes, got $2",
+          col.name(), expected_size, col_pb.data().size()));
+    }
+    if (PREDICT_FALSE(col_pb.has_non_null_bitmap() &&
+                      col_pb.non_null_bitmap().size() < BitmapSize(num_rows))) {
+      return Status::Corruption("Non-null bitmap too small for column", col.name());
+    }
+  }
+
+  // Every row sets all of the client's columns, so the rows share an isset
+  // bitmap.
+  const size_t isset_bitmap_size = BitmapSize(tablet_schema_->num_columns());
+  auto tablet_isset_bitmap = reinterpret_cast<uint8_t*>(
+      dst_arena_->AllocateBytes(isset_bitmap_size));
+  if (PREDICT_FALSE(!tablet_isset_bitmap)) {
+    return Status::RuntimeError("Out of memory");
+  }
+  memset(tablet_isset_bitmap, 0, isset_bitmap_size);
+  for (size_t client_col_idx = 0; client_col_idx < mapping.num_mapped(); client_col_idx++) {
+    BitmapSet(tablet_isset_bitmap, mapping.client_to_tablet_idx(client_col_idx));
+  }
+
+  // Allocate the rows with the tablet's layout, starting from the prototype
+  // row which has all the defaults filled in.
+  vector<uint8_t*> tablet_rows(num_rows);
+  const size_t first_op_idx = ops->size();
+  ops->resize(first_op_idx + num_rows);
+  for (int64_t row_idx = 0; row_idx < num_rows; row_idx++) {
+    auto tablet_row_storage = reinterpret_cast<uint8_t*>(
+        dst_arena_->AllocateBytesAligned(tablet_row_size_, 8));
+    if (PREDICT_FALSE(!tablet_row_storage)) {
+      return Status::RuntimeError("Out of memory");
+    }
+    memcpy(tablet_row_storage, prototype_row_storage, tablet_row_size_);
+    tablet_rows[row_idx] = tablet_row_storage;
+
+    DecodedRowOperation* op = &(*ops)[first_op_idx + row_idx];
+    op->type = type;
+    op->row_data = tablet_row_storage;
+    op->isset_bitmap = tablet_isset_bitmap;
+  }
+
+  // Now fill the rows in one column at a time, so that the checks which only
+  // depend on the column are done once rather than for every cell.
+  for (int client_col_idx = 0; client_col_idx < pb.columns_size(); client_col_idx++) {
+    const ColumnarRowOperationsPB::Column& col_pb = pb.columns(client_col_idx);
+    const size_t tablet_col_idx = mapping.client_to_tablet_idx(client_col_idx);
+    // We use the server-side ColumnSchema object since it has the most
+    // up-to-date default, nullability, etc.
+    const ColumnSchema& col = tablet_schema_->column(tablet_col_idx);
+    const size_t cell_size = col.type_info()->size();
+    const bool is_binary = col.type_info()->physical_type() == BINARY;
+    const auto* data = reinterpret_cast<const uint8_t*>(col_pb.data().data());
+    const auto* non_null_bitmap = col_pb.has_non_null_bitmap() ?
+        reinterpret_cast<const uint8_t*>(col_pb.non_null_bitmap().data()) : nullptr;
+    const string& varlen_data = col_pb.varlen_data();
+
+    for (int64_t row_idx = 0; row_idx < num_rows; row_idx++) {
+      ContiguousRow tablet_row(tablet_schema_, tablet_rows[row_idx]);
+      const bool is_null = non_null_bitmap && !BitmapTest(non_null_bitmap, row_idx);
+      if (col.is_nullable()) {
+        tablet_row.set_null(tablet_col_idx, is_null);
+      }
+      if (is_null) {
+        if (PREDICT_FALSE(!col.is_nullable())) {
+          (*ops)[first_op_idx + row_idx].SetFailureStatusOnce(Status::InvalidArgument(
+              "NULL values not allowed for non-nullable column", col.ToString()));
+        }
+        continue;
+      }
+
+      uint8_t* dst = tablet_row.mutable_cell_ptr(tablet_col_idx);
+      if (is_binary) {
+        const auto start = UnalignedLoad<uint32_t>(data + row_idx * sizeof(uint32_t));
+        const auto end = UnalignedLoad<uint32_t>(data + (row_idx + 1) * sizeof(uint32_t));
+        if (PREDICT_FALSE(end < start || end > varlen_data.size())) {
+          return Status::Corruption("Bad varlen data offsets for column", col.name());
+        }
+        const size_t size = end - start;
+        // Check that no individual cell is larger than the specified max.
+        if (PREDICT_FALSE(size > FLAGS_max_cell_size_bytes)) {
+          (*ops)[first_op_idx + row_idx].SetFailureStatusOnce(Status::InvalidArgument(Substitute(
+              "value too large for column '$0' ($1 bytes, maximum is $2 bytes)",
+              col.name(), size, FLAGS_max_cell_size_bytes)));
+        }
+        Slice val(&varlen_data[start], size);
+        memcpy(dst, &val, sizeof(val));
+      } else {
+        memcpy(dst, data + row_idx * cell_size, cell_size);
+      }
+    }
+  }
+  return Status::OK();
+}
+
 template <DecoderMode mode>
 Status RowOperationsPBDecoder::DecodeOperations(vector<DecodedRowOperation>* ops) {
   // TODO(todd): there's a bug here, in that if a client passes some column in
@@ -674,6 +873,13 @@ Status RowOperationsPBDecoder::DecodeOperations(vector<DecodedRowOperation>* ops
   ContiguousRow prototype_row(tablet_schema_, prototype_row_storage);
   SetupPrototypeRow(*tablet_schema_, &prototype_row);
 
+  if (pb_->has_columnar()) {
+    if (mode != DecoderMode::WRITE_OPS) {
+      return Status::InvalidArgument("Columnar row operations are only supported for writes");
+    }
+    return DecodeColumnarOperations(prototype_row_storage, mapping, ops);
+  }
+
   while (HasNext()) {
     RowOperationsPB::Type type = RowOperationsPB::UNKNOWN;
     RETURN_NOT_OK(ReadOpType(&type));
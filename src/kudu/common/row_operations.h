@@ -72,6 +72,29 @@ class RowOperationsPBEncoder {
   DISALLOW_COPY_AND_ASSIGN(RowOperationsPBEncoder);
 };
 
+// Encodes operations of a single type into the columnar format of
+// ColumnarRowOperationsPB: see wire_protocol.proto. Only INSERT, INSERT_IGNORE
+// and UPSERT operations may be encoded this way.
+class ColumnarRowOperationsPBEncoder {
+ public:
+  // The rows to add must all have 'schema' as their schema.
+  ColumnarRowOperationsPBEncoder(RowOperationsPB::Type type,
+                                 const Schema* schema,
+                                 ColumnarRowOperationsPB* pb);
+  ~ColumnarRowOperationsPBEncoder();
+
+  // Append the cells of this partial row to the columns of the protobuf. All
+  // of the row's columns must be set. Returns the size delta for the
+  // underlying protobuf after adding the partial row.
+  size_t Add(const KuduPartialRow& partial_row);
+
+ private:
+  const Schema* const schema_;
+  ColumnarRowOperationsPB* const pb_;
+
+  DISALLOW_COPY_AND_ASSIGN(ColumnarRowOperationsPBEncoder);
+};
+
 struct DecodedRowOperation {
   RowOperationsPB::Type type;
 
@@ -141,6 +164,13 @@ class RowOperationsPBDecoder {
   Status DecodeInsertOrUpsert(const uint8_t* prototype_row_storage,
                               const ClientServerMapping& mapping,
                               DecodedRowOperation* op);
+
+  // Decode all of the operations of 'pb_->columnar()' at once, one column at
+  // a time.
+  Status DecodeColumnarOperations(const uint8_t* prototype_row_storage,
+                                  const ClientServerMapping& mapping,
+                                  std::vector<DecodedRowOperation>* ops);
+
   //------------------------------------------------------------
   // Serialization/deserialization support
   //------------------------------------------------------------
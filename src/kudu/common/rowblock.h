@@ -220,6 +220,20 @@ class SelectionVectorView {
     DCHECK_LE(offset + nrows, sel_vec_->nrows() - row_offset_);
     BitmapChangeBits(sel_vec_->mutable_bitmap(), row_offset_ + offset, nrows, false);
   }
+  // Returns the length of the run of rows starting at "row_idx" which are
+  // either all selected or all unselected, looking at no more than "max_rows"
+  // rows. Sets "selected" to whether the rows of the run are selected.
+  size_t GetRun(size_t row_idx, size_t max_rows, bool* selected) const {
+    DCHECK_GT(max_rows, 0);
+    DCHECK_LE(row_idx + max_rows, sel_vec_->nrows() - row_offset_);
+    size_t start = row_offset_ + row_idx;
+    *selected = BitmapTest(sel_vec_->bitmap(), start);
+    size_t end;
+    if (!BitmapFindFirst(sel_vec_->bitmap(), start, start + max_rows, !*selected, &end)) {
+      return max_rows;
+    }
+    return end - start;
+  }
  private:
   SelectionVector* sel_vec_;
   size_t row_offset_;
@@ -146,13 +146,15 @@ struct ColumnStorageAttributes {
   ColumnStorageAttributes()
     : encoding(AUTO_ENCODING),
       compression(DEFAULT_COMPRESSION),
-      cfile_block_size(0) {
+      cfile_block_size(0),
+      bloom_filter(false) {
   }
 
   ColumnStorageAttributes(EncodingType enc, CompressionType cmp)
     : encoding(enc),
       compression(cmp),
-      cfile_block_size(0) {
+      cfile_block_size(0),
+      bloom_filter(false) {
   }
 
   std::string ToString() const;
@@ -163,6 +165,11 @@ struct ColumnStorageAttributes {
   // The preferred block size for cfile blocks. If 0, uses the
   // server-wide default.
   int32_t cfile_block_size;
+
+  // Whether to write a bloom filter of the column's values into each of its
+  // cfiles, so that scans with equality or IN-list predicates on the column
+  // can skip rowsets which don't contain any of the values.
+  bool bloom_filter;
 };
 
 // A struct representing changes to a ColumnSchema.
@@ -194,6 +201,7 @@ public:
   boost::optional<EncodingType> encoding;
   boost::optional<CompressionType> compression;
   boost::optional<int32_t> cfile_block_size;
+  boost::optional<bool> bloom_filter;
 
   boost::optional<std::string> new_comment;
 };
@@ -203,6 +203,33 @@ TEST_F(WireProtocolTest, TestSchemaRoundTrip) {
   EXPECT_EQ(schema_.num_key_columns(), schema2.num_key_columns());
 }
 
+// Test that the bloom filter storage attribute survives the conversion to and
+// from protobuf, both in a column schema and in an alter delta.
+TEST_F(WireProtocolTest, TestBloomFilterAttributeRoundTrip) {
+  ColumnStorageAttributes attrs;
+  attrs.bloom_filter = true;
+  ColumnSchema col("trace_id", STRING, false, nullptr, nullptr, attrs);
+  ColumnSchemaPB pb;
+  ColumnSchemaToPB(col, &pb);
+  EXPECT_TRUE(pb.bloom_filter());
+  boost::optional<ColumnSchema> col2;
+  ASSERT_OK(ColumnSchemaFromPB(pb, &col2));
+  EXPECT_TRUE(col2->attributes().bloom_filter);
+
+  // Storage attributes may be omitted.
+  ColumnSchemaToPB(col, &pb, SCHEMA_PB_WITHOUT_STORAGE_ATTRIBUTES);
+  EXPECT_FALSE(pb.has_bloom_filter());
+
+  ColumnSchemaDelta delta(col.name());
+  delta.bloom_filter = false;
+  ColumnSchemaDeltaPB delta_pb;
+  ColumnSchemaDeltaToPB(delta, &delta_pb);
+  ColumnSchemaDelta delta2 = ColumnSchemaDeltaFromPB(delta_pb);
+  ASSERT_TRUE(delta2.bloom_filter);
+  ASSERT_OK(col2->ApplyDelta(delta2));
+  EXPECT_FALSE(col2->attributes().bloom_filter);
+}
+
 // Test that, when non-contiguous key columns are passed, an error Status
 // is returned.
 TEST_F(WireProtocolTest, TestBadSchema_NonContiguousKey) {
@@ -240,6 +240,9 @@ void ColumnSchemaToPB(const ColumnSchema& col_schema, ColumnSchemaPB *pb, int fl
     pb->set_encoding(col_schema.attributes().encoding);
     pb->set_compression(col_schema.attributes().compression);
     pb->set_cfile_block_size(col_schema.attributes().cfile_block_size);
+    if (col_schema.attributes().bloom_filter) {
+      pb->set_bloom_filter(true);
+    }
   }
   if (col_schema.has_read_default()) {
     if (col_schema.type_info()->physical_type() == BINARY) {
@@ -321,6 +324,9 @@ Status ColumnSchemaFromPB(const ColumnSchemaPB& pb, boost::optional<ColumnSchema
   if (pb.has_cfile_block_size()) {
     attributes.cfile_block_size = pb.cfile_block_size();
   }
+  if (pb.has_bloom_filter()) {
+    attributes.bloom_filter = pb.bloom_filter();
+  }
 
   // According to the URL below, the default value for strings that are optional
   // in protobuf is the empty string. So, it's safe to use pb.comment() directly
@@ -354,6 +360,9 @@ void ColumnSchemaDeltaToPB(const ColumnSchemaDelta& col_delta, ColumnSchemaDelta
   if (col_delta.cfile_block_size) {
     pb->set_block_size(*col_delta.cfile_block_size);
   }
+  if (col_delta.bloom_filter) {
+    pb->set_bloom_filter(*col_delta.bloom_filter);
+  }
   if (col_delta.new_comment) {
     pb->set_new_comment(*col_delta.new_comment);
   }
@@ -379,6 +388,9 @@ ColumnSchemaDelta ColumnSchemaDeltaFromPB(const ColumnSchemaDeltaPB& pb) {
   if (pb.has_block_size()) {
     col_delta.cfile_block_size = boost::optional<int32_t>(pb.block_size());
   }
+  if (pb.has_bloom_filter()) {
+    col_delta.bloom_filter = boost::optional<bool>(pb.bloom_filter());
+  }
   if (pb.has_new_comment()) {
     col_delta.new_comment = boost::optional<string>(pb.new_comment());
   }
@@ -649,6 +661,9 @@ Status ColumnPredicateFromPB(const Schema& schema,
 
 const char kTableHistoryMaxAgeSec[] = "kudu.table.history_max_age_sec";
 const char kTableMaintenancePriority[] = "kudu.table.maintenance_priority";
+const char kTableCompactionPolicy[] = "kudu.table.compaction_policy";
+const char kBudgetedCompactionPolicy[] = "budgeted";
+const char kTimeWindowCompactionPolicy[] = "time_window";
 Status ExtraConfigPBToMap(const TableExtraConfigPB& pb, map<string, string>* configs) {
   Map<string, string> tmp;
   RETURN_NOT_OK(ExtraConfigPBToPBMap(pb, &tmp));
@@ -682,6 +697,13 @@ Status ExtraConfigPBFromPBMap(const Map<string, string>& configs, TableExtraConf
         RETURN_NOT_OK(ParseInt32Config(name, value, &maintenance_priority));
         result.set_maintenance_priority(maintenance_priority);
       }
+    } else if (name == kTableCompactionPolicy) {
+      if (!value.empty()) {
+        if (value != kBudgetedCompactionPolicy && value != kTimeWindowCompactionPolicy) {
+          return Status::InvalidArgument(Substitute("unknown $0", name), value);
+        }
+        result.set_compaction_policy(value);
+      }
     } else {
       LOG(WARNING) << "Unknown extra configuration property: " << name;
     }
@@ -698,6 +720,9 @@ Status ExtraConfigPBToPBMap(const TableExtraConfigPB& pb, Map<string, string>* c
   if (pb.has_maintenance_priority()) {
     result[kTableMaintenancePriority] = std::to_string(pb.maintenance_priority());
   }
+  if (pb.has_compaction_policy()) {
+    result[kTableCompactionPolicy] = pb.compaction_policy();
+  }
   *configs = std::move(result);
   return Status::OK();
 }
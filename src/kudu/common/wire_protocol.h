@@ -143,6 +143,10 @@ Status ColumnPredicateFromPB(const Schema& schema,
                              const ColumnPredicatePB& pb,
                              boost::optional<ColumnPredicate>* predicate);
 
+// Values of the table's compaction policy extra configuration property.
+extern const char kBudgetedCompactionPolicy[];
+extern const char kTimeWindowCompactionPolicy[];
+
 // Convert a extra configuration properties protobuf to map.
 Status ExtraConfigPBToMap(const TableExtraConfigPB& pb,
                           std::map<std::string, std::string>* configs);
@@ -28,6 +28,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <google/protobuf/repeated_field.h>
 
 #include "kudu/common/common.pb.h"
 #include "kudu/common/wire_protocol.h"
@@ -42,8 +43,13 @@
 #include "kudu/gutil/strings/substitute.h"
 #include "kudu/rpc/periodic.h"
 #include "kudu/rpc/response_callback.h"
+#include "kudu/rpc/messenger.h"
 #include "kudu/rpc/rpc_controller.h"
+#include "kudu/rpc/rpc_header.pb.h"
 #include "kudu/tserver/tserver.pb.h"
+#include "kudu/util/compression/compression.pb.h"
+#include "kudu/util/compression/compression_codec.h"
+#include "kudu/util/faststring.h"
 #include "kudu/util/fault_injection.h"
 #include "kudu/util/flag_tags.h"
 #include "kudu/util/logging.h"
@@ -82,7 +88,34 @@ DEFINE_bool(enable_tablet_copy, true,
             "replica. For testing purposes only.");
 TAG_FLAG(enable_tablet_copy, unsafe);
 
+DEFINE_bool(consensus_multi_raft_batching, false,
+            "Whether to coalesce the status-only consensus updates, such as "
+            "heartbeats, which the leaders hosted on this server send to the "
+            "same remote server into batched MultiRaftUpdateConsensus RPCs. "
+            "Updates which carry ops are always sent on their own.");
+TAG_FLAG(consensus_multi_raft_batching, experimental);
+TAG_FLAG(consensus_multi_raft_batching, runtime);
+
+DEFINE_int32(consensus_multi_raft_batch_window_ms, 10,
+             "The longest time a status-only consensus update waits for "
+             "others to join its batch when --consensus_multi_raft_batching "
+             "is enabled.");
+TAG_FLAG(consensus_multi_raft_batch_window_ms, experimental);
+TAG_FLAG(consensus_multi_raft_batch_window_ms, runtime);
+
+DEFINE_int32(consensus_multi_raft_max_batch_size, 1000,
+             "The maximum number of consensus updates in a batch. A batch "
+             "which reaches this size is sent right away.");
+TAG_FLAG(consensus_multi_raft_max_batch_size, experimental);
+TAG_FLAG(consensus_multi_raft_max_batch_size, runtime);
+
+DEFINE_string(consensus_multi_raft_compression_codec, "no_compression",
+              "Codec to use for compressing batches of consensus updates, "
+              "e.g. LZ4.");
+TAG_FLAG(consensus_multi_raft_compression_codec, experimental);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_int64(rpc_max_message_size);
 
 using kudu::pb_util::SecureShortDebugString;
 using kudu::rpc::Messenger;
@@ -287,10 +320,10 @@ void Peer::SendNextRequest(bool even_if_queue_empty) {
   // Capture a shared_ptr reference into the RPC callback so that we're guaranteed
   // that this object outlives the RPC.
   shared_ptr<Peer> s_this = shared_from_this();
-  proxy_->UpdateAsync(request_, &response_, &controller_,
-                      [s_this]() {
-                        s_this->ProcessResponse();
-                      });
+  proxy_->UpdateWithCachedOpsAsync(&request_, replicate_msg_refs_, &response_, &controller_,
+                                   [s_this]() {
+                                     s_this->ProcessResponse();
+                                   });
 }
 
 void Peer::StartElection() {
@@ -513,9 +546,11 @@ Peer::~Peer() {
 }
 
 RpcPeerProxy::RpcPeerProxy(HostPort hostport,
-                           unique_ptr<ConsensusServiceProxy> consensus_proxy)
+                           unique_ptr<ConsensusServiceProxy> consensus_proxy,
+                           shared_ptr<MultiRaftBatcher> batcher)
     : hostport_(std::move(hostport)),
-      consensus_proxy_(std::move(DCHECK_NOTNULL(consensus_proxy))) {
+      consensus_proxy_(std::move(DCHECK_NOTNULL(consensus_proxy))),
+      batcher_(std::move(batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB& request,
@@ -523,9 +558,55 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB& request,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  // Peer doesn't touch its request while it's in flight, so it's safe to
+  // hand it to the batcher, which serializes it only once the batch is sent.
+  if (batcher_ && request.ops_size() == 0 && FLAGS_consensus_multi_raft_batching) {
+    batcher_->UpdateAsync(request, response, controller, callback);
+    return;
+  }
   consensus_proxy_->UpdateConsensusAsync(request, response, controller, callback);
 }
 
+void RpcPeerProxy::UpdateWithCachedOpsAsync(ConsensusRequestPB* request,
+                                            const vector<ReplicateRefPtr>& ops,
+                                            ConsensusResponsePB* response,
+                                            rpc::RpcController* controller,
+                                            const rpc::ResponseCallback& callback) {
+  bool all_encoded = request->ops_size() > 0 &&
+                     request->ops_size() == static_cast<int>(ops.size());
+  for (int i = 0; all_encoded && i < request->ops_size(); i++) {
+    DCHECK_EQ(ops[i]->get(), &request->ops(i));
+    all_encoded = ops[i]->encoded() != nullptr;
+  }
+  if (!all_encoded) {
+    UpdateAsync(*request, response, controller, callback);
+    return;
+  }
+
+  // Serialize everything but the ops, then parse the result back in as
+  // unknown fields of the stand-in message. The ops don't belong to 'request'
+  // (they're borrowed from the log cache), so swapping them out and back in
+  // is only a pointer swap.
+  EncodedOpsConsensusRequestPB wire_request;
+  {
+    google::protobuf::RepeatedPtrField<ReplicateMsg> detached_ops;
+    detached_ops.Swap(request->mutable_ops());
+    string header;
+    CHECK(request->SerializeToString(&header));
+    detached_ops.Swap(request->mutable_ops());
+    CHECK(wire_request.ParseFromString(header));
+  }
+  // Borrow the retained encodings rather than copying them. The request is
+  // serialized before AsyncRequest() returns, so they can be released right
+  // after.
+  for (const auto& op : ops) {
+    wire_request.mutable_ops()->AddAllocated(const_cast<string*>(op->encoded()));
+  }
+  controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  consensus_proxy_->AsyncRequest("UpdateConsensus", wire_request, response, controller, callback);
+  wire_request.mutable_ops()->ExtractSubrange(0, wire_request.ops_size(), nullptr);
+}
+
 void RpcPeerProxy::StartElectionAsync(const RunLeaderElectionRequestPB& request,
                                       RunLeaderElectionResponsePB* response,
                                       rpc::RpcController* controller,
@@ -574,9 +655,11 @@ Status CreateConsensusServiceProxyForHost(
 } // anonymous namespace
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(shared_ptr<Messenger> messenger,
-                                         DnsResolver* dns_resolver)
+                                         DnsResolver* dns_resolver,
+                                         MultiRaftManager* multi_raft_manager)
     : messenger_(std::move(messenger)),
-      dns_resolver_(dns_resolver) {
+      dns_resolver_(dns_resolver),
+      multi_raft_manager_(multi_raft_manager) {
 }
 
 Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
@@ -585,10 +668,231 @@ Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
   unique_ptr<ConsensusServiceProxy> new_proxy;
   RETURN_NOT_OK(CreateConsensusServiceProxyForHost(
       hostport, messenger_, dns_resolver_, &new_proxy));
-  proxy->reset(new RpcPeerProxy(std::move(hostport), std::move(new_proxy)));
+  shared_ptr<MultiRaftBatcher> batcher;
+  if (multi_raft_manager_) {
+    RETURN_NOT_OK(multi_raft_manager_->GetBatcher(hostport, &batcher));
+  }
+  proxy->reset(new RpcPeerProxy(std::move(hostport), std::move(new_proxy), std::move(batcher)));
   return Status::OK();
 }
 
+MultiRaftBatcher::MultiRaftBatcher(HostPort hostport,
+                                   shared_ptr<Messenger> messenger,
+                                   unique_ptr<ConsensusServiceProxy> consensus_proxy,
+                                   const CompressionCodec* codec)
+    : hostport_(std::move(hostport)),
+      messenger_(std::move(messenger)),
+      consensus_proxy_(std::move(DCHECK_NOTNULL(consensus_proxy))),
+      codec_(codec),
+      supported_(true),
+      send_scheduled_(false) {
+}
+
+void MultiRaftBatcher::UpdateAsync(const ConsensusRequestPB& request,
+                                   ConsensusResponsePB* response,
+                                   rpc::RpcController* controller,
+                                   const rpc::ResponseCallback& callback) {
+  PendingUpdate update = { &request, response, controller, callback };
+  if (PREDICT_FALSE(!supported_)) {
+    SendIndividually(update);
+    return;
+  }
+
+  bool send_now = false;
+  bool schedule_send = false;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    pending_.emplace_back(std::move(update));
+    if (pending_.size() >= FLAGS_consensus_multi_raft_max_batch_size) {
+      send_now = true;
+    } else if (!send_scheduled_) {
+      send_scheduled_ = true;
+      schedule_send = true;
+    }
+  }
+  if (send_now) {
+    SendBatch();
+  } else if (schedule_send) {
+    // Even if the reactor is shutting down, send the batch so that its
+    // updates fail, rather than leaving their callers waiting.
+    shared_ptr<MultiRaftBatcher> s_this = shared_from_this();
+    messenger_->ScheduleOnReactor(
+        [s_this](const Status& /*s*/) { s_this->SendBatch(); },
+        MonoDelta::FromMilliseconds(FLAGS_consensus_multi_raft_batch_window_ms));
+  }
+}
+
+void MultiRaftBatcher::SendBatch() {
+  shared_ptr<Batch> batch = std::make_shared<Batch>();
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    batch->updates.swap(pending_);
+    send_scheduled_ = false;
+  }
+  if (batch->updates.empty()) {
+    // Already sent along with a batch which filled up.
+    return;
+  }
+
+  // The requests still belong to the callers, so they're only borrowed by
+  // the batch until it has been serialized into the RPC.
+  MultiRaftConsensusRequestPB req;
+  for (const auto& update : batch->updates) {
+    req.mutable_requests()->AddAllocated(const_cast<ConsensusRequestPB*>(update.request));
+  }
+  const int num_requests = req.requests_size();
+  if (codec_) {
+    string compressed;
+    int64_t uncompressed_size;
+    Status s = CompressPB(*codec_, req, &compressed, &uncompressed_size);
+    req.mutable_requests()->ExtractSubrange(0, num_requests, nullptr);
+    if (PREDICT_FALSE(!s.ok())) {
+      KLOG_EVERY_N_SECS(WARNING, 10) << Substitute(
+          "Unable to compress batch of consensus updates to $0: $1",
+          hostport_.ToString(), s.ToString()) << THROTTLE_MSG;
+      for (const auto& update : batch->updates) {
+        SendIndividually(update);
+      }
+      return;
+    }
+    req.set_compression_codec(codec_->type());
+    req.mutable_compressed_requests()->swap(compressed);
+    req.set_uncompressed_size(uncompressed_size);
+  }
+
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  shared_ptr<MultiRaftBatcher> s_this = shared_from_this();
+  consensus_proxy_->MultiRaftUpdateConsensusAsync(
+      req, &batch->response, &batch->controller,
+      [s_this, batch]() { s_this->ProcessBatchResponse(batch); });
+  if (!codec_) {
+    req.mutable_requests()->ExtractSubrange(0, num_requests, nullptr);
+  }
+}
+
+void MultiRaftBatcher::ProcessBatchResponse(const shared_ptr<Batch>& batch) {
+  // Note: This method runs on the reactor thread.
+  Status s = batch->controller.status();
+  if (PREDICT_FALSE(!s.ok())) {
+    const rpc::ErrorStatusPB* err = batch->controller.error_response();
+    if (err && err->has_code() &&
+        err->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_METHOD) {
+      LOG(INFO) << Substitute("$0 doesn't support batched consensus updates: "
+                              "sending them separately", hostport_.ToString());
+      supported_ = false;
+    }
+  } else if (batch->response.has_error()) {
+    s = StatusFromPB(batch->response.error().status());
+  } else if (batch->response.has_compressed_responses()) {
+    if (PREDICT_FALSE(!codec_)) {
+      s = Status::Corruption("unexpected compressed responses");
+    } else {
+      MultiRaftConsensusResponsePB uncompressed;
+      s = UncompressPB(*codec_, batch->response.compressed_responses(),
+                       batch->response.uncompressed_size(), &uncompressed);
+      batch->response.mutable_responses()->Swap(uncompressed.mutable_responses());
+    }
+  }
+  if (s.ok() && batch->response.responses_size() != batch->updates.size()) {
+    s = Status::Corruption(Substitute("got $0 responses to a batch of $1 updates",
+                                      batch->response.responses_size(),
+                                      batch->updates.size()));
+  }
+
+  if (PREDICT_FALSE(!s.ok())) {
+    if (supported_) {
+      KLOG_EVERY_N_SECS(WARNING, 10) << Substitute(
+          "Batch of consensus updates to $0 failed, sending them separately: $1",
+          hostport_.ToString(), s.ToString()) << THROTTLE_MSG;
+    }
+    for (const auto& update : batch->updates) {
+      SendIndividually(update);
+    }
+    return;
+  }
+
+  for (int i = 0; i < batch->updates.size(); i++) {
+    const auto& update = batch->updates[i];
+    update.response->Swap(batch->response.mutable_responses(i));
+    update.callback();
+  }
+}
+
+void MultiRaftBatcher::SendIndividually(const PendingUpdate& update) {
+  consensus_proxy_->UpdateConsensusAsync(*update.request, update.response,
+                                         update.controller, update.callback);
+}
+
+MultiRaftManager::MultiRaftManager(shared_ptr<Messenger> messenger,
+                                   DnsResolver* dns_resolver)
+    : messenger_(std::move(messenger)),
+      dns_resolver_(dns_resolver),
+      codec_(nullptr) {
+  CHECK_OK(GetCompressionCodec(
+      GetCompressionCodecType(FLAGS_consensus_multi_raft_compression_codec), &codec_));
+}
+
+Status MultiRaftManager::GetBatcher(const HostPort& hostport,
+                                    shared_ptr<MultiRaftBatcher>* batcher) {
+  {
+    std::lock_guard<Mutex> l(lock_);
+    auto it = batchers_.find(hostport);
+    if (it != batchers_.end()) {
+      *batcher = it->second.lock();
+      if (*batcher) {
+        return Status::OK();
+      }
+    }
+  }
+
+  // Resolve the address outside the lock.
+  unique_ptr<ConsensusServiceProxy> proxy;
+  RETURN_NOT_OK(CreateConsensusServiceProxyForHost(
+      hostport, messenger_, dns_resolver_, &proxy));
+  shared_ptr<MultiRaftBatcher> new_batcher = std::make_shared<MultiRaftBatcher>(
+      hostport, messenger_, std::move(proxy), codec_);
+
+  std::lock_guard<Mutex> l(lock_);
+  auto& entry = batchers_[hostport];
+  *batcher = entry.lock();
+  if (!*batcher) {
+    // Nobody else created one in the meantime.
+    entry = new_batcher;
+    *batcher = std::move(new_batcher);
+  }
+  return Status::OK();
+}
+
+Status CompressPB(const CompressionCodec& codec,
+                  const google::protobuf::MessageLite& msg,
+                  string* compressed,
+                  int64_t* uncompressed_size) {
+  faststring serialized;
+  pb_util::SerializeToString(msg, &serialized);
+  compressed->resize(codec.MaxCompressedLength(serialized.size()));
+  size_t compressed_size;
+  RETURN_NOT_OK(codec.Compress(Slice(serialized),
+                               reinterpret_cast<uint8_t*>(&(*compressed)[0]),
+                               &compressed_size));
+  compressed->resize(compressed_size);
+  *uncompressed_size = serialized.size();
+  return Status::OK();
+}
+
+Status UncompressPB(const CompressionCodec& codec,
+                    const string& compressed,
+                    int64_t uncompressed_size,
+                    google::protobuf::MessageLite* msg) {
+  if (PREDICT_FALSE(uncompressed_size < 0 ||
+                    uncompressed_size > FLAGS_rpc_max_message_size)) {
+    return Status::Corruption(Substitute("invalid uncompressed size: $0", uncompressed_size));
+  }
+  faststring uncompressed;
+  uncompressed.resize(uncompressed_size);
+  RETURN_NOT_OK(codec.Uncompress(Slice(compressed), uncompressed.data(), uncompressed_size));
+  return pb_util::ParseFromArray(msg, uncompressed.data(), uncompressed_size);
+}
+
 Status SetPermanentUuidForRemotePeer(
     const shared_ptr<rpc::Messenger>& messenger,
     DnsResolver* resolver,
@@ -21,6 +21,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <glog/logging.h>
@@ -33,10 +34,12 @@
 #include "kudu/rpc/rpc_controller.h"
 #include "kudu/util/locks.h"
 #include "kudu/util/make_shared.h"
+#include "kudu/util/mutex.h"
 #include "kudu/util/net/net_util.h"
 #include "kudu/util/status.h"
 
 namespace kudu {
+class CompressionCodec;
 class DnsResolver;
 class ThreadPoolToken;
 
@@ -46,6 +49,8 @@ class PeriodicTimer;
 }
 
 namespace consensus {
+class MultiRaftBatcher;
+class MultiRaftManager;
 class PeerMessageQueue;
 class PeerProxy;
 
@@ -220,6 +225,19 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Like UpdateAsync(), where 'ops' are the log cache entries whose messages
+  // make up 'request->ops()', in the same order. Implementations may send the
+  // encoding retained with those entries rather than serializing the ops
+  // again. 'request' may be modified while the call is issued, but it's
+  // restored to its original state before this returns.
+  virtual void UpdateWithCachedOpsAsync(ConsensusRequestPB* request,
+                                        const std::vector<ReplicateRefPtr>& /*ops*/,
+                                        ConsensusResponsePB* response,
+                                        rpc::RpcController* controller,
+                                        const rpc::ResponseCallback& callback) {
+    UpdateAsync(*request, response, controller, callback);
+  }
+
   // Asks a peer to vote for a candidate.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB& request,
                                          VoteResponsePB* response,
@@ -260,14 +278,25 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
+  // If 'batcher' is non-null, status-only updates are sent through it while
+  // --consensus_multi_raft_batching is enabled.
   RpcPeerProxy(HostPort hostport,
-               std::unique_ptr<ConsensusServiceProxy> consensus_proxy);
+               std::unique_ptr<ConsensusServiceProxy> consensus_proxy,
+               std::shared_ptr<MultiRaftBatcher> batcher = nullptr);
 
   void UpdateAsync(const ConsensusRequestPB& request,
                    ConsensusResponsePB* response,
                    rpc::RpcController* controller,
                    const rpc::ResponseCallback& callback) override;
 
+  // If every op in 'ops' has its encoding retained by the log cache, sends
+  // those bytes as they are instead of serializing 'request->ops()'.
+  void UpdateWithCachedOpsAsync(ConsensusRequestPB* request,
+                                const std::vector<ReplicateRefPtr>& ops,
+                                ConsensusResponsePB* response,
+                                rpc::RpcController* controller,
+                                const rpc::ResponseCallback& callback) override;
+
   void RequestConsensusVoteAsync(const VoteRequestPB& request,
                                  VoteResponsePB* response,
                                  rpc::RpcController* controller,
@@ -288,13 +317,17 @@ class RpcPeerProxy : public PeerProxy {
  private:
   const HostPort hostport_;
   std::unique_ptr<ConsensusServiceProxy> consensus_proxy_;
+  std::shared_ptr<MultiRaftBatcher> batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
+  // 'multi_raft_manager' may be null, in which case consensus updates are
+  // never batched.
   RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger,
-                      DnsResolver* dns_resolver);
+                      DnsResolver* dns_resolver,
+                      MultiRaftManager* multi_raft_manager = nullptr);
   ~RpcPeerProxyFactory() = default;
 
   Status NewProxy(const RaftPeerPB& peer_pb,
@@ -307,8 +340,109 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
  private:
   std::shared_ptr<rpc::Messenger> messenger_;
   DnsResolver* dns_resolver_;
+  MultiRaftManager* multi_raft_manager_;
+};
+
+// Coalesces the status-only consensus updates, such as heartbeats, which the
+// leaders hosted on this server send to the same remote server into batched
+// MultiRaftUpdateConsensus RPCs.
+//
+// An update waits at most --consensus_multi_raft_batch_window_ms for others to
+// join its batch. If the batch as a whole fails, e.g. because the remote
+// server doesn't support MultiRaftUpdateConsensus, its updates are resent as
+// separate UpdateConsensus RPCs so that each caller sees the error for its
+// own update.
+class MultiRaftBatcher : public std::enable_shared_from_this<MultiRaftBatcher> {
+ public:
+  MultiRaftBatcher(HostPort hostport,
+                   std::shared_ptr<rpc::Messenger> messenger,
+                   std::unique_ptr<ConsensusServiceProxy> consensus_proxy,
+                   const CompressionCodec* codec);
+
+  // Sends 'request' to the remote server as part of the next batch. This
+  // follows the contract of PeerProxy::UpdateAsync(), except that 'request'
+  // must also remain valid and unchanged until 'callback' runs.
+  void UpdateAsync(const ConsensusRequestPB& request,
+                   ConsensusResponsePB* response,
+                   rpc::RpcController* controller,
+                   const rpc::ResponseCallback& callback);
+
+ private:
+  struct PendingUpdate {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+  struct Batch {
+    std::vector<PendingUpdate> updates;
+    MultiRaftConsensusResponsePB response;
+    rpc::RpcController controller;
+  };
+
+  // Sends all the pending updates in one batch.
+  void SendBatch();
+
+  // Hands the responses of 'batch' back to their callers.
+  void ProcessBatchResponse(const std::shared_ptr<Batch>& batch);
+
+  // Sends 'update' on its own, as an UpdateConsensus RPC.
+  void SendIndividually(const PendingUpdate& update);
+
+  const HostPort hostport_;
+  std::shared_ptr<rpc::Messenger> messenger_;
+  std::unique_ptr<ConsensusServiceProxy> consensus_proxy_;
+
+  // The codec used to compress batches, or null if they're not compressed.
+  const CompressionCodec* codec_;
+
+  // Set to false once the remote server turns out not to support batches.
+  std::atomic<bool> supported_;
+
+  // Protects the fields below.
+  simple_spinlock lock_;
+  std::vector<PendingUpdate> pending_;
+  bool send_scheduled_;
+};
+
+// Hands out the MultiRaftBatcher for each remote server, so that all the
+// replicas hosted on this server batch their updates together.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger,
+                   DnsResolver* dns_resolver);
+
+  // Returns the batcher for updates to the server at 'hostport', creating it
+  // if there is none yet.
+  Status GetBatcher(const HostPort& hostport,
+                    std::shared_ptr<MultiRaftBatcher>* batcher);
+
+ private:
+  std::shared_ptr<rpc::Messenger> messenger_;
+  DnsResolver* dns_resolver_;
+  const CompressionCodec* codec_;
+
+  // Batchers are dropped once no proxy refers to them anymore.
+  Mutex lock_;
+  std::unordered_map<HostPort,
+                     std::weak_ptr<MultiRaftBatcher>,
+                     HostPortHasher,
+                     HostPortEqualityPredicate> batchers_;
 };
 
+// Serializes 'msg' and compresses it with 'codec' into 'compressed', setting
+// 'uncompressed_size' to the size of the serialized message.
+Status CompressPB(const CompressionCodec& codec,
+                  const google::protobuf::MessageLite& msg,
+                  std::string* compressed,
+                  int64_t* uncompressed_size);
+
+// Reverses CompressPB(), parsing the uncompressed message into 'msg'.
+Status UncompressPB(const CompressionCodec& codec,
+                    const std::string& compressed,
+                    int64_t uncompressed_size,
+                    google::protobuf::MessageLite* msg);
+
 // Query the consensus service at last known host/port that is
 // specified in 'remote_peer' and set the 'permanent_uuid' field based
 // on the response.
@@ -18,6 +18,7 @@
 #include "kudu/consensus/log.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cerrno>
 #include <cstdint>
@@ -26,6 +27,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gflags/gflags.h>
@@ -44,6 +46,7 @@
 #include "kudu/consensus/log_util.h"
 #include "kudu/consensus/opid.pb.h"
 #include "kudu/consensus/opid_util.h"
+#include "kudu/consensus/ref_counted_replicate.h"
 #include "kudu/gutil/ref_counted.h"
 #include "kudu/gutil/stl_util.h"
 #include "kudu/gutil/strings/substitute.h"
@@ -55,14 +58,17 @@
 #include "kudu/util/file_cache.h"
 #include "kudu/util/metrics.h"
 #include "kudu/util/random.h"
+#include "kudu/util/scoped_cleanup.h"
 #include "kudu/util/status.h"
 #include "kudu/util/stopwatch.h"
 #include "kudu/util/test_macros.h"
 #include "kudu/util/test_util.h"
+#include "kudu/util/threadpool.h"
 
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_bool(log_async_sync);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_int32(log_max_segments_to_retain);
 DECLARE_double(log_inject_io_error_on_preallocate_fraction);
@@ -82,6 +88,7 @@ using consensus::MakeOpId;
 using consensus::NO_OP;
 using consensus::OpId;
 using consensus::ReplicateMsg;
+using consensus::ReplicateRefPtr;
 using consensus::WRITE_OP;
 using strings::Substitute;
 
@@ -673,6 +680,146 @@ TEST_P(LogTestOptionalCompression, TestWaitUntilAllFlushed) {
   }
 }
 
+// Tests that entries appended while their predecessors are synced on the
+// sync thread are all written, across segment roll overs.
+TEST_P(LogTestOptionalCompression, TestAsyncSync) {
+  FLAGS_log_async_sync = true;
+  ASSERT_OK(BuildLog());
+  log_->SetMaxSegmentSizeForTests(990);
+  constexpr int kNumPairs = 500;
+  for (int i = 0; i < kNumPairs; i++) {
+    OpId opid = MakeOpId(1, current_index_++);
+    ASSERT_OK(AppendReplicateBatch(opid, APPEND_ASYNC));
+    ASSERT_OK(AppendCommit(opid, APPEND_ASYNC));
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  ASSERT_OK(log_->Close());
+
+  shared_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_.get(),
+                            /*index*/nullptr,
+                            kTestTablet,
+                            metric_entity_tablet_,
+                            file_cache_.get(),
+                            &reader));
+  SegmentSequence segments;
+  reader->GetSegmentsSnapshot(&segments);
+  ASSERT_GT(segments.size(), 1);
+  int num_entries = 0;
+  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
+    entries_.clear();
+    ASSERT_OK(segment->ReadEntries(&entries_));
+    num_entries += entries_.size();
+  }
+  ASSERT_EQ(2 * kNumPairs, num_entries);
+}
+
+// Tests that logs sharing a single-threaded append pool don't hold on to its
+// thread while idle, and write all of their entries.
+TEST_F(LogTest, TestSharedAppendPool) {
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("wal-append").set_max_threads(1).Build(&pool));
+  options_.append_pool = pool.get();
+  ASSERT_OK(BuildLog());
+  scoped_refptr<Log> other_log;
+  ASSERT_OK(Log::Open(options_,
+                      fs_manager_.get(),
+                      file_cache_.get(),
+                      "other-tablet",
+                      SchemaBuilder(schema_).Build(),
+                      0, // schema_version
+                      metric_entity_tablet_.get(),
+                      &other_log));
+
+  constexpr int kNumOps = 100;
+  OpId op_id = MakeOpId(1, 1);
+  OpId other_op_id = MakeOpId(1, 1);
+  for (int i = 0; i < kNumOps; i++) {
+    ASSERT_OK(AppendNoOp(&op_id));
+    ASSERT_OK(AppendNoOpToLogSync(clock_.get(), other_log.get(), &other_op_id));
+  }
+  for (Log* log : { log_.get(), other_log.get() }) {
+    SegmentSequence segments;
+    log->reader()->GetSegmentsSnapshot(&segments);
+    int num_entries = 0;
+    for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
+      entries_.clear();
+      ASSERT_OK(segment->ReadEntries(&entries_));
+      num_entries += entries_.size();
+    }
+    ASSERT_EQ(kNumOps, num_entries);
+  }
+  // The logs must release their tokens before the pool is destroyed.
+  ASSERT_OK(other_log->Close());
+  ASSERT_OK(log_->Close());
+}
+
+// Tests that logs which always have entries queued take turns on a shared
+// append pool with fewer threads than logs, rather than holding on to them.
+TEST_F(LogTest, TestSharedAppendPoolFairness) {
+  constexpr int kNumLogs = 4;
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("wal-append").set_max_threads(2).Build(&pool));
+  options_.append_pool = pool.get();
+
+  vector<scoped_refptr<Log>> logs(kNumLogs);
+  for (int i = 0; i < kNumLogs; i++) {
+    ASSERT_OK(Log::Open(options_,
+                        fs_manager_.get(),
+                        file_cache_.get(),
+                        Substitute("tablet-$0", i),
+                        SchemaBuilder(schema_).Build(),
+                        0, // schema_version
+                        metric_entity_tablet_.get(),
+                        &logs[i]));
+  }
+
+  // Each writer keeps its log's queue busy with asynchronous appends.
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> num_appended[kNumLogs];
+  vector<std::thread> writers;
+  for (int i = 0; i < kNumLogs; i++) {
+    num_appended[i] = 0;
+    writers.emplace_back([&, i]() {
+      OpId op_id = MakeOpId(1, 1);
+      while (!stop) {
+        ReplicateRefPtr replicate = consensus::make_scoped_refptr_replicate(new ReplicateMsg());
+        replicate->get()->mutable_id()->CopyFrom(op_id);
+        replicate->get()->set_op_type(NO_OP);
+        replicate->get()->set_timestamp(clock_->Now().ToUint64());
+        op_id.set_index(op_id.index() + 1);
+        CHECK_OK(logs[i]->AsyncAppendReplicates(
+            { replicate },
+            [&num_appended, i](const Status& s) {
+              CHECK_OK(s);
+              num_appended[i]++;
+            }));
+      }
+    });
+  }
+  auto stop_writers = [&]() {
+    if (!stop.exchange(true)) {
+      for (auto& t : writers) {
+        t.join();
+      }
+    }
+  };
+  SCOPED_CLEANUP({ stop_writers(); });
+
+  // While all of the logs are busy, every one of them makes progress.
+  ASSERT_EVENTUALLY([&]() {
+    for (int i = 0; i < kNumLogs; i++) {
+      ASSERT_GT(num_appended[i], 0) << "log " << i;
+    }
+  });
+
+  stop_writers();
+  for (auto& log : logs) {
+    ASSERT_OK(log->WaitUntilAllFlushed());
+    ASSERT_OK(log->Close());
+  }
+}
+
 // Tests log reopening and that GC'ing the old log's segments works.
 TEST_P(LogTestOptionalCompression, TestLogReopenAndGC) {
   ASSERT_OK(BuildLog());
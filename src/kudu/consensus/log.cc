@@ -24,6 +24,7 @@
 #include <mutex>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <gflags/gflags.h>
@@ -43,6 +44,7 @@
 #include "kudu/gutil/walltime.h"
 #include "kudu/util/async_util.h"
 #include "kudu/util/compression/compression_codec.h"
+#include "kudu/util/condition_variable.h"
 #include "kudu/util/debug/trace_event.h"
 #include "kudu/util/env.h"
 #include "kudu/util/env_util.h"
@@ -53,6 +55,7 @@
 #include "kudu/util/logging.h"
 #include "kudu/util/metrics.h"
 #include "kudu/util/monotime.h"
+#include "kudu/util/mutex.h"
 #include "kudu/util/path_util.h"
 #include "kudu/util/pb_util.h"
 #include "kudu/util/random.h"
@@ -84,6 +87,12 @@ DEFINE_int32(group_commit_queue_size_bytes, 4 * 1024 * 1024,
              "Maximum size of the group commit queue in bytes");
 TAG_FLAG(group_commit_queue_size_bytes, advanced);
 
+DEFINE_bool(log_async_sync, false,
+            "Whether to sync each group of WAL entries on a separate thread, so that "
+            "writing the next group to the log segment overlaps with the sync of the "
+            "previous one. The entries of a group are only acknowledged once they're "
+            "synced either way.");
+TAG_FLAG(log_async_sync, experimental);
 
 DEFINE_int32(log_thread_idle_threshold_ms, 1000,
              "Number of milliseconds after which the log append thread decides that a "
@@ -214,6 +223,16 @@ string LogContext::LogPrefix() const {
 //    This is done in GoIdle().
 //
 // See the implementation comments in Wake() and GoIdle() for details.
+//
+// With --log_async_sync, the task hands each written group off to a second
+// single-threaded pool which syncs it and runs its callbacks, and moves on to
+// write the next group in the meantime. Groups which queue up behind a sync
+// in progress are synced together by the next one.
+//
+// If LogOptions::append_pool is set, the task runs on a serial token of that
+// pool, shared with the logs of other tablets, instead. It then doesn't wait
+// for more batches once the queue is empty, so as not to hold on to a thread
+// of the pool, and syncs each group itself.
 class Log::AppendThread {
  public:
   explicit AppendThread(Log* log);
@@ -250,6 +269,18 @@ class Log::AppendThread {
   // Handle the actual appending of a group of entries.
   void HandleBatches(vector<unique_ptr<LogEntryBatch>> entry_batches);
 
+  // Syncs the log if 'needs_sync' and runs the callbacks of 'entry_batches'.
+  void SyncAndRunCallbacks(vector<unique_ptr<LogEntryBatch>> entry_batches,
+                           bool needs_sync);
+
+  // Queues written batches to be synced on 'sync_pool_'. Blocks while the
+  // batches already queued exceed the group commit queue size.
+  void EnqueueForSync(vector<unique_ptr<LogEntryBatch>> entry_batches,
+                      bool needs_sync);
+
+  // The task submitted to 'sync_pool_', which syncs all queued batches.
+  void ProcessSyncQueue();
+
   string LogPrefix() const;
 
   Log* const log_;
@@ -265,18 +296,39 @@ class Log::AppendThread {
   Atomic32 thread_state_ = IDLE;
 
   // Pool with a single thread, which handles shutting down the thread
-  // when idle.
+  // when idle. Null if the log appends on a shared pool.
   unique_ptr<ThreadPool> append_pool_;
+
+  // Token on which the ProcessQueue() tasks are submitted, either to
+  // 'append_pool_' or to the shared pool.
+  unique_ptr<ThreadPoolToken> append_token_;
+
+  // Pool with a single thread on which written batches are synced, or null
+  // if batches are synced on the append thread.
+  unique_ptr<ThreadPool> sync_pool_;
+
+  // Batches written but not yet synced, in order.
+  Mutex sync_queue_lock_;
+  ConditionVariable sync_queue_cond_;
+  vector<unique_ptr<LogEntryBatch>> sync_queue_;
+  size_t sync_queue_bytes_ = 0;
+  bool sync_queue_needs_sync_ = false;
 };
 
 
 Log::AppendThread::AppendThread(Log *log)
-  : log_(log) {
+  : log_(log),
+    sync_queue_cond_(&sync_queue_lock_) {
 }
 
 Status Log::AppendThread::Init() {
-  DCHECK(!append_pool_) << "Already initialized";
+  DCHECK(!append_token_) << "Already initialized";
   VLOG_WITH_PREFIX(1) << "Starting log append thread";
+  ThreadPool* shared_pool = log_->options_.append_pool;
+  if (shared_pool) {
+    append_token_ = shared_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+    return Status::OK();
+  }
   RETURN_NOT_OK(ThreadPoolBuilder("wal-append")
                 .set_min_threads(0)
                 // Only need one thread since we'll only schedule one
@@ -286,15 +338,22 @@ Status Log::AppendThread::Init() {
                 // handles waiting for work while idle.
                 .set_idle_timeout(MonoDelta::FromSeconds(0))
                 .Build(&append_pool_));
+  append_token_ = append_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  if (FLAGS_log_async_sync) {
+    RETURN_NOT_OK(ThreadPoolBuilder("wal-sync")
+                  .set_min_threads(0)
+                  .set_max_threads(1)
+                  .Build(&sync_pool_));
+  }
   return Status::OK();
 }
 
 void Log::AppendThread::Wake() {
-  DCHECK(append_pool_);
+  DCHECK(append_token_);
   auto old_status = base::subtle::NoBarrier_CompareAndSwap(
       &thread_state_, IDLE, ACTIVE);
   if (old_status == IDLE) {
-    CHECK_OK(append_pool_->Submit([this]() { this->ProcessQueue(); }));
+    CHECK_OK(append_token_->Submit([this]() { this->ProcessQueue(); }));
   }
 }
 
@@ -346,9 +405,12 @@ bool Log::AppendThread::GoIdle() {
 void Log::AppendThread::ProcessQueue() {
   DCHECK_EQ(ANNOTATE_UNPROTECTED_READ(thread_state_), ACTIVE);
   VLOG_WITH_PREFIX(2) << "WAL Appender going active";
+  const bool shared = log_->options_.append_pool != nullptr;
   while (true) {
-    MonoTime deadline = MonoTime::Now() +
-        MonoDelta::FromMilliseconds(FLAGS_log_thread_idle_threshold_ms);
+    MonoTime deadline = MonoTime::Now();
+    if (!shared) {
+      deadline += MonoDelta::FromMilliseconds(FLAGS_log_thread_idle_threshold_ms);
+    }
     vector<unique_ptr<LogEntryBatch>> entry_batches;
     Status s = log_->entry_queue()->BlockingDrainTo(&entry_batches, deadline);
     if (PREDICT_FALSE(s.IsAborted())) {
@@ -358,6 +420,17 @@ void Log::AppendThread::ProcessQueue() {
       continue;
     }
     HandleBatches(std::move(entry_batches));
+    if (shared) {
+      // Give the shared thread back after each group, so that busy logs take
+      // turns on the pool instead of holding on to its threads. The state
+      // stays ACTIVE, so Wake() won't submit another task meanwhile.
+      CHECK_OK(append_token_->Submit([this]() { this->ProcessQueue(); }));
+      return;
+    }
+  }
+  if (sync_pool_) {
+    // Let the groups in flight finish, so that no work is left behind once idle.
+    sync_pool_->Wait();
   }
   log_->SetActiveSegmentIdle();
   VLOG_WITH_PREFIX(2) << "WAL Appender going idle";
@@ -388,8 +461,51 @@ void Log::AppendThread::HandleBatches(vector<unique_ptr<LogEntryBatch>> entry_ba
     }
   }
 
+  if (sync_pool_) {
+    EnqueueForSync(std::move(entry_batches), !is_all_commits);
+  } else {
+    SyncAndRunCallbacks(std::move(entry_batches), !is_all_commits);
+  }
+}
+
+void Log::AppendThread::EnqueueForSync(vector<unique_ptr<LogEntryBatch>> entry_batches,
+                                       bool needs_sync) {
+  {
+    MutexLock l(sync_queue_lock_);
+    while (sync_queue_bytes_ > static_cast<size_t>(FLAGS_group_commit_queue_size_bytes)) {
+      sync_queue_cond_.Wait();
+    }
+    for (auto& entry_batch : entry_batches) {
+      sync_queue_bytes_ += entry_batch->total_size_bytes();
+      sync_queue_.emplace_back(std::move(entry_batch));
+    }
+    sync_queue_needs_sync_ |= needs_sync;
+  }
+  CHECK_OK(sync_pool_->Submit([this]() { this->ProcessSyncQueue(); }));
+}
+
+void Log::AppendThread::ProcessSyncQueue() {
+  vector<unique_ptr<LogEntryBatch>> entry_batches;
+  bool needs_sync;
+  {
+    MutexLock l(sync_queue_lock_);
+    entry_batches.swap(sync_queue_);
+    needs_sync = sync_queue_needs_sync_;
+    sync_queue_needs_sync_ = false;
+    sync_queue_bytes_ = 0;
+    sync_queue_cond_.Signal();
+  }
+  if (entry_batches.empty()) {
+    // Synced by an earlier task along with the batches queued before it.
+    return;
+  }
+  SyncAndRunCallbacks(std::move(entry_batches), needs_sync);
+}
+
+void Log::AppendThread::SyncAndRunCallbacks(vector<unique_ptr<LogEntryBatch>> entry_batches,
+                                            bool needs_sync) {
   Status s;
-  if (!is_all_commits) {
+  if (needs_sync) {
     s = log_->Sync();
   }
   if (PREDICT_FALSE(!s.ok())) {
@@ -413,10 +529,18 @@ void Log::AppendThread::HandleBatches(vector<unique_ptr<LogEntryBatch>> entry_ba
 
 void Log::AppendThread::Shutdown() {
   log_->entry_queue()->Shutdown();
+  if (append_token_) {
+    append_token_->Wait();
+    // Release the token now: a shared pool may not outlive the Log itself.
+    append_token_.reset();
+  }
   if (append_pool_) {
-    append_pool_->Wait();
     append_pool_->Shutdown();
   }
+  if (sync_pool_) {
+    sync_pool_->Wait();
+    sync_pool_->Shutdown();
+  }
 }
 
 string Log::AppendThread::LogPrefix() const {
@@ -491,6 +615,12 @@ Status SegmentAllocator::AllocateOrRollOverIfNecessary(
 }
 
 Status SegmentAllocator::Sync() {
+  std::lock_guard<Mutex> l(sync_lock_);
+  return SyncUnlocked();
+}
+
+Status SegmentAllocator::SyncUnlocked() {
+  sync_lock_.AssertAcquired();
   TRACE_EVENT0("log", "Sync");
   SCOPED_LATENCY_METRIC(ctx_->metrics, sync_latency);
 
@@ -523,6 +653,13 @@ Status SegmentAllocator::Sync() {
 
 Status SegmentAllocator::FinishCurrentSegment(
     scoped_refptr<ReadableLogSegment>* finished_segment) {
+  std::lock_guard<Mutex> l(sync_lock_);
+  return FinishCurrentSegmentUnlocked(finished_segment);
+}
+
+Status SegmentAllocator::FinishCurrentSegmentUnlocked(
+    scoped_refptr<ReadableLogSegment>* finished_segment) {
+  sync_lock_.AssertAcquired();
   if (hooks_) {
     RETURN_NOT_OK_PREPEND(hooks_->PreClose(), "PreClose hook failed");
   }
@@ -550,7 +687,7 @@ Status SegmentAllocator::FinishCurrentSegment(
     RETURN_NOT_OK(active_segment_->file()->Truncate(
         active_segment_->written_offset()));
   }
-  RETURN_NOT_OK(Sync());
+  RETURN_NOT_OK(SyncUnlocked());
 
   if (hooks_) {
     RETURN_NOT_OK_PREPEND(hooks_->PostClose(), "PostClose hook failed");
@@ -732,8 +869,9 @@ Status SegmentAllocator::RollOver(
 
   // If this isn't the first active segment, close it and return a reopened
   // segment reader so that the caller can update its log reader.
+  std::lock_guard<Mutex> l(sync_lock_);
   if (active_segment_) {
-    RETURN_NOT_OK(FinishCurrentSegment(finished_segment));
+    RETURN_NOT_OK(FinishCurrentSegmentUnlocked(finished_segment));
   }
   RETURN_NOT_OK(SwitchToAllocatedSegment(new_readable_segment));
 
@@ -42,6 +42,7 @@
 #include "kudu/util/faststring.h"
 #include "kudu/util/locks.h"
 #include "kudu/util/metrics.h"
+#include "kudu/util/mutex.h"
 #include "kudu/util/promise.h"
 #include "kudu/util/rw_mutex.h"
 #include "kudu/util/slice.h"
@@ -134,6 +135,8 @@ class SegmentAllocator {
 
 
   // Fsyncs the currently active segment to disk.
+  //
+  // May be called concurrently with appends to the active segment.
   Status Sync();
 
   // Syncs the current segment and writes out the footer.
@@ -192,6 +195,10 @@ class SegmentAllocator {
   // pre-allocation is enabled.
   Status AllocateNewSegment();
 
+  // Same as above, but requires 'sync_lock_' to be held.
+  Status SyncUnlocked();
+  Status FinishCurrentSegmentUnlocked(scoped_refptr<ReadableLogSegment>* finished_segment);
+
   // Swaps in the next segment file as the new active segment.
   //
   // 'new_readable_segment' contains the newly active segment, reopened for reading.
@@ -242,6 +249,10 @@ class SegmentAllocator {
   // The currently active segment being written.
   std::unique_ptr<WritableLogSegment> active_segment_;
 
+  // Held while syncing or swapping out the active segment. Syncs may run on
+  // the log's sync thread while the append thread rolls over to a new segment.
+  Mutex sync_lock_;
+
   // Protects allocation_state_;
   mutable RWMutex allocation_lock_;
   SegmentAllocationState allocation_state_ = kAllocationNotStarted;
@@ -58,6 +58,7 @@
 
 using std::atomic;
 using std::shared_ptr;
+using std::string;
 using std::thread;
 using std::unique_ptr;
 using std::vector;
@@ -65,6 +66,7 @@ using strings::Substitute;
 
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
+DECLARE_bool(log_cache_retain_encoded_ops);
 
 METRIC_DECLARE_entity(server);
 METRIC_DECLARE_entity(tablet);
@@ -302,6 +304,51 @@ TEST_F(LogCacheTest, TestMemoryLimit) {
   ASSERT_EQ(cache_->BytesUsed(), 0);
 }
 
+// Test that the cache can retain the wire encoding of its ops, that the
+// encoding is accounted for, and that a request built from those encodings is
+// read back as the original ConsensusRequestPB.
+TEST_F(LogCacheTest, TestRetainEncodedOps) {
+  const int kPayloadSize = 400 * 1024;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 1, kPayloadSize));
+  int size_without_encoding = cache_->BytesUsed();
+
+  FLAGS_log_cache_retain_encoded_ops = true;
+  ASSERT_OK(AppendReplicateMessagesToCache(2, 2, kPayloadSize));
+  log_->WaitUntilAllFlushed();
+  ASSERT_EQ(3, cache_->num_cached_ops());
+  ASSERT_GT(cache_->BytesUsed(), size_without_encoding + 2 * 2 * 300 * 1024);
+
+  vector<ReplicateRefPtr> messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(3, messages.size());
+  ASSERT_EQ(nullptr, messages[0]->encoded());
+
+  ConsensusRequestPB request;
+  request.set_tablet_id(kTestTablet);
+  request.set_caller_uuid(kPeerUuid);
+  request.set_caller_term(1);
+  request.set_committed_index(1);
+  *request.mutable_preceding_id() = messages[0]->get()->id();
+
+  // Build the stand-in request the way RpcPeerProxy does.
+  string header;
+  ASSERT_TRUE(request.SerializeToString(&header));
+  EncodedOpsConsensusRequestPB wire_request;
+  ASSERT_TRUE(wire_request.ParseFromString(header));
+  for (size_t i = 1; i < messages.size(); i++) {
+    ASSERT_NE(nullptr, messages[i]->encoded());
+    wire_request.add_ops(*messages[i]->encoded());
+    *request.add_ops() = *messages[i]->get();
+  }
+  string wire_bytes;
+  ASSERT_TRUE(wire_request.SerializeToString(&wire_bytes));
+
+  ConsensusRequestPB received;
+  ASSERT_TRUE(received.ParseFromString(wire_bytes));
+  ASSERT_EQ(request.SerializeAsString(), received.SerializeAsString());
+}
+
 TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   // Need to force the global cache memtracker to be destroyed before calling
   // CloseAndreopenCache(), otherwise it'll just be reused instead of recreated
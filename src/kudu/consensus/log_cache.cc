@@ -58,6 +58,14 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_bool(log_cache_retain_encoded_ops, false,
+            "Whether the log cache keeps the serialized form of each cached operation "
+            "alongside it, so that requests to followers reuse those bytes instead of "
+            "encoding every operation again for each peer and each retry. The retained "
+            "bytes count against the log cache memory limits.");
+TAG_FLAG(log_cache_retain_encoded_ops, experimental);
+TAG_FLAG(log_cache_retain_encoded_ops, runtime);
+
 using kudu::pb_util::SecureShortDebugString;
 using std::string;
 using std::vector;
@@ -152,12 +160,21 @@ Status LogCache::AppendOperations(vector<ReplicateRefPtr> msgs,
   CHECK_GT(msgs.size(), 0);
 
   // SpaceUsed is relatively expensive, so do calculations outside the lock
-  // and cache the result with each message.
+  // and cache the result with each message. The same goes for encoding the
+  // messages, which must be done before they're visible to other threads.
+  const bool retain_encoded = FLAGS_log_cache_retain_encoded_ops;
   int64_t mem_required = 0;
   vector<CacheEntry> entries_to_insert;
   entries_to_insert.reserve(msgs.size());
   for (const auto& msg : msgs) {
-    CacheEntry e = { msg, msg->get()->SpaceUsedLong() };
+    size_t mem_usage = msg->get()->SpaceUsedLong();
+    if (retain_encoded && !msg->encoded()) {
+      msg->CacheEncoding();
+    }
+    if (msg->encoded()) {
+      mem_usage += msg->encoded()->capacity();
+    }
+    CacheEntry e = { msg, mem_usage };
     mem_required += e.mem_usage;
     entries_to_insert.emplace_back(std::move(e));
   }
@@ -44,6 +44,7 @@ namespace kudu {
 
 class CompressionCodec;
 class FileCache;
+class ThreadPool;
 
 namespace log {
 
@@ -71,6 +72,11 @@ struct LogOptions {
   // Whether the allocation should happen asynchronously.
   bool async_preallocate_segments;
 
+  // If set, the pool on which entries are appended and synced, shared with
+  // other logs. Otherwise, the log appends on threads of its own. Either way,
+  // the log writes its entries to segments of its own.
+  ThreadPool* append_pool;
+
   LogOptions();
 };
 
@@ -16,6 +16,11 @@
 // under the License.
 #pragma once
 
+#include <memory>
+#include <string>
+
+#include <glog/logging.h>
+
 #include "kudu/consensus/consensus.pb.h"
 #include "kudu/gutil/ref_counted.h"
 
@@ -31,8 +36,27 @@ class RefCountedReplicate : public RefCountedThreadSafe<RefCountedReplicate> {
     return msg_.get();
   }
 
+  // Serializes the message and keeps the result, so that it can be put on the
+  // wire without being encoded again. The message must not be modified
+  // afterwards.
+  //
+  // Not thread-safe: must be called before the message is made visible to
+  // other readers of encoded(), e.g. before it's inserted into the log cache.
+  void CacheEncoding() {
+    DCHECK(!encoded_);
+    encoded_.reset(new std::string());
+    CHECK(msg_->SerializeToString(encoded_.get()));
+  }
+
+  // Returns the wire encoding of the message, or nullptr if CacheEncoding()
+  // hasn't been called.
+  const std::string* encoded() const {
+    return encoded_.get();
+  }
+
  private:
   std::unique_ptr<ReplicateMsg> msg_;
+  std::unique_ptr<std::string> encoded_;
 };
 
 typedef scoped_refptr<RefCountedReplicate> ReplicateRefPtr;
@@ -46,6 +46,7 @@ class BlockId;
 class FileCache;
 class InstanceMetadataPB;
 class MemTracker;
+class ThreadPool;
 
 namespace fs {
 
@@ -295,6 +296,19 @@ class FsManager {
     return block_manager_.get();
   }
 
+  // Returns the pool used to read blocks ahead of scans, or null if blocks
+  // aren't read ahead.
+  ThreadPool* readahead_pool() const {
+    return readahead_pool_;
+  }
+
+  // Sets the pool returned by readahead_pool(). The pool is owned by the
+  // server, which must shut it down only after the readers of the blocks
+  // managed by this FsManager are done with it.
+  void set_readahead_pool(ThreadPool* pool) {
+    readahead_pool_ = pool;
+  }
+
   // Prints the file system trees under the file system roots.
   void DumpFileSystemTree(std::ostream& out);
 
@@ -394,6 +408,8 @@ class FsManager {
 
   ObjectIdGenerator oid_generator_;
 
+  ThreadPool* readahead_pool_;
+
   bool initted_;
 
   DISALLOW_COPY_AND_ASSIGN(FsManager);
@@ -247,6 +247,10 @@ struct FsReport {
 
     // Total number of full LBM containers.
     int64_t lbm_full_container_count = 0;
+
+    // Wall time spent loading and repairing LBM containers. Data directories
+    // are loaded concurrently, so merging takes the maximum.
+    int64_t lbm_load_time_ms = 0;
   };
   Stats stats;
 
@@ -77,6 +77,7 @@ using strings::Substitute;
 
 DECLARE_bool(cache_force_single_shard);
 DECLARE_bool(crash_on_eio);
+DECLARE_bool(log_container_metadata_checkpoint);
 DECLARE_double(env_inject_eio);
 DECLARE_double(log_container_excess_space_before_cleanup_fraction);
 DECLARE_double(log_container_live_metadata_before_compact_ratio);
@@ -86,6 +87,7 @@ DECLARE_string(block_manager_preflush_control);
 DECLARE_string(env_inject_eio_globs);
 DECLARE_uint64(log_container_preallocate_bytes);
 DECLARE_uint64(log_container_max_size);
+DECLARE_uint64(log_container_metadata_preload_max_bytes);
 DEFINE_int32(startup_benchmark_block_count_for_testing, 1000000,
              "Block count to do startup benchmark.");
 DEFINE_int32(startup_benchmark_data_dir_count_for_testing, 8,
@@ -1506,6 +1508,57 @@ TEST_F(LogBlockManagerTest, TestRepairPartialRecords) {
   NO_FATALS(AssertEmptyReport(report));
 }
 
+// Tests that container metadata is loaded the same whether or not the
+// metadata files are read into memory up front.
+TEST_F(LogBlockManagerTest, TestPreloadContainerMetadata) {
+  const int kNumBlocks = 100;
+
+  // Create some blocks and delete every other one, so that the metadata has
+  // both CREATE and DELETE records.
+  vector<BlockId> created;
+  {
+    unique_ptr<BlockCreationTransaction> transaction = bm_->NewCreationTransaction();
+    for (int i = 0; i < kNumBlocks; i++) {
+      unique_ptr<WritableBlock> block;
+      ASSERT_OK(bm_->CreateBlock(test_block_opts_, &block));
+      ASSERT_OK(block->Append("a"));
+      created.push_back(block->id());
+      transaction->AddCreatedBlock(std::move(block));
+    }
+    ASSERT_OK(transaction->CommitCreatedBlocks());
+  }
+  {
+    shared_ptr<BlockDeletionTransaction> transaction = bm_->NewDeletionTransaction();
+    for (int i = 0; i < kNumBlocks; i += 2) {
+      transaction->AddDeletedBlock(created[i]);
+    }
+    vector<BlockId> deleted;
+    ASSERT_OK(transaction->CommitDeletedBlocks(&deleted));
+  }
+
+  // Add a partial record, which must be detected either way.
+  LBMCorruptor corruptor(env_, dd_manager_->GetDirs(), SeedRandom());
+  ASSERT_OK(corruptor.Init());
+  ASSERT_OK(corruptor.AddPartialRecordToContainer());
+
+  for (uint64_t preload_max_bytes : { 0, 64 * 1024 * 1024 }) {
+    SCOPED_TRACE(preload_max_bytes);
+    FLAGS_log_container_metadata_preload_max_bytes = preload_max_bytes;
+    FsReport report;
+    ASSERT_OK(ReopenBlockManager(nullptr, &report));
+    ASSERT_FALSE(report.HasFatalErrors());
+    ASSERT_EQ(kNumBlocks / 2, report.stats.live_block_count);
+    ASSERT_GE(report.stats.lbm_load_time_ms, 0);
+
+    vector<BlockId> block_ids;
+    ASSERT_OK(bm_->GetAllBlockIds(&block_ids));
+    ASSERT_EQ(kNumBlocks / 2, block_ids.size());
+    for (int i = 1; i < kNumBlocks; i += 2) {
+      ASSERT_TRUE(std::find(block_ids.begin(), block_ids.end(), created[i]) != block_ids.end());
+    }
+  }
+}
+
 TEST_F(LogBlockManagerTest, TestDeleteDeadContainersAtStartup) {
   // Force our single container to become full once created.
   FLAGS_log_container_max_size = 0;
@@ -1603,6 +1656,84 @@ TEST_F(LogBlockManagerTest, TestCompactFullContainerMetadataAtStartup) {
   ASSERT_EQ(last_live_aligned_bytes, report.stats.live_block_bytes_aligned);
 }
 
+// Tests that the metadata of a container that isn't full is compacted at
+// startup when checkpoints are enabled, and that the checkpoint preserves
+// what the deleted blocks contributed to the container.
+TEST_F(LogBlockManagerTest, TestCheckpointContainerMetadataAtStartup) {
+  FLAGS_log_container_metadata_checkpoint = true;
+  FLAGS_log_container_live_metadata_before_compact_ratio = 0.50;
+  FLAGS_log_container_max_blocks = 10;
+
+  // Create a container that isn't full and delete most of its blocks.
+  vector<BlockId> live_ids;
+  {
+    shared_ptr<BlockDeletionTransaction> deletion_transaction =
+        bm_->NewDeletionTransaction();
+    for (int i = 0; i < 8; i++) {
+      unique_ptr<WritableBlock> block;
+      ASSERT_OK(bm_->CreateBlock(test_block_opts_, &block));
+      ASSERT_OK(block->Append(Substitute("block $0", i)));
+      ASSERT_OK(block->Close());
+      if (i < 6) {
+        deletion_transaction->AddDeletedBlock(block->id());
+      } else {
+        live_ids.emplace_back(block->id());
+      }
+    }
+    vector<BlockId> deleted;
+    ASSERT_OK(deletion_transaction->CommitDeletedBlocks(&deleted));
+  }
+  string metadata_file_name;
+  NO_FATALS(GetOnlyContainerMetadataFile(&metadata_file_name));
+  uint64_t pre_compaction_file_size;
+  ASSERT_OK(env_->GetFileSize(metadata_file_name, &pre_compaction_file_size));
+
+  // The metadata should be compacted at startup.
+  FsReport report;
+  ASSERT_OK(ReopenBlockManager(nullptr, &report));
+  NO_FATALS(AssertEmptyReport(report));
+  ASSERT_EQ(2, report.stats.live_block_count);
+  uint64_t post_compaction_file_size;
+  ASSERT_OK(env_->GetFileSize(metadata_file_name, &post_compaction_file_size));
+  ASSERT_LT(post_compaction_file_size, pre_compaction_file_size);
+
+  // The compacted metadata has no dead records left, so it shouldn't be
+  // compacted again.
+  ASSERT_OK(ReopenBlockManager(nullptr, &report));
+  NO_FATALS(AssertEmptyReport(report));
+  uint64_t file_size;
+  ASSERT_OK(env_->GetFileSize(metadata_file_name, &file_size));
+  ASSERT_EQ(post_compaction_file_size, file_size);
+
+  // The deleted blocks still count towards the container's block limit: two
+  // more blocks fill it up, and the next one goes to a new container.
+  for (int i = 0; i < 3; i++) {
+    unique_ptr<WritableBlock> block;
+    ASSERT_OK(bm_->CreateBlock(test_block_opts_, &block));
+    ASSERT_OK(block->Append(Substitute("new block $0", i)));
+    ASSERT_OK(block->Close());
+    NO_FATALS(AssertNumContainers(i < 2 ? 1 : 2));
+    live_ids.emplace_back(block->id());
+  }
+
+  // None of the new blocks should have overwritten the surviving ones.
+  ASSERT_OK(ReopenBlockManager(nullptr, &report));
+  NO_FATALS(AssertEmptyReport(report));
+  ASSERT_EQ(live_ids.size(), report.stats.live_block_count);
+  for (int i = 0; i < live_ids.size(); i++) {
+    unique_ptr<ReadableBlock> block;
+    ASSERT_OK(bm_->OpenBlock(live_ids[i], &block));
+    string expected = i < 2 ? Substitute("block $0", i + 6) : Substitute("new block $0", i - 2);
+    uint64_t size;
+    ASSERT_OK(block->Size(&size));
+    ASSERT_EQ(expected.size(), size);
+    uint8_t scratch[64];
+    Slice data(scratch, size);
+    ASSERT_OK(block->Read(0, data));
+    ASSERT_EQ(expected, data.ToString());
+  }
+}
+
 // Regression test for a bug in which, after a metadata file was compacted,
 // we would not properly handle appending to the new (post-compaction) metadata.
 //
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <memory>
@@ -57,11 +58,13 @@
 #include "kudu/util/alignment.h"
 #include "kudu/util/array_view.h"
 #include "kudu/util/env.h"
+#include "kudu/util/faststring.h"
 #include "kudu/util/file_cache.h"
 #include "kudu/util/flag_tags.h"
 #include "kudu/util/locks.h"
 #include "kudu/util/malloc.h"
 #include "kudu/util/metrics.h"
+#include "kudu/util/monotime.h"
 #include "kudu/util/path_util.h"
 #include "kudu/util/pb_util.h"
 #include "kudu/util/random.h"
@@ -104,6 +107,22 @@ DEFINE_double(log_container_live_metadata_before_compact_ratio, 0.50,
               "the container's metadata file will be compacted at startup.");
 TAG_FLAG(log_container_live_metadata_before_compact_ratio, experimental);
 
+DEFINE_bool(log_container_metadata_checkpoint, false,
+            "Whether compacted container metadata files end with a checkpoint "
+            "record of the container's next block offset and total block count. "
+            "This allows the metadata of containers that aren't full to be "
+            "compacted at startup too, so that subsequent startups only replay "
+            "their live blocks and the records appended since. Metadata files "
+            "with checkpoint records can't be read by older versions of Kudu.");
+TAG_FLAG(log_container_metadata_checkpoint, experimental);
+
+DEFINE_uint64(log_container_metadata_preload_max_bytes, 64LU * 1024 * 1024,
+              "Container metadata files up to this size are read into memory with "
+              "a single sequential read when the log block manager opens, rather "
+              "than with several small reads per block record. If 0, metadata "
+              "files are always read record by record.");
+TAG_FLAG(log_container_metadata_preload_max_bytes, advanced);
+
 DEFINE_bool(log_block_manager_test_hole_punching, true,
             "Ensure hole punching is supported by the underlying filesystem");
 TAG_FLAG(log_block_manager_test_hole_punching, advanced);
@@ -212,6 +231,65 @@ LogBlockManagerMetrics::LogBlockManagerMetrics(const scoped_refptr<MetricEntity>
 }
 #undef GINIT
 
+////////////////////////////////////////////////////////////
+// PreloadedFile
+////////////////////////////////////////////////////////////
+
+// An in-memory copy of a file's contents, read with a single sequential read
+// and then served to readers without any further I/O.
+class PreloadedFile : public RandomAccessFile {
+ public:
+  // Reads the whole of 'file' into memory.
+  static Status Load(const RandomAccessFile& file, uint64_t size,
+                     unique_ptr<RandomAccessFile>* preloaded) {
+    unique_ptr<PreloadedFile> f(new PreloadedFile(file.filename()));
+    f->data_.resize(size);
+    RETURN_NOT_OK(file.Read(0, Slice(f->data_)));
+    *preloaded = std::move(f);
+    return Status::OK();
+  }
+
+  Status Read(uint64_t offset, Slice result) const override {
+    return ReadV(offset, ArrayView<Slice>(&result, 1));
+  }
+
+  Status ReadV(uint64_t offset, ArrayView<Slice> results) const override {
+    for (Slice& result : results) {
+      if (PREDICT_FALSE(offset + result.size() > data_.size())) {
+        return Status::IOError(Substitute(
+            "cannot read $0 bytes at offset $1 from $2: file is only $3 bytes",
+            result.size(), offset, filename_, data_.size()));
+      }
+      memcpy(result.mutable_data(), data_.data() + offset, result.size());
+      offset += result.size();
+    }
+    return Status::OK();
+  }
+
+  Status Size(uint64_t* size) const override {
+    *size = data_.size();
+    return Status::OK();
+  }
+
+  size_t memory_footprint() const override {
+    return kudu_malloc_usable_size(this) + data_.capacity();
+  }
+
+  const string& filename() const override {
+    return filename_;
+  }
+
+ private:
+  explicit PreloadedFile(string filename)
+      : filename_(std::move(filename)) {
+  }
+
+  const string filename_;
+  faststring data_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadedFile);
+};
+
 ////////////////////////////////////////////////////////////
 // LogBlock (declaration)
 ////////////////////////////////////////////////////////////
@@ -631,6 +709,13 @@ class LogBlockContainer: public RefCountedThreadSafe<LogBlockContainer> {
   // This function is thread unsafe.
   void UpdateNextBlockOffset(int64_t block_offset, int64_t block_length);
 
+  // Restores the container's next block offset and total block count from a
+  // CHECKPOINT record, which follows the records of the blocks that were
+  // live when it was written.
+  //
+  // This function is thread unsafe.
+  void RestoreCheckpoint(int64_t next_block_offset, int64_t total_blocks);
+
   // The owning block manager. Must outlive the container itself.
   LogBlockManager* const block_manager_;
 
@@ -971,6 +1056,17 @@ Status LogBlockContainer::ProcessRecords(
   unique_ptr<RandomAccessFile> metadata_reader;
   RETURN_NOT_OK_HANDLE_ERROR(block_manager()->env()->NewRandomAccessFile(
       metadata_path, &metadata_reader));
+
+  // Reading the records one at a time takes a couple of small reads apiece,
+  // so read the whole file at once unless it's unusually large.
+  uint64_t metadata_size;
+  RETURN_NOT_OK_HANDLE_ERROR(metadata_reader->Size(&metadata_size));
+  if (metadata_size <= FLAGS_log_container_metadata_preload_max_bytes) {
+    unique_ptr<RandomAccessFile> preloaded;
+    RETURN_NOT_OK_HANDLE_ERROR(PreloadedFile::Load(*metadata_reader, metadata_size,
+                                                   &preloaded));
+    metadata_reader = std::move(preloaded);
+  }
   ReadablePBContainerFile pb_reader(std::move(metadata_reader));
   RETURN_NOT_OK_HANDLE_ERROR(pb_reader.Open());
 
@@ -1087,6 +1183,18 @@ Status LogBlockContainer::ProcessRecord(
       CHECK_EQ(1, live_block_records->erase(block_id));
       dead_blocks->emplace_back(std::move(lb));
       break;
+    case CHECKPOINT:
+      if (PREDICT_FALSE(!record->has_next_block_offset() ||
+                        !record->has_total_blocks() ||
+                        record->next_block_offset() < 0 ||
+                        record->total_blocks() < total_blocks())) {
+        report->malformed_record_check->entries.emplace_back(ToString(), record);
+        break;
+      }
+      VLOG(2) << Substitute("Found CHECKPOINT with next block offset $0 and $1 total blocks",
+                            record->next_block_offset(), record->total_blocks());
+      RestoreCheckpoint(record->next_block_offset(), record->total_blocks());
+      break;
     default:
       // We found a record with an unknown type.
       //
@@ -1317,6 +1425,19 @@ void LogBlockContainer::UpdateNextBlockOffset(int64_t block_offset, int64_t bloc
   }
 }
 
+void LogBlockContainer::RestoreCheckpoint(int64_t next_block_offset, int64_t total_blocks) {
+  // The byte ranges of the blocks deleted before the checkpoint must never be
+  // reused, and they still count towards the container's block limit.
+  next_block_offset_.StoreMax(next_block_offset);
+  total_blocks_.StoreMax(total_blocks);
+
+  if (full()) {
+    VLOG(1) << Substitute(
+        "Container $0 with size $1 is now full, max size is $2",
+        ToString(), next_block_offset_.Load(), FLAGS_log_container_max_size);
+  }
+}
+
 void LogBlockContainer::BlockCreated(const LogBlockRefPtr& block) {
   DCHECK_GE(block->offset(), 0);
 
@@ -2063,6 +2184,7 @@ Status LogBlockManager::Open(FsReport* report) {
   }
 
   // Open containers in each data dirs.
+  const MonoTime load_start = MonoTime::Now();
   vector<Status> statuses(dd_manager_->dirs().size());
   vector<vector<unique_ptr<internal::LogBlockContainerLoadResult>>> container_results(
       dd_manager_->dirs().size());
@@ -2160,6 +2282,7 @@ Status LogBlockManager::Open(FsReport* report) {
   if (dd_manager_->GetFailedDirs().size() == dd_manager_->dirs().size()) {
     return Status::IOError("All data dirs failed to open", "", EIO);
   }
+  merged_report.stats.lbm_load_time_ms = (MonoTime::Now() - load_start).ToMilliseconds();
 
   // Either return or log the report.
   if (report) {
@@ -2611,6 +2734,52 @@ void LogBlockManager::LoadContainer(Dir* dir,
     }
   }
 
+  // Metadata files of containers with very few live blocks will be compacted.
+  // Without a checkpoint record, only full containers qualify: the compacted
+  // file would otherwise lose track of the byte ranges and block count of
+  // the deleted blocks. Their records are gone after a compaction, so the
+  // ratio only considers the records in the current file.
+  //
+  // TODO(adar): this should be reported as an inconsistency once
+  // container metadata compaction is also done in realtime. Until then,
+  // it would be confusing to report it as such since it'll be a natural
+  // event at startup.
+  if (container->live_blocks() > 0 &&
+      (container->full() || FLAGS_log_container_metadata_checkpoint) &&
+      static_cast<double>(container->live_blocks()) /
+          (container->live_blocks() + dead_blocks.size()) <=
+          FLAGS_log_container_live_metadata_before_compact_ratio) {
+    vector<BlockRecordPB> records(live_block_records.size());
+    int i = 0;
+    for (auto& e : live_block_records) {
+      records[i].Swap(&e.second);
+      i++;
+    }
+
+    // Sort the records such that their ordering reflects the ordering in
+    // the pre-compacted metadata file.
+    //
+    // This is preferred to storing the records in an order-preserving
+    // container (such as std::map) because while records are temporarily
+    // retained for every container, only some containers will actually
+    // undergo metadata compaction.
+    std::sort(records.begin(), records.end(),
+              [](const BlockRecordPB& a, const BlockRecordPB& b) {
+      // Sort by timestamp.
+      if (a.timestamp_us() != b.timestamp_us()) {
+        return a.timestamp_us() < b.timestamp_us();
+      }
+
+      // If the timestamps match, sort by offset.
+      //
+      // If the offsets also match (i.e. both blocks are of zero length),
+      // it doesn't matter which of the two records comes first.
+      return a.offset() < b.offset();
+    });
+
+    result->low_live_block_containers[container->ToString()] = std::move(records);
+  }
+
   if (container->full()) {
     // Full containers without any live blocks can be deleted outright.
     //
@@ -2620,43 +2789,6 @@ void LogBlockManager::LoadContainer(Dir* dir,
     if (container->live_blocks() == 0) {
       DCHECK(live_blocks.empty());
       result->dead_containers.emplace_back(container);
-    } else if (static_cast<double>(container->live_blocks()) /
-        container->total_blocks() <= FLAGS_log_container_live_metadata_before_compact_ratio) {
-      // Metadata files of containers with very few live blocks will be compacted.
-      //
-      // TODO(adar): this should be reported as an inconsistency once
-      // container metadata compaction is also done in realtime. Until then,
-      // it would be confusing to report it as such since it'll be a natural
-      // event at startup.
-      vector<BlockRecordPB> records(live_block_records.size());
-      int i = 0;
-      for (auto& e : live_block_records) {
-        records[i].Swap(&e.second);
-        i++;
-      }
-
-      // Sort the records such that their ordering reflects the ordering in
-      // the pre-compacted metadata file.
-      //
-      // This is preferred to storing the records in an order-preserving
-      // container (such as std::map) because while records are temporarily
-      // retained for every container, only some containers will actually
-      // undergo metadata compaction.
-      std::sort(records.begin(), records.end(),
-                [](const BlockRecordPB& a, const BlockRecordPB& b) {
-        // Sort by timestamp.
-        if (a.timestamp_us() != b.timestamp_us()) {
-          return a.timestamp_us() < b.timestamp_us();
-        }
-
-        // If the timestamps match, sort by offset.
-        //
-        // If the offsets also match (i.e. both blocks are of zero length),
-        // it doesn't matter which of the two records comes first.
-        return a.offset() < b.offset();
-      });
-
-      result->low_live_block_containers[container->ToString()] = std::move(records);
     }
 
     // Having processed the block records, let's check whether any full
@@ -3013,6 +3145,17 @@ Status LogBlockManager::RewriteMetadataFile(const LogBlockContainer& container,
     RETURN_NOT_OK_LBM_DISK_FAILURE_PREPEND(pb_file.Append(r),
                                            "could not append to temporary metadata file");
   }
+  if (FLAGS_log_container_metadata_checkpoint) {
+    // Preserve what the dropped records contributed to the container's state.
+    BlockRecordPB checkpoint;
+    BlockId().CopyToPB(checkpoint.mutable_block_id());
+    checkpoint.set_op_type(CHECKPOINT);
+    checkpoint.set_timestamp_us(GetCurrentTimeMicros());
+    checkpoint.set_next_block_offset(container.next_block_offset());
+    checkpoint.set_total_blocks(container.total_blocks());
+    RETURN_NOT_OK_LBM_DISK_FAILURE_PREPEND(pb_file.Append(checkpoint),
+                                           "could not append to temporary metadata file");
+  }
   RETURN_NOT_OK_LBM_DISK_FAILURE_PREPEND(pb_file.Sync(),
                                          "could not sync temporary metadata file");
   RETURN_NOT_OK_LBM_DISK_FAILURE_PREPEND(pb_file.Close(),
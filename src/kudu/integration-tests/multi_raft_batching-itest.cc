@@ -0,0 +1,86 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cstdint>
+#include <string>
+
+#include <gflags/gflags_declare.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "kudu/gutil/ref_counted.h"
+#include "kudu/integration-tests/cluster_verifier.h"
+#include "kudu/integration-tests/internal_mini_cluster-itest-base.h"
+#include "kudu/integration-tests/test_workload.h"
+#include "kudu/mini-cluster/internal_mini_cluster.h"
+#include "kudu/tserver/mini_tablet_server.h"
+#include "kudu/tserver/tablet_server.h"
+#include "kudu/util/metrics.h"
+#include "kudu/util/monotime.h"
+#include "kudu/util/test_macros.h"
+#include "kudu/util/test_util.h"
+
+DECLARE_bool(consensus_multi_raft_batching);
+DECLARE_string(consensus_multi_raft_compression_codec);
+
+METRIC_DECLARE_histogram(handler_latency_kudu_consensus_ConsensusService_MultiRaftUpdateConsensus);
+
+using std::string;
+
+namespace kudu {
+
+class MultiRaftBatchingITest : public MiniClusterITestBase,
+                               public ::testing::WithParamInterface<string> {
+};
+
+INSTANTIATE_TEST_CASE_P(Codecs, MultiRaftBatchingITest,
+                        ::testing::Values("no_compression", "lz4"));
+
+// Ensure that, with batching enabled, the heartbeats of the tablets which
+// share servers are sent in batches, and that the tablets keep replicating
+// writes correctly.
+TEST_P(MultiRaftBatchingITest, TestHeartbeatsAreBatched) {
+  FLAGS_consensus_multi_raft_batching = true;
+  FLAGS_consensus_multi_raft_compression_codec = GetParam();
+
+  NO_FATALS(StartCluster(/*num_tablet_servers=*/ 3));
+  TestWorkload workload(cluster_.get());
+  workload.set_num_tablets(6);
+  workload.Setup();
+  workload.Start();
+  while (workload.rows_inserted() < 1000) {
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+  workload.StopAndJoin();
+
+  // Every server hosts followers, whose heartbeats should arrive in batches.
+  ASSERT_EVENTUALLY([&] {
+    for (int i = 0; i < cluster_->num_tablet_servers(); i++) {
+      scoped_refptr<Histogram> hist =
+          METRIC_handler_latency_kudu_consensus_ConsensusService_MultiRaftUpdateConsensus
+          .Instantiate(cluster_->mini_tablet_server(i)->server()->metric_entity());
+      ASSERT_GT(hist->TotalCount(), 0);
+    }
+  });
+
+  ClusterVerifier v(cluster_.get());
+  NO_FATALS(v.CheckCluster());
+  NO_FATALS(v.CheckRowCount(workload.table_name(), ClusterVerifier::AT_LEAST,
+                            workload.rows_inserted()));
+}
+
+} // namespace kudu
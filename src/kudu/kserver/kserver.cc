@@ -55,6 +55,18 @@ static bool ValidateThreadPoolThreadLimit(const char* /*flagname*/, int32_t valu
 }
 DEFINE_validator(server_thread_pool_max_thread_count, &ValidateThreadPoolThreadLimit);
 
+DEFINE_int32(cfile_readahead_threads, 16,
+             "Number of threads used to read data blocks ahead of scans. Only used if "
+             "--cfile_readahead_max_blocks is positive.");
+TAG_FLAG(cfile_readahead_threads, experimental);
+
+DEFINE_int32(rowset_writer_encoding_threads, 0,
+             "Number of server-wide threads that encode and compress the columns "
+             "of rowsets being written by flushes and compactions, so that the "
+             "columns of a wide table are written in parallel. If 0, each column "
+             "is written by the thread doing the flush or compaction.");
+TAG_FLAG(rowset_writer_encoding_threads, experimental);
+
 using kudu::server::ServerBaseOptions;
 using std::string;
 using strings::Substitute;
@@ -161,6 +173,15 @@ Status KuduServer::Init() {
                 .set_trace_metric_prefix("raft")
                 .set_max_threads(server_wide_pool_limit)
                 .Build(&raft_pool_));
+  RETURN_NOT_OK(ThreadPoolBuilder("cfile-readahead")
+                .set_max_threads(FLAGS_cfile_readahead_threads)
+                .Build(&readahead_pool_));
+  fs_manager_->set_readahead_pool(readahead_pool_.get());
+  if (FLAGS_rowset_writer_encoding_threads > 0) {
+    RETURN_NOT_OK(ThreadPoolBuilder("rowset-writer")
+                  .set_max_threads(FLAGS_rowset_writer_encoding_threads)
+                  .Build(&rowset_encoding_pool_));
+  }
 
   num_raft_leaders_ = metric_entity_->FindOrCreateGauge(&METRIC_num_raft_leaders, 0);
 
@@ -196,6 +217,12 @@ void KuduServer::Shutdown() {
   if (tablet_prepare_pool_) {
     tablet_prepare_pool_->Shutdown();
   }
+  if (readahead_pool_) {
+    readahead_pool_->Shutdown();
+  }
+  if (rowset_encoding_pool_) {
+    rowset_encoding_pool_->Shutdown();
+  }
   ServerBase::Shutdown();
 }
 
@@ -62,6 +62,7 @@ class KuduServer : public server::ServerBase {
   ThreadPool* tablet_prepare_pool() { return tablet_prepare_pool_.get(); }
   ThreadPool* tablet_apply_pool() { return tablet_apply_pool_.get(); }
   ThreadPool* raft_pool() { return raft_pool_.get(); }
+  ThreadPool* rowset_encoding_pool() { return rowset_encoding_pool_.get(); }
   scoped_refptr<AtomicGauge<int32_t>> num_raft_leaders() { return num_raft_leaders_; }
 
  private:
@@ -74,6 +75,15 @@ class KuduServer : public server::ServerBase {
   // Thread pool for Raft-related operations, shared between all tablets.
   std::unique_ptr<ThreadPool> raft_pool_;
 
+  // Thread pool for reading CFile data blocks ahead of scans, shared between
+  // all tablets.
+  std::unique_ptr<ThreadPool> readahead_pool_;
+
+  // Thread pool for encoding the columns of rowsets written by flushes and
+  // compactions, shared between all tablets. Null unless
+  // --rowset_writer_encoding_threads is positive.
+  std::unique_ptr<ThreadPool> rowset_encoding_pool_;
+
   // Gauge counting the number of Raft instances that in leaders mode.
   scoped_refptr<AtomicGauge<int32_t>> num_raft_leaders_;
 
@@ -416,6 +416,8 @@ Status SysCatalogTable::SetupTablet(
       /*result_tracker*/nullptr,
       metric_registry_,
       master_->file_cache(),
+      /*log_append_pool*/nullptr,
+      master_->rowset_encoding_pool(),
       tablet_replica_,
       tablet_replica_->log_anchor_registry(),
       &tablet,
@@ -433,7 +435,8 @@ Status SysCatalogTable::SetupTablet(
       /*result_tracker*/nullptr,
       log,
       master_->tablet_prepare_pool(),
-      master_->dns_resolver()), "failed to start system catalog replica");
+      master_->dns_resolver(),
+      /*multi_raft_manager*/nullptr), "failed to start system catalog replica");
 
   tablet_replica_->RegisterMaintenanceOps(master_->maintenance_manager());
 
@@ -58,6 +58,8 @@
 #include "kudu/util/status.h"
 #include "kudu/util/test_macros.h"
 
+DECLARE_bool(consult_column_bloom_filters);
+DECLARE_bool(consult_zone_maps);
 DECLARE_int32(cfile_default_block_size);
 
 using std::shared_ptr;
@@ -73,7 +75,8 @@ class TestCFileSet : public KuduRowSetTest {
   TestCFileSet() :
     KuduRowSetTest(Schema({ ColumnSchema("c0", INT32),
                             ColumnSchema("c1", INT32, false, nullptr, nullptr, GetRLEStorage()),
-                            ColumnSchema("c2", INT32, true) }, 1))
+                            ColumnSchema("c2", INT32, true, nullptr, nullptr,
+                                         GetBloomFilterStorage()) }, 1))
   {}
 
   virtual void SetUp() OVERRIDE {
@@ -90,7 +93,8 @@ class TestCFileSet : public KuduRowSetTest {
   // The third column contains index * 100, but is never read.
   void WriteTestRowSet(int nrows) {
     DiskRowSetWriter rsw(rowset_meta_.get(), &schema_,
-                         BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f));
+                         BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f),
+                         /*encoding_pool=*/nullptr);
 
     ASSERT_OK(rsw.Open());
 
@@ -265,6 +269,12 @@ class TestCFileSet : public KuduRowSetTest {
     return attr;
   }
 
+  ColumnStorageAttributes GetBloomFilterStorage() const {
+    ColumnStorageAttributes attr;
+    attr.bloom_filter = true;
+    return attr;
+  }
+
   static const int kRatio[];
 
  protected:
@@ -444,6 +454,125 @@ TEST_F(TestCFileSet, TestRangeScan) {
   EXPECT_EQ(1, stats[2].blocks_read);
 }
 
+// Test that a predicate on a non-key column skips the data blocks whose zone
+// map shows they can't contain matching values.
+TEST_F(TestCFileSet, TestZoneMapPruning) {
+  const int kNumRows = 10000;
+  WriteTestRowSet(kNumRows);
+
+  shared_ptr<CFileSet> fileset;
+  ASSERT_OK(CFileSet::Open(rowset_meta_, MemTracker::GetRootTracker(), MemTracker::GetRootTracker(),
+                           nullptr, &fileset));
+
+  // Scans for the rows 5000 through 5009 with a predicate on the second
+  // column, returning the number of blocks read from it.
+  const auto scan = [&] (int64_t* blocks_read) {
+    unique_ptr<RowwiseIterator> iter(NewMaterializingIterator(
+        fileset->NewIterator(&schema_, nullptr)));
+    ScanSpec spec;
+    int32_t lower = 5000 * kRatio[1];
+    int32_t upper = 5010 * kRatio[1];
+    spec.AddPredicate(ColumnPredicate::Range(schema_.column(1), &lower, &upper));
+    ASSERT_OK(iter->Init(&spec));
+    vector<string> results;
+    ASSERT_OK(IterateToStringList(iter.get(), &results));
+    ASSERT_EQ(10, results.size());
+    EXPECT_EQ("(int32 c0=10000, int32 c1=50000, int32 c2=500000)", results[0]);
+
+    vector<IteratorStats> stats;
+    iter->GetIteratorStats(&stats);
+    ASSERT_EQ(3, stats.size());
+    *blocks_read = stats[1].blocks_read;
+  };
+
+  FLAGS_consult_zone_maps = false;
+  int64_t blocks_read_without_zone_maps;
+  NO_FATALS(scan(&blocks_read_without_zone_maps));
+
+  FLAGS_consult_zone_maps = true;
+  int64_t blocks_read_with_zone_maps;
+  NO_FATALS(scan(&blocks_read_with_zone_maps));
+
+  // Without zone maps, every block of the column is read. With them, only
+  // the blocks holding the matching rows are.
+  ASSERT_GT(blocks_read_without_zone_maps, 10);
+  ASSERT_LE(blocks_read_with_zone_maps, 2);
+
+  // A predicate outside of the range of the column skips the whole file.
+  unique_ptr<RowwiseIterator> iter(NewMaterializingIterator(
+      fileset->NewIterator(&schema_, nullptr)));
+  ScanSpec spec;
+  int32_t value = -1;
+  spec.AddPredicate(ColumnPredicate::Equality(schema_.column(2), &value));
+  ASSERT_OK(iter->Init(&spec));
+  vector<string> results;
+  ASSERT_OK(IterateToStringList(iter.get(), &results));
+  ASSERT_TRUE(results.empty());
+  vector<IteratorStats> stats;
+  iter->GetIteratorStats(&stats);
+  for (const auto& col_stats : stats) {
+    EXPECT_EQ(0, col_stats.blocks_read);
+  }
+}
+
+// Test that an equality or IN-list predicate on a column with a bloom filter
+// skips the whole file if the file doesn't contain the predicate's values,
+// even if they lie within the range of values of the file.
+TEST_F(TestCFileSet, TestColumnBloomFilterPruning) {
+  const int kNumRows = 10000;
+  WriteTestRowSet(kNumRows);
+
+  shared_ptr<CFileSet> fileset;
+  ASSERT_OK(CFileSet::Open(rowset_meta_, MemTracker::GetRootTracker(), MemTracker::GetRootTracker(),
+                           nullptr, &fileset));
+
+  // Scans with 'pred' on the third column, returning the number of results
+  // and the number of blocks read from the column.
+  const auto scan = [&] (const ColumnPredicate& pred, size_t* num_results,
+                         int64_t* blocks_read) {
+    unique_ptr<RowwiseIterator> iter(NewMaterializingIterator(
+        fileset->NewIterator(&schema_, nullptr)));
+    ScanSpec spec;
+    spec.AddPredicate(pred);
+    ASSERT_OK(iter->Init(&spec));
+    vector<string> results;
+    ASSERT_OK(IterateToStringList(iter.get(), &results));
+    *num_results = results.size();
+
+    vector<IteratorStats> stats;
+    iter->GetIteratorStats(&stats);
+    ASSERT_EQ(3, stats.size());
+    *blocks_read = stats[2].blocks_read;
+  };
+
+  // The values of the column are multiples of 100, so the zone map of the
+  // first block can't rule this value out.
+  int32_t missing_value = kRatio[2] + 1;
+  const auto missing = ColumnPredicate::Equality(schema_.column(2), &missing_value);
+  size_t num_results;
+  int64_t blocks_read;
+  FLAGS_consult_column_bloom_filters = false;
+  NO_FATALS(scan(missing, &num_results, &blocks_read));
+  ASSERT_EQ(0, num_results);
+  ASSERT_GT(blocks_read, 0);
+
+  FLAGS_consult_column_bloom_filters = true;
+  NO_FATALS(scan(missing, &num_results, &blocks_read));
+  ASSERT_EQ(0, num_results);
+  ASSERT_EQ(0, blocks_read);
+
+  // Present values are still found.
+  int32_t present_value = 5000 * kRatio[2];
+  NO_FATALS(scan(ColumnPredicate::Equality(schema_.column(2), &present_value),
+                 &num_results, &blocks_read));
+  ASSERT_EQ(1, num_results);
+
+  vector<const void*> in_list = { &missing_value, &present_value };
+  NO_FATALS(scan(ColumnPredicate::InList(schema_.column(2), &in_list),
+                 &num_results, &blocks_read));
+  ASSERT_EQ(1, num_results);
+}
+
 // Several other black-box tests for range scans. These are similar to
 // TestRangeScan above, except don't inspect internal state.
 TEST_F(TestCFileSet, TestRangePredicates2) {
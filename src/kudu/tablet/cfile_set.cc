@@ -32,7 +32,10 @@
 #include "kudu/cfile/bloomfile.h"
 #include "kudu/cfile/cfile_reader.h"
 #include "kudu/cfile/cfile_util.h"
+#include "kudu/cfile/column_bloom_filter.h"
+#include "kudu/cfile/zone_map.h"
 #include "kudu/common/column_materialization_context.h"
+#include "kudu/common/column_predicate.h"
 #include "kudu/common/columnblock.h"
 #include "kudu/common/encoded_key.h"
 #include "kudu/common/iterator_stats.h"
@@ -52,6 +55,7 @@
 #include "kudu/tablet/diskrowset.h"
 #include "kudu/tablet/rowset.h"
 #include "kudu/tablet/rowset_metadata.h"
+#include "kudu/util/bloom_filter.h"
 #include "kudu/util/flag_tags.h"
 #include "kudu/util/logging.h"
 #include "kudu/util/slice.h"
@@ -60,6 +64,19 @@
 DEFINE_bool(consult_bloom_filters, true, "Whether to consult bloom filters on row presence checks");
 TAG_FLAG(consult_bloom_filters, hidden);
 
+DEFINE_bool(consult_zone_maps, true,
+            "Whether to consult cfile zone maps to skip data blocks which cannot "
+            "satisfy a scan's predicates");
+TAG_FLAG(consult_zone_maps, hidden);
+TAG_FLAG(consult_zone_maps, runtime);
+
+DEFINE_bool(consult_column_bloom_filters, true,
+            "Whether to consult the bloom filters of columns with the bloom filter "
+            "storage attribute to skip rowsets which cannot satisfy a scan's "
+            "equality and IN-list predicates");
+TAG_FLAG(consult_column_bloom_filters, hidden);
+TAG_FLAG(consult_column_bloom_filters, runtime);
+
 DECLARE_bool(rowset_metadata_store_keys);
 
 namespace kudu {
@@ -71,9 +88,11 @@ namespace tablet {
 using cfile::BloomFileReader;
 using cfile::CFileIterator;
 using cfile::CFileReader;
+using cfile::ColumnBloomFilter;
 using cfile::ColumnIterator;
 using cfile::ReaderOptions;
 using cfile::DefaultColumnValueIterator;
+using cfile::ZoneMap;
 using fs::IOContext;
 using fs::ReadableBlock;
 using std::shared_ptr;
@@ -97,6 +116,7 @@ static Status OpenReader(FsManager* fs,
   ReaderOptions opts;
   opts.parent_mem_tracker = std::move(cfile_reader_tracker);
   opts.io_context = io_context;
+  opts.readahead_pool = fs->readahead_pool();
   return CFileReader::OpenNoInit(std::move(block),
                                  std::move(opts),
                                  new_reader);
@@ -232,6 +252,22 @@ Status CFileSet::NewColumnIterator(ColumnId col_id,
                                                             io_context);
 }
 
+Status CFileSet::GetZoneMap(ColumnId col_id,
+                            const IOContext* io_context,
+                            const ZoneMap** zone_map) const {
+  CFileReader* reader = FindOrDie(readers_by_col_id_, col_id).get();
+  RETURN_NOT_OK(reader->Init(io_context));
+  return reader->GetZoneMap(io_context, zone_map);
+}
+
+Status CFileSet::GetBloomFilter(ColumnId col_id,
+                                const IOContext* io_context,
+                                const ColumnBloomFilter** bloom_filter) const {
+  CFileReader* reader = FindOrDie(readers_by_col_id_, col_id).get();
+  RETURN_NOT_OK(reader->Init(io_context));
+  return reader->GetBloomFilter(io_context, bloom_filter);
+}
+
 unique_ptr<CFileSet::Iterator> CFileSet::NewIterator(
     const Schema* projection,
     const IOContext* io_context) const {
@@ -334,6 +370,62 @@ Status CFileSet::CheckRowPresent(const RowSetKeyProbe& probe, const IOContext* i
   return Status::OK();
 }
 
+Status CFileSet::CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                                  const IOContext* io_context, bool* present,
+                                  rowid_t* rowids, ProbeStats* const* stats) const {
+  std::fill(present, present + n_probes, true);
+  if (FLAGS_consult_bloom_filters) {
+    // Fully open the BloomFileReader if it was lazily opened earlier.
+    //
+    // If it's already initialized, this is a no-op.
+    RETURN_NOT_OK(bloom_reader_->Init(io_context));
+
+    vector<const BloomKeyProbe*> bloom_probes(n_probes);
+    for (size_t i = 0; i < n_probes; i++) {
+      bloom_probes[i] = &probes[i]->bloom_probe();
+      stats[i]->blooms_consulted++;
+    }
+    Status s = bloom_reader_->CheckKeysPresent(bloom_probes.data(), n_probes,
+                                               io_context, present);
+    if (!s.ok()) {
+      KLOG_EVERY_N_SECS(WARNING, 1) << Substitute("Unable to query bloom in $0: $1",
+          rowset_metadata_->bloom_block().ToString(), s.ToString());
+      if (PREDICT_FALSE(s.IsDiskFailure())) {
+        // If the bloom lookup failed because of a disk failure, return early
+        // since I/O to the tablet should be stopped.
+        return s;
+      }
+      // Continue with the slow path for all of the keys.
+      std::fill(present, present + n_probes, true);
+    }
+  }
+
+  // Look up the keys which passed the bloom filter using a single key iterator:
+  // since the keys are sorted, consecutive keys in the same data block are found
+  // without seeking the key index again.
+  unique_ptr<CFileIterator> key_iter;
+  for (size_t i = 0; i < n_probes; i++) {
+    if (!present[i]) continue;
+    if (!key_iter) {
+      RETURN_NOT_OK(NewKeyIterator(io_context, &key_iter));
+    }
+    stats[i]->keys_consulted++;
+    bool exact;
+    Status s = key_iter->SeekAtOrAfterInOrder(probes[i]->encoded_key(), &exact);
+    if (s.IsNotFound()) {
+      // The key is after the last key in the file, and so are all the others.
+      std::fill(present + i, present + n_probes, false);
+      break;
+    }
+    RETURN_NOT_OK(s);
+    present[i] = exact;
+    if (exact) {
+      rowids[i] = key_iter->GetCurrentOrdinal();
+    }
+  }
+  return Status::OK();
+}
+
 Status CFileSet::NewKeyIterator(const IOContext* io_context,
                                 unique_ptr<CFileIterator>* key_iter) const {
   RETURN_NOT_OK(key_index_reader()->Init(io_context));
@@ -383,6 +475,9 @@ Status CFileSet::Iterator::CreateColumnIterators(const ScanSpec* spec) {
 
   col_iters_.swap(ret_iters);
   prepared_iters_.reserve(col_iters_.size());
+  zone_maps_.assign(col_iters_.size(), nullptr);
+  zone_maps_loaded_.assign(col_iters_.size(), false);
+  bloom_filter_rejected_.assign(col_iters_.size(), false);
   return Status::OK();
 }
 
@@ -526,10 +621,54 @@ Status CFileSet::Iterator::InitializeSelectionVector(SelectionVector *sel_vec) {
   return Status::OK();
 }
 
+Status CFileSet::Iterator::PredicateMayMatchBatch(size_t col_idx,
+                                                  const ColumnPredicate& pred,
+                                                  bool* may_match) {
+  *may_match = true;
+  if (!zone_maps_loaded_[col_idx]) {
+    const ColumnId col_id = projection_->column_id(col_idx);
+    if (base_data_->has_data_for_column_id(col_id)) {
+      RETURN_NOT_OK(base_data_->GetZoneMap(col_id, io_context_, &zone_maps_[col_idx]));
+
+      // The predicate on a column doesn't change over the life of the
+      // iterator, so the bloom filter only needs to be checked once.
+      const ColumnBloomFilter* bloom_filter;
+      RETURN_NOT_OK(base_data_->GetBloomFilter(col_id, io_context_, &bloom_filter));
+      bloom_filter_rejected_[col_idx] = bloom_filter && !bloom_filter->MayMatch(pred);
+    }
+    zone_maps_loaded_[col_idx] = true;
+  }
+  if (FLAGS_consult_column_bloom_filters && bloom_filter_rejected_[col_idx]) {
+    *may_match = false;
+    return Status::OK();
+  }
+  const ZoneMap* zone_map = zone_maps_[col_idx];
+  if (FLAGS_consult_zone_maps && zone_map) {
+    *may_match = zone_map->MayMatch(pred, cur_idx_, cur_idx_ + prepared_count_);
+  }
+  return Status::OK();
+}
+
 Status CFileSet::Iterator::MaterializeColumn(ColumnMaterializationContext *ctx) {
   CHECK_EQ(prepared_count_, ctx->block()->nrows());
   DCHECK_LT(ctx->col_idx(), col_iters_.size());
 
+  // The zone maps and bloom filters summarize the stored values. They're only
+  // consulted if the predicate may be evaluated against the stored values,
+  // which isn't the case if, for example, there are deltas to apply on top of
+  // them.
+  if ((FLAGS_consult_zone_maps || FLAGS_consult_column_bloom_filters) &&
+      !ctx->DecoderEvalNotSupported()) {
+    bool may_match;
+    RETURN_NOT_OK(PredicateMayMatchBatch(ctx->col_idx(), *ctx->pred(), &may_match));
+    if (!may_match) {
+      // Skip the batch without reading the column at all; the column will be
+      // seeked past it if it's prepared for a later batch.
+      ctx->sel()->SetAllFalse();
+      return Status::OK();
+    }
+  }
+
   RETURN_NOT_OK(PrepareColumn(ctx));
   ColumnIterator* iter = col_iters_[ctx->col_idx()].get();
 
@@ -48,6 +48,7 @@ class optional;
 namespace kudu {
 
 class ColumnMaterializationContext;
+class ColumnPredicate;
 class MemTracker;
 class ScanSpec;
 class SelectionVector;
@@ -55,6 +56,8 @@ struct IteratorStats;
 
 namespace cfile {
 class BloomFileReader;
+class ColumnBloomFilter;
+class ZoneMap;
 }  // namespace cfile
 
 namespace fs {
@@ -124,6 +127,14 @@ class CFileSet :
   Status CheckRowPresent(const RowSetKeyProbe& probe, const fs::IOContext* io_context,
                          bool* present, rowid_t* rowid, ProbeStats* stats) const;
 
+  // Batched version of CheckRowPresent() for 'n_probes' probes sorted by key.
+  // Sets present[i], and rowids[i] if present, for each probes[i], accounting
+  // the work in stats[i]. The bloom and key indexes are sought once per block
+  // rather than once per key.
+  Status CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                          const fs::IOContext* io_context, bool* present,
+                          rowid_t* rowids, ProbeStats* const* stats) const;
+
   // Return true if there exists a CFile for the given column ID.
   bool has_data_for_column_id(ColumnId col_id) const {
     return ContainsKey(readers_by_col_id_, col_id);
@@ -152,6 +163,18 @@ class CFileSet :
   Status NewKeyIterator(const fs::IOContext* io_context,
                         std::unique_ptr<cfile::CFileIterator>* key_iter) const;
 
+  // Returns the zone map of the given column in '*zone_map', or nullptr if
+  // the column's cfile has none.
+  Status GetZoneMap(ColumnId col_id,
+                    const fs::IOContext* io_context,
+                    const cfile::ZoneMap** zone_map) const;
+
+  // Returns the bloom filter of the given column in '*bloom_filter', or
+  // nullptr if the column's cfile has none.
+  Status GetBloomFilter(ColumnId col_id,
+                        const fs::IOContext* io_context,
+                        const cfile::ColumnBloomFilter** bloom_filter) const;
+
   // Return the CFileReader responsible for reading the key index.
   // (the ad-hoc reader for composite keys, otherwise the key column reader)
   cfile::CFileReader* key_index_reader() const;
@@ -249,6 +272,10 @@ class CFileSet::Iterator : public ColumnwiseIterator {
   // Prepare the given column. The column must not have been prepared yet.
   Status PrepareColumn(ColumnMaterializationContext *ctx);
 
+  // Sets '*may_match' to false if the zone map of the column at 'col_idx'
+  // shows that no row of the prepared batch can satisfy 'pred'.
+  Status PredicateMayMatchBatch(size_t col_idx, const ColumnPredicate& pred, bool* may_match);
+
   const std::shared_ptr<CFileSet const> base_data_;
   const Schema* projection_;
 
@@ -281,6 +308,15 @@ class CFileSet::Iterator : public ColumnwiseIterator {
   // stored in 'col_iters_'.
   std::vector<cfile::ColumnIterator*> prepared_iters_;
 
+  // The zone maps of the projected columns, indexed like 'col_iters_' and
+  // loaded the first time a predicate is evaluated on the column. A column
+  // without a zone map has a nullptr entry once loaded.
+  std::vector<const cfile::ZoneMap*> zone_maps_;
+  std::vector<bool> zone_maps_loaded_;
+
+  // Whether the bloom filter of each projected column showed that no row
+  // satisfies the predicate on the column. Set along with 'zone_maps_'.
+  std::vector<bool> bloom_filter_rejected_;
 };
 
 } // namespace tablet
@@ -288,7 +288,8 @@ class TestCompaction : public KuduRowSetTest {
     // This simplifies the test so we always need to reopen only a single rowset.
     RollingDiskRowSetWriter rsw(tablet()->metadata(), projection,
                                 Tablet::DefaultBloomSizing(),
-                                roll_threshold);
+                                roll_threshold,
+                                /*encoding_pool=*/nullptr);
     ASSERT_OK(rsw.Open());
     ASSERT_OK(FlushCompactionInput(input, snap, HistoryGcOpts::Disabled(), &rsw));
     ASSERT_OK(rsw.Finish());
@@ -464,7 +465,8 @@ class TestCompaction : public KuduRowSetTest {
       // Use a low target row size to increase the number of resulting rowsets.
       RollingDiskRowSetWriter rdrsw(tablet()->metadata(), schema_,
                                     Tablet::DefaultBloomSizing(),
-                                    1024 * 1024); // 1 MB
+                                    1024 * 1024, // 1 MB
+                                    /*encoding_pool=*/nullptr);
       ASSERT_OK(rdrsw.Open());
       ASSERT_OK(FlushCompactionInput(compact_input.get(), merge_snap, HistoryGcOpts::Disabled(),
                                      &rdrsw));
@@ -31,6 +31,7 @@
 #include <glog/stl_logging.h>
 #include <gtest/gtest.h>
 
+#include "kudu/gutil/map-util.h"
 #include "kudu/gutil/stringprintf.h"
 #include "kudu/gutil/strings/numbers.h"
 #include "kudu/gutil/strings/split.h"
@@ -635,5 +636,47 @@ TEST_F(TestCompactionPolicy, TestKUDU2704) {
   ASSERT_EQ(2, picked.size());
   ASSERT_GT(quality, 0.0);
 }
+
+// Test that the time-window policy only compacts the most recent key range
+// and small rowsets, leaving larger rowsets outside of the window untouched
+// even if their key ranges are overlapped by late writes.
+TEST_F(TestCompactionPolicy, TestTimeWindowSelection) {
+  FLAGS_compaction_small_rowset_tradeoff = 0.0;
+  const uint64_t kRowSetSize = FLAGS_budgeted_compaction_target_rowset_size;
+
+  /* NB: Zero-padding of string keys omitted to save space.
+   *
+   *     [50 - 150]                                   <- late writes
+   * [0 - 99] [100 - 199] ... [400 - 499]
+   *                                [450 - 549]       <- most recent
+   */
+  RowSetVector rowsets;
+  for (int i = 0; i < 5; i++) {
+    rowsets.emplace_back(new MockDiskRowSet(
+        StringPrintf("%010d", i * 100),
+        StringPrintf("%010d", i * 100 + 99),
+        kRowSetSize));
+  }
+  rowsets.emplace_back(new MockDiskRowSet(
+      StringPrintf("%010d", 450), StringPrintf("%010d", 549), kRowSetSize));
+  rowsets.emplace_back(new MockDiskRowSet(
+      StringPrintf("%010d", 50), StringPrintf("%010d", 150), kRowSetSize));
+  RowSetTree tree;
+  ASSERT_OK(tree.Reset(rowsets));
+
+  // With a window which only spans the two most recent rowsets, the late
+  // rowset and the rowsets it overlaps are left alone.
+  constexpr auto kBudgetMb = 1000;
+  const int kWindowMb = 2 * kRowSetSize / 1024 / 1024;
+  TimeWindowCompactionPolicy policy(kBudgetMb, kWindowMb);
+  CompactionSelection picked;
+  double quality = 0.0;
+  ASSERT_OK(policy.PickRowSets(tree, &picked, &quality, /*log=*/nullptr));
+  ASSERT_EQ(2, picked.size());
+  ASSERT_TRUE(ContainsKey(picked, rowsets[4].get()));
+  ASSERT_TRUE(ContainsKey(picked, rowsets[5].get()));
+  ASSERT_GT(quality, 0.0);
+}
+
 } // namespace tablet
 } // namespace kudu
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <unordered_set>
@@ -30,12 +31,17 @@
 
 #include "kudu/gutil/map-util.h"
 #include "kudu/gutil/strings/substitute.h"
+#include "kudu/tablet/rowset.h"
 #include "kudu/tablet/rowset_info.h"
+#include "kudu/tablet/rowset_tree.h"
 #include "kudu/tablet/svg_dump.h"
 #include "kudu/util/flag_tags.h"
 #include "kudu/util/knapsack_solver.h"
 #include "kudu/util/status.h"
 
+using std::pair;
+using std::shared_ptr;
+using std::string;
 using std::vector;
 using strings::Substitute;
 
@@ -513,5 +519,69 @@ Status BudgetedCompactionPolicy::PickRowSets(
   return Status::OK();
 }
 
+////////////////////////////////////////////////////////////
+// TimeWindowCompactionPolicy
+////////////////////////////////////////////////////////////
+
+TimeWindowCompactionPolicy::TimeWindowCompactionPolicy(int size_budget_mb, int window_mb)
+  : budgeted_policy_(size_budget_mb),
+    window_mb_(window_mb) {
+  CHECK_GT(window_mb, 0);
+}
+
+uint64_t TimeWindowCompactionPolicy::target_rowset_size() const {
+  return budgeted_policy_.target_rowset_size();
+}
+
+Status TimeWindowCompactionPolicy::PickRowSets(
+    const RowSetTree& tree,
+    CompactionSelection* picked,
+    double* quality,
+    std::vector<std::string>* log) {
+  // Rowsets without bounds (i.e. the MemRowSet) are never available for
+  // compaction anyway; pass them through untouched.
+  RowSetVector eligible;
+  vector<pair<string, shared_ptr<RowSet>>> by_max_key;
+  for (const shared_ptr<RowSet>& rs : tree.all_rowsets()) {
+    string min_key;
+    string max_key;
+    if (!rs->GetBounds(&min_key, &max_key).ok()) {
+      eligible.push_back(rs);
+      continue;
+    }
+    by_max_key.emplace_back(std::move(max_key), rs);
+  }
+  std::sort(by_max_key.begin(), by_max_key.end(),
+            [](const pair<string, shared_ptr<RowSet>>& a,
+               const pair<string, shared_ptr<RowSet>>& b) {
+              return a.first > b.first;
+            });
+
+  const uint64_t window_bytes = window_mb_ * 1024 * 1024;
+  const uint64_t target_size_bytes = target_rowset_size();
+  uint64_t hot_bytes = 0;
+  int num_sealed = 0;
+  for (const auto& e : by_max_key) {
+    const shared_ptr<RowSet>& rs = e.second;
+    const uint64_t size_bytes = rs->OnDiskBaseDataSizeWithRedos();
+    if (hot_bytes < window_bytes) {
+      hot_bytes += size_bytes;
+      eligible.push_back(rs);
+    } else if (size_bytes < target_size_bytes) {
+      eligible.push_back(rs);
+    } else {
+      num_sealed++;
+    }
+  }
+  if (log) {
+    LOG_STRING(INFO, log) << Substitute("Sealed $0 of $1 rowsets outside of the $2 MiB window",
+                                        num_sealed, by_max_key.size(), window_mb_);
+  }
+
+  RowSetTree window;
+  RETURN_NOT_OK(window.Reset(eligible));
+  return budgeted_policy_.PickRowSets(window, picked, quality, log);
+}
+
 } // namespace tablet
 } // namespace kudu
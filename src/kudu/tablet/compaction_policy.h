@@ -127,6 +127,30 @@ class BudgetedCompactionPolicy : public CompactionPolicy {
   const size_t size_budget_mb_;
 };
 
+// A compaction policy for append-mostly tables, e.g. time series keyed by
+// timestamp, in which newer rows have higher keys.
+//
+// The rowsets with the highest max keys, up to 'window_mb' of them in total,
+// make up the hot window; together with any smaller-than-target rowsets
+// outside of it, they are handed to a BudgetedCompactionPolicy. The remaining
+// rowsets are sealed and never rewritten, even if late writes overlap their
+// key ranges.
+class TimeWindowCompactionPolicy : public CompactionPolicy {
+ public:
+  TimeWindowCompactionPolicy(int size_budget_mb, int window_mb);
+
+  Status PickRowSets(const RowSetTree &tree,
+                     CompactionSelection* picked,
+                     double* quality,
+                     std::vector<std::string>* log) override;
+
+  uint64_t target_rowset_size() const override;
+
+ private:
+  BudgetedCompactionPolicy budgeted_policy_;
+  const size_t window_mb_;
+};
+
 } // namespace tablet
 } // namespace kudu
 #endif
@@ -79,7 +79,8 @@ MajorDeltaCompaction::MajorDeltaCompaction(
     vector<shared_ptr<DeltaStore> > included_stores,
     vector<ColumnId> col_ids,
     HistoryGcOpts history_gc_opts,
-    string tablet_id)
+    string tablet_id,
+    ThreadPool* encoding_pool)
     : fs_manager_(fs_manager),
       base_schema_(base_schema),
       column_ids_(std::move(col_ids)),
@@ -88,6 +89,7 @@ MajorDeltaCompaction::MajorDeltaCompaction(
       included_stores_(std::move(included_stores)),
       delta_iter_(std::move(delta_iter)),
       tablet_id_(std::move(tablet_id)),
+      encoding_pool_(encoding_pool),
       redo_delta_mutations_written_(0),
       undo_delta_mutations_written_(0),
       state_(kInitialized) {
@@ -266,7 +268,8 @@ Status MajorDeltaCompaction::OpenBaseDataWriter() {
 
   unique_ptr<MultiColumnWriter> w(new MultiColumnWriter(fs_manager_,
                                                         &partial_schema_,
-                                                        tablet_id_));
+                                                        tablet_id_,
+                                                        encoding_pool_));
   RETURN_NOT_OK(w->Open());
   base_data_writer_ = std::move(w);
   return Status::OK();
@@ -30,6 +30,7 @@
 namespace kudu {
 
 class FsManager;
+class ThreadPool;
 
 namespace fs {
 struct IOContext;
@@ -62,7 +63,8 @@ class MajorDeltaCompaction {
       std::vector<std::shared_ptr<DeltaStore> > included_stores,
       std::vector<ColumnId> col_ids,
       HistoryGcOpts history_gc_opts,
-      std::string tablet_id);
+      std::string tablet_id,
+      ThreadPool* encoding_pool);
   ~MajorDeltaCompaction();
 
   // Executes the compaction.
@@ -126,6 +128,9 @@ class MajorDeltaCompaction {
   // The ID of the tablet being compacted.
   const std::string tablet_id_;
 
+  // The pool on which the new base data is encoded, or null.
+  ThreadPool* const encoding_pool_;
+
   // Outputs:
   std::unique_ptr<MultiColumnWriter> base_data_writer_;
   // The following two may not be initialized if we don't need to write a delta file.
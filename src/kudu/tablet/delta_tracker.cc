@@ -482,13 +482,16 @@ bool DeltaTracker::EstimateAllRedosAreAncient(Timestamp ancient_history_mark) {
 }
 
 Status DeltaTracker::EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp ancient_history_mark,
-                                                                 int64_t* bytes) {
+                                                                 int64_t* bytes,
+                                                                 int64_t* blocks) {
   DCHECK_NE(Timestamp::kInvalidTimestamp, ancient_history_mark);
   DCHECK(bytes);
+  DCHECK(blocks);
   SharedDeltaStoreVector undos_newest_first;
   CollectStores(&undos_newest_first, UNDOS_ONLY);
 
   int64_t tmp_bytes = 0;
+  int64_t tmp_blocks = 0;
   for (const auto& undo : boost::adaptors::reverse(undos_newest_first)) {
     // Short-circuit once we hit an initialized delta block with 'max_timestamp' > AHM.
     if (undo->has_delta_stats() &&
@@ -496,9 +499,11 @@ Status DeltaTracker::EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp ancie
       break;
     }
     tmp_bytes += undo->EstimateSize(); // Can be called before Init().
+    tmp_blocks++;
   }
 
   *bytes = tmp_bytes;
+  *blocks = tmp_blocks;
   return Status::OK();
 }
 
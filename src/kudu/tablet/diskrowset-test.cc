@@ -71,6 +71,7 @@
 #include "kudu/util/stopwatch.h"
 #include "kudu/util/test_macros.h"
 #include "kudu/util/test_util.h"
+#include "kudu/util/threadpool.h"
 
 DEFINE_double(update_fraction, 0.1f, "fraction of rows to update");
 DECLARE_bool(cfile_lazy_open);
@@ -178,6 +179,78 @@ TEST_F(TestRowSet, TestRowSetRoundTrip) {
   }
 }
 
+// Test that a rowset whose columns are encoded on the shared encoding pool
+// reads back the same as one written by a single thread.
+TEST_F(TestRowSet, TestRowSetRoundTripWithEncodingThreads) {
+  unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("encoding").set_max_threads(4).Build(&pool));
+  {
+    DiskRowSetWriter drsw(rowset_meta_.get(), &schema_,
+                          BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f),
+                          pool.get());
+    DoWriteTestRowSet(0, &drsw);
+  }
+
+  shared_ptr<DiskRowSet> rs;
+  ASSERT_OK(OpenTestRowSet(&rs));
+  IterateProjection(*rs, schema_, n_rows_);
+
+  NO_FATALS(VerifyRandomRead(*rs, "hello 000000000000050",
+                             R"((string key="hello 000000000000050", uint32 val=50))"));
+}
+
+// Test that checking the presence of a sorted batch of keys spanning many
+// blocks agrees with checking the keys one at a time, including for keys in
+// between the rowset's keys and for deleted rows.
+TEST_F(TestRowSet, TestCheckRowsPresent) {
+  FLAGS_cfile_default_block_size = 1024;
+  WriteTestRowSet();
+  shared_ptr<DiskRowSet> rs;
+  ASSERT_OK(OpenTestRowSet(&rs));
+  for (int i = 0; i < n_rows_; i += 7) {
+    OperationResultPB result;
+    ASSERT_OK(DeleteRow(rs.get(), i, &result));
+  }
+
+  // Probe every row's key, each followed by a key sorting right after it which
+  // isn't in the rowset.
+  // The probes refer to the keys and rows, so those must outlive the probes.
+  Schema pk = schema_.CreateKeyProjection();
+  vector<string> keys;
+  for (int i = 0; i < n_rows_; i++) {
+    char buf[256];
+    FormatKey(i, buf, sizeof(buf));
+    keys.emplace_back(buf);
+    keys.emplace_back(string(buf) + "x");
+  }
+  Arena arena(1024);
+  vector<unique_ptr<RowBuilder>> rows;
+  vector<RowSetKeyProbe*> probes;
+  for (const auto& key : keys) {
+    rows.emplace_back(new RowBuilder(&pk));
+    rows.back()->AddString(Slice(key));
+    probes.push_back(arena.NewObject<RowSetKeyProbe>(rows.back()->row(), &arena));
+  }
+  vector<ProbeStats> stats(probes.size());
+  vector<ProbeStats*> stats_ptrs;
+  for (auto& s : stats) {
+    stats_ptrs.push_back(&s);
+  }
+
+  unique_ptr<bool[]> present(new bool[probes.size()]);
+  ASSERT_OK(rs->CheckRowsPresent(probes.data(), probes.size(), nullptr,
+                                 present.get(), stats_ptrs.data()));
+  for (int i = 0; i < probes.size(); i++) {
+    int row_idx = i / 2;
+    bool expected_present = i % 2 == 0 && row_idx % 7 != 0;
+    ASSERT_EQ(expected_present, present[i]) << "probe " << i;
+    ProbeStats single_stats;
+    bool single_present;
+    ASSERT_OK(rs->CheckRowPresent(*probes[i], nullptr, &single_present, &single_stats));
+    ASSERT_EQ(single_present, present[i]) << "probe " << i;
+  }
+}
+
 // Test writing a rowset, and then updating some rows in it.
 TEST_F(TestRowSet, TestRowSetUpdate) {
   Arena arena(64);
@@ -389,7 +462,8 @@ TEST_F(TestRowSet, TestFlushedUpdatesRespectMVCC) {
   // Write a single row into a new DiskRowSet.
   LOG_TIMING(INFO, "Writing rowset") {
     DiskRowSetWriter drsw(rowset_meta_.get(), &schema_,
-                          BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f));
+                          BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f),
+                          /*encoding_pool=*/nullptr);
 
     ASSERT_OK(drsw.Open());
 
@@ -515,7 +589,8 @@ TEST_F(TestRowSet, TestRollingDiskRowSetWriter) {
 
   RollingDiskRowSetWriter writer(tablet()->metadata(), schema_,
                                  BloomFilterSizing::BySizeAndFPRate(32*1024, 0.01f),
-                                 64 * 1024); // roll every 64KB
+                                 64 * 1024, // roll every 64KB
+                                 /*encoding_pool=*/nullptr);
   DoWriteTestRowSet(FLAGS_roundtrip_num_rows, &writer);
 
   // Should have rolled 4 times.
@@ -750,7 +825,8 @@ TEST_P(DiffScanRowSetTest, TestFuzz) {
   shared_ptr<DiskRowSet> rs;
   {
     DiskRowSetWriter drsw(rowset_meta_.get(), &schema_,
-                          BloomFilterSizing::BySizeAndFPRate(32 * 1024, 0.01f));
+                          BloomFilterSizing::BySizeAndFPRate(32 * 1024, 0.01f),
+                          /*encoding_pool=*/nullptr);
     ASSERT_OK(drsw.Open());
 
     RowBuilder rb(&schema_);
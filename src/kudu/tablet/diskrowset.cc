@@ -106,10 +106,12 @@ const char *DiskRowSet::kMaxKeyMetaEntryName = "max_key";
 
 DiskRowSetWriter::DiskRowSetWriter(RowSetMetadata* rowset_metadata,
                                    const Schema* schema,
-                                   BloomFilterSizing bloom_sizing)
+                                   BloomFilterSizing bloom_sizing,
+                                   ThreadPool* encoding_pool)
     : rowset_metadata_(rowset_metadata),
       schema_(schema),
       bloom_sizing_(bloom_sizing),
+      encoding_pool_(encoding_pool),
       finished_(false),
       written_count_(0) {
   CHECK(schema->has_column_ids());
@@ -120,7 +122,7 @@ Status DiskRowSetWriter::Open() {
 
   FsManager* fs = rowset_metadata_->fs_manager();
   const string& tablet_id = rowset_metadata_->tablet_metadata()->tablet_id();
-  col_writer_.reset(new MultiColumnWriter(fs, schema_, tablet_id));
+  col_writer_.reset(new MultiColumnWriter(fs, schema_, tablet_id, encoding_pool_));
   RETURN_NOT_OK(col_writer_->Open());
 
   // Open bloom filter.
@@ -197,8 +199,12 @@ Status DiskRowSetWriter::AppendBlock(const RowBlock &block, int live_row_count)
     last_encoded_key_.clear();
   }
 
-  // Write the batch to each of the columns
-  RETURN_NOT_OK(col_writer_->AppendBlock(block));
+  // Write the batch to each of the columns. The columns may be encoded on
+  // other threads while the keys are written below.
+  col_writer_->StartAppendBlock(block);
+  auto finish_columns = MakeScopedCleanup([&]() {
+    WARN_NOT_OK(col_writer_->FinishAppendBlock(), "Unable to write columns");
+  });
 
   // Increase the live row count if necessary.
   rowset_metadata_->IncrementLiveRows(live_row_count);
@@ -232,6 +238,8 @@ Status DiskRowSetWriter::AppendBlock(const RowBlock &block, int live_row_count)
 #endif
   }
 
+  finish_columns.cancel();
+  RETURN_NOT_OK(col_writer_->FinishAppendBlock());
   written_count_ += block.nrows();
 
   return Status::OK();
@@ -322,12 +330,14 @@ DiskRowSetWriter::~DiskRowSetWriter() {
 
 RollingDiskRowSetWriter::RollingDiskRowSetWriter(
     TabletMetadata* tablet_metadata, const Schema& schema,
-    BloomFilterSizing bloom_sizing, size_t target_rowset_size)
+    BloomFilterSizing bloom_sizing, size_t target_rowset_size,
+    ThreadPool* encoding_pool)
     : state_(kInitialized),
       tablet_metadata_(DCHECK_NOTNULL(tablet_metadata)),
       schema_(schema),
       bloom_sizing_(bloom_sizing),
       target_rowset_size_(target_rowset_size),
+      encoding_pool_(encoding_pool),
       row_idx_in_cur_drs_(0),
       can_roll_(false),
       written_count_(0),
@@ -353,7 +363,8 @@ Status RollingDiskRowSetWriter::RollWriter() {
 
   RETURN_NOT_OK(tablet_metadata_->CreateRowSet(&cur_drs_metadata_));
 
-  cur_writer_.reset(new DiskRowSetWriter(cur_drs_metadata_.get(), &schema_, bloom_sizing_));
+  cur_writer_.reset(new DiskRowSetWriter(cur_drs_metadata_.get(), &schema_, bloom_sizing_,
+                                         encoding_pool_));
   RETURN_NOT_OK(cur_writer_->Open());
 
   FsManager* fs = tablet_metadata_->fs_manager();
@@ -563,12 +574,14 @@ Status DiskRowSet::MajorCompactDeltaStores(const IOContext* io_context,
     return Status::OK();
   }
 
-  return MajorCompactDeltaStoresWithColumnIds(col_ids, io_context, std::move(history_gc_opts));
+  return MajorCompactDeltaStoresWithColumnIds(col_ids, io_context, std::move(history_gc_opts),
+                                              /*encoding_pool=*/nullptr);
 }
 
 Status DiskRowSet::MajorCompactDeltaStoresWithColumnIds(const vector<ColumnId>& col_ids,
                                                         const IOContext* io_context,
-                                                        HistoryGcOpts history_gc_opts) {
+                                                        HistoryGcOpts history_gc_opts,
+                                                        ThreadPool* encoding_pool) {
   VLOG_WITH_PREFIX(1) << "Major compacting REDO delta stores (cols: " << col_ids << ")";
   TRACE_EVENT0("tablet", "DiskRowSet::MajorCompactDeltaStoresWithColumnIds");
   std::lock_guard<Mutex> l(*delta_tracker()->compact_flush_lock());
@@ -577,7 +590,7 @@ Status DiskRowSet::MajorCompactDeltaStoresWithColumnIds(const vector<ColumnId>&
   // TODO(todd): do we need to lock schema or anything here?
   unique_ptr<MajorDeltaCompaction> compaction;
   RETURN_NOT_OK(NewMajorDeltaCompaction(col_ids, std::move(history_gc_opts),
-                                        io_context, &compaction));
+                                        io_context, encoding_pool, &compaction));
 
   RETURN_NOT_OK(compaction->Compact(io_context));
 
@@ -625,6 +638,7 @@ Status DiskRowSet::MajorCompactDeltaStoresWithColumnIds(const vector<ColumnId>&
 Status DiskRowSet::NewMajorDeltaCompaction(const vector<ColumnId>& col_ids,
                                            HistoryGcOpts history_gc_opts,
                                            const IOContext* io_context,
+                                           ThreadPool* encoding_pool,
                                            unique_ptr<MajorDeltaCompaction>* out) const {
   DCHECK(open_);
   shared_lock<rw_spinlock> l(component_lock_);
@@ -646,7 +660,8 @@ Status DiskRowSet::NewMajorDeltaCompaction(const vector<ColumnId>& col_ids,
                                       std::move(included_stores),
                                       col_ids,
                                       std::move(history_gc_opts),
-                                      rowset_metadata_->tablet_metadata()->tablet_id()));
+                                      rowset_metadata_->tablet_metadata()->tablet_id(),
+                                      encoding_pool));
   return Status::OK();
 }
 
@@ -735,6 +750,26 @@ Status DiskRowSet::CheckRowPresent(const RowSetKeyProbe &probe,
   return Status::OK();
 }
 
+Status DiskRowSet::CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                                    const IOContext* io_context, bool* present,
+                                    ProbeStats* const* stats) const {
+  DCHECK(open_);
+  shared_lock<rw_spinlock> l(component_lock_);
+
+  vector<rowid_t> row_idxs(n_probes);
+  RETURN_NOT_OK(base_data_->CheckRowsPresent(probes, n_probes, io_context, present,
+                                             row_idxs.data(), stats));
+
+  // The keys found in the base data might have been deleted since.
+  for (size_t i = 0; i < n_probes; i++) {
+    if (!present[i]) continue;
+    bool deleted = false;
+    RETURN_NOT_OK(delta_tracker_->CheckRowDeleted(row_idxs[i], io_context, &deleted, stats[i]));
+    present[i] = !deleted;
+  }
+  return Status::OK();
+}
+
 Status DiskRowSet::CountRows(const IOContext* io_context, rowid_t *count) const {
   DCHECK(open_);
   rowid_t num_rows = num_rows_.load();
@@ -862,8 +897,10 @@ double DiskRowSet::DeltaStoresCompactionPerfImprovementScore(DeltaCompactionType
 }
 
 Status DiskRowSet::EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp ancient_history_mark,
-                                                               int64_t* bytes) {
-  return delta_tracker_->EstimateBytesInPotentiallyAncientUndoDeltas(ancient_history_mark, bytes);
+                                                               int64_t* bytes,
+                                                               int64_t* blocks) {
+  return delta_tracker_->EstimateBytesInPotentiallyAncientUndoDeltas(ancient_history_mark,
+                                                                     bytes, blocks);
 }
 
 Status DiskRowSet::IsDeletedAndFullyAncient(Timestamp ancient_history_mark,
@@ -55,6 +55,7 @@ class MonoTime;
 class RowBlock;
 class RowChangeList;
 class RowwiseIterator;
+class ThreadPool;
 class Timestamp;
 
 namespace cfile {
@@ -90,8 +91,10 @@ class OperationResultPB;
 class DiskRowSetWriter {
  public:
   // TODO: document ownership of rowset_metadata
+  //
+  // If 'encoding_pool' isn't null, the columns are encoded on its threads.
   DiskRowSetWriter(RowSetMetadata* rowset_metadata, const Schema* schema,
-                   BloomFilterSizing bloom_sizing);
+                   BloomFilterSizing bloom_sizing, ThreadPool* encoding_pool);
 
   ~DiskRowSetWriter();
 
@@ -145,6 +148,8 @@ class DiskRowSetWriter {
 
   BloomFilterSizing bloom_sizing_;
 
+  ThreadPool* const encoding_pool_;
+
   bool finished_;
   rowid_t written_count_;
   std::unique_ptr<MultiColumnWriter> col_writer_;
@@ -165,10 +170,12 @@ class RollingDiskRowSetWriter {
  public:
   // Create a new rolling writer. The given 'tablet_metadata' must stay valid
   // for the lifetime of this writer, and is used to construct the new rowsets
-  // that this RollingDiskRowSetWriter creates.
+  // that this RollingDiskRowSetWriter creates. If 'encoding_pool' isn't null,
+  // the columns of the new rowsets are encoded on its threads.
   RollingDiskRowSetWriter(TabletMetadata* tablet_metadata, const Schema& schema,
                           BloomFilterSizing bloom_sizing,
-                          size_t target_rowset_size);
+                          size_t target_rowset_size,
+                          ThreadPool* encoding_pool);
   ~RollingDiskRowSetWriter();
 
   Status Open();
@@ -247,6 +254,7 @@ class RollingDiskRowSetWriter {
   std::shared_ptr<RowSetMetadata> cur_drs_metadata_;
   const BloomFilterSizing bloom_sizing_;
   const size_t target_rowset_size_;
+  ThreadPool* const encoding_pool_;
 
   std::unique_ptr<DiskRowSetWriter> cur_writer_;
 
@@ -356,6 +364,10 @@ class DiskRowSet :
   Status CheckRowPresent(const RowSetKeyProbe &probe, const fs::IOContext* io_context,
                          bool *present, ProbeStats* stats) const override;
 
+  Status CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                          const fs::IOContext* io_context, bool* present,
+                          ProbeStats* const* stats) const override;
+
   ////////////////////
   // Read functions.
   ////////////////////
@@ -399,7 +411,8 @@ class DiskRowSet :
   double DeltaStoresCompactionPerfImprovementScore(DeltaCompactionType type) const override;
 
   Status EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp ancient_history_mark,
-                                                     int64_t* bytes) override;
+                                                     int64_t* bytes,
+                                                     int64_t* blocks) override;
 
   Status IsDeletedAndFullyAncient(Timestamp ancient_history_mark,
                                   bool* deleted_and_ancient) override;
@@ -469,12 +482,15 @@ class DiskRowSet :
   Status NewMajorDeltaCompaction(const std::vector<ColumnId>& col_ids,
                                  HistoryGcOpts history_gc_opts,
                                  const fs::IOContext* io_context,
+                                 ThreadPool* encoding_pool,
                                  std::unique_ptr<MajorDeltaCompaction>* out) const;
 
-  // Major compacts all the delta files for the specified columns.
+  // Major compacts all the delta files for the specified columns. If
+  // 'encoding_pool' isn't null, the new base data is encoded on its threads.
   Status MajorCompactDeltaStoresWithColumnIds(const std::vector<ColumnId>& col_ids,
                                               const fs::IOContext* io_context,
-                                              HistoryGcOpts history_gc_opts);
+                                              HistoryGcOpts history_gc_opts,
+                                              ThreadPool* encoding_pool);
 
   std::shared_ptr<RowSetMetadata> rowset_metadata_;
 
@@ -136,6 +136,14 @@ class LocalTabletWriter {
     return Status::OK();
   }
 
+  // Like WriteBatch(), but writes the rows as a bulk load.
+  Status BulkLoadBatch(const std::vector<RowOp>& ops) {
+    req_.set_bulk_load(true);
+    Status s = WriteBatch(ops);
+    req_.clear_bulk_load();
+    return s;
+  }
+
   // Return the result of the last row operation run against the tablet.
   const OperationResultPB& last_op_result() {
     CHECK_GE(result_->ops_size(), 1);
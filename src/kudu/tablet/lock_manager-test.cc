@@ -110,6 +110,23 @@ TEST_F(LockManagerTest, TestLockBatch) {
   }
 }
 
+TEST_F(LockManagerTest, TestLockBatchWithDuplicates) {
+  vector<Slice> keys = {"a", "b", "a", "c", "b", "a"};
+  {
+    ScopedRowLock l1(&lock_manager_, kFakeTransaction, keys, LockManager::LOCK_EXCLUSIVE);
+    ASSERT_TRUE(l1.acquired());
+    for (const auto& k : keys) {
+      VerifyAlreadyLocked(k);
+    }
+  }
+  // Releasing the batch should fully unlock every key, however many times it
+  // appeared in the batch, so that another op can lock them without waiting.
+  // The lock table also checks on destruction that no references leaked.
+  const OpState* other_op = reinterpret_cast<OpState*>(0xcafebabe);
+  ScopedRowLock l2(&lock_manager_, other_op, keys, LockManager::LOCK_EXCLUSIVE);
+  ASSERT_TRUE(l2.acquired());
+}
+
 TEST_F(LockManagerTest, TestRelockSameRow) {
   Slice key_a[] = {"a"};
   ScopedRowLock row_lock(&lock_manager_, kFakeTransaction, key_a, LockManager::LOCK_EXCLUSIVE);
@@ -17,6 +17,7 @@
 
 #include "kudu/tablet/lock_manager.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -58,14 +59,18 @@ class OpState;
 // Callers should generally use ScopedRowLock (see below).
 class LockEntry {
  public:
-  explicit LockEntry(const Slice& key)
+  LockEntry(const Slice& key, uint64_t key_hash)
   : sem(1),
     recursion_(0) {
-    key_hash_ = util_hash::CityHash64(reinterpret_cast<const char *>(key.data()), key.size());
+    key_hash_ = key_hash;
     key_ = key;
     refs_ = 1;
   }
 
+  static uint64_t HashKey(const Slice& key) {
+    return util_hash::CityHash64(reinterpret_cast<const char *>(key.data()), key.size());
+  }
+
   bool Equals(const Slice& key, uint64_t hash) const {
     return key_hash_ == hash && key_ == key;
   }
@@ -131,6 +136,9 @@ class LockTable {
     }
   }
 
+  // Returns the entries of the distinct keys among 'keys', taking a
+  // reference to each. The entries are ordered by key hash, then by key, so
+  // that the locks of any two batches are acquired in a consistent order.
   vector<LockEntry*> GetLockEntries(ArrayView<Slice> keys);
   LockEntry* GetLockEntry(Slice key);
 
@@ -179,35 +187,70 @@ class LockTable {
 };
 
 vector<LockEntry*> LockTable::GetLockEntries(ArrayView<Slice> keys) {
+  // Hash the keys up front and sort them, dropping any duplicates within the
+  // batch: each distinct key needs only one entry and one acquisition, and
+  // the sorted order keeps concurrent batches from deadlocking on each other.
+  struct HashedKey {
+    uint64_t hash;
+    Slice key;
+  };
+  vector<HashedKey> hashed;
+  hashed.reserve(keys.size());
+  for (const Slice& key : keys) {
+    hashed.push_back({ LockEntry::HashKey(key), key });
+  }
+  std::sort(hashed.begin(), hashed.end(), [](const HashedKey& a, const HashedKey& b) {
+    return a.hash < b.hash || (a.hash == b.hash && a.key.compare(b.key) < 0);
+  });
+  hashed.erase(std::unique(hashed.begin(), hashed.end(),
+                           [](const HashedKey& a, const HashedKey& b) {
+                             return a.hash == b.hash && a.key == b.key;
+                           }),
+               hashed.end());
+
   vector<LockEntry*> entries;
-  entries.resize(keys.size());
-  for (int i = 0; i < keys.size(); i++) {
-    entries[i] = new LockEntry(keys[i]);
+  entries.reserve(hashed.size());
+  for (const auto& hk : hashed) {
+    entries.push_back(new LockEntry(hk.key, hk.hash));
   }
 
   vector<LockEntry*> to_delete;
+  const auto& InsertEntry = [&](LockEntry** entry) {
+    LockEntry* new_entry = *entry;
+    Bucket* bucket = FindBucket(new_entry->key_hash_);
+    LockEntry **node = FindSlot(bucket, new_entry->key_, new_entry->key_hash_);
+    LockEntry* old_entry = *node;
+    if (PREDICT_FALSE(old_entry != nullptr)) {
+      old_entry->refs_++;
+      to_delete.push_back(new_entry);
+      *entry = old_entry;
+    } else {
+      new_entry->ht_next_ = nullptr;
+      new_entry->CopyKey();
+      *node = new_entry;
+      ++item_count_;
+
+      if (PREDICT_FALSE(item_count_ > size_)) {
+        Resize();
+      }
+    }
+  };
 
-  // TODO(todd) prefetch the hash buckets
   {
     unique_lock<simple_spinlock> l(lock_);
-    for (int i = 0; i < entries.size(); i++) {
-      LockEntry* new_entry = entries[i];
-      Bucket* bucket = FindBucket(new_entry->key_hash_);
-      LockEntry **node = FindSlot(bucket, new_entry->key_, new_entry->key_hash_);
-      LockEntry* old_entry = *node;
-      if (PREDICT_FALSE(old_entry != nullptr)) {
-        old_entry->refs_++;
-        to_delete.push_back(entries[i]);
-        entries[i] = old_entry;
-      } else {
-        new_entry->ht_next_ = nullptr;
-        new_entry->CopyKey();
-        *node = new_entry;
-        ++item_count_;
-
-        if (PREDICT_FALSE(item_count_ > size_)) {
-          Resize();
-        }
+
+    // Prefetch the buckets of a block of entries before probing them, as in
+    // ReleaseLockEntries() below. The bucket is looked up again on insertion,
+    // since inserting an earlier entry of the block may resize the table.
+    static constexpr int kBatchSize = 16;
+    for (int start = 0; start < entries.size(); start += kBatchSize) {
+      const int end = std::min<int>(start + kBatchSize, entries.size());
+      for (int i = start; i < end; i++) {
+        prefetch(reinterpret_cast<const char*>(FindBucket(entries[i]->key_hash_)),
+                 PREFETCH_HINT_T0);
+      }
+      for (int i = start; i < end; i++) {
+        InsertEntry(&entries[i]);
       }
     }
   }
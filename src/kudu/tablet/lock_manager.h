@@ -53,6 +53,9 @@ class LockManager {
   friend class ScopedRowLock;
   friend class LockManagerTest;
 
+  // Locks the distinct keys among 'keys' on behalf of 'op', returning one
+  // entry per distinct key. Keys are locked in hash order, so batches which
+  // overlap can't deadlock against each other.
   std::vector<LockEntry*> LockBatch(ArrayView<Slice> keys, const OpState* op);
 
   bool TryLock(const Slice& key, const OpState* op, LockEntry** entry);
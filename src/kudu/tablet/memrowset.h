@@ -389,9 +389,12 @@ class MemRowSet : public RowSet,
   }
 
   Status EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp /*ancient_history_mark*/,
-                                                     int64_t* bytes) override {
+                                                     int64_t* bytes,
+                                                     int64_t* blocks) override {
     DCHECK(bytes);
+    DCHECK(blocks);
     *bytes = 0;
+    *blocks = 0;
     return Status::OK();
   }
 
@@ -154,7 +154,8 @@ class MockRowSet : public RowSet {
   }
 
   virtual Status EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp /*ancient_history_mark*/,
-                                                             int64_t* /*bytes*/) override {
+                                                             int64_t* /*bytes*/,
+                                                             int64_t* /*blocks*/) override {
     LOG(FATAL) << "Unimplemented";
     return Status::OK();
   }
@@ -17,6 +17,7 @@
 
 #include "kudu/tablet/multi_column_writer.h"
 
+#include <algorithm>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -32,6 +33,7 @@
 #include "kudu/fs/fs_manager.h"
 #include "kudu/gutil/stl_util.h"
 #include "kudu/gutil/strings/substitute.h"
+#include "kudu/util/threadpool.h"
 
 namespace kudu {
 namespace tablet {
@@ -44,14 +46,20 @@ using std::unique_ptr;
 
 MultiColumnWriter::MultiColumnWriter(FsManager* fs,
                                      const Schema* schema,
-                                     std::string tablet_id)
+                                     std::string tablet_id,
+                                     ThreadPool* encoding_pool)
   : fs_(fs),
     schema_(schema),
+    encoding_pool_(encoding_pool),
     finished_(false),
     tablet_id_(std::move(tablet_id)) {
 }
 
 MultiColumnWriter::~MultiColumnWriter() {
+  // Don't free the writers out from under any in-flight encoding tasks.
+  if (encoding_token_) {
+    encoding_token_->Wait();
+  }
   STLDeleteElements(&cfile_writers_);
 }
 
@@ -72,6 +80,10 @@ Status MultiColumnWriter::Open() {
     /// Set the column storage attributes.
     opts.storage_attributes = col.attributes();
 
+    // Summarize each data block so scans can skip blocks whose values cannot
+    // satisfy their predicates.
+    opts.write_zone_map = true;
+
     // If the schema has a single PK and this is the PK col
     if (i == 0 && schema_->num_key_columns() == 1) {
       opts.write_validx = true;
@@ -98,11 +110,57 @@ Status MultiColumnWriter::Open() {
   VLOG(1) << strings::Substitute("Opened CFile writers for $0 column(s)",
                                  cfile_writers_.size());
 
+  if (encoding_pool_ && schema_->num_columns() > 1) {
+    encoding_token_ = encoding_pool_->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+  }
+
   return Status::OK();
 }
 
 Status MultiColumnWriter::AppendBlock(const RowBlock& block) {
-  for (int i = 0; i < schema_->num_columns(); i++) {
+  StartAppendBlock(block);
+  return FinishAppendBlock();
+}
+
+void MultiColumnWriter::StartAppendBlock(const RowBlock& block) {
+  DCHECK(append_statuses_.empty());
+  if (!encoding_token_) {
+    append_statuses_.emplace_back(AppendColumns(block, 0, 1));
+    return;
+  }
+
+  // Split the columns among as many tasks as there are encoding threads.
+  const int num_tasks = std::min<int>(encoding_pool_->max_threads(),
+                                      schema_->num_columns());
+  append_statuses_.resize(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    Status* s = &append_statuses_[i];
+    Status submit_status = encoding_token_->Submit([this, &block, i, num_tasks, s]() {
+      *s = AppendColumns(block, i, num_tasks);
+    });
+    if (PREDICT_FALSE(!submit_status.ok())) {
+      *s = AppendColumns(block, i, num_tasks);
+    }
+  }
+}
+
+Status MultiColumnWriter::FinishAppendBlock() {
+  if (encoding_token_) {
+    encoding_token_->Wait();
+  }
+  Status s;
+  for (const auto& task_status : append_statuses_) {
+    if (PREDICT_FALSE(!task_status.ok())) {
+      s = task_status;
+      break;
+    }
+  }
+  append_statuses_.clear();
+  return s;
+}
+
+Status MultiColumnWriter::AppendColumns(const RowBlock& block, int first_col, int stride) {
+  for (int i = first_col; i < schema_->num_columns(); i += stride) {
     ColumnBlock column = block.column_block(i);
     if (column.is_nullable()) {
       RETURN_NOT_OK(cfile_writers_[i]->AppendNullableEntries(column.non_null_bitmap(),
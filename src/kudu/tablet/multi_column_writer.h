@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,8 @@ namespace kudu {
 class FsManager;
 class RowBlock;
 class Schema;
+class ThreadPool;
+class ThreadPoolToken;
 struct ColumnId;
 
 namespace cfile {
@@ -47,11 +50,15 @@ namespace tablet {
 
 // Wrapper which writes several columns in parallel corresponding to some
 // Schema. Written blocks will fall in the tablet_id's data dir group.
+//
+// If 'encoding_pool' isn't null, the columns are encoded and compressed on
+// its threads; it must outlive the writer.
 class MultiColumnWriter {
  public:
   MultiColumnWriter(FsManager* fs,
                     const Schema* schema,
-                    std::string tablet_id);
+                    std::string tablet_id,
+                    ThreadPool* encoding_pool);
 
   virtual ~MultiColumnWriter();
 
@@ -63,6 +70,17 @@ class MultiColumnWriter {
   // Note that the selection vector here is ignored.
   Status AppendBlock(const RowBlock& block);
 
+  // Like AppendBlock(), but split in two so that the caller can do other work
+  // while the columns are encoded. If the writer has an encoding pool,
+  // StartAppendBlock() hands the columns to its threads and returns
+  // immediately; otherwise it appends them itself.
+  //
+  // FinishAppendBlock() waits for the columns to be appended and returns the
+  // result. It must be called after each StartAppendBlock(), before 'block'
+  // is modified or destroyed and before any other call on this writer.
+  void StartAppendBlock(const RowBlock& block);
+  Status FinishAppendBlock();
+
   // Close the in-progress CFiles, finalizing the underlying writable
   // blocks and releasing them to 'transaction'.
   Status FinishAndReleaseBlocks(fs::BlockCreationTransaction* transaction);
@@ -81,8 +99,13 @@ class MultiColumnWriter {
   void GetFlushedBlocksByColumnId(std::map<ColumnId, BlockId>* ret) const;
 
  private:
+  // Appends the columns of 'block' whose index is congruent to 'first_col'
+  // modulo 'stride'.
+  Status AppendColumns(const RowBlock& block, int first_col, int stride);
+
   FsManager* const fs_;
   const Schema* const schema_;
+  ThreadPool* const encoding_pool_;
 
   bool finished_;
 
@@ -91,6 +114,13 @@ class MultiColumnWriter {
   std::vector<cfile::CFileWriter *> cfile_writers_;
   std::vector<BlockId> block_ids_;
 
+  // Token for the shared encoding pool, or null if columns are appended by
+  // the calling thread.
+  std::unique_ptr<ThreadPoolToken> encoding_token_;
+
+  // Results of the in-flight StartAppendBlock(), one per encoding task.
+  std::vector<Status> append_statuses_;
+
   DISALLOW_COPY_AND_ASSIGN(MultiColumnWriter);
 };
 
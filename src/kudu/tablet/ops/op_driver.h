@@ -87,6 +87,14 @@ class OpTracker;
 //  5 - ApplyAsync() submits ApplyTask() to the apply_pool_.
 //      ApplyTask() calls op_->Apply().
 //
+//      Unlike preparing, applying isn't serialized per tablet: the apply pool
+//      is shared by all replicas and runs ops concurrently, including ops of
+//      the same tablet. Ops which touch the same rows are still applied in
+//      log order, since each holds its row locks from Prepare() (which does
+//      run serially, in log order) until Finalize(). MVCC doesn't require ops
+//      to finish applying in timestamp order, and the CommitMsgs which apply
+//      enqueues may be written to the WAL in any order.
+//
 //      When Apply() is called, changes are made to the in-memory data structures. These
 //      changes are not visible to clients yet. After Apply() completes, a CommitMsg
 //      is enqueued to the WAL in order to store information about the operation result
@@ -55,6 +55,12 @@ void RowOp::SetInsertSucceeded(int mrs_id) {
   result->add_mutated_stores()->set_mrs_id(mrs_id);
 }
 
+void RowOp::SetBulkLoadSucceeded(int64_t bulk_load_id) {
+  DCHECK(!result) << SecureDebugString(*result);
+  result = google::protobuf::Arena::CreateMessage<OperationResultPB>(pb_arena_);
+  result->add_mutated_stores()->set_bulk_load_id(bulk_load_id);
+}
+
 void RowOp::SetErrorIgnored() {
   DCHECK(!result) << SecureDebugString(*result);
   result = google::protobuf::Arena::CreateMessage<OperationResultPB>(pb_arena_);
@@ -16,6 +16,7 @@
 // under the License.
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "kudu/common/row_operations.h"
@@ -43,9 +44,10 @@ struct RowOp {
   ~RowOp() = default;
 
   // Functions to set the result of the mutation.
-  // Only one of the following four functions must be called, at most once.
+  // Only one of the following five functions must be called, at most once.
   void SetFailed(const Status& s);
   void SetInsertSucceeded(int mrs_id);
+  void SetBulkLoadSucceeded(int64_t bulk_load_id);
   void SetErrorIgnored();
 
   // REQUIRES: result must be allocated from the same protobuf::Arena associated
@@ -47,7 +47,18 @@ RowIteratorOptions::RowIteratorOptions()
     : projection(nullptr),
       snap_to_include(MvccSnapshot::CreateSnapshotIncludingAllOps()),
       order(OrderMode::UNORDERED),
-      include_deleted_rows(false) {}
+      include_deleted_rows(false),
+      scan_pool(nullptr),
+      scan_parallelism(1) {}
+
+Status RowSet::CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                                const IOContext* io_context, bool* present,
+                                ProbeStats* const* stats) const {
+  for (size_t i = 0; i < n_probes; i++) {
+    RETURN_NOT_OK(CheckRowPresent(*probes[i], io_context, &present[i], stats[i]));
+  }
+  return Status::OK();
+}
 
 Status RowSet::NewRowIteratorWithBounds(const RowIteratorOptions& opts,
                                         IterWithBounds* out) const {
@@ -46,6 +46,7 @@ class RowChangeList;
 class RowwiseIterator;
 class Schema;
 class Slice;
+class ThreadPool;
 struct ColumnId;
 struct IterWithBounds;
 
@@ -101,6 +102,15 @@ struct RowIteratorOptions {
   //
   // Defaults to false.
   bool include_deleted_rows;
+
+  // If set, an UNORDERED iteration over a tablet scans up to
+  // 'scan_parallelism' of its rowsets at a time on this pool.
+  //
+  // Defaults to nullptr.
+  ThreadPool* scan_pool;
+
+  // Defaults to 1.
+  int scan_parallelism;
 };
 
 class RowSet {
@@ -120,6 +130,16 @@ class RowSet {
   virtual Status CheckRowPresent(const RowSetKeyProbe &probe, const fs::IOContext* io_context,
                                  bool *present, ProbeStats* stats) const = 0;
 
+  // Check whether each of the 'n_probes' given row keys is present in this
+  // rowset, setting present[i] for probes[i] as CheckRowPresent() would and
+  // accounting the work in stats[i]. The probes must be sorted by key.
+  //
+  // The default implementation checks the keys one at a time. Rowsets which
+  // can share work between neighbouring keys override it.
+  virtual Status CheckRowsPresent(const RowSetKeyProbe* const* probes, size_t n_probes,
+                                  const fs::IOContext* io_context, bool* present,
+                                  ProbeStats* const* stats) const;
+
   // Update/delete a row in this rowset.
   // The 'update_schema' is the client schema used to encode the 'update' RowChangeList.
   //
@@ -226,11 +246,12 @@ class RowSet {
   virtual Status IsDeletedAndFullyAncient(Timestamp ancient_history_mark,
                                           bool* deleted_and_ancient) = 0;
 
-  // Estimate the number of bytes in ancient undo delta stores. This may be an
-  // overestimate. The argument 'ancient_history_mark' must be valid (it may
-  // not be equal to Timestamp::kInvalidTimestamp).
+  // Estimate the number of bytes and blocks in ancient undo delta stores.
+  // This may be an overestimate. The argument 'ancient_history_mark' must be
+  // valid (it may not be equal to Timestamp::kInvalidTimestamp).
   virtual Status EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp ancient_history_mark,
-                                                             int64_t* bytes) = 0;
+                                                             int64_t* bytes,
+                                                             int64_t* blocks) = 0;
 
   // Initialize undo delta blocks until the given 'deadline' is passed, or
   // until all undo delta blocks with a max timestamp older than
@@ -465,9 +486,12 @@ class DuplicatingRowSet : public RowSet {
   }
 
   Status EstimateBytesInPotentiallyAncientUndoDeltas(Timestamp /*ancient_history_mark*/,
-                                                     int64_t* bytes) OVERRIDE {
+                                                     int64_t* bytes,
+                                                     int64_t* blocks) OVERRIDE {
     DCHECK(bytes);
+    DCHECK(blocks);
     *bytes = 0;
+    *blocks = 0;
     return Status::OK();
   }
 
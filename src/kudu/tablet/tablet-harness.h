@@ -122,7 +122,8 @@ class TabletHarness {
                              clock_.get(),
                              {},
                              metrics_registry_.get(),
-                             make_scoped_refptr(new log::LogAnchorRegistry)));
+                             make_scoped_refptr(new log::LogAnchorRegistry),
+                             /*rowset_encoding_pool=*/nullptr));
     return Status::OK();
   }
 
@@ -39,6 +39,7 @@
 #include "kudu/common/key_range.h"
 #include "kudu/common/partial_row.h"
 #include "kudu/common/rowblock.h"
+#include "kudu/common/rowid.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/timestamp.h"
 #include "kudu/common/wire_protocol.pb.h"
@@ -795,6 +796,68 @@ TYPED_TEST(TestTablet, TestInsertIgnore) {
   EXPECT_EQ(vector<string>{ this->setup_.FormatDebugRow(0, 1011, false) }, rows);
 }
 
+// Test that a bulk load writes its rows into a new DiskRowSet, in key order,
+// and with the same semantics as regular inserts.
+TYPED_TEST(TestTablet, TestBulkLoad) {
+  LocalTabletWriter writer(this->tablet().get(), &this->client_schema_);
+  const int kNumRows = this->ClampRowCount(100);
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 0));
+  MvccSnapshot snap_before_load(*this->tablet()->mvcc_manager());
+
+  // Load the rows in reverse order, along with an INSERT IGNORE of the last
+  // one. Its key is already in the MemRowSet.
+  vector<unique_ptr<KuduPartialRow>> rows;
+  vector<LocalTabletWriter::RowOp> ops;
+  for (int i = kNumRows - 1; i >= 0; i--) {
+    rows.emplace_back(new KuduPartialRow(&this->client_schema_));
+    this->setup_.BuildRow(rows.back().get(), i, 1);
+    ops.emplace_back(RowOperationsPB::INSERT, rows.back().get());
+  }
+  ops.emplace_back(RowOperationsPB::INSERT_IGNORE, rows.back().get());
+  Status s = writer.BulkLoadBatch(ops);
+  ASSERT_STR_CONTAINS(s.ToString(), "key already present");
+
+  // The rows went straight to disk, leaving the MemRowSet with the one row.
+  vector<shared_ptr<RowSet>> rowsets;
+  this->tablet()->GetRowSetsForTests(&rowsets);
+  ASSERT_EQ(1, rowsets.size());
+  rowid_t rows_in_drs = 0;
+  ASSERT_OK(rowsets[0]->CountRows(nullptr, &rows_in_drs));
+  ASSERT_EQ(kNumRows - 1, rows_in_drs);
+  ASSERT_EQ(kNumRows, this->TabletCount());
+  NO_FATALS(this->CheckLiveRowsCount(kNumRows));
+  vector<string> out_rows;
+  ASSERT_OK(this->IterateToStringList(&out_rows));
+  ASSERT_EQ(kNumRows, out_rows.size());
+  ASSERT_TRUE(std::find(out_rows.begin(), out_rows.end(),
+                        this->setup_.FormatDebugRow(0, 0, false)) != out_rows.end());
+  ASSERT_TRUE(std::find(out_rows.begin(), out_rows.end(),
+                        this->setup_.FormatDebugRow(1, 1, false)) != out_rows.end());
+
+  // Snapshots from before the load don't see its rows.
+  vector<vector<string>*> snap_rows;
+  CollectRowsForSnapshots(this->tablet().get(), this->client_schema_,
+                          { snap_before_load }, &snap_rows);
+  ASSERT_EQ(1, snap_rows[0]->size());
+  STLDeleteElements(&snap_rows);
+
+  // The bulk loaded rows can be mutated like any other.
+  ASSERT_OK(this->UpdateTestRow(&writer, 1, 100));
+  ASSERT_OK(this->DeleteTestRow(&writer, 2));
+  ASSERT_EQ(kNumRows - 1, this->TabletCount());
+
+  // Only inserts may be bulk loaded.
+  ops.clear();
+  ops.emplace_back(RowOperationsPB::UPSERT, rows.back().get());
+  s = writer.BulkLoadBatch(ops);
+  ASSERT_TRUE(s.IsInvalidArgument()) << s.ToString();
+
+  // The rowset is durable.
+  this->TabletReOpen();
+  ASSERT_EQ(kNumRows - 1, this->TabletCount());
+  ASSERT_EQ(0, this->tablet()->metadata()->last_durable_bulk_load_id());
+}
+
 TYPED_TEST(TestTablet, TestUpsert) {
   vector<string> rows;
   const auto& upserts_as_updates = this->tablet()->metrics()->upserts_as_updates;
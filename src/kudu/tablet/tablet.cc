@@ -43,10 +43,12 @@
 #include "kudu/common/row.h"
 #include "kudu/common/row_changelist.h"
 #include "kudu/common/row_operations.h"
+#include "kudu/common/rowblock.h"
 #include "kudu/common/rowid.h"
 #include "kudu/common/scan_spec.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/timestamp.h"
+#include "kudu/common/wire_protocol.h"
 #include "kudu/common/wire_protocol.pb.h"
 #include "kudu/consensus/log_anchor_registry.h"
 #include "kudu/consensus/opid.pb.h"
@@ -62,6 +64,7 @@
 #include "kudu/tablet/delta_tracker.h"
 #include "kudu/tablet/diskrowset.h"
 #include "kudu/tablet/memrowset.h"
+#include "kudu/tablet/mutation.h"
 #include "kudu/tablet/ops/alter_schema_op.h"
 #include "kudu/tablet/ops/write_op.h"
 #include "kudu/tablet/row_op.h"
@@ -95,6 +98,13 @@ DEFINE_int32(tablet_compaction_budget_mb, 128,
              "Budget for a single compaction");
 TAG_FLAG(tablet_compaction_budget_mb, experimental);
 
+DEFINE_int32(time_window_compaction_window_mb, 1024,
+             "Size of the most recent key range whose rowsets may be compacted "
+             "by the time-window compaction policy. Larger rowsets outside of "
+             "it are never rewritten. Only affects tables whose "
+             "'kudu.table.compaction_policy' is 'time_window'.");
+TAG_FLAG(time_window_compaction_window_mb, experimental);
+
 DEFINE_int32(tablet_bloom_block_size, 4096,
              "Block size of the bloom filters used for tablet keys.");
 TAG_FLAG(tablet_bloom_block_size, advanced);
@@ -230,6 +240,11 @@ static CompactionPolicy *CreateCompactionPolicy() {
   return new BudgetedCompactionPolicy(FLAGS_tablet_compaction_budget_mb);
 }
 
+static CompactionPolicy *CreateTimeWindowCompactionPolicy() {
+  return new TimeWindowCompactionPolicy(FLAGS_tablet_compaction_budget_mb,
+                                        FLAGS_time_window_compaction_window_mb);
+}
+
 ////////////////////////////////////////////////////////////
 // TabletComponents
 ////////////////////////////////////////////////////////////
@@ -246,13 +261,16 @@ Tablet::Tablet(scoped_refptr<TabletMetadata> metadata,
                clock::Clock* clock,
                shared_ptr<MemTracker> parent_mem_tracker,
                MetricRegistry* metric_registry,
-               scoped_refptr<LogAnchorRegistry> log_anchor_registry)
+               scoped_refptr<LogAnchorRegistry> log_anchor_registry,
+               ThreadPool* rowset_encoding_pool)
   : key_schema_(metadata->schema().CreateKeyProjection()),
     metadata_(std::move(metadata)),
     log_anchor_registry_(std::move(log_anchor_registry)),
     mem_trackers_(tablet_id(), std::move(parent_mem_tracker)),
     next_mrs_id_(0),
+    next_bulk_load_id_(0),
     clock_(clock),
+    rowset_encoding_pool_(rowset_encoding_pool),
     rowsets_flush_sem_(1),
     state_(kInitialized),
     last_write_time_(MonoTime::Now()),
@@ -264,6 +282,7 @@ Tablet::Tablet(scoped_refptr<TabletMetadata> metadata,
     last_write_score_(0.0) {
       CHECK(schema()->has_column_ids());
   compaction_policy_.reset(CreateCompactionPolicy());
+  time_window_compaction_policy_.reset(CreateTimeWindowCompactionPolicy());
 
   if (metric_registry) {
     MetricEntity::AttributeMap attrs;
@@ -319,6 +338,7 @@ Status Tablet::Open() {
   CHECK(schema()->has_column_ids());
 
   next_mrs_id_ = metadata_->last_durable_mrs_id() + 1;
+  next_bulk_load_id_ = metadata_->last_durable_bulk_load_id() + 1;
 
   RowSetVector rowsets_opened;
 
@@ -506,6 +526,19 @@ Status Tablet::DecodeWriteOperations(const Schema* client_schema,
   RETURN_NOT_OK(dec.DecodeOperations<DecoderMode::WRITE_OPS>(&ops));
   TRACE_COUNTER_INCREMENT("num_ops", ops.size());
 
+  // Bulk loads write their rows straight into new DiskRowSets, so they can
+  // only insert rows.
+  if (op_state->request()->bulk_load()) {
+    for (const auto& op : ops) {
+      if (PREDICT_FALSE(op.type != RowOperationsPB::INSERT &&
+                        op.type != RowOperationsPB::INSERT_IGNORE)) {
+        return Status::InvalidArgument(
+            "bulk loads may only contain INSERT and INSERT_IGNORE operations",
+            RowOperationsPB::Type_Name(op.type));
+      }
+    }
+  }
+
   // Important to set the schema before the ops -- we need the
   // schema in order to stringify the ops.
   op_state->set_schema_at_decode_time(schema());
@@ -906,6 +939,11 @@ Status Tablet::BulkCheckPresence(const IOContext* io_context, WriteOpState* op_s
   // 'pending_group' and then calls 'ProcessPendingGroup' when the next group
   // begins.
   vector<pair<RowSet*, int>> pending_group;
+  // The probes, stats and ops of the keys of 'pending_group' which are still
+  // to be checked, reused across groups.
+  vector<const RowSetKeyProbe*> group_probes;
+  vector<ProbeStats*> group_stats;
+  vector<RowOp*> group_ops;
   Status s;
   const auto& ProcessPendingGroup = [&]() {
     if (pending_group.empty() || !s.ok()) return;
@@ -919,6 +957,9 @@ Status Tablet::BulkCheckPresence(const IOContext* io_context, WriteOpState* op_s
                             return s_a.compare(s_b) < 0;
                           }));
     RowSet* rs = pending_group[0].first;
+    group_probes.clear();
+    group_stats.clear();
+    group_ops.clear();
     for (auto it = pending_group.begin();
          it != pending_group.end();
          ++it) {
@@ -929,17 +970,28 @@ Status Tablet::BulkCheckPresence(const IOContext* io_context, WriteOpState* op_s
         // Already found this op present somewhere.
         continue;
       }
+      group_probes.push_back(op->key_probe);
+      group_stats.push_back(op_state->mutable_op_stats(op_idx));
+      group_ops.push_back(op);
+    }
+    if (group_ops.empty()) {
+      pending_group.clear();
+      return;
+    }
 
-      bool present = false;
-      s = rs->CheckRowPresent(*op->key_probe, io_context,
-                              &present, op_state->mutable_op_stats(op_idx));
-      if (PREDICT_FALSE(!s.ok())) {
-        LOG(WARNING) << Substitute("Tablet $0 failed to check row presence for op $1: $2",
-            tablet_id(), op->ToString(key_schema_), s.ToString());
-        return;
-      }
-      if (present) {
-        op->present_in_rowset = rs;
+    // Check all of the group's keys at once, so that the rowset can share
+    // index seeks and block reads between neighbouring keys.
+    unique_ptr<bool[]> present(new bool[group_ops.size()]);
+    s = rs->CheckRowsPresent(group_probes.data(), group_probes.size(), io_context,
+                             present.get(), group_stats.data());
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG(WARNING) << Substitute("Tablet $0 failed to check row presence for $1 ops in $2: $3",
+          tablet_id(), group_ops.size(), rs->ToString(), s.ToString());
+      return;
+    }
+    for (int i = 0; i < group_ops.size(); i++) {
+      if (present[i]) {
+        group_ops[i]->present_in_rowset = rs;
       }
     }
     pending_group.clear();
@@ -992,12 +1044,16 @@ Status Tablet::ApplyRowOperations(WriteOpState* op_state) {
   RETURN_NOT_OK(BulkCheckPresence(&io_context, op_state));
 
   // Actually apply the ops.
-  for (int op_idx = 0; op_idx < num_ops; op_idx++) {
-    RowOp* row_op = op_state->row_ops()[op_idx];
-    if (row_op->has_result()) continue;
-    RETURN_NOT_OK(ApplyRowOperation(&io_context, op_state, row_op,
-                                    op_state->mutable_op_stats(op_idx)));
-    DCHECK(row_op->has_result());
+  if (op_state->request()->bulk_load()) {
+    RETURN_NOT_OK(ApplyBulkLoad(&io_context, op_state));
+  } else {
+    for (int op_idx = 0; op_idx < num_ops; op_idx++) {
+      RowOp* row_op = op_state->row_ops()[op_idx];
+      if (row_op->has_result()) continue;
+      RETURN_NOT_OK(ApplyRowOperation(&io_context, op_state, row_op,
+                                      op_state->mutable_op_stats(op_idx)));
+      DCHECK(row_op->has_result());
+    }
   }
 
   {
@@ -1071,6 +1127,158 @@ Status Tablet::ApplyRowOperation(const IOContext* io_context,
   return Status::OK();
 }
 
+Status Tablet::ApplyBulkLoad(const IOContext* io_context, WriteOpState* op_state) {
+  TRACE_EVENT1("tablet", "Tablet::ApplyBulkLoad",
+               "num_ops", op_state->row_ops().size());
+  {
+    State s;
+    RETURN_NOT_OK_PREPEND(CheckHasNotBeenStopped(&s),
+        Substitute("Apply of $0 exited early", op_state->ToString()));
+    CHECK(s == kOpen || s == kBootstrapping);
+  }
+  DCHECK_EQ(op_state->schema_at_decode_time(), schema());
+  const TabletComponents* comps = DCHECK_NOTNULL(op_state->tablet_components());
+
+  // Sort the rows by key, keeping the index of each op for its stats. As in
+  // BulkCheckPresence(), the sort is stable so that the first op for a key
+  // is the one which gets inserted.
+  const int num_ops = op_state->row_ops().size();
+  vector<pair<RowOp*, int>> ops_and_indexes;
+  ops_and_indexes.reserve(num_ops);
+  for (int op_idx = 0; op_idx < num_ops; op_idx++) {
+    RowOp* row_op = op_state->row_ops()[op_idx];
+    if (row_op->has_result() || !ValidateOpOrMarkFailed(row_op)) continue;
+    DCHECK(row_op->decoded_op.type == RowOperationsPB::INSERT ||
+           row_op->decoded_op.type == RowOperationsPB::INSERT_IGNORE)
+        << RowOperationsPB::Type_Name(row_op->decoded_op.type);
+    ops_and_indexes.emplace_back(row_op, op_idx);
+  }
+  std::stable_sort(ops_and_indexes.begin(), ops_and_indexes.end(),
+                   [](const pair<RowOp*, int>& a, const pair<RowOp*, int>& b) {
+                     return a.first->key_probe->encoded_key_slice().compare(
+                         b.first->key_probe->encoded_key_slice()) < 0;
+                   });
+
+  // Fail the ops whose keys are already present, either in the tablet or
+  // earlier in the batch.
+  vector<RowOp*> to_write;
+  to_write.reserve(ops_and_indexes.size());
+  for (const auto& op_and_index : ops_and_indexes) {
+    RowOp* row_op = op_and_index.first;
+    bool present = !to_write.empty() &&
+        to_write.back()->key_probe->encoded_key_slice() ==
+        row_op->key_probe->encoded_key_slice();
+    // An op replayed from the log succeeded originally, so its key wasn't
+    // present then and isn't now.
+    if (!present && !row_op->orig_result_from_log) {
+      DCHECK(row_op->checked_present);
+      present = row_op->present_in_rowset != nullptr;
+      if (!present) {
+        RETURN_NOT_OK_PREPEND(comps->memrowset->CheckRowPresent(
+            *row_op->key_probe, io_context, &present,
+            op_state->mutable_op_stats(op_and_index.second)),
+            "Failed to check if row is present");
+      }
+    }
+    if (present) {
+      if (row_op->decoded_op.type == RowOperationsPB::INSERT_IGNORE) {
+        row_op->SetErrorIgnored();
+      } else {
+        if (metrics_) {
+          metrics_->insertions_failed_dup_key->Increment();
+        }
+        row_op->SetFailed(Status::AlreadyPresent("key already present"));
+      }
+      continue;
+    }
+    to_write.push_back(row_op);
+  }
+  if (to_write.empty()) {
+    return Status::OK();
+  }
+
+  // Write the rows out. Like a flushed MemRowSet insert, each row gets an
+  // UNDO which deletes it, so that snapshots before this op don't see it.
+  RollingDiskRowSetWriter drsw(metadata_.get(), *schema(), DefaultBloomSizing(),
+                               compaction_policy()->target_rowset_size(),
+                               rowset_encoding_pool_);
+  RETURN_NOT_OK_PREPEND(drsw.Open(), "Failed to open DiskRowSet for bulk load");
+
+  faststring undo_buf;
+  RowChangeListEncoder undo_encoder(&undo_buf);
+  undo_encoder.SetToDelete();
+  const Timestamp ts = op_state->timestamp();
+
+  static constexpr int kBulkLoadBlockNumRows = 100;
+  RowBlock block(schema(), kBulkLoadBlockNumRows, nullptr);
+  Arena undo_arena(1024);
+  int n = 0;
+  for (RowOp* row_op : to_write) {
+    RETURN_NOT_OK(drsw.RollIfNecessary());
+    ConstContiguousRow src_row(schema(), row_op->decoded_op.row_data);
+    RowBlockRow dst_row = block.row(n);
+    RETURN_NOT_OK(CopyRow(src_row, &dst_row, static_cast<Arena*>(nullptr)));
+
+    Mutation* undo = Mutation::CreateInArena(&undo_arena, ts, undo_encoder.as_changelist());
+    rowid_t index_in_current_drs;
+    RETURN_NOT_OK(drsw.AppendUndoDeltas(n, undo, &index_in_current_drs));
+
+    n++;
+    if (n == block.nrows()) {
+      RETURN_NOT_OK(drsw.AppendBlock(block, n));
+      undo_arena.Reset();
+      n = 0;
+    }
+  }
+  if (n > 0) {
+    block.Resize(n);
+    RETURN_NOT_OK(drsw.AppendBlock(block, n));
+  }
+  RETURN_NOT_OK_PREPEND(drsw.Finish(), "Failed to finish DRS writer");
+
+  RowSetMetadataVector new_drs_metas;
+  drsw.GetWrittenRowSetMetadata(&new_drs_metas);
+  RowSetVector new_disk_rowsets;
+  for (const shared_ptr<RowSetMetadata>& meta : new_drs_metas) {
+    shared_ptr<DiskRowSet> new_rowset;
+    RETURN_NOT_OK_PREPEND(DiskRowSet::Open(meta,
+                                           log_anchor_registry_.get(),
+                                           mem_trackers_,
+                                           io_context,
+                                           &new_rowset),
+                          Substitute("Unable to open bulk loaded rowset $0",
+                                     meta->ToString()));
+    new_disk_rowsets.emplace_back(std::move(new_rowset));
+  }
+
+  // Make the new rowsets durable before they become visible, so that any
+  // mutation of their rows is made after the bulk load is durable.
+  int64_t bulk_load_id;
+  {
+    std::lock_guard<std::mutex> l(bulk_load_lock_);
+    bulk_load_id = next_bulk_load_id_++;
+    RETURN_NOT_OK_PREPEND(metadata_->AddBulkLoadedRowSetsAndFlush(new_drs_metas, bulk_load_id),
+                          "Failed to flush new tablet metadata");
+  }
+  AtomicSwapRowSets(RowSetVector(), new_disk_rowsets);
+  UpdateAverageRowsetHeight();
+
+  for (RowOp* row_op : to_write) {
+    row_op->SetBulkLoadSucceeded(bulk_load_id);
+  }
+  if (metrics_) {
+    metrics_->bytes_flushed->IncrementBy(drsw.written_size());
+  }
+  TRACE_COUNTER_INCREMENT("rows_written", drsw.rows_written_count());
+  TRACE_COUNTER_INCREMENT("drs_written", drsw.drs_written_count());
+  VLOG_WITH_PREFIX(1) << Substitute("Bulk load $0 wrote $1 rows ($2 rowsets, $3 bytes)",
+                                    bulk_load_id,
+                                    drsw.rows_written_count(),
+                                    drsw.drs_written_count(),
+                                    drsw.written_size());
+  return Status::OK();
+}
+
 void Tablet::ModifyRowSetTree(const RowSetTree& old_tree,
                               const RowSetVector& rowsets_to_remove,
                               const RowSetVector& rowsets_to_add,
@@ -1128,7 +1336,8 @@ Status Tablet::DoMajorDeltaCompaction(const vector<ColumnId>& col_ids,
                                       const IOContext* io_context) {
   RETURN_IF_STOPPED_OR_CHECK_STATE(kOpen);
   Status s = down_cast<DiskRowSet*>(input_rs.get())
-      ->MajorCompactDeltaStoresWithColumnIds(col_ids, io_context, GetHistoryGcOpts());
+      ->MajorCompactDeltaStoresWithColumnIds(col_ids, io_context, GetHistoryGcOpts(),
+                                             rowset_encoding_pool_);
   return s;
 }
 
@@ -1415,10 +1624,10 @@ Status Tablet::PickRowSetsToCompact(RowSetsInCompaction *picked,
   } else {
     // Let the policy decide which rowsets to compact.
     double quality = 0.0;
-    RETURN_NOT_OK(compaction_policy_->PickRowSets(*rowsets_copy,
-                                                  &picked_set,
-                                                  &quality,
-                                                  /*log=*/nullptr));
+    RETURN_NOT_OK(compaction_policy()->PickRowSets(*rowsets_copy,
+                                                   &picked_set,
+                                                   &quality,
+                                                   /*log=*/nullptr));
     VLOG_WITH_PREFIX(2) << "Compaction quality: " << quality;
   }
 
@@ -1599,7 +1808,8 @@ Status Tablet::DoMergeCompactionOrFlush(const RowSetsInCompaction &input,
   RETURN_NOT_OK(input.CreateCompactionInput(flush_snap, schema(), &io_context, &merge));
 
   RollingDiskRowSetWriter drsw(metadata_.get(), merge->schema(), DefaultBloomSizing(),
-                               compaction_policy_->target_rowset_size());
+                               compaction_policy()->target_rowset_size(),
+                               rowset_encoding_pool_);
   RETURN_NOT_OK_PREPEND(drsw.Open(), "Failed to open DiskRowSet for flush");
 
   HistoryGcOpts history_gc_opts = GetHistoryGcOpts();
@@ -1841,6 +2051,12 @@ Status Tablet::Compact(CompactFlags flags) {
   // Step 1. Capture the rowsets to be merged
   RETURN_NOT_OK_PREPEND(PickRowSetsToCompact(&input, flags),
                         "Failed to pick rowsets to compact");
+  return CompactPickedRowSets(input);
+}
+
+Status Tablet::CompactPickedRowSets(const RowSetsInCompaction& input) {
+  RETURN_IF_STOPPED_OR_CHECK_STATE(kOpen);
+
   const auto num_input_rowsets = input.num_rowsets();
   TRACE_COUNTER_INCREMENT("num_input_rowsets", num_input_rowsets);
   VLOG_WITH_PREFIX(1) << Substitute("Compaction: stage 1 complete, picked $0 "
@@ -1858,6 +2074,15 @@ Status Tablet::Compact(CompactFlags flags) {
   return DoMergeCompactionOrFlush(input, TabletMetadata::kNoMrsFlushed);
 }
 
+CompactionPolicy* Tablet::compaction_policy() const {
+  const auto extra_config = metadata_->extra_config();
+  if (extra_config &&
+      extra_config->compaction_policy() == kTimeWindowCompactionPolicy) {
+    return time_window_compaction_policy_.get();
+  }
+  return compaction_policy_.get();
+}
+
 void Tablet::UpdateCompactionStats(MaintenanceOpStats* stats) {
 
   if (mvcc_.GetCleanTimestamp() == Timestamp::kInitialTimestamp) {
@@ -1868,7 +2093,7 @@ void Tablet::UpdateCompactionStats(MaintenanceOpStats* stats) {
   }
 
   double quality = 0;
-  unordered_set<const RowSet*> picked_set_ignored;
+  unordered_set<const RowSet*> picked_set;
 
   shared_ptr<RowSetTree> rowsets_copy;
   {
@@ -1878,14 +2103,22 @@ void Tablet::UpdateCompactionStats(MaintenanceOpStats* stats) {
 
   {
     std::lock_guard<std::mutex> compact_lock(compact_select_lock_);
-    WARN_NOT_OK(compaction_policy_->PickRowSets(*rowsets_copy, &picked_set_ignored, &quality, NULL),
+    WARN_NOT_OK(compaction_policy()->PickRowSets(*rowsets_copy, &picked_set,
+                                                 &quality, NULL),
                 Substitute("Couldn't determine compaction quality for $0", tablet_id()));
   }
 
   VLOG_WITH_PREFIX(1) << "Best compaction for " << tablet_id() << ": " << quality;
 
+  // A compaction reads its inputs and writes about as much back out.
+  int64_t io_bytes = 0;
+  for (const RowSet* rs : picked_set) {
+    io_bytes += 2 * rs->OnDiskSize();
+  }
+
   stats->set_runnable(quality >= 0);
   stats->set_perf_improvement(quality);
+  stats->set_io_bytes(io_bytes);
 }
 
 
@@ -2313,7 +2546,7 @@ double Tablet::GetPerfImprovementForBestDeltaCompactUnlocked(RowSet::DeltaCompac
   return worst_delta_perf;
 }
 
-Status Tablet::EstimateBytesInPotentiallyAncientUndoDeltas(int64_t* bytes) {
+Status Tablet::EstimateBytesInPotentiallyAncientUndoDeltas(int64_t* bytes, int64_t* blocks) {
   DCHECK(bytes);
 
   Timestamp ancient_history_mark;
@@ -2327,15 +2560,20 @@ Status Tablet::EstimateBytesInPotentiallyAncientUndoDeltas(int64_t* bytes) {
   GetComponents(&comps);
 
   int64_t tablet_bytes = 0;
+  int64_t tablet_blocks = 0;
   for (const auto& rowset : comps->rowsets->all_rowsets()) {
     int64_t rowset_bytes;
+    int64_t rowset_blocks;
     RETURN_NOT_OK(rowset->EstimateBytesInPotentiallyAncientUndoDeltas(ancient_history_mark,
-                                                                      &rowset_bytes));
+                                                                      &rowset_bytes,
+                                                                      &rowset_blocks));
     tablet_bytes += rowset_bytes;
+    tablet_blocks += rowset_blocks;
   }
 
   metrics_->undo_delta_block_estimated_retained_bytes->set_value(tablet_bytes);
   *bytes = tablet_bytes;
+  if (blocks) *blocks = tablet_blocks;
   return Status::OK();
 }
 
@@ -2362,8 +2600,9 @@ Status Tablet::InitAncientUndoDeltas(MonoDelta time_budget, int64_t* bytes_in_an
   for (size_t i = 0; i < rowsets.size(); i++) {
     const auto& rowset = rowsets[i];
     int64_t bytes;
+    int64_t blocks;
     RETURN_NOT_OK(rowset->EstimateBytesInPotentiallyAncientUndoDeltas(ancient_history_mark,
-                                                                      &bytes));
+                                                                      &bytes, &blocks));
     rowset_ancient_undos_est_sizes.emplace_back(i, bytes);
   }
 
@@ -2401,18 +2640,21 @@ Status Tablet::InitAncientUndoDeltas(MonoDelta time_budget, int64_t* bytes_in_an
   return Status::OK();
 }
 
-Status Tablet::GetBytesInAncientDeletedRowsets(int64_t* bytes_in_ancient_deleted_rowsets) {
+Status Tablet::GetBytesInAncientDeletedRowsets(int64_t* bytes_in_ancient_deleted_rowsets,
+                                               int64_t* blocks_in_ancient_deleted_rowsets) {
   Timestamp ancient_history_mark;
   if (!Tablet::GetTabletAncientHistoryMark(&ancient_history_mark)) {
     VLOG_WITH_PREFIX(1) << "Cannot get ancient history mark. "
                            "The clock is likely not a hybrid clock";
     *bytes_in_ancient_deleted_rowsets = 0;
+    if (blocks_in_ancient_deleted_rowsets) *blocks_in_ancient_deleted_rowsets = 0;
     return Status::OK();
   }
 
   scoped_refptr<TabletComponents> comps;
   GetComponents(&comps);
   int64_t bytes = 0;
+  int64_t blocks = 0;
   {
     std::lock_guard<std::mutex> csl(compact_select_lock_);
     for (const auto& rowset : comps->rowsets->all_rowsets()) {
@@ -2423,11 +2665,15 @@ Status Tablet::GetBytesInAncientDeletedRowsets(int64_t* bytes_in_ancient_deleted
       RETURN_NOT_OK(rowset->IsDeletedAndFullyAncient(ancient_history_mark, &deleted_and_ancient));
       if (deleted_and_ancient) {
         bytes += rowset->OnDiskSize();
+        if (blocks_in_ancient_deleted_rowsets) {
+          blocks += rowset->metadata()->GetAllBlocks().size();
+        }
       }
     }
   }
   metrics_->deleted_rowset_estimated_retained_bytes->set_value(bytes);
   *bytes_in_ancient_deleted_rowsets = bytes;
+  if (blocks_in_ancient_deleted_rowsets) *blocks_in_ancient_deleted_rowsets = blocks;
   return Status::OK();
 }
 
@@ -2583,7 +2829,7 @@ void Tablet::PrintRSLayout(ostream* o) {
   vector<string> log;
   unordered_set<const RowSet*> picked;
   double quality;
-  Status s = compaction_policy_->PickRowSets(*rowsets_copy, &picked, &quality, &log);
+  Status s = compaction_policy()->PickRowSets(*rowsets_copy, &picked, &quality, &log);
   if (!s.ok()) {
     out << "<b>Error:</b> " << EscapeForHtmlToString(s.ToString());
     return;
@@ -2718,7 +2964,12 @@ Status Tablet::Iterator::Init(ScanSpec *spec) {
       break;
     case UNORDERED:
     default:
-      iter_ = NewUnionIterator(std::move(iters));
+      if (opts_.scan_pool && opts_.scan_parallelism > 1 && iters.size() > 1) {
+        iter_ = NewParallelUnionIterator(std::move(iters), opts_.scan_pool,
+                                         opts_.scan_parallelism);
+      } else {
+        iter_ = NewUnionIterator(std::move(iters));
+      }
       break;
   }
 
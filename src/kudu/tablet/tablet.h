@@ -60,6 +60,7 @@ class KeyRange;
 class MemTracker;
 class RowBlock;
 class ScanSpec;
+class ThreadPool;
 class Throttler;
 class Timestamp;
 struct IterWithBounds;
@@ -101,11 +102,15 @@ class Tablet {
   //
   // If 'metric_registry' is non-NULL, then this tablet will create a 'tablet' entity
   // within the provided registry. Otherwise, no metrics are collected.
+  //
+  // If 'rowset_encoding_pool' is non-NULL, flushes and compactions encode the
+  // columns of the rowsets they write on its threads.
   Tablet(scoped_refptr<TabletMetadata> metadata,
          clock::Clock* clock,
          std::shared_ptr<MemTracker> parent_mem_tracker,
          MetricRegistry* metric_registry,
-         scoped_refptr<log::LogAnchorRegistry> log_anchor_registry);
+         scoped_refptr<log::LogAnchorRegistry> log_anchor_registry,
+         ThreadPool* rowset_encoding_pool);
 
   ~Tablet();
 
@@ -159,6 +164,9 @@ class Tablet {
   void StartApplying(WriteOpState* op_state);
 
   // Apply all of the row operations associated with this op.
+  //
+  // If the op is a bulk load, its rows are written straight into new
+  // DiskRowSets instead of the MemRowSet. See ApplyBulkLoad().
   Status ApplyRowOperations(WriteOpState* op_state) WARN_UNUSED_RESULT;
 
   // Apply a single row operation, which must already be prepared.
@@ -236,6 +244,16 @@ class Tablet {
 
   Status Compact(CompactFlags flags);
 
+  // Picks the rowsets to compact according to 'flags' and takes their
+  // compact_flush_locks, which are held until 'picked' is destroyed. Since
+  // a locked rowset is never available for compaction, inputs picked while
+  // other compactions are running are disjoint from theirs.
+  Status PickRowSetsToCompact(RowSetsInCompaction *picked,
+                              CompactFlags flags) const;
+
+  // Compacts rowsets previously picked by PickRowSetsToCompact().
+  Status CompactPickedRowSets(const RowSetsInCompaction& input);
+
   // Update the statistics for performing a compaction.
   void UpdateCompactionStats(MaintenanceOpStats* stats);
 
@@ -302,8 +320,10 @@ class Tablet {
                                                        std::shared_ptr<RowSet>* rs) const;
 
   // Estimate the number of bytes in ancient undo delta stores. This may be an
-  // overestimate.
-  Status EstimateBytesInPotentiallyAncientUndoDeltas(int64_t* bytes);
+  // overestimate. If 'blocks' is not null, the number of those stores is
+  // estimated in it as well.
+  Status EstimateBytesInPotentiallyAncientUndoDeltas(int64_t* bytes,
+                                                     int64_t* blocks = nullptr);
 
   // Initialize undo delta blocks for up to 'time_budget' amount of time.
   // If 'time_budget' is not Initialized() then there is no time limit.
@@ -329,7 +349,11 @@ class Tablet {
   // the newest redo but doesn't initialize it. As such, since we may miss out
   // on counting rowsets we haven't initialized yet, this may be an
   // underestimate.
-  Status GetBytesInAncientDeletedRowsets(int64_t* bytes_in_ancient_deleted_rowsets);
+  //
+  // If 'blocks_in_ancient_deleted_rowsets' is not null, the number of blocks
+  // of those rowsets is returned in it.
+  Status GetBytesInAncientDeletedRowsets(int64_t* bytes_in_ancient_deleted_rowsets,
+                                         int64_t* blocks_in_ancient_deleted_rowsets = nullptr);
 
   // Finds and GCs all fully deleted rowsets that have a maximum op timestamp
   // prior to the current ancient history mark.
@@ -582,6 +606,15 @@ class Tablet {
   Status BulkCheckPresence(const fs::IOContext* io_context,
                            WriteOpState* op_state) WARN_UNUSED_RESULT;
 
+  // Apply the INSERT and INSERT_IGNORE operations of a bulk load op by sorting
+  // their rows by key and writing them into new DiskRowSets, which are then
+  // made durable and swapped into the RowSetTree. Rows whose keys are already
+  // present fail the same way they would in the MemRowSet.
+  //
+  // Requires that BulkCheckPresence() has already run on 'op_state'.
+  Status ApplyBulkLoad(const fs::IOContext* io_context,
+                       WriteOpState* op_state) WARN_UNUSED_RESULT;
+
   // Capture a set of iterators which, together, reflect all of the data in the tablet.
   //
   // These iterators are not true snapshot iterators, but they are safe against
@@ -595,8 +628,8 @@ class Tablet {
                                     const ScanSpec* spec,
                                     std::vector<IterWithBounds>* iters) const;
 
-  Status PickRowSetsToCompact(RowSetsInCompaction *picked,
-                              CompactFlags flags) const;
+  // Returns the compaction policy selected by the table's extra config.
+  CompactionPolicy* compaction_policy() const;
 
   // Performs a merge compaction or a flush.
   Status DoMergeCompactionOrFlush(const RowSetsInCompaction &input,
@@ -730,13 +763,23 @@ class Tablet {
 
   int64_t next_mrs_id_;
 
+  // Lock protecting 'next_bulk_load_id_'. It's held while a bulk load's
+  // rowsets are made durable so that bulk loads become durable in the order
+  // of their ids.
+  std::mutex bulk_load_lock_;
+  int64_t next_bulk_load_id_;
+
   // A pointer to the server's clock.
   clock::Clock* clock_;
 
+  // The server's pool for encoding rowset columns, or null.
+  ThreadPool* const rowset_encoding_pool_;
+
   MvccManager mvcc_;
   LockManager lock_manager_;
 
   std::unique_ptr<CompactionPolicy> compaction_policy_;
+  std::unique_ptr<CompactionPolicy> time_window_compaction_policy_;
 
   // Lock protecting the selection of rowsets for compaction.
   // Only one thread may run the compaction selection algorithm at a time
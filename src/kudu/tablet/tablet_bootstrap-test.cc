@@ -26,6 +26,7 @@
 #include <vector>
 
 #include <boost/optional/optional.hpp>
+#include <gflags/gflags_declare.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -75,6 +76,8 @@
 #include "kudu/util/status.h"
 #include "kudu/util/test_macros.h"
 
+DECLARE_int32(tablet_bootstrap_log_readahead_mb);
+
 using kudu::consensus::ConsensusBootstrapInfo;
 using kudu::consensus::ConsensusMetadata;
 using kudu::consensus::ConsensusMetadataManager;
@@ -170,6 +173,8 @@ class BootstrapTest : public LogTestBase {
         /*result_tracker*/nullptr,
         metric_registry_.get(),
         file_cache_.get(),
+        /*log_append_pool*/nullptr,
+        /*rowset_encoding_pool*/nullptr,
         /*tablet_replica*/nullptr,
         std::move(log_anchor_registry),
         tablet,
@@ -238,6 +243,39 @@ TEST_F(BootstrapTest, TestBootstrap) {
   ASSERT_EQ(1, results.size());
 }
 
+// Tests that a log spanning several segments is replayed the same with and
+// without reading entries ahead of replay on a separate thread.
+TEST_F(BootstrapTest, TestBootstrapWithLogReadahead) {
+  const int kNumSegments = 5;
+  const int kOpsPerSegment = 20;
+  ASSERT_OK(BuildLog());
+  for (int i = 0; i < kNumSegments; i++) {
+    ASSERT_OK(AppendReplicateBatchAndCommitEntryPairsToLog(kOpsPerSegment));
+    ASSERT_OK(RollLog());
+  }
+  OpId last_opid = MakeOpId(1, current_index_ - 1);
+
+  scoped_refptr<TabletMetadata> meta;
+  ASSERT_OK(LoadTestTabletMetadata(-1, -1, &meta));
+  ASSERT_OK(CreateConsensusMetadata(meta));
+
+  // Bootstrapping rewrites the log, so the second run replays the log written
+  // by the first one.
+  for (int readahead_mb : { 0, 1 }) {
+    SCOPED_TRACE(readahead_mb);
+    FLAGS_tablet_bootstrap_log_readahead_mb = readahead_mb;
+    shared_ptr<Tablet> tablet;
+    ConsensusBootstrapInfo boot_info;
+    ASSERT_OK(RunBootstrapOnTestTablet(meta, &tablet, &boot_info));
+    ASSERT_OPID_EQ(last_opid, boot_info.last_id);
+    ASSERT_OPID_EQ(last_opid, boot_info.last_committed_id);
+
+    vector<string> results;
+    IterateTabletRows(tablet.get(), &results);
+    ASSERT_EQ(kNumSegments * kOpsPerSegment, results.size());
+  }
+}
+
 // Test that we don't overflow opids. Regression test for KUDU-1933.
 TEST_F(BootstrapTest, TestBootstrapHighOpIdIndex) {
   // Start appending with a log index 3 under the int32 max value.
@@ -17,6 +17,9 @@
 
 #include "kudu/tablet/tablet_bootstrap.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iterator>
@@ -78,6 +81,7 @@
 #include "kudu/tablet/tablet_replica.h"
 #include "kudu/tserver/tserver.pb.h"
 #include "kudu/tserver/tserver_admin.pb.h"
+#include "kudu/util/blocking_queue.h"
 #include "kudu/util/debug/trace_event.h"
 #include "kudu/util/env.h"
 #include "kudu/util/env_util.h"
@@ -90,6 +94,7 @@
 #include "kudu/util/pb_util.h"
 #include "kudu/util/scoped_cleanup.h"
 #include "kudu/util/stopwatch.h"
+#include "kudu/util/thread.h"
 
 DECLARE_int32(group_commit_queue_size_bytes);
 
@@ -99,6 +104,13 @@ DEFINE_double(fault_crash_during_log_replay, 0.0,
               "(For testing only!)");
 TAG_FLAG(fault_crash_during_log_replay, unsafe);
 
+DEFINE_int32(tablet_bootstrap_log_readahead_mb, 16,
+             "Maximum amount of decoded WAL entries that tablet bootstrap reads "
+             "ahead of replay on a separate thread, so that reading and decoding "
+             "log segments overlaps with applying their entries. If 0, entries are "
+             "read on the replay thread.");
+TAG_FLAG(tablet_bootstrap_log_readahead_mb, advanced);
+
 DECLARE_int32(max_clock_sync_error_usec);
 
 using kudu::clock::Clock;
@@ -124,12 +136,14 @@ using kudu::log::LogIndex;
 using kudu::log::LogOptions;
 using kudu::log::LogReader;
 using kudu::log::ReadableLogSegment;
+using kudu::log::SegmentSequence;
 using kudu::pb_util::SecureDebugString;
 using kudu::pb_util::SecureShortDebugString;
 using kudu::rpc::ResultTracker;
 using kudu::tserver::AlterSchemaRequestPB;
 using kudu::tserver::WriteRequestPB;
 using kudu::tserver::WriteResponsePB;
+using std::atomic;
 using std::map;
 using std::shared_ptr;
 using std::string;
@@ -167,15 +181,93 @@ class FlushedStoresSnapshot {
   // (b) the store was in the process of being written by a flush or compaction
   //     but the process crashed before the associated tablet metadata update
   //     was committed.
+  //
+  // The rows of a bulk load are active until the bulk load is made durable.
   bool IsMemStoreActive(const MemStoreTargetPB& target) const;
 
  private:
   int64_t last_durable_mrs_id_;
+  int64_t last_durable_bulk_load_id_;
   unordered_map<int64_t, int64_t> flushed_dms_by_drs_id_;
 
   DISALLOW_COPY_AND_ASSIGN(FlushedStoresSnapshot);
 };
 
+// An entry read from the WAL by LogReadahead.
+struct ReadaheadEntry {
+  // Index of the segment the entry was read from.
+  int segment_idx = 0;
+
+  // OK if 'entry' was read, EndOfFile at the end of the segment, or the error
+  // hit while reading it.
+  Status status;
+  unique_ptr<LogEntryPB> entry;
+
+  // Position of the segment reader after reading the entry.
+  int64_t offset = 0;
+  int64_t read_up_to_offset = 0;
+
+  // Memory used by 'entry', accounted against the read-ahead limit.
+  size_t size = 0;
+};
+
+struct ReadaheadEntrySize {
+  static size_t logical_size(const ReadaheadEntry& e) {
+    return e.size;
+  }
+};
+
+// Reads the entries of a sequence of log segments in order. If given a
+// non-zero buffer size, entries are read and decoded on a separate thread,
+// up to that many bytes ahead of the consumer; otherwise they're read on
+// demand by the consumer.
+class LogReadahead {
+ public:
+  LogReadahead(SegmentSequence segments, size_t max_buffered_bytes);
+  ~LogReadahead();
+
+  // Starts the read-ahead thread, if any.
+  Status Start();
+
+  // Returns the next entry of the segment sequence. Once the end of a segment
+  // is reported, the following calls read from the next segment. Nothing may
+  // be read after an error or after the end of the last segment.
+  void ReadNextEntry(ReadaheadEntry* e);
+
+  // Total time spent reading and decoding entries.
+  MonoDelta read_time() const {
+    return MonoDelta::FromMicroseconds(read_time_us_);
+  }
+
+  // Total time the consumer spent waiting for entries to be read.
+  MonoDelta wait_time() const {
+    return wait_time_;
+  }
+
+ private:
+  // Reads the next entry from 'segments_', advancing to the next segment at
+  // the end of the current one.
+  void ReadEntry(ReadaheadEntry* e);
+
+  void ReadaheadThread();
+
+  const SegmentSequence segments_;
+  const size_t max_buffered_bytes_;
+
+  // Reader of the current segment, and its index. Only accessed by the
+  // read-ahead thread, if any.
+  int cur_segment_idx_;
+  unique_ptr<log::LogEntryReader> reader_;
+
+  BlockingQueue<ReadaheadEntry, ReadaheadEntrySize> queue_;
+  scoped_refptr<Thread> thread_;
+
+  atomic<int64_t> read_time_us_;
+  MonoDelta wait_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(LogReadahead);
+};
+
 // Bootstraps an existing tablet by opening the metadata from disk, and rebuilding soft
 // state by playing log segments. A bootstrapped tablet can then be added to an existing
 // consensus configuration as a LEARNER, which will bring its state up to date with the
@@ -198,6 +290,8 @@ class TabletBootstrap {
                   scoped_refptr<ResultTracker> result_tracker,
                   MetricRegistry* metric_registry,
                   FileCache* file_cache,
+                  ThreadPool* log_append_pool,
+                  ThreadPool* rowset_encoding_pool,
                   scoped_refptr<TabletReplica> tablet_replica,
                   scoped_refptr<LogAnchorRegistry> log_anchor_registry);
 
@@ -379,6 +473,8 @@ class TabletBootstrap {
   scoped_refptr<rpc::ResultTracker> result_tracker_;
   MetricRegistry* metric_registry_;
   FileCache* file_cache_;
+  ThreadPool* log_append_pool_;
+  ThreadPool* rowset_encoding_pool_;
   scoped_refptr<TabletReplica> tablet_replica_;
   unique_ptr<tablet::Tablet> tablet_;
   const scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
@@ -396,18 +492,25 @@ class TabletBootstrap {
         inserts_ignored(0),
         mutations_seen(0),
         mutations_ignored(0),
-        orphaned_commits(0) {
+        orphaned_commits(0),
+        read_time(MonoDelta::FromSeconds(0)),
+        read_wait_time(MonoDelta::FromSeconds(0)),
+        replay_time(MonoDelta::FromSeconds(0)) {
     }
 
     string ToString() const {
       return Substitute("ops{read=$0 overwritten=$1 applied=$2 ignored=$3} "
                         "inserts{seen=$4 ignored=$5} "
                         "mutations{seen=$6 ignored=$7} "
-                        "orphaned_commits=$8",
+                        "orphaned_commits=$8 "
+                        "time{$9}",
                         ops_read, ops_overwritten, ops_committed, ops_ignored,
                         inserts_seen, inserts_ignored,
                         mutations_seen, mutations_ignored,
-                        orphaned_commits);
+                        orphaned_commits,
+                        Substitute("read=$0 read_wait=$1 replay=$2",
+                                   read_time.ToString(), read_wait_time.ToString(),
+                                   replay_time.ToString()));
     }
 
     // Number of REPLICATE messages read from the log
@@ -428,6 +531,14 @@ class TabletBootstrap {
 
     // Number of COMMIT messages for which a corresponding REPLICATE was not found.
     int orphaned_commits;
+
+    // Time spent reading and decoding log entries. With read-ahead enabled,
+    // this overlaps with replay, and only 'read_wait_time' of it delays replay.
+    MonoDelta read_time;
+    // Time the replay thread spent waiting for log entries to be read.
+    MonoDelta read_wait_time;
+    // Time spent replaying log entries, including MVCC and commit bookkeeping.
+    MonoDelta replay_time;
   };
   Stats stats_;
 
@@ -449,6 +560,8 @@ Status BootstrapTablet(scoped_refptr<TabletMetadata> tablet_meta,
                        scoped_refptr<ResultTracker> result_tracker,
                        MetricRegistry* metric_registry,
                        FileCache* file_cache,
+                       ThreadPool* log_append_pool,
+                       ThreadPool* rowset_encoding_pool,
                        scoped_refptr<TabletReplica> tablet_replica,
                        scoped_refptr<log::LogAnchorRegistry> log_anchor_registry,
                        shared_ptr<tablet::Tablet>* rebuilt_tablet,
@@ -463,6 +576,8 @@ Status BootstrapTablet(scoped_refptr<TabletMetadata> tablet_meta,
                             std::move(result_tracker),
                             metric_registry,
                             file_cache,
+                            log_append_pool,
+                            rowset_encoding_pool,
                             std::move(tablet_replica),
                             std::move(log_anchor_registry));
   RETURN_NOT_OK(bootstrap.Bootstrap(rebuilt_tablet, rebuilt_log, consensus_info));
@@ -500,6 +615,8 @@ TabletBootstrap::TabletBootstrap(
     scoped_refptr<ResultTracker> result_tracker,
     MetricRegistry* metric_registry,
     FileCache* file_cache,
+    ThreadPool* log_append_pool,
+    ThreadPool* rowset_encoding_pool,
     scoped_refptr<TabletReplica> tablet_replica,
     scoped_refptr<LogAnchorRegistry> log_anchor_registry)
     : tablet_meta_(std::move(tablet_meta)),
@@ -509,6 +626,8 @@ TabletBootstrap::TabletBootstrap(
       result_tracker_(std::move(result_tracker)),
       metric_registry_(metric_registry),
       file_cache_(file_cache),
+      log_append_pool_(log_append_pool),
+      rowset_encoding_pool_(rowset_encoding_pool),
       tablet_replica_(std::move(tablet_replica)),
       log_anchor_registry_(std::move(log_anchor_registry)) {}
 
@@ -637,7 +756,8 @@ Status TabletBootstrap::OpenTablet(bool* has_blocks) {
                                        clock_,
                                        mem_tracker_,
                                        metric_registry_,
-                                       log_anchor_registry_));
+                                       log_anchor_registry_,
+                                       rowset_encoding_pool_));
   // doing nothing for now except opening a tablet locally.
   {
     SCOPED_LOG_SLOW_EXECUTION_PREFIX(INFO, 100, LogPrefix(), "opening tablet");
@@ -734,7 +854,9 @@ Status TabletBootstrap::OpenLogReaderInRecoveryDir() {
 }
 
 Status TabletBootstrap::OpenNewLog() {
-  RETURN_NOT_OK(Log::Open(LogOptions(),
+  LogOptions options;
+  options.append_pool = log_append_pool_;
+  RETURN_NOT_OK(Log::Open(std::move(options),
                           tablet_->metadata()->fs_manager(),
                           file_cache_,
                           tablet_->tablet_id(),
@@ -1156,6 +1278,73 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
   }
 }
 
+LogReadahead::LogReadahead(SegmentSequence segments, size_t max_buffered_bytes)
+    : segments_(std::move(segments)),
+      max_buffered_bytes_(max_buffered_bytes),
+      cur_segment_idx_(0),
+      queue_(std::max<size_t>(max_buffered_bytes, 1)),
+      read_time_us_(0),
+      wait_time_(MonoDelta::FromSeconds(0)) {
+}
+
+LogReadahead::~LogReadahead() {
+  queue_.Shutdown();
+  if (thread_) {
+    thread_->Join();
+  }
+}
+
+Status LogReadahead::Start() {
+  if (max_buffered_bytes_ == 0 || segments_.empty()) {
+    return Status::OK();
+  }
+  return Thread::Create("tablet-bootstrap", "log-readahead",
+                        [this]() { this->ReadaheadThread(); }, &thread_);
+}
+
+void LogReadahead::ReadNextEntry(ReadaheadEntry* e) {
+  if (!thread_) {
+    ReadEntry(e);
+    return;
+  }
+  MonoTime start = MonoTime::Now();
+  // The queue is only shut down on destruction, and the consumer never reads
+  // past the last entry the thread puts.
+  CHECK_OK(queue_.BlockingGet(e));
+  wait_time_ += MonoTime::Now() - start;
+}
+
+void LogReadahead::ReadEntry(ReadaheadEntry* e) {
+  DCHECK_LT(cur_segment_idx_, static_cast<int>(segments_.size()));
+  MonoTime start = MonoTime::Now();
+  if (!reader_) {
+    reader_.reset(new log::LogEntryReader(segments_[cur_segment_idx_].get()));
+  }
+  e->segment_idx = cur_segment_idx_;
+  e->status = reader_->ReadNextEntry(&e->entry);
+  e->offset = reader_->offset();
+  e->read_up_to_offset = reader_->read_up_to_offset();
+  if (e->status.IsEndOfFile()) {
+    reader_.reset();
+    cur_segment_idx_++;
+  }
+  read_time_us_ += (MonoTime::Now() - start).ToMicroseconds();
+}
+
+void LogReadahead::ReadaheadThread() {
+  while (cur_segment_idx_ < static_cast<int>(segments_.size())) {
+    ReadaheadEntry e;
+    ReadEntry(&e);
+    if (e.entry) {
+      e.size = e.entry->SpaceUsedLong();
+    }
+    bool failed = !e.status.ok() && !e.status.IsEndOfFile();
+    if (!queue_.BlockingPut(std::move(e)).ok() || failed) {
+      return;
+    }
+  }
+}
+
 Status TabletBootstrap::PlaySegments(const IOContext* io_context,
                                      ConsensusBootstrapInfo* consensus_info) {
   ReplayState state;
@@ -1181,18 +1370,33 @@ Status TabletBootstrap::PlaySegments(const IOContext* io_context,
   // writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  // Read and decode entries on a separate thread while they're replayed.
+  const size_t readahead_bytes =
+      static_cast<size_t>(FLAGS_tablet_bootstrap_log_readahead_mb) * 1024 * 1024;
+  LogReadahead readahead(segments, readahead_bytes);
+  RETURN_NOT_OK_PREPEND(readahead.Start(), "Failed to start log read-ahead");
+  const auto update_read_stats = [&]() {
+    stats_.read_time = readahead.read_time();
+    stats_.read_wait_time = readahead.wait_time();
+  };
+
   auto last_status_update = MonoTime::Now();
   const auto kStatusUpdateInterval = MonoDelta::FromSeconds(5);
   int segment_count = 0;
 
   for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    log::LogEntryReader reader(segment.get());
+    int64_t offset = 0;
+    int64_t read_up_to_offset = 0;
 
     int entry_count = 0;
     while (true) {
       {
-        unique_ptr<LogEntryPB> entry;
-        Status s = reader.ReadNextEntry(&entry);
+        ReadaheadEntry read;
+        readahead.ReadNextEntry(&read);
+        DCHECK_EQ(segment_count, read.segment_idx);
+        offset = read.offset;
+        read_up_to_offset = read.read_up_to_offset;
+        const Status& s = read.status;
         if (PREDICT_FALSE(!s.ok())) {
           if (s.IsEndOfFile()) {
             break;
@@ -1209,28 +1413,33 @@ Status TabletBootstrap::PlaySegments(const IOContext* io_context,
         entry_count++;
 
         string entry_debug_info;
-        s = HandleEntry(io_context, &state, std::move(entry), &entry_debug_info);
-        if (!s.ok()) {
+        MonoTime replay_start = MonoTime::Now();
+        Status replay_status = HandleEntry(io_context, &state, std::move(read.entry),
+                                           &entry_debug_info);
+        stats_.replay_time += MonoTime::Now() - replay_start;
+        if (!replay_status.ok()) {
           DumpReplayStateToLog(state);
-          RETURN_NOT_OK_PREPEND(s, DebugInfo(tablet_->tablet_id(),
-                                             segment->header().sequence_number(),
-                                             entry_count, segment->path(),
-                                             entry_debug_info));
+          RETURN_NOT_OK_PREPEND(replay_status, DebugInfo(tablet_->tablet_id(),
+                                                         segment->header().sequence_number(),
+                                                         entry_count, segment->path(),
+                                                         entry_debug_info));
         }
       }
 
       const auto now = MonoTime::Now();
       if (now - last_status_update > kStatusUpdateInterval) {
+        update_read_stats();
         SetStatusMessage(Substitute("Bootstrap replaying log segment $0/$1 "
                                     "($2/$3 this segment, stats: $4)",
                                     segment_count + 1, log_reader_->num_segments(),
-                                    HumanReadableNumBytes::ToString(reader.offset()),
-                                    HumanReadableNumBytes::ToString(reader.read_up_to_offset()),
+                                    HumanReadableNumBytes::ToString(offset),
+                                    HumanReadableNumBytes::ToString(read_up_to_offset),
                                     stats_.ToString()));
         last_status_update = now;
       }
     }
 
+    update_read_stats();
     SetStatusMessage(Substitute("Bootstrap replayed $0/$1 log segments. "
                                 "Stats: $2. Pending: $3 replicates",
                                 segment_count + 1, log_reader_->num_segments(),
@@ -1675,6 +1884,7 @@ string TabletBootstrap::LogPrefix() const {
 Status FlushedStoresSnapshot::InitFrom(const TabletMetadata& tablet_meta) {
   CHECK(flushed_dms_by_drs_id_.empty()) << "already initted";
   last_durable_mrs_id_ = tablet_meta.last_durable_mrs_id();
+  last_durable_bulk_load_id_ = tablet_meta.last_durable_bulk_load_id();
   for (const shared_ptr<RowSetMetadata>& rsmd : tablet_meta.rowsets()) {
     if (!InsertIfNotPresent(&flushed_dms_by_drs_id_, rsmd->id(),
                             rsmd->last_durable_redo_dms_id())) {
@@ -1691,6 +1901,15 @@ Status FlushedStoresSnapshot::InitFrom(const TabletMetadata& tablet_meta) {
 }
 
 bool FlushedStoresSnapshot::IsMemStoreActive(const MemStoreTargetPB& target) const {
+  if (target.has_bulk_load_id()) {
+    DCHECK(!target.has_mrs_id());
+    DCHECK(!target.has_rs_id());
+
+    // The original insert was written into a DiskRowSet by a bulk load. Unlike
+    // a flush, the bulk load doesn't duplicate its rows anywhere else, so it
+    // needs to be replayed unless its rowsets were made durable.
+    return target.bulk_load_id() > last_durable_bulk_load_id_;
+  }
   if (target.has_mrs_id()) {
     DCHECK(!target.has_rs_id());
     DCHECK(!target.has_dms_id());
@@ -26,6 +26,7 @@ namespace kudu {
 class FileCache;
 class MemTracker;
 class MetricRegistry;
+class ThreadPool;
 
 namespace log {
 class Log;
@@ -58,6 +59,11 @@ extern const char* kLogRecoveryDir;
 //
 // This is a synchronous method, but is typically called within a thread pool by
 // TSTabletManager.
+//
+// If 'log_append_pool' is not null, the rebuilt log appends its entries on
+// that pool, shared with the logs of other tablets, rather than on threads
+// of its own. If 'rowset_encoding_pool' is not null, the rebuilt tablet
+// encodes the columns of the rowsets it writes on that pool.
 Status BootstrapTablet(scoped_refptr<TabletMetadata> tablet_meta,
                        consensus::RaftConfigPB committed_raft_config,
                        clock::Clock* clock,
@@ -65,6 +71,8 @@ Status BootstrapTablet(scoped_refptr<TabletMetadata> tablet_meta,
                        scoped_refptr<rpc::ResultTracker> result_tracker,
                        MetricRegistry* metric_registry,
                        FileCache* file_cache,
+                       ThreadPool* log_append_pool,
+                       ThreadPool* rowset_encoding_pool,
                        scoped_refptr<TabletReplica> tablet_replica,
                        scoped_refptr<log::LogAnchorRegistry> log_anchor_registry,
                        std::shared_ptr<Tablet>* rebuilt_tablet,
@@ -54,12 +54,15 @@
 #include "kudu/tablet/tablet.h"
 #include "kudu/tablet/tablet_metadata.h"
 #include "kudu/tablet/tablet_metrics.h"
+#include "kudu/tablet/tablet_mm_ops.h"
+#include "kudu/util/maintenance_manager.h"
 #include "kudu/util/metrics.h"
 #include "kudu/util/monotime.h"
 #include "kudu/util/status.h"
 #include "kudu/util/test_macros.h"
 
 DECLARE_bool(enable_maintenance_manager);
+DECLARE_int64(data_gc_io_bytes_per_block);
 DECLARE_int32(tablet_history_max_age_sec);
 DECLARE_string(time_source);
 
@@ -270,7 +273,8 @@ TEST_F(TabletHistoryGcTest, TestMajorDeltaCompactionOnSubsetOfColumns) {
     DiskRowSet* drs = down_cast<DiskRowSet*>(rowsets[i].get());
     vector<ColumnId> col_ids_to_compact = { schema_.column_id(2) };
     ASSERT_OK(drs->MajorCompactDeltaStoresWithColumnIds(col_ids_to_compact, nullptr,
-                                                        tablet()->GetHistoryGcOpts()));
+                                                        tablet()->GetHistoryGcOpts(),
+                                                        /*encoding_pool=*/nullptr));
   }
 
   NO_FATALS(VerifyDebugDumpRowsMatch(
@@ -745,5 +749,40 @@ TEST_F(TabletHistoryGcNoMaintMgrTest, TestGCDeletedRowsetsAfterMajorCompaction)
   NO_FATALS(TryRunningDeletedRowsetGC());
 }
 
+// Test that the GC ops charge the maintenance manager's I/O budget for the
+// blocks they'd delete rather than for their size, so that GCing a lot of
+// data doesn't hold back compactions.
+TEST_F(TabletHistoryGcNoMaintMgrTest, TestGcOpsEstimateIoPerBlock) {
+  FLAGS_tablet_history_max_age_sec = 1000;
+  FLAGS_data_gc_io_bytes_per_block = 1;
+  NO_FATALS(InsertOriginalRows(kNumRowsets, rows_per_rowset_));
+
+  // The undo delta blocks aren't initialized yet, so they may be ancient.
+  int64_t bytes = 0;
+  int64_t blocks = 0;
+  ASSERT_OK(tablet()->EstimateBytesInPotentiallyAncientUndoDeltas(&bytes, &blocks));
+  ASSERT_GT(blocks, 0);
+  ASSERT_LE(blocks, tablet()->CountUndoDeltasForTests());
+
+  UndoDeltaBlockGCOp undo_gc_op(tablet().get());
+  MaintenanceOpStats undo_gc_stats;
+  undo_gc_op.UpdateStats(&undo_gc_stats);
+  ASSERT_TRUE(undo_gc_stats.runnable());
+  ASSERT_EQ(bytes, undo_gc_stats.data_retained_bytes());
+  ASSERT_EQ(blocks, undo_gc_stats.io_bytes());
+
+  NO_FATALS(DeleteOriginalRows(kNumRowsets, rows_per_rowset_, /*flush_dms*/true));
+  NO_FATALS(AddTimeToHybridClock(MonoDelta::FromSeconds(FLAGS_tablet_history_max_age_sec + 1)));
+  ASSERT_OK(tablet()->GetBytesInAncientDeletedRowsets(&bytes, &blocks));
+  ASSERT_GT(blocks, 0);
+
+  DeletedRowsetGCOp deleted_rowset_gc_op(tablet().get());
+  MaintenanceOpStats deleted_rowset_gc_stats;
+  deleted_rowset_gc_op.UpdateStats(&deleted_rowset_gc_stats);
+  ASSERT_TRUE(deleted_rowset_gc_stats.runnable());
+  ASSERT_EQ(bytes, deleted_rowset_gc_stats.data_retained_bytes());
+  ASSERT_EQ(blocks, deleted_rowset_gc_stats.io_bytes());
+}
+
 } // namespace tablet
 } // namespace kudu
@@ -297,6 +297,7 @@ TabletMetadata::TabletMetadata(FsManager* fs_manager, string tablet_id,
       fs_manager_(fs_manager),
       next_rowset_idx_(0),
       last_durable_mrs_id_(kNoDurableMemStore),
+      last_durable_bulk_load_id_(kNoDurableMemStore),
       schema_(new Schema(schema)),
       schema_version_(0),
       table_name_(std::move(table_name)),
@@ -325,6 +326,7 @@ TabletMetadata::TabletMetadata(FsManager* fs_manager, string tablet_id)
       tablet_id_(std::move(tablet_id)),
       fs_manager_(fs_manager),
       next_rowset_idx_(0),
+      last_durable_bulk_load_id_(kNoDurableMemStore),
       schema_(nullptr),
       num_flush_pins_(0),
       needs_flush_(false),
@@ -372,6 +374,7 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
     }
 
     last_durable_mrs_id_ = superblock.last_durable_mrs_id();
+    last_durable_bulk_load_id_ = superblock.last_durable_bulk_load_id();
 
     table_name_ = superblock.table_name();
 
@@ -509,6 +512,17 @@ Status TabletMetadata::UpdateAndFlush(const RowSetMetadataIds& to_remove,
   return Flush();
 }
 
+Status TabletMetadata::AddBulkLoadedRowSetsAndFlush(const RowSetMetadataVector& to_add,
+                                                    int64_t bulk_load_id) {
+  {
+    std::lock_guard<LockType> l(data_lock_);
+    DCHECK_GT(bulk_load_id, last_durable_bulk_load_id_);
+    RETURN_NOT_OK(UpdateUnlocked({}, to_add, kNoMrsFlushed));
+    last_durable_bulk_load_id_ = bulk_load_id;
+  }
+  return Flush();
+}
+
 void TabletMetadata::AddOrphanedBlocks(const BlockIdContainer& block_ids) {
   std::lock_guard<LockType> l(data_lock_);
   AddOrphanedBlocksUnlocked(block_ids);
@@ -698,6 +712,9 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* super_block,
   pb.set_tablet_id(tablet_id_);
   partition_.ToPB(pb.mutable_partition());
   pb.set_last_durable_mrs_id(last_durable_mrs_id_);
+  if (last_durable_bulk_load_id_ != kNoDurableMemStore) {
+    pb.set_last_durable_bulk_load_id(last_durable_bulk_load_id_);
+  }
   pb.set_schema_version(schema_version_);
   partition_schema_.ToPB(pb.mutable_partition_schema());
   pb.set_table_name(table_name_);
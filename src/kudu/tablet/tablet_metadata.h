@@ -185,6 +185,12 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
                         const RowSetMetadataVector& to_add,
                         int64_t last_durable_mrs_id);
 
+  // Adds the rowsets written by the bulk load 'bulk_load_id' and flushes the
+  // metadata, recording the bulk load as durable. Bulk loads must be added in
+  // the order of their ids.
+  Status AddBulkLoadedRowSetsAndFlush(const RowSetMetadataVector& to_add,
+                                      int64_t bulk_load_id);
+
   // Adds the blocks referenced by 'block_ids' to 'orphaned_blocks_'.
   //
   // This set will be written to the on-disk metadata in any subsequent
@@ -238,6 +244,8 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   void SetLastDurableMrsIdForTests(int64_t mrs_id) { last_durable_mrs_id_ = mrs_id; }
 
+  int64_t last_durable_bulk_load_id() const { return last_durable_bulk_load_id_; }
+
   void SetPreFlushCallback(StatusClosure callback);
 
   // Return the last-logged opid of a tombstoned tablet, if known.
@@ -372,6 +380,8 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   int64_t last_durable_mrs_id_;
 
+  int64_t last_durable_bulk_load_id_;
+
   // The current schema version. This is owned by this class.
   // We don't use unique_ptr so that we can do an atomic swap.
   Schema* schema_;
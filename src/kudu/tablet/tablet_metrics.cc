@@ -120,6 +120,23 @@ METRIC_DEFINE_counter(tablet, scanner_bytes_scanned_from_disk, "Scanner Bytes Sc
                       "includes both cache misses and cache hits.",
                       kudu::MetricLevel::kDebug);
 
+METRIC_DEFINE_counter(tablet, scanner_readahead_hits, "Scanner Readahead Hits",
+                      kudu::MetricUnit::kBlocks,
+                      "Number of CFile data blocks read ahead of scan requests and then "
+                      "used by them. Only counted if --cfile_readahead_max_blocks is positive.",
+                      kudu::MetricLevel::kDebug);
+METRIC_DEFINE_counter(tablet, scanner_readahead_misses, "Scanner Readahead Misses",
+                      kudu::MetricUnit::kBlocks,
+                      "Number of CFile data blocks read synchronously by scan requests "
+                      "because they hadn't been read ahead. Only counted if "
+                      "--cfile_readahead_max_blocks is positive.",
+                      kudu::MetricLevel::kDebug);
+METRIC_DEFINE_counter(tablet, scanner_readahead_wasted, "Scanner Readahead Wasted",
+                      kudu::MetricUnit::kBlocks,
+                      "Number of CFile data blocks read ahead of scan requests but never "
+                      "used by them, for example because the scan seeked elsewhere.",
+                      kudu::MetricLevel::kDebug);
+
 METRIC_DEFINE_counter(tablet, scans_started, "Scans Started",
                       kudu::MetricUnit::kScanners,
                       "Number of scanners which have been started on this tablet",
@@ -373,6 +390,9 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(scanner_cells_scanned_from_disk),
     MINIT(scanner_bytes_scanned_from_disk),
     MINIT(scanner_predicates_disabled),
+    MINIT(scanner_readahead_hits),
+    MINIT(scanner_readahead_misses),
+    MINIT(scanner_readahead_wasted),
     MINIT(scans_started),
     GINIT(tablet_active_scanners),
     MINIT(bloom_lookups),
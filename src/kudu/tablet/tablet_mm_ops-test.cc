@@ -19,12 +19,14 @@
 #include <unordered_set>
 #include <vector>
 
+#include <gflags/gflags_declare.h>
 #include <gtest/gtest.h>
 
 #include "kudu/common/common.pb.h"
 #include "kudu/gutil/map-util.h"
 #include "kudu/gutil/port.h"
 #include "kudu/gutil/ref_counted.h"
+#include "kudu/tablet/compaction.h"
 #include "kudu/tablet/tablet-test-base.h"
 #include "kudu/tablet/tablet.h"
 #include "kudu/tablet/tablet_metrics.h"
@@ -34,6 +36,8 @@
 #include "kudu/util/monotime.h"
 #include "kudu/util/test_macros.h"
 
+DECLARE_double(tablet_delta_store_major_compact_min_ratio);
+
 namespace kudu {
 namespace tablet {
 
@@ -107,6 +111,31 @@ TEST_F(KuduTabletMmOpsTest, TestCompactRowSetsOpCacheStats) {
                                        tablet()->metrics()->compact_rs_duration }));
 }
 
+// Test that a prepared CompactRowSetsOp isn't scheduled again until it has
+// locked its inputs, and that concurrently picked inputs are disjoint.
+TEST_F(KuduTabletMmOpsTest, TestCompactRowSetsOpConcurrentPicks) {
+  for (int i = 0; i < 3; i++) {
+    NO_FATALS(InsertTestRows(i * 10, 10, 0));
+    ASSERT_OK(tablet()->Flush());
+  }
+  CompactRowSetsOp op(tablet().get());
+  ASSERT_TRUE(op.Prepare());
+  op.UpdateStats(&stats_);
+  ASSERT_FALSE(stats_.runnable());
+  op.Perform();
+
+  // Once a compaction has locked its inputs, no other compaction may pick them.
+  RowSetsInCompaction first;
+  ASSERT_OK(tablet()->PickRowSetsToCompact(&first, Tablet::FORCE_COMPACT_ALL));
+  ASSERT_EQ(tablet()->num_rowsets(), first.num_rowsets());
+  RowSetsInCompaction second;
+  ASSERT_OK(tablet()->PickRowSetsToCompact(&second, Tablet::FORCE_COMPACT_ALL));
+  ASSERT_EQ(0, second.num_rowsets());
+
+  ASSERT_OK(tablet()->CompactPickedRowSets(first));
+  ASSERT_EQ(1, tablet()->num_rowsets());
+}
+
 TEST_F(KuduTabletMmOpsTest, TestMinorDeltaCompactionOpCacheStats) {
   MinorDeltaCompactionOp op(tablet().get());
   NO_FATALS(TestFirstCall(&op));
@@ -125,5 +154,30 @@ TEST_F(KuduTabletMmOpsTest, TestMajorDeltaCompactionOpCacheStats) {
                                        tablet()->metrics()->delta_minor_compact_rs_duration,
                                        tablet()->metrics()->delta_major_compact_rs_duration }));
 }
+
+// Test that delta compactions estimate the I/O of rewriting the rowset they'd
+// compact.
+TEST_F(KuduTabletMmOpsTest, TestDeltaCompactionOpsEstimateIo) {
+  FLAGS_tablet_delta_store_major_compact_min_ratio = 0;
+  NO_FATALS(InsertTestRows(0, 100, 0));
+  ASSERT_OK(tablet()->Flush());
+  for (int i = 1; i <= 3; i++) {
+    NO_FATALS(UpsertTestRows(0, 100, i));
+    ASSERT_OK(tablet()->FlushAllDMSForTests());
+  }
+
+  MinorDeltaCompactionOp minor_op(tablet().get());
+  minor_op.UpdateStats(&stats_);
+  ASSERT_TRUE(stats_.runnable());
+  const int64_t minor_io_bytes = stats_.io_bytes();
+  ASSERT_GT(minor_io_bytes, 0);
+
+  // A major delta compaction rewrites the base data as well.
+  MaintenanceOpStats major_stats;
+  MajorDeltaCompactionOp major_op(tablet().get());
+  major_op.UpdateStats(&major_stats);
+  ASSERT_TRUE(major_stats.runnable());
+  ASSERT_GT(major_stats.io_bytes(), minor_io_bytes);
+}
 } // namespace tablet
 } // namespace kudu
@@ -17,6 +17,7 @@
 
 #include "kudu/tablet/tablet_mm_ops.h"
 
+#include <memory>
 #include <mutex>
 #include <ostream>
 #include <utility>
@@ -28,6 +29,7 @@
 #include "kudu/common/common.pb.h"
 #include "kudu/gutil/port.h"
 #include "kudu/gutil/strings/substitute.h"
+#include "kudu/tablet/compaction.h"
 #include "kudu/tablet/rowset.h"
 #include "kudu/tablet/tablet.h"
 #include "kudu/tablet/tablet_metadata.h"
@@ -83,12 +85,22 @@ DEFINE_bool(enable_deleted_rowset_gc, true,
     "considered ancient history (see --tablet_history_max_age_sec) are deleted.");
 TAG_FLAG(enable_deleted_rowset_gc, runtime);
 
+DEFINE_int64(data_gc_io_bytes_per_block, 4096,
+    "The number of bytes of disk I/O that undo delta block GC and deleted "
+    "rowset GC are charged against --maintenance_manager_io_budget_mb_per_sec "
+    "for each block they delete. Deleting a block doesn't read or rewrite its "
+    "data, so it costs about the same whatever the size of the block.");
+TAG_FLAG(data_gc_io_bytes_per_block, advanced);
+TAG_FLAG(data_gc_io_bytes_per_block, experimental);
+TAG_FLAG(data_gc_io_bytes_per_block, runtime);
+
 DEFINE_bool(enable_workload_score_for_perf_improvement_ops, false,
             "Whether to enable prioritization of maintenance operations based on "
             "whether there are on-going workloads, favoring ops of 'hot' tablets.");
 TAG_FLAG(enable_workload_score_for_perf_improvement_ops, experimental);
 TAG_FLAG(enable_workload_score_for_perf_improvement_ops, runtime);
 
+using std::shared_ptr;
 using std::string;
 using strings::Substitute;
 
@@ -121,7 +133,8 @@ CompactRowSetsOp::CompactRowSetsOp(Tablet* tablet)
   : TabletOpBase(Substitute("CompactRowSetsOp($0)", tablet->tablet_id()),
                  MaintenanceOp::HIGH_IO_USAGE, tablet),
     last_num_mrs_flushed_(0),
-    last_num_rs_compacted_(0) {
+    last_num_rs_compacted_(0),
+    num_pending_picks_(0) {
 }
 
 void CompactRowSetsOp::UpdateStats(MaintenanceOpStats* stats) {
@@ -134,6 +147,16 @@ void CompactRowSetsOp::UpdateStats(MaintenanceOpStats* stats) {
 
   std::lock_guard<simple_spinlock> l(lock_);
 
+  // Until a prepared run has locked its inputs, the policy would pick those
+  // same rowsets again, and scheduling another run on their account would
+  // only yield a much less fruitful compaction (see KUDU-790). Once they're
+  // locked, the stats only reflect the remaining rowsets, so another run may
+  // compact a disjoint section of the tablet concurrently.
+  if (num_pending_picks_ > 0) {
+    stats->set_runnable(false);
+    return;
+  }
+
   double workload_score = FLAGS_enable_workload_score_for_perf_improvement_ops ?
                           tablet_->CollectAndUpdateWorkloadStats(MaintenanceOp::COMPACT_OP) : 0;
 
@@ -161,21 +184,30 @@ void CompactRowSetsOp::UpdateStats(MaintenanceOpStats* stats) {
 
 bool CompactRowSetsOp::Prepare() {
   std::lock_guard<simple_spinlock> l(lock_);
-  // Invalidate the cached stats so that another section of the tablet can
-  // be compacted concurrently.
-  //
-  // TODO: we should acquire the rowset compaction locks here. Otherwise, until
-  // Compact() acquires them, the maintenance manager may compute the same
-  // stats for this op and run it again, even though Perform() will end up
-  // performing a much less fruitful compaction. See KUDU-790 for more details.
+  // The rowset compaction locks can't be taken here: they're mutexes, and
+  // Perform() runs on a different thread. Instead, hold off rescheduling
+  // this op until Perform() has picked and locked its inputs.
+  num_pending_picks_++;
   prev_stats_.Clear();
   return true;
 }
 
 void CompactRowSetsOp::Perform() {
-  WARN_NOT_OK(tablet_->Compact(Tablet::COMPACT_NO_FLAGS),
-              Substitute("$0Compaction failed on $1",
-                         LogPrefix(), tablet_->tablet_id()));
+  RowSetsInCompaction input;
+  Status s = tablet_->PickRowSetsToCompact(&input, Tablet::COMPACT_NO_FLAGS);
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    DCHECK_GT(num_pending_picks_, 0);
+    num_pending_picks_--;
+    // The picked rowsets are now locked: invalidate the cached stats so
+    // that another section of the tablet can be compacted concurrently.
+    prev_stats_.Clear();
+  }
+  if (s.ok()) {
+    s = tablet_->CompactPickedRowSets(input);
+  }
+  WARN_NOT_OK(s, Substitute("$0Compaction failed on $1",
+                            LogPrefix(), tablet_->tablet_id()));
 }
 
 scoped_refptr<Histogram> CompactRowSetsOp::DurationHistogram() const {
@@ -236,10 +268,15 @@ void MinorDeltaCompactionOp::UpdateStats(MaintenanceOpStats* stats) {
     last_num_rs_minor_delta_compacted_ = new_num_rs_minor_delta_compacted;
   }
 
+  shared_ptr<RowSet> rs;
   double perf_improv = tablet_->GetPerfImprovementForBestDeltaCompact(
-      RowSet::MINOR_DELTA_COMPACTION, nullptr);
+      RowSet::MINOR_DELTA_COMPACTION, &rs);
   prev_stats_.set_perf_improvement(perf_improv);
   prev_stats_.set_runnable(perf_improv > 0);
+  // A minor delta compaction reads the rowset's REDO delta files and writes
+  // about as much back out.
+  prev_stats_.set_io_bytes(
+      rs ? 2 * (rs->OnDiskBaseDataSizeWithRedos() - rs->OnDiskBaseDataSize()) : 0);
   prev_stats_.set_workload_score(workload_score);
   *stats = prev_stats_;
 }
@@ -323,10 +360,15 @@ void MajorDeltaCompactionOp::UpdateStats(MaintenanceOpStats* stats) {
     last_num_rs_major_delta_compacted_ = new_num_rs_major_delta_compacted;
   }
 
+  shared_ptr<RowSet> rs;
   double perf_improv = tablet_->GetPerfImprovementForBestDeltaCompact(
-      RowSet::MAJOR_DELTA_COMPACTION, nullptr);
+      RowSet::MAJOR_DELTA_COMPACTION, &rs);
   prev_stats_.set_perf_improvement(perf_improv);
   prev_stats_.set_runnable(perf_improv > 0);
+  // A major delta compaction reads the updated base columns along with the
+  // REDO delta files, and rewrites them. Not every column is necessarily
+  // updated, so this overestimates the I/O.
+  prev_stats_.set_io_bytes(rs ? 2 * rs->OnDiskBaseDataSizeWithRedos() : 0);
   prev_stats_.set_workload_score(workload_score);
   *stats = prev_stats_;
 }
@@ -373,10 +415,15 @@ void UndoDeltaBlockGCOp::UpdateStats(MaintenanceOpStats* stats) {
   }
 
   int64_t max_estimated_retained_bytes = 0;
-  WARN_NOT_OK(tablet_->EstimateBytesInPotentiallyAncientUndoDeltas(&max_estimated_retained_bytes),
+  int64_t max_estimated_retained_blocks = 0;
+  WARN_NOT_OK(tablet_->EstimateBytesInPotentiallyAncientUndoDeltas(
+                  &max_estimated_retained_bytes, &max_estimated_retained_blocks),
               "Unable to count bytes in potentially ancient undo deltas");
   stats->set_data_retained_bytes(max_estimated_retained_bytes);
   stats->set_runnable(max_estimated_retained_bytes > 0);
+  // The GC only reads the headers of the undo delta files and deletes the
+  // ancient ones, so its I/O depends on the number of blocks, not their size.
+  stats->set_io_bytes(max_estimated_retained_blocks * FLAGS_data_gc_io_bytes_per_block);
 }
 
 bool UndoDeltaBlockGCOp::Prepare() {
@@ -429,10 +476,14 @@ void DeletedRowsetGCOp::UpdateStats(MaintenanceOpStats* stats) {
     return;
   }
   int64_t estimated_retained_bytes = 0;
-  WARN_NOT_OK(tablet_->GetBytesInAncientDeletedRowsets(&estimated_retained_bytes),
+  int64_t estimated_retained_blocks = 0;
+  WARN_NOT_OK(tablet_->GetBytesInAncientDeletedRowsets(&estimated_retained_bytes,
+                                                       &estimated_retained_blocks),
               "Unable to count bytes in ancient, deleted rowsets");
   stats->set_data_retained_bytes(estimated_retained_bytes);
   stats->set_runnable(estimated_retained_bytes > 0);
+  // As with the undo delta block GC, only the number of deleted blocks matters.
+  stats->set_io_bytes(estimated_retained_blocks * FLAGS_data_gc_io_bytes_per_block);
 }
 
 void DeletedRowsetGCOp::Perform() {
@@ -72,6 +72,10 @@ class CompactRowSetsOp : public TabletOpBase {
   MaintenanceOpStats prev_stats_;
   uint64_t last_num_mrs_flushed_;
   uint64_t last_num_rs_compacted_;
+
+  // The number of runs of this op that have been prepared but haven't yet
+  // picked and locked their input rowsets.
+  int num_pending_picks_;
 };
 
 // MaintenanceOp to run minor compaction on delta stores.
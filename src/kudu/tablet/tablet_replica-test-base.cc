@@ -146,7 +146,8 @@ Status TabletReplicaTestBase::StartReplica(const ConsensusBootstrapInfo& info) {
                                 scoped_refptr<ResultTracker>(),
                                 log,
                                 prepare_pool_.get(),
-                                dns_resolver_.get());
+                                dns_resolver_.get(),
+                                /*multi_raft_manager*/nullptr);
 }
 
 Status TabletReplicaTestBase::StartReplicaAndWaitUntilLeader(const ConsensusBootstrapInfo& info) {
@@ -172,6 +173,8 @@ Status TabletReplicaTestBase::RestartReplica() {
                                 /*result_tracker*/nullptr,
                                 &metric_registry_,
                                 /*file_cache*/nullptr,
+                                /*log_append_pool*/nullptr,
+                                /*rowset_encoding_pool*/nullptr,
                                 tablet_replica_,
                                 tablet_replica_->log_anchor_registry(),
                                 &tablet,
@@ -184,7 +187,8 @@ Status TabletReplicaTestBase::RestartReplica() {
                                        scoped_refptr<ResultTracker>(),
                                        log,
                                        prepare_pool_.get(),
-                                       dns_resolver_.get()));
+                                       dns_resolver_.get(),
+                                       /*multi_raft_manager*/nullptr));
   // Wait for the replica to be usable.
   return tablet_replica_->consensus()->WaitUntilLeaderForTests(kLeadershipTimeout);
 }
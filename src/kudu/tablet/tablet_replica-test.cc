@@ -505,6 +505,51 @@ TEST_F(TabletReplicaTest, TestActiveOpPreventsLogGC) {
   ASSERT_EQ(2, segments.size());
 }
 
+// Ensure that ops of the same tablet which don't touch the same rows don't
+// wait on each other to be applied.
+TEST_F(TabletReplicaTest, TestNonConflictingOpsApplyConcurrently) {
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartReplicaAndWaitUntilLeader(info));
+
+  // Start an insert which hangs during Apply().
+  CountDownLatch rpc_latch(1);
+  CountDownLatch apply_started(1);
+  CountDownLatch apply_continue(1);
+  WriteRequestPB req;
+  WriteResponsePB resp;
+  ASSERT_OK(GenerateSequentialInsertRequest(GetTestSchema(), &req));
+  unique_ptr<WriteOpState> op_state(new WriteOpState(tablet_replica_.get(),
+                                                     &req,
+                                                     nullptr, // No RequestIdPB
+                                                     &resp));
+  op_state->set_completion_callback(unique_ptr<OpCompletionCallback>(
+      new LatchOpCompletionCallback<WriteResponsePB>(&rpc_latch, &resp)));
+  unique_ptr<DelayedApplyOp> op(new DelayedApplyOp(&apply_started,
+                                                   &apply_continue,
+                                                   std::move(op_state)));
+  scoped_refptr<OpDriver> driver;
+  ASSERT_OK(tablet_replica_->NewLeaderOpDriver(std::move(op), &driver));
+  ASSERT_OK(driver->ExecuteAsync());
+  apply_started.Wait();
+
+  // Writes to other rows should go through while the first op is still
+  // being applied.
+  for (int i = 0; i < 3; i++) {
+    WriteRequestPB other_req;
+    ASSERT_OK(GenerateSequentialInsertRequest(GetTestSchema(), &other_req));
+    ASSERT_OK(ExecuteWrite(tablet_replica_.get(), other_req));
+  }
+  ASSERT_EQ(1, rpc_latch.count());
+
+  apply_continue.CountDown();
+  rpc_latch.Wait();
+  ASSERT_FALSE(resp.has_error()) << SecureDebugString(resp);
+  tablet_replica_->op_tracker_.WaitForAllToFinish();
+  uint64_t num_rows;
+  ASSERT_OK(tablet_replica_->tablet()->CountRows(&num_rows));
+  ASSERT_EQ(4, num_rows);
+}
+
 TEST_F(TabletReplicaTest, TestGCEmptyLog) {
   ConsensusBootstrapInfo info;
   ASSERT_OK(StartReplica(info));
@@ -106,6 +106,7 @@ using consensus::ConsensusBootstrapInfo;
 using consensus::ConsensusOptions;
 using consensus::ConsensusRound;
 using consensus::MarkDirtyCallback;
+using consensus::MultiRaftManager;
 using consensus::OpId;
 using consensus::PeerProxyFactory;
 using consensus::RaftConfigPB;
@@ -180,7 +181,8 @@ Status TabletReplica::Start(const ConsensusBootstrapInfo& bootstrap_info,
                             scoped_refptr<ResultTracker> result_tracker,
                             scoped_refptr<Log> log,
                             ThreadPool* prepare_pool,
-                            DnsResolver* resolver) {
+                            DnsResolver* resolver,
+                            MultiRaftManager* multi_raft_manager) {
   DCHECK(tablet) << "A TabletReplica must be provided with a Tablet";
   DCHECK(log) << "A TabletReplica must be provided with a Log";
 
@@ -233,7 +235,8 @@ Status TabletReplica::Start(const ConsensusBootstrapInfo& bootstrap_info,
       VLOG(2) << "T " << tablet_id() << " P " << consensus_->peer_uuid() << ": Peer starting";
       VLOG(2) << "RaftConfig before starting: " << SecureDebugString(consensus_->CommittedConfig());
 
-      peer_proxy_factory.reset(new RpcPeerProxyFactory(messenger_, resolver));
+      peer_proxy_factory.reset(new RpcPeerProxyFactory(messenger_, resolver,
+                                                       multi_raft_manager));
       time_manager.reset(new TimeManager(clock_, tablet_->mvcc_manager()->GetCleanTimestamp()));
     }
 
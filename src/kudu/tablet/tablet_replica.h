@@ -53,6 +53,7 @@ class ThreadPoolToken;
 
 namespace consensus {
 class ConsensusMetadataManager;
+class MultiRaftManager;
 class OpStatusPB;
 class TimeManager;
 }
@@ -102,6 +103,9 @@ class TabletReplica : public RefCountedThreadSafe<TabletReplica>,
   // Starts the TabletReplica, making it available for Write()s. If this
   // TabletReplica is part of a consensus configuration this will connect it to other replicas
   // in the consensus configuration.
+  //
+  // 'multi_raft_manager' may be null, in which case this replica never batches
+  // its consensus updates with those of other replicas.
   Status Start(const consensus::ConsensusBootstrapInfo& bootstrap_info,
                std::shared_ptr<tablet::Tablet> tablet,
                clock::Clock* clock,
@@ -109,7 +113,8 @@ class TabletReplica : public RefCountedThreadSafe<TabletReplica>,
                scoped_refptr<rpc::ResultTracker> result_tracker,
                scoped_refptr<log::Log> log,
                ThreadPool* prepare_pool,
-               DnsResolver* resolver);
+               DnsResolver* resolver,
+               consensus::MultiRaftManager* multi_raft_manager);
 
   // Synchronously transition this replica to STOPPED state from any other
   // state. This also stops RaftConsensus. If a Stop() operation is already in
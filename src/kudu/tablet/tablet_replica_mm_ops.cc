@@ -176,6 +176,9 @@ void FlushMRSOp::UpdateStats(MaintenanceOpStats* stats) {
   }
 
   stats->set_ram_anchored(tablet_replica_->tablet()->MemRowSetSize());
+  // The flushed data is usually smaller on disk than in memory, so this
+  // overestimates the I/O a little.
+  stats->set_io_bytes(tablet_replica_->tablet()->MemRowSetSize());
   stats->set_logs_retained_bytes(
       tablet_replica_->tablet()->MemRowSetLogReplaySize(replay_size_map));
 
@@ -250,6 +253,7 @@ void FlushDeltaMemStoresOp::UpdateStats(MaintenanceOpStats* stats) {
                                                    &dms_size, &retention_size);
 
   stats->set_ram_anchored(dms_size);
+  stats->set_io_bytes(dms_size);
   stats->set_runnable(true);
   stats->set_logs_retained_bytes(retention_size);
 
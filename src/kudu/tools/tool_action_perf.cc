@@ -868,6 +868,8 @@ Status TabletScan(const RunnerContext& context) {
                                         /*result_tracker=*/ nullptr,
                                         /*metric_registry=*/ nullptr,
                                         /*file_cache=*/ nullptr,
+                                        /*log_append_pool=*/ nullptr,
+                                        /*rowset_encoding_pool=*/ nullptr,
                                         /*tablet_replica=*/ nullptr,
                                         std::move(registry),
                                         &tablet,
@@ -973,6 +973,9 @@ Status ToClientCompressionType(
     case ColumnPB::ZLIB :
       *type = KuduColumnStorageAttributes::ZLIB;
       break;
+    case ColumnPB::ZSTD :
+      *type = KuduColumnStorageAttributes::ZSTD;
+      break;
     default :
       s = Status::InvalidArgument(Substitute("Unexpected compression type: $0", type_pb));
   }
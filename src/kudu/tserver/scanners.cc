@@ -29,6 +29,7 @@
 #include "kudu/common/column_predicate.h"
 #include "kudu/common/encoded_key.h"
 #include "kudu/common/iterator.h"
+#include "kudu/common/row_aggregator.h"
 #include "kudu/common/scan_spec.h"
 #include "kudu/common/schema.h"
 #include "kudu/gutil/dynamic_annotations.h"
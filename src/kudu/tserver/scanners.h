@@ -48,6 +48,7 @@
 
 namespace kudu {
 
+class RowAggregator;
 class RowwiseIterator;
 class Schema;
 class Status;
@@ -329,6 +330,20 @@ class Scanner {
     return DCHECK_NOTNULL(client_projection_schema_.get());
   }
 
+  // Sets the aggregator evaluating the client's aggregation over the scanned
+  // rows. Aggregating scanners return partial aggregates instead of rows.
+  void set_aggregator(std::unique_ptr<RowAggregator> aggregator) {
+    lock_.AssertAcquired();
+    aggregator_ = std::move(aggregator);
+  }
+
+  // Returns the aggregator evaluating the client's aggregation over the
+  // scanned rows, or nullptr if the scanner returns rows.
+  RowAggregator* aggregator() const {
+    lock_.AssertAcquired();
+    return aggregator_.get();
+  }
+
   // Update the stats from the underlying scanner and return a delta since the
   // previous call to this method.
   IteratorStats UpdateStatsAndGetDelta();
@@ -417,6 +432,10 @@ class Scanner {
   // Assumed to be set once initted_ is true.
   std::unique_ptr<Schema> client_projection_schema_;
 
+  // Evaluates the aggregation requested by the client, if any. Set when the
+  // scanner is created.
+  std::unique_ptr<RowAggregator> aggregator_;
+
   // The last time that the scanner was accessed.
   // Only modified under lock_ but can be read outside.
   std::atomic<MonoTime> last_access_time_;
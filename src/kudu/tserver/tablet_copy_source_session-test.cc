@@ -186,7 +186,8 @@ class TabletCopyTest : public KuduTabletTest {
                                      scoped_refptr<rpc::ResultTracker>(),
                                      log,
                                      prepare_pool_.get(),
-                                     dns_resolver_.get()));
+                                     dns_resolver_.get(),
+                                     /*multi_raft_manager*/nullptr));
     ASSERT_OK(tablet_replica_->WaitUntilConsensusRunning(MonoDelta::FromSeconds(10)));
     ASSERT_OK(tablet_replica_->consensus()->WaitUntilLeaderForTests(MonoDelta::FromSeconds(10)));
   }
@@ -48,6 +48,7 @@
 #include "kudu/common/encoded_key.h"
 #include "kudu/common/partial_row.h"
 #include "kudu/common/partition.h"
+#include "kudu/common/row_aggregator.h"
 #include "kudu/common/row_operations.h"
 #include "kudu/common/schema.h"
 #include "kudu/common/timestamp.h"
@@ -2701,6 +2702,100 @@ TEST_F(TabletServerTest, TestColumnarScan) {
 }
 
 
+// Test that the tablet server evaluates aggregates in place of returning rows,
+// and that the partial aggregates of every response merge into the result.
+TEST_F(TabletServerTest, TestAggregateScan) {
+  const int kNumRows = 1000;
+  InsertTestRowsDirect(0, kNumRows);
+  FLAGS_scanner_batch_size_rows = 100;
+
+  AggregationSpecPB spec;
+  spec.add_aggregates()->set_function(AggregatePB::COUNT);
+  auto* agg = spec.add_aggregates();
+  agg->set_function(AggregatePB::SUM);
+  agg->set_column("int_val");
+  agg = spec.add_aggregates();
+  agg->set_function(AggregatePB::MIN);
+  agg->set_column("key");
+  agg = spec.add_aggregates();
+  agg->set_function(AggregatePB::MAX);
+  agg->set_column("string_val");
+
+  unique_ptr<RowAggregator> merged;
+  ASSERT_OK(RowAggregator::Create(spec, schema_, &merged));
+
+  ScanRequestPB req;
+  NewScanRequestPB* scan = req.mutable_new_scan_request();
+  scan->set_tablet_id(kTabletId);
+  ASSERT_OK(SchemaToColumnPBs(schema_, scan->mutable_projected_columns()));
+  *scan->mutable_aggregation() = spec;
+  // Respond after every RowBlock so that the results span several responses.
+  req.set_batch_size_bytes(1);
+
+  int num_responses = 0;
+  while (true) {
+    ScanResponsePB resp;
+    RpcController rpc;
+    rpc.RequireServerFeature(TabletServerFeatures::AGGREGATE_PUSHDOWN);
+    SCOPED_TRACE(SecureDebugString(req));
+    ASSERT_OK(proxy_->Scan(req, &resp, &rpc));
+    SCOPED_TRACE(SecureDebugString(resp));
+    ASSERT_FALSE(resp.has_error());
+    ASSERT_FALSE(resp.has_data());
+    ASSERT_OK(merged->MergeFromPB(resp.aggregate_result()));
+    num_responses++;
+    if (!resp.has_more_results()) {
+      break;
+    }
+    req.clear_new_scan_request();
+    req.set_scanner_id(resp.scanner_id());
+    req.set_call_seq_id(req.call_seq_id() + 1);
+  }
+  ASSERT_GT(num_responses, 1);
+  // The aggregated rows count as returned.
+  ASSERT_EQ(kNumRows, tablet_replica_->tablet()->metrics()->scanner_rows_returned->value());
+
+  vector<KuduPartialRow> rows;
+  ASSERT_OK(merged->GetResultRows(&rows));
+  ASSERT_EQ(1, rows.size());
+  int64_t v;
+  ASSERT_OK(rows[0].GetInt64("count(*)", &v));
+  ASSERT_EQ(kNumRows, v);
+  ASSERT_OK(rows[0].GetInt64("sum(int_val)", &v));
+  ASSERT_EQ(kNumRows * (kNumRows - 1), v);
+  int32_t min_key;
+  ASSERT_OK(rows[0].GetInt32("min(key)", &min_key));
+  ASSERT_EQ(0, min_key);
+  Slice max_str;
+  ASSERT_OK(rows[0].GetString("max(string_val)", &max_str));
+  ASSERT_EQ("hello 999", max_str);
+}
+
+TEST_F(TabletServerTest, TestInvalidAggregateScan) {
+  NO_FATALS(InsertTestRowsDirect(0, 10));
+  ScanRequestPB req;
+  NewScanRequestPB* scan = req.mutable_new_scan_request();
+  scan->set_tablet_id(kTabletId);
+  ASSERT_OK(SchemaToColumnPBs(schema_.CreateKeyProjection(),
+                              scan->mutable_projected_columns()));
+  req.set_call_seq_id(0);
+  auto* agg = scan->mutable_aggregation()->add_aggregates();
+  agg->set_function(AggregatePB::SUM);
+  agg->set_column("int_val");
+
+  // Aggregated columns must be projected.
+  NO_FATALS(VerifyScanRequestFailure(req,
+                                     TabletServerErrorPB::INVALID_SCAN_SPEC,
+                                     "unknown aggregated column"));
+
+  // Aggregation and limits are mutually exclusive.
+  agg->set_column("key");
+  scan->set_limit(5);
+  NO_FATALS(VerifyScanRequestFailure(req,
+                                     TabletServerErrorPB::INVALID_SCAN_SPEC,
+                                     "a limit cannot be combined with an aggregation"));
+}
+
 TEST_F(TabletServerTest, TestNonPositiveLimitsShortCircuit) {
   InsertTestRowsDirect(0, 10);
   for (int limit : { -1, 0 }) {
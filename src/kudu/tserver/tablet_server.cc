@@ -23,6 +23,7 @@
 #include <utility>
 #include <vector>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "kudu/cfile/block_cache.h"
@@ -37,10 +38,18 @@
 #include "kudu/tserver/tablet_service.h"
 #include "kudu/tserver/ts_tablet_manager.h"
 #include "kudu/tserver/tserver_path_handlers.h"
+#include "kudu/util/flag_tags.h"
 #include "kudu/util/maintenance_manager.h"
 #include "kudu/util/net/dns_resolver.h"
 #include "kudu/util/net/net_util.h"
 #include "kudu/util/status.h"
+#include "kudu/util/threadpool.h"
+
+DEFINE_int32(scan_pool_max_threads, 0,
+             "Maximum number of threads used to scan the rowsets of a tablet in "
+             "parallel for unordered scans. If 0, each scan is served by the RPC "
+             "thread handling it.");
+TAG_FLAG(scan_pool_max_threads, experimental);
 
 using kudu::fs::ErrorHandlerType;
 using kudu::rpc::ServiceIf;
@@ -107,6 +116,12 @@ Status TabletServer::Init() {
   RETURN_NOT_OK_PREPEND(tablet_manager_->Init(),
                         "Could not init Tablet Manager");
 
+  if (FLAGS_scan_pool_max_threads > 0) {
+    RETURN_NOT_OK(ThreadPoolBuilder("scan")
+                  .set_max_threads(FLAGS_scan_pool_max_threads)
+                  .Build(&scan_pool_));
+  }
+
   RETURN_NOT_OK_PREPEND(scanner_manager_->StartRemovalThread(),
                         "Could not start expired Scanner removal thread");
 
@@ -165,6 +180,9 @@ void TabletServer::ShutdownImpl() {
     fs_manager_->UnsetErrorNotificationCb(ErrorHandlerType::DISK_ERROR);
     fs_manager_->UnsetErrorNotificationCb(ErrorHandlerType::CFILE_CORRUPTION);
     tablet_manager_->Shutdown();
+    if (scan_pool_) {
+      scan_pool_->Shutdown();
+    }
 
     // 3. Shut down generic subsystems.
     KuduServer::Shutdown();
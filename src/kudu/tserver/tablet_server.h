@@ -30,6 +30,7 @@
 namespace kudu {
 
 class MaintenanceManager;
+class ThreadPool;
 
 namespace tserver {
 
@@ -71,6 +72,10 @@ class TabletServer : public kserver::KuduServer {
 
   Heartbeater* heartbeater() { return heartbeater_.get(); }
 
+  // The pool used to scan the rowsets of a tablet in parallel, or nullptr if
+  // parallel scans are disabled.
+  ThreadPool* scan_pool() const { return scan_pool_.get(); }
+
   void set_fail_heartbeats_for_tests(bool fail_heartbeats_for_tests) {
     base::subtle::NoBarrier_Store(&fail_heartbeats_for_tests_, 1);
   }
@@ -118,6 +123,11 @@ class TabletServer : public kserver::KuduServer {
   // Manager for tablets which are available on this server.
   std::unique_ptr<TSTabletManager> tablet_manager_;
 
+  // Thread pool for parallel scans of a tablet's rowsets. It is declared
+  // before 'scanner_manager_' so that it outlives the iterators of any
+  // scanners still open at destruction time.
+  std::unique_ptr<ThreadPool> scan_pool_;
+
   // Manager for open scanners from clients.
   // This is always non-NULL. It is scoped only to minimize header
   // dependencies.
@@ -43,6 +43,7 @@
 #include "kudu/common/iterator_stats.h"
 #include "kudu/common/key_range.h"
 #include "kudu/common/partition.h"
+#include "kudu/common/row_aggregator.h"
 #include "kudu/common/rowblock.h"
 #include "kudu/common/scan_spec.h"
 #include "kudu/common/schema.h"
@@ -51,6 +52,7 @@
 #include "kudu/common/wire_protocol.h"
 #include "kudu/common/wire_protocol.pb.h"
 #include "kudu/consensus/consensus.pb.h"
+#include "kudu/consensus/consensus_peers.h"
 #include "kudu/consensus/opid.pb.h"
 #include "kudu/consensus/raft_consensus.h"
 #include "kudu/consensus/replica_management.pb.h"
@@ -92,6 +94,8 @@
 #include "kudu/tserver/tserver_admin.pb.h"
 #include "kudu/tserver/tserver_service.pb.h"
 #include "kudu/util/bitset.h"
+#include "kudu/util/compression/compression.pb.h"
+#include "kudu/util/compression/compression_codec.h"
 #include "kudu/util/crc.h"
 #include "kudu/util/debug/trace_event.h"
 #include "kudu/util/faststring.h"
@@ -127,6 +131,12 @@ DEFINE_int32(scanner_batch_size_rows, 128,
 TAG_FLAG(scanner_batch_size_rows, advanced);
 TAG_FLAG(scanner_batch_size_rows, runtime);
 
+DEFINE_int32(scanner_parallelism, 4,
+             "The maximum number of rowsets of a tablet scanned concurrently by an "
+             "unordered scan. Only takes effect if --scan_pool_max_threads is positive.");
+TAG_FLAG(scanner_parallelism, experimental);
+TAG_FLAG(scanner_parallelism, runtime);
+
 DEFINE_bool(scanner_allow_snapshot_scans_with_logical_timestamps, false,
             "If set, the server will support snapshot scans with logical timestamps.");
 TAG_FLAG(scanner_allow_snapshot_scans_with_logical_timestamps, unsafe);
@@ -180,6 +190,8 @@ using kudu::consensus::GetNodeInstanceResponsePB;
 using kudu::consensus::LeaderStepDownMode;
 using kudu::consensus::LeaderStepDownRequestPB;
 using kudu::consensus::LeaderStepDownResponsePB;
+using kudu::consensus::MultiRaftConsensusRequestPB;
+using kudu::consensus::MultiRaftConsensusResponsePB;
 using kudu::consensus::OpId;
 using kudu::consensus::RaftConsensus;
 using kudu::consensus::RunLeaderElectionRequestPB;
@@ -260,24 +272,34 @@ bool LookupTabletReplicaOrRespond(TabletReplicaLookupIf* tablet_manager,
   return true;
 }
 
-template<class RespClass>
-void RespondTabletNotRunning(const scoped_refptr<TabletReplica>& replica,
+// Returns the error for a request to 'replica', which is in 'tablet_state'
+// rather than RUNNING, setting 'error_code' to the matching code.
+Status TabletNotRunningError(const scoped_refptr<TabletReplica>& replica,
                              tablet::TabletStatePB tablet_state,
-                             RespClass* resp,
-                             rpc::RpcContext* context) {
+                             TabletServerErrorPB::Code* error_code) {
   Status s = Status::IllegalState("Tablet not RUNNING",
                                   tablet::TabletStatePB_Name(tablet_state));
-  auto error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+  *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
   if (replica->tablet_metadata()->tablet_data_state() == TABLET_DATA_TOMBSTONED ||
       replica->tablet_metadata()->tablet_data_state() == TABLET_DATA_DELETED) {
     // Treat tombstoned tablets as if they don't exist for most purposes.
     // This takes precedence over failed, since we don't reset the failed
     // status of a TabletReplica when deleting it. Only tablet copy does that.
-    error_code = TabletServerErrorPB::TABLET_NOT_FOUND;
+    *error_code = TabletServerErrorPB::TABLET_NOT_FOUND;
   } else if (tablet_state == tablet::FAILED) {
     s = s.CloneAndAppend(replica->error().ToString());
-    error_code = TabletServerErrorPB::TABLET_FAILED;
+    *error_code = TabletServerErrorPB::TABLET_FAILED;
   }
+  return s;
+}
+
+template<class RespClass>
+void RespondTabletNotRunning(const scoped_refptr<TabletReplica>& replica,
+                             tablet::TabletStatePB tablet_state,
+                             RespClass* resp,
+                             rpc::RpcContext* context) {
+  TabletServerErrorPB::Code error_code;
+  Status s = TabletNotRunningError(replica, tablet_state, &error_code);
   SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
 }
 
@@ -701,6 +723,20 @@ class ScanResultCollector {
     return Status::OK();
   }
 
+  // Called once the scanner serving the request is locked, before any of its
+  // row blocks are handled.
+  //
+  // Does nothing by default.
+  virtual void InitForScanner(const Scanner& /* scanner */) {
+  }
+
+  // Called once every row block of the response has been handled, while the
+  // scanner is still locked.
+  //
+  // Does nothing by default.
+  virtual void FinishBatch(Scanner* /* scanner */) {
+  }
+
   CpuTimes* cpu_times() {
     return &cpu_times_;
   }
@@ -955,6 +991,130 @@ class ScanResultCopier : public ScanResultCollector {
   DISALLOW_COPY_AND_ASSIGN(ScanResultCopier);
 };
 
+// Folds the scan result into the scanner's aggregator and returns the partial
+// aggregates in place of the rows.
+//
+// The aggregator is owned by the scanner, which may be used by another call
+// once this one releases it, so the partial aggregates are taken out of it
+// before the scanner is unlocked.
+class ScanResultAggregator : public ScanResultCollector {
+ public:
+  ScanResultAggregator()
+      : aggregator_(nullptr),
+        num_rows_returned_(0) {
+  }
+
+  void HandleRowBlock(Scanner* scanner, const RowBlock& row_block) override {
+    aggregator_ = DCHECK_NOTNULL(scanner->aggregator());
+    aggregator_->AddRowBlock(row_block);
+
+    // The aggregated rows count as returned, even though only their partial
+    // aggregates make it to the client.
+    int num_selected = row_block.selection_vector()->CountSelected();
+    if (num_selected > 0) {
+      num_rows_returned_ += num_selected;
+      scanner->add_num_rows_returned(num_selected);
+      SetLastRow(row_block, &last_primary_key_);
+    }
+  }
+
+  // Returns the approximate number of bytes of partial aggregates to return.
+  int64_t ResponseSize() const override {
+    return aggregator_ ? aggregator_->ResultSizeBytes() : result_.ByteSizeLong();
+  }
+
+  int64_t NumRowsReturned() const override {
+    return num_rows_returned_;
+  }
+
+  void FinishBatch(Scanner* /* scanner */) override {
+    if (aggregator_) {
+      aggregator_->TakeResultPB(&result_);
+      aggregator_ = nullptr;
+    }
+  }
+
+  void SetupResponse(ScanResponsePB* resp) {
+    DCHECK(!aggregator_);
+    resp->mutable_aggregate_result()->Swap(&result_);
+    if (last_primary_key_.length() > 0) {
+      resp->set_last_primary_key(last_primary_key_.ToString());
+    }
+  }
+
+ private:
+  // The scanner's aggregator, set while the scanner is locked by this call.
+  RowAggregator* aggregator_;
+  AggregateResultPB result_;
+  int64_t num_rows_returned_;
+  faststring last_primary_key_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScanResultAggregator);
+};
+
+// Collects the result of a Scan call: the rows, or the partial aggregates if
+// the scanner aggregates them.
+//
+// Whether the scanner aggregates is only known once it is locked, so the
+// collector to delegate to is picked then, rather than when the request
+// comes in.
+class ScanResponseCollector : public ScanResultCollector {
+ public:
+  explicit ScanResponseCollector(int batch_size_bytes)
+      : copier_(batch_size_bytes),
+        collector_(&copier_) {
+  }
+
+  void HandleRowBlock(Scanner* scanner, const RowBlock& row_block) override {
+    collector_->HandleRowBlock(scanner, row_block);
+  }
+
+  int64_t ResponseSize() const override {
+    return collector_->ResponseSize();
+  }
+
+  int64_t NumRowsReturned() const override {
+    return collector_->NumRowsReturned();
+  }
+
+  Status InitSerializer(uint64_t row_format_flags,
+                        const Schema& scanner_schema,
+                        const Schema& client_schema) override {
+    // The serializer also validates the row format flags, so set it up even
+    // if the rows end up aggregated.
+    return copier_.InitSerializer(row_format_flags, scanner_schema, client_schema);
+  }
+
+  void InitForScanner(const Scanner& scanner) override {
+    if (scanner.aggregator()) {
+      collector_ = &aggregator_;
+    } else {
+      collector_ = &copier_;
+    }
+  }
+
+  void FinishBatch(Scanner* scanner) override {
+    collector_->FinishBatch(scanner);
+  }
+
+  void SetupResponse(rpc::RpcContext* context, ScanResponsePB* resp) {
+    if (collector_ == &aggregator_) {
+      aggregator_.SetupResponse(resp);
+    } else {
+      copier_.SetupResponse(context, resp);
+    }
+  }
+
+ private:
+  ScanResultCopier copier_;
+  ScanResultAggregator aggregator_;
+
+  // Either 'copier_' or 'aggregator_'.
+  ScanResultCollector* collector_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScanResponseCollector);
+};
+
 // Checksums the scan result.
 class ScanResultChecksummer : public ScanResultCollector {
  public:
@@ -1451,6 +1611,9 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
 
   uint64_t bytes = req->row_operations().rows().size() +
       req->row_operations().indirect_data().size();
+  for (const auto& col : req->row_operations().columnar().columns()) {
+    bytes += col.data().size() + col.varlen_data().size() + col.non_null_bitmap().size();
+  }
   if (!tablet->ShouldThrottleAllow(bytes)) {
     SetupErrorAndRespond(resp->mutable_error(),
                          Status::ServiceUnavailable("Rejecting Write request: throttled"),
@@ -1566,6 +1729,102 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context->RespondSuccess();
 }
 
+namespace {
+
+// Handles one of the updates of a MultiRaftUpdateConsensus() batch. Unlike
+// UpdateConsensus(), an error is set in 'resp' instead of being responded to
+// the RPC, since the rest of the batch still has to be handled.
+void UpdateConsensusInBatch(TabletReplicaLookupIf* tablet_manager,
+                            const ConsensusRequestPB& req,
+                            ConsensusResponsePB* resp) {
+  const auto set_error = [resp](const Status& s, TabletServerErrorPB::Code code) {
+    resp->Clear();
+    StatusToPB(s, resp->mutable_error()->mutable_status());
+    resp->mutable_error()->set_code(code);
+  };
+
+  const string& local_uuid = tablet_manager->NodeInstance().permanent_uuid();
+  if (PREDICT_FALSE(req.dest_uuid() != local_uuid)) {
+    set_error(Status::InvalidArgument(Substitute(
+                  "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                  "Local UUID: $0. Requested UUID: $1", local_uuid, req.dest_uuid())),
+              TabletServerErrorPB::WRONG_SERVER_UUID);
+    return;
+  }
+  scoped_refptr<TabletReplica> replica;
+  Status s = tablet_manager->GetTabletReplica(req.tablet_id(), &replica);
+  if (PREDICT_FALSE(!s.ok())) {
+    set_error(s, s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                          : TabletServerErrorPB::TABLET_NOT_FOUND);
+    return;
+  }
+  tablet::TabletStatePB state = replica->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    TabletServerErrorPB::Code error_code;
+    s = TabletNotRunningError(replica, state, &error_code);
+    set_error(s, error_code);
+    return;
+  }
+  shared_ptr<RaftConsensus> consensus = replica->shared_consensus();
+  if (PREDICT_FALSE(!consensus)) {
+    set_error(Status::ServiceUnavailable("Raft Consensus unavailable",
+                                         "Tablet replica not initialized"),
+              TabletServerErrorPB::TABLET_NOT_RUNNING);
+    return;
+  }
+  s = consensus->Update(&req, resp);
+  if (PREDICT_FALSE(!s.ok())) {
+    set_error(s, TabletServerErrorPB::UNKNOWN_ERROR);
+  }
+}
+
+} // anonymous namespace
+
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(const MultiRaftConsensusRequestPB* req,
+                                                    MultiRaftConsensusResponsePB* resp,
+                                                    rpc::RpcContext* context) {
+  DVLOG(3) << "Received Multi-Raft Consensus Update RPC: " << SecureDebugString(*req);
+  const CompressionCodec* codec = nullptr;
+  Status s = GetCompressionCodec(req->compression_codec(), &codec);
+  MultiRaftConsensusRequestPB uncompressed;
+  const MultiRaftConsensusRequestPB* batch = req;
+  if (s.ok() && codec) {
+    s = consensus::UncompressPB(*codec, req->compressed_requests(),
+                                req->uncompressed_size(), &uncompressed);
+    batch = &uncompressed;
+  }
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         s.CloneAndPrepend("unable to decode batch of consensus updates"),
+                         TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return;
+  }
+
+  // Leaders only batch status-only updates, which don't wait on the WAL, so
+  // the updates are handled one after the other on this thread.
+  MultiRaftConsensusResponsePB responses;
+  for (const auto& update : batch->requests()) {
+    UpdateConsensusInBatch(tablet_manager_, update, responses.add_responses());
+  }
+
+  if (codec) {
+    int64_t uncompressed_size;
+    s = consensus::CompressPB(*codec, responses, resp->mutable_compressed_responses(),
+                              &uncompressed_size);
+    if (PREDICT_FALSE(!s.ok())) {
+      resp->Clear();
+      SetupErrorAndRespond(resp->mutable_error(),
+                           s.CloneAndPrepend("unable to compress consensus responses"),
+                           TabletServerErrorPB::UNKNOWN_ERROR, context);
+      return;
+    }
+    resp->set_uncompressed_size(uncompressed_size);
+  } else {
+    resp->mutable_responses()->Swap(responses.mutable_responses());
+  }
+  context->RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext* context) {
@@ -1998,7 +2257,7 @@ void TabletServiceImpl::Scan(const ScanRequestPB* req,
   }
 
   size_t batch_size_bytes = GetMaxBatchSizeBytesHint(req);
-  ScanResultCopier collector(batch_size_bytes);
+  ScanResponseCollector collector(batch_size_bytes);
 
   bool has_more_results = false;
   TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
@@ -2348,6 +2607,8 @@ bool TabletServiceImpl::SupportsFeature(uint32_t feature) const {
     case TabletServerFeatures::QUIESCING:
     case TabletServerFeatures::BLOOM_FILTER_PREDICATE:
     case TabletServerFeatures::COLUMNAR_LAYOUT_FEATURE:
+    case TabletServerFeatures::AGGREGATE_PUSHDOWN:
+    case TabletServerFeatures::COLUMNAR_WRITE:
       return true;
     default:
       return false;
@@ -2666,6 +2927,27 @@ Status TabletServiceImpl::HandleNewScanRequest(TabletReplica* replica,
     return s;
   }
 
+  if (scan_pb.has_aggregation()) {
+    if (scan_pb.has_limit()) {
+      *error_code = TabletServerErrorPB::INVALID_SCAN_SPEC;
+      return Status::InvalidArgument("a limit cannot be combined with an aggregation");
+    }
+    // Aggregates may only refer to columns of the client's projection, but
+    // are evaluated over the rows of the scan projection, which extends it
+    // with the columns needed to evaluate the predicates.
+    unique_ptr<RowAggregator> aggregator;
+    s = RowAggregator::Validate(scan_pb.aggregation(), *client_projection);
+    if (PREDICT_TRUE(s.ok())) {
+      s = RowAggregator::Create(scan_pb.aggregation(), projection, &aggregator);
+    }
+    if (PREDICT_FALSE(!s.ok())) {
+      *error_code = TabletServerErrorPB::INVALID_SCAN_SPEC;
+      return s;
+    }
+    scanner->set_aggregator(std::move(aggregator));
+  }
+  result_collector->InitForScanner(*scanner);
+
   if (spec.CanShortCircuit()) {
     VLOG(1) << "short-circuiting without creating a server-side scanner.";
     *has_more_results = false;
@@ -2706,7 +2988,13 @@ Status TabletServiceImpl::HandleNewScanRequest(TabletReplica* replica,
           return Status::InvalidArgument("scan start timestamp is only supported "
                                          "in READ_AT_SNAPSHOT read mode");
         }
-        s = tablet->NewRowIterator(projection, &iter);
+        tablet::RowIteratorOptions opts;
+        // Yield current rows.
+        opts.snap_to_include = MvccSnapshot(*tablet->mvcc_manager());
+        opts.projection = &projection;
+        opts.scan_pool = server_->scan_pool();
+        opts.scan_parallelism = FLAGS_scanner_parallelism;
+        s = tablet->NewRowIterator(std::move(opts), &iter);
         break;
       }
       case READ_YOUR_WRITES: // Fallthrough intended
@@ -2850,6 +3138,7 @@ Status TabletServiceImpl::HandleContinueScanRequest(const ScanRequestPB* req,
   // another thread is already using the scanner? This should be rare in real
   // circumstances -- only relevant when a client performs some retries on timeout.
   auto scanner_lock = scanner->LockForAccess();
+  result_collector->InitForScanner(*scanner);
 
   if (PREDICT_FALSE(FLAGS_scanner_inject_service_unavailable_on_continue_scan)) {
     return Status::ServiceUnavailable("Injecting service unavailable status on Scan due to "
@@ -2979,11 +3268,16 @@ Status TabletServiceImpl::HandleContinueScanRequest(const ScanRequestPB* req,
     tablet->metrics()->scanner_cells_scanned_from_disk->IncrementBy(delta_stats.cells_read);
     tablet->metrics()->scanner_bytes_scanned_from_disk->IncrementBy(delta_stats.bytes_read);
     tablet->metrics()->scanner_predicates_disabled->IncrementBy(delta_stats.predicates_disabled);
+    tablet->metrics()->scanner_readahead_hits->IncrementBy(delta_stats.readahead_hits);
+    tablet->metrics()->scanner_readahead_misses->IncrementBy(delta_stats.readahead_misses);
+    tablet->metrics()->scanner_readahead_wasted->IncrementBy(delta_stats.readahead_wasted);
 
     // Last read timestamp.
     tablet->UpdateLastReadTime();
   }
 
+  result_collector->FinishBatch(scanner.get());
+
   *has_more_results = !req->close_scanner() && iter->HasNext() &&
       !scanner->has_fulfilled_limit();
   if (*has_more_results) {
@@ -3079,6 +3373,8 @@ Status TabletServiceImpl::HandleScanAtSnapshot(const NewScanRequestPB& scan_pb,
   opts.projection = &projection;
   opts.snap_to_include = snap;
   opts.order = scan_pb.order_mode();
+  opts.scan_pool = server_->scan_pool();
+  opts.scan_parallelism = FLAGS_scanner_parallelism;
 
   boost::optional<Timestamp> tmp_snap_start_timestamp;
   if (scan_pb.has_snap_start_timestamp()) {
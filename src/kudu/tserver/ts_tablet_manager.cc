@@ -36,6 +36,7 @@
 #include "kudu/consensus/consensus.pb.h"
 #include "kudu/consensus/consensus_meta.h"
 #include "kudu/consensus/consensus_meta_manager.h"
+#include "kudu/consensus/consensus_peers.h"
 #include "kudu/consensus/log.h"
 #include "kudu/consensus/log_anchor_registry.h"
 #include "kudu/consensus/metadata.pb.h"
@@ -90,6 +91,15 @@ DEFINE_int32(num_tablets_to_delete_simultaneously, 0,
              "device such as SSD or a RAID array, it may make sense to manually tune this.");
 TAG_FLAG(num_tablets_to_delete_simultaneously, advanced);
 
+DEFINE_int32(num_shared_wal_append_threads, 0,
+             "Number of threads shared by the WALs of all tablet replicas to append and "
+             "sync their entries. If this is set to 0 (the default), each WAL appends its "
+             "entries on a thread of its own, so a server with many active replicas may "
+             "run as many threads and concurrent fsyncs. Otherwise, this bounds both. "
+             "Only the threads are shared: each replica still writes its own WAL "
+             "segments.");
+TAG_FLAG(num_shared_wal_append_threads, experimental);
+
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
              "If a tablet takes more than this number of millis to start, issue "
              "a warning with a trace.");
@@ -372,6 +382,18 @@ Status TSTabletManager::Init() {
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-delete")
                 .set_max_threads(max_delete_threads)
                 .Build(&delete_tablet_pool_));
+  // TODO: sharing the append threads bounds the number of concurrent WAL
+  // fsyncs, but each replica still writes its own segments. A server-wide log
+  // interleaving the entries of many replicas in common segments, with a
+  // per-replica index for bootstrap and the LogCache, would turn those into a
+  // single sequential write stream per disk.
+  if (FLAGS_num_shared_wal_append_threads > 0) {
+    RETURN_NOT_OK(ThreadPoolBuilder("wal-append")
+                  .set_max_threads(FLAGS_num_shared_wal_append_threads)
+                  .Build(&wal_append_pool_));
+  }
+  multi_raft_manager_.reset(new consensus::MultiRaftManager(server_->messenger(),
+                                                            server_->dns_resolver()));
 
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
@@ -1137,6 +1159,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletReplica>& replica,
                         server_->result_tracker(),
                         metric_registry_,
                         server_->file_cache(),
+                        wal_append_pool_.get(),
+                        server_->rowset_encoding_pool(),
                         replica,
                         replica->log_anchor_registry(),
                         &tablet,
@@ -1159,7 +1183,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletReplica>& replica,
                        server_->result_tracker(),
                        log,
                        server_->tablet_prepare_pool(),
-                       server_->dns_resolver());
+                       server_->dns_resolver(),
+                       multi_raft_manager_.get());
     if (!s.ok()) {
       LOG(ERROR) << LogPrefix(tablet_id) << "Tablet failed to start: "
                  << s.ToString();
@@ -1235,6 +1260,12 @@ void TSTabletManager::Shutdown() {
     replica->Shutdown();
   }
 
+  // The replicas' logs have released their tokens on the shared WAL append
+  // pool, if any, so it can be shut down now.
+  if (wal_append_pool_) {
+    wal_append_pool_->Shutdown();
+  }
+
   {
     std::lock_guard<RWMutex> l(lock_);
     // We don't expect anyone else to be modifying the map after we start the
@@ -60,6 +60,7 @@ class ThreadPool;
 
 namespace consensus {
 class ConsensusMetadataManager;
+class MultiRaftManager;
 class OpId;
 class StartTabletCopyRequestPB;
 } // namespace consensus
@@ -399,6 +400,14 @@ class TSTabletManager : public tserver::TabletReplicaLookupIf {
   // Thread pool used to delete tablets asynchronously.
   std::unique_ptr<ThreadPool> delete_tablet_pool_;
 
+  // Thread pool shared by the WALs of all replicas to append their entries,
+  // or null if each WAL uses threads of its own.
+  std::unique_ptr<ThreadPool> wal_append_pool_;
+
+  // Batches the consensus updates which the leaders hosted on this server
+  // send to the same remote server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   // Ensures that we only update stats from a single thread at a time.
   mutable rw_spinlock lock_update_;
   MonoTime next_update_time_;
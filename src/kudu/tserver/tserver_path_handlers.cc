@@ -630,6 +630,7 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
       HumanReadableElapsedTime::ToShortString(op_pb.duration_millis() / 1000.0);
     completed_op["time_since_start"] =
       HumanReadableElapsedTime::ToShortString(op_pb.millis_since_start() / 1000.0);
+    completed_op["note"] = op_pb.note();
   }
 
   EasyJson registered_ops = output->Set("registered_operations", EasyJson::kArray);
@@ -641,6 +642,7 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
     registered_op["logs_retained"] = HumanReadableNumBytes::ToString(op_pb.logs_retained_bytes());
     registered_op["perf"] = op_pb.perf_improvement();
     registered_op["workload_score"] = op_pb.workload_score();
+    registered_op["io"] = HumanReadableNumBytes::ToString(op_pb.io_bytes());
   }
 }
 
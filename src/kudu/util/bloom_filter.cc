@@ -17,6 +17,7 @@
 
 #include "kudu/util/bloom_filter.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <ostream>
@@ -84,6 +85,21 @@ BloomFilter::BloomFilter(const Slice &data, size_t n_hashes)
     n_hashes_(n_hashes)
 {}
 
+void BloomFilter::MayContainKeys(const BloomKeyProbe* const* probes, size_t n_probes,
+                                 bool* maybe_present) const {
+  static constexpr size_t kBatchSize = 16;
+  for (size_t start = 0; start < n_probes; start += kBatchSize) {
+    const size_t end = std::min(n_probes, start + kBatchSize);
+    for (size_t i = start; i < end; i++) {
+      uint32_t bitpos = PickBit(probes[i]->initial_hash(), n_bits_);
+      prefetch(reinterpret_cast<const char*>(&bitmap_[bitpos >> 3]), PREFETCH_HINT_T0);
+    }
+    for (size_t i = start; i < end; i++) {
+      maybe_present[i] = MayContainKey(*probes[i]);
+    }
+  }
+}
+
 
 
 } // namespace kudu
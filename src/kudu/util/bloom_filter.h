@@ -196,6 +196,13 @@ class BloomFilter {
   // Return true if the filter may contain the given key.
   bool MayContainKey(const BloomKeyProbe &probe) const;
 
+  // Batched version of MayContainKey(): sets maybe_present[i] to whether the
+  // filter may contain the key of probes[i]. The bitmap lines for a group of
+  // probes are prefetched before any of them is tested, so that the cache
+  // misses of the group overlap rather than being taken one after the other.
+  void MayContainKeys(const BloomKeyProbe* const* probes, size_t n_probes,
+                      bool* maybe_present) const;
+
  private:
   friend class BloomFilterBuilder;
   static uint32_t PickBit(uint32_t hash, size_t n_bits);
@@ -64,7 +64,11 @@ struct BenchSetup {
     // vast majority of lookups.
     ZIPFIAN,
     // Every item is equally likely to be looked up.
-    UNIFORM
+    UNIFORM,
+    // Half of the operations are Zipfian lookups as above. The other half
+    // scan through items which are never looked up again, as a large table
+    // scan would. Only the lookups count towards the hit rate.
+    ZIPFIAN_WITH_SCAN
   };
   Pattern pattern;
 
@@ -74,11 +78,20 @@ struct BenchSetup {
   // in the cache.
   double dataset_cache_ratio;
 
+  // The eviction policy of the cache.
+  Cache::EvictionPolicy eviction_policy;
+
   string ToString() const {
     string ret;
     switch (pattern) {
       case Pattern::ZIPFIAN: ret += "ZIPFIAN"; break;
       case Pattern::UNIFORM: ret += "UNIFORM"; break;
+      case Pattern::ZIPFIAN_WITH_SCAN: ret += "ZIPFIAN_WITH_SCAN"; break;
+    }
+    switch (eviction_policy) {
+      case Cache::EvictionPolicy::FIFO: ret += " FIFO"; break;
+      case Cache::EvictionPolicy::LRU: ret += " LRU"; break;
+      case Cache::EvictionPolicy::SLRU: ret += " SLRU"; break;
     }
     ret += StringPrintf(" ratio=%.2fx n_unique=%d", dataset_cache_ratio, max_key());
     return ret;
@@ -95,7 +108,33 @@ class CacheBench : public KuduTest,
  public:
   void SetUp() override {
     KuduTest::SetUp();
-    cache_.reset(NewCache(kCacheCapacity, "test-cache"));
+    switch (GetParam().eviction_policy) {
+      case Cache::EvictionPolicy::FIFO:
+        cache_.reset(NewCache<Cache::EvictionPolicy::FIFO>(kCacheCapacity, "test-cache"));
+        break;
+      case Cache::EvictionPolicy::LRU:
+        cache_.reset(NewCache<Cache::EvictionPolicy::LRU>(kCacheCapacity, "test-cache"));
+        break;
+      case Cache::EvictionPolicy::SLRU:
+        cache_.reset(NewCache<Cache::EvictionPolicy::SLRU>(kCacheCapacity, "test-cache"));
+        break;
+    }
+  }
+
+  // Looks up 'int_key' in the cache, inserting it if it's missing. Returns
+  // true if it was a hit.
+  bool LookupOrInsert(uint32_t int_key) {
+    char key_buf[sizeof(int_key)];
+    memcpy(key_buf, &int_key, sizeof(int_key));
+    Slice key_slice(key_buf, arraysize(key_buf));
+    auto h(cache_->Lookup(key_slice, Cache::EXPECT_IN_CACHE));
+    if (h) {
+      return true;
+    }
+    auto ph(cache_->Allocate(
+        key_slice, /* val_len=*/kEntrySize, /* charge=*/kEntrySize));
+    cache_->Insert(std::move(ph), nullptr);
+    return false;
   }
 
   // Run queries against the cache until '*done' becomes true.
@@ -107,21 +146,25 @@ class CacheBench : public KuduTest,
     int64_t hits = 0;
     while (!*done) {
       uint32_t int_key;
-      if (setup.pattern == BenchSetup::Pattern::ZIPFIAN) {
-        int_key = r.Skewed(Bits::Log2Floor(setup.max_key()));
-      } else {
-        int_key = r.Uniform(setup.max_key());
+      switch (setup.pattern) {
+        case BenchSetup::Pattern::ZIPFIAN:
+          int_key = r.Skewed(Bits::Log2Floor(setup.max_key()));
+          break;
+        case BenchSetup::Pattern::UNIFORM:
+          int_key = r.Uniform(setup.max_key());
+          break;
+        case BenchSetup::Pattern::ZIPFIAN_WITH_SCAN:
+          if (r.OneIn(2)) {
+            // Scanned keys follow the looked up ones, and aren't reused until
+            // the key space wraps around.
+            LookupOrInsert(setup.max_key() + next_scan_key_++);
+            continue;
+          }
+          int_key = r.Skewed(Bits::Log2Floor(setup.max_key()));
+          break;
       }
-      char key_buf[sizeof(int_key)];
-      memcpy(key_buf, &int_key, sizeof(int_key));
-      Slice key_slice(key_buf, arraysize(key_buf));
-      auto h(cache_->Lookup(key_slice, Cache::EXPECT_IN_CACHE));
-      if (h) {
+      if (LookupOrInsert(int_key)) {
         ++hits;
-      } else {
-        auto ph(cache_->Allocate(
-            key_slice, /* val_len=*/kEntrySize, /* charge=*/kEntrySize));
-        cache_->Insert(std::move(ph), nullptr);
       }
       ++lookups;
     }
@@ -152,15 +195,24 @@ class CacheBench : public KuduTest,
 
  protected:
   unique_ptr<Cache> cache_;
+
+  // The offset of the next key scanned by the ZIPFIAN_WITH_SCAN pattern.
+  atomic<uint32_t> next_scan_key_ { 0 };
 };
 
 // Test both distributions, and for each, test both the case where the data
-// fits in the cache and where it is a bit larger.
+// fits in the cache and where it is a bit larger. The mixed scan and lookup
+// workload compares how well each eviction policy keeps the looked up items.
 INSTANTIATE_TEST_CASE_P(Patterns, CacheBench, testing::ValuesIn(std::vector<BenchSetup>{
-      {BenchSetup::Pattern::ZIPFIAN, 1.0},
-      {BenchSetup::Pattern::ZIPFIAN, 3.0},
-      {BenchSetup::Pattern::UNIFORM, 1.0},
-      {BenchSetup::Pattern::UNIFORM, 3.0}
+      {BenchSetup::Pattern::ZIPFIAN, 1.0, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::ZIPFIAN, 3.0, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::UNIFORM, 1.0, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::UNIFORM, 3.0, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::ZIPFIAN, 3.0, Cache::EvictionPolicy::SLRU},
+      {BenchSetup::Pattern::ZIPFIAN_WITH_SCAN, 0.5, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::ZIPFIAN_WITH_SCAN, 0.5, Cache::EvictionPolicy::SLRU},
+      {BenchSetup::Pattern::ZIPFIAN_WITH_SCAN, 1.0, Cache::EvictionPolicy::LRU},
+      {BenchSetup::Pattern::ZIPFIAN_WITH_SCAN, 1.0, Cache::EvictionPolicy::SLRU}
     }));
 
 TEST_P(CacheBench, RunBench) {
@@ -34,6 +34,7 @@ DECLARE_bool(cache_force_single_shard);
 DECLARE_string(nvm_cache_path);
 
 DECLARE_double(cache_memtracker_approximation_ratio);
+DECLARE_double(cache_slru_protected_ratio);
 
 using std::make_tuple;
 using std::tuple;
@@ -145,6 +146,15 @@ class CacheBaseTest : public KuduTest,
         }
         MemTracker::FindTracker("cache_test-sharded_lru_cache", &mem_tracker_);
         break;
+      case Cache::EvictionPolicy::SLRU:
+        if (mem_type != Cache::MemoryType::DRAM) {
+          FAIL() << "SLRU cache can only be of DRAM type";
+        }
+        cache_.reset(NewCache<Cache::EvictionPolicy::SLRU,
+                              Cache::MemoryType::DRAM>(cache_size(),
+                                                       "cache_test"));
+        MemTracker::FindTracker("cache_test-sharded_slru_cache", &mem_tracker_);
+        break;
       default:
         FAIL() << "unrecognized cache eviction policy";
         break;
@@ -207,6 +217,12 @@ INSTANTIATE_TEST_CASE_P(
         make_tuple(Cache::MemoryType::DRAM,
                    Cache::EvictionPolicy::LRU,
                    ShardingPolicy::SingleShard),
+        make_tuple(Cache::MemoryType::DRAM,
+                   Cache::EvictionPolicy::SLRU,
+                   ShardingPolicy::MultiShard),
+        make_tuple(Cache::MemoryType::DRAM,
+                   Cache::EvictionPolicy::SLRU,
+                   ShardingPolicy::SingleShard),
         make_tuple(Cache::MemoryType::NVM,
                    Cache::EvictionPolicy::LRU,
                    ShardingPolicy::MultiShard),
@@ -532,4 +548,76 @@ TEST_P(LRUCacheTest, EvictionPolicy) {
   ASSERT_EQ(-1, Lookup(200));
 }
 
+// This class is dedicated for scenarios specific for SLRUCache.
+// The scenarios use a single-shard cache for simpler logic.
+class SLRUCacheTest : public CacheBaseTest {
+ public:
+  SLRUCacheTest()
+      : CacheBaseTest(10 * 1024) {
+  }
+
+  void SetUp() override {
+    SetupWithParameters(Cache::MemoryType::DRAM,
+                        Cache::EvictionPolicy::SLRU,
+                        ShardingPolicy::SingleShard);
+  }
+};
+
+// Verify that entries which are looked up after being inserted survive a
+// "scan" of many more entries which are inserted but never looked up, and
+// which would have evicted them from an LRU cache.
+TEST_F(SLRUCacheTest, ScanResistance) {
+  static constexpr int kNumElems = 100;
+  const int size_per_elem = cache_size() / kNumElems;
+  // Half of the protected segment's capacity.
+  const int kNumHot = kNumElems * FLAGS_cache_slru_protected_ratio / 2;
+
+  for (int i = 0; i < kNumHot; i++) {
+    Insert(i, i, size_per_elem);
+    ASSERT_EQ(i, Lookup(i));
+  }
+  for (int i = 0; i < kNumElems * 10; i++) {
+    Insert(1000 + i, 1000 + i, size_per_elem);
+  }
+  for (int i = 0; i < kNumHot; i++) {
+    SCOPED_TRACE(Substitute("hot entry $0", i));
+    ASSERT_EQ(i, Lookup(i));
+  }
+  // Only the scanned entries were evicted.
+  ASSERT_FALSE(evicted_keys_.empty());
+  for (int key : evicted_keys_) {
+    ASSERT_GE(key, 1000);
+  }
+  // The latest scanned entries are still in the probationary segment.
+  ASSERT_EQ(1000 + kNumElems * 10 - 1, Lookup(1000 + kNumElems * 10 - 1));
+}
+
+// Verify that once the protected segment is full, its least recently used
+// entries are demoted to the probationary segment rather than evicted, and
+// can be promoted again.
+TEST_F(SLRUCacheTest, Demotion) {
+  static constexpr int kNumElems = 100;
+  const int size_per_elem = cache_size() / kNumElems;
+  const int protected_capacity = kNumElems * FLAGS_cache_slru_protected_ratio;
+
+  // Promote more entries than the protected segment can hold.
+  for (int i = 0; i < protected_capacity + 5; i++) {
+    Insert(i, i, size_per_elem);
+    ASSERT_EQ(i, Lookup(i));
+  }
+  ASSERT_TRUE(evicted_keys_.empty());
+
+  // The oldest promoted entries were demoted and are evicted first, before
+  // any of the protected ones.
+  for (int i = 0; i < kNumElems - protected_capacity; i++) {
+    Insert(1000 + i, 1000 + i, size_per_elem);
+  }
+  ASSERT_FALSE(evicted_keys_.empty());
+  ASSERT_EQ(0, evicted_keys_.front());
+  for (int i = 5; i < protected_capacity + 5; i++) {
+    SCOPED_TRACE(Substitute("protected entry $0", i));
+    ASSERT_EQ(i, Lookup(i));
+  }
+}
+
 }  // namespace kudu
@@ -45,6 +45,13 @@ DEFINE_double(cache_memtracker_approximation_ratio, 0.01,
               "this ratio to improve performance. For tests.");
 TAG_FLAG(cache_memtracker_approximation_ratio, hidden);
 
+DEFINE_double(cache_slru_protected_ratio, 0.8,
+              "The fraction of the capacity of a segmented LRU cache which is reserved "
+              "for its protected segment, i.e. for the entries which were looked up "
+              "after being inserted.");
+TAG_FLAG(cache_slru_protected_ratio, advanced);
+TAG_FLAG(cache_slru_protected_ratio, experimental);
+
 using std::atomic;
 using std::shared_ptr;
 using std::string;
@@ -83,10 +90,11 @@ struct RLHandle {
   uint32_t val_length;
   std::atomic<int32_t> refs;
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
+  bool in_protected;  // Whether in the protected segment of an SLRU cache
 
   // The storage for the key/value pair itself. The data is stored as:
   //   [key bytes ...] [padding up to 8-byte boundary] [value bytes ...]
-  uint8_t kv_data[1];   // Beginning of key/value pair
+  alignas(sizeof(void*)) uint8_t kv_data[1];   // Beginning of key/value pair
 
   Slice key() const {
     return Slice(kv_data, key_length);
@@ -198,6 +206,8 @@ string ToString(Cache::EvictionPolicy p) {
       return "fifo";
     case Cache::EvictionPolicy::LRU:
       return "lru";
+    case Cache::EvictionPolicy::SLRU:
+      return "slru";
     default:
       LOG(FATAL) << "unexpected cache eviction policy: " << static_cast<int>(p);
       break;
@@ -215,6 +225,7 @@ class CacheShard {
   // Separate from constructor so caller can easily make an array of CacheShard
   void SetCapacity(size_t capacity) {
     capacity_ = capacity;
+    protected_capacity_ = capacity * FLAGS_cache_slru_protected_ratio;
     max_deferred_consumption_ = capacity * FLAGS_cache_memtracker_approximation_ratio;
   }
 
@@ -230,8 +241,12 @@ class CacheShard {
  private:
   void RL_Remove(RLHandle* e);
   void RL_Append(RLHandle* e);
+  // Like RL_Append, but appends to the protected segment of an SLRU cache.
+  void RL_AppendProtected(RLHandle* e);
   // Update the recency list after a lookup operation.
   void RL_UpdateAfterLookup(RLHandle* e);
+  // Return the entry to evict next, or nullptr if the shard is empty.
+  RLHandle* RL_Oldest();
   // Just reduce the reference count by 1.
   // Return true if last reference
   bool Unref(RLHandle* e);
@@ -271,8 +286,15 @@ class CacheShard {
 
   // Dummy head of recency list.
   // rl.prev is newest entry, rl.next is oldest entry.
+  // For SLRU caches, this is the probationary segment.
   RLHandle rl_;
 
+  // Dummy head of the recency list of the protected segment, and the total
+  // charge of its entries. Only used by SLRU caches.
+  RLHandle protected_rl_;
+  size_t protected_usage_;
+  size_t protected_capacity_;
+
   HandleTable table_;
 
   MemTracker* mem_tracker_;
@@ -288,23 +310,29 @@ class CacheShard {
 template<Cache::EvictionPolicy policy>
 CacheShard<policy>::CacheShard(MemTracker* tracker)
     : usage_(0),
+      protected_usage_(0),
+      protected_capacity_(0),
       mem_tracker_(tracker),
       metrics_(nullptr) {
-  // Make empty circular linked list.
+  // Make empty circular linked lists.
   rl_.next = &rl_;
   rl_.prev = &rl_;
+  protected_rl_.next = &protected_rl_;
+  protected_rl_.prev = &protected_rl_;
 }
 
 template<Cache::EvictionPolicy policy>
 CacheShard<policy>::~CacheShard() {
-  for (RLHandle* e = rl_.next; e != &rl_; ) {
-    RLHandle* next = e->next;
-    DCHECK_EQ(e->refs.load(std::memory_order_relaxed), 1)
-        << "caller has an unreleased handle";
-    if (Unref(e)) {
-      FreeEntry(e);
+  for (RLHandle* list : { &rl_, &protected_rl_ }) {
+    for (RLHandle* e = list->next; e != list; ) {
+      RLHandle* next = e->next;
+      DCHECK_EQ(e->refs.load(std::memory_order_relaxed), 1)
+          << "caller has an unreleased handle";
+      if (Unref(e)) {
+        FreeEntry(e);
+      }
+      e = next;
     }
-    e = next;
   }
   mem_tracker_->Consume(deferred_consumption_);
 }
@@ -367,6 +395,11 @@ void CacheShard<policy>::RL_Remove(RLHandle* e) {
   e->prev->next = e->next;
   DCHECK_GE(usage_, e->charge);
   usage_ -= e->charge;
+  if (e->in_protected) {
+    DCHECK_GE(protected_usage_, e->charge);
+    protected_usage_ -= e->charge;
+    e->in_protected = false;
+  }
 }
 
 template<Cache::EvictionPolicy policy>
@@ -376,9 +409,34 @@ void CacheShard<policy>::RL_Append(RLHandle* e) {
   e->prev = rl_.prev;
   e->prev->next = e;
   e->next->prev = e;
+  e->in_protected = false;
   usage_ += e->charge;
 }
 
+template<Cache::EvictionPolicy policy>
+void CacheShard<policy>::RL_AppendProtected(RLHandle* e) {
+  e->next = &protected_rl_;
+  e->prev = protected_rl_.prev;
+  e->prev->next = e;
+  e->next->prev = e;
+  e->in_protected = true;
+  usage_ += e->charge;
+  protected_usage_ += e->charge;
+}
+
+template<Cache::EvictionPolicy policy>
+RLHandle* CacheShard<policy>::RL_Oldest() {
+  // The probationary segment of an SLRU cache is evicted first. Other
+  // policies never use the protected segment.
+  if (rl_.next != &rl_) {
+    return rl_.next;
+  }
+  if (protected_rl_.next != &protected_rl_) {
+    return protected_rl_.next;
+  }
+  return nullptr;
+}
+
 template<>
 void CacheShard<Cache::EvictionPolicy::FIFO>::RL_UpdateAfterLookup(RLHandle* /* e */) {
 }
@@ -389,6 +447,20 @@ void CacheShard<Cache::EvictionPolicy::LRU>::RL_UpdateAfterLookup(RLHandle* e) {
   RL_Append(e);
 }
 
+template<>
+void CacheShard<Cache::EvictionPolicy::SLRU>::RL_UpdateAfterLookup(RLHandle* e) {
+  // Make "e" the newest entry of the protected segment, then make room for it
+  // by demoting the oldest protected entries to the probationary segment,
+  // where they get one more chance to be looked up before being evicted.
+  RL_Remove(e);
+  RL_AppendProtected(e);
+  while (protected_usage_ > protected_capacity_ && protected_rl_.next != e) {
+    RLHandle* old = protected_rl_.next;
+    RL_Remove(old);
+    RL_Append(old);
+  }
+}
+
 template<Cache::EvictionPolicy policy>
 Cache::Handle* CacheShard<policy>::Lookup(const Slice& key,
                                           uint32_t hash,
@@ -448,13 +520,13 @@ Cache::Handle* CacheShard<policy>::Insert(
       }
     }
 
-    while (usage_ > capacity_ && rl_.next != &rl_) {
-      RLHandle* old = rl_.next;
-      RL_Remove(old);
-      table_.Remove(old->key(), old->hash);
-      if (Unref(old)) {
-        old->next = to_remove_head;
-        to_remove_head = old;
+    RLHandle* oldest;
+    while (usage_ > capacity_ && (oldest = RL_Oldest()) != nullptr) {
+      RL_Remove(oldest);
+      table_.Remove(oldest->key(), oldest->hash);
+      if (Unref(oldest)) {
+        oldest->next = to_remove_head;
+        to_remove_head = oldest;
       }
     }
   }
@@ -499,27 +571,30 @@ size_t CacheShard<policy>::Invalidate(const Cache::InvalidationControl& ctl) {
     std::lock_guard<decltype(mutex_)> l(mutex_);
 
     // rl_.next is the oldest (a.k.a. least relevant) entry in the recency list.
-    RLHandle* h = rl_.next;
-    while (h != nullptr && h != &rl_ &&
-           ctl.iteration_func(valid_entry_count, invalid_entry_count)) {
-      if (ctl.validity_func(h->key(), h->value())) {
-        // Continue iterating over the list.
+    // The protected segment, if any, follows the probationary one.
+    for (RLHandle* list : { &rl_, &protected_rl_ }) {
+      RLHandle* h = list->next;
+      while (h != nullptr && h != list &&
+             ctl.iteration_func(valid_entry_count, invalid_entry_count)) {
+        if (ctl.validity_func(h->key(), h->value())) {
+          // Continue iterating over the list.
+          h = h->next;
+          ++valid_entry_count;
+          continue;
+        }
+        // Copy the handle slated for removal.
+        RLHandle* h_to_remove = h;
+        // Prepare for next iteration of the cycle.
         h = h->next;
-        ++valid_entry_count;
-        continue;
-      }
-      // Copy the handle slated for removal.
-      RLHandle* h_to_remove = h;
-      // Prepare for next iteration of the cycle.
-      h = h->next;
-
-      RL_Remove(h_to_remove);
-      table_.Remove(h_to_remove->key(), h_to_remove->hash);
-      if (Unref(h_to_remove)) {
-        h_to_remove->next = to_remove_head;
-        to_remove_head = h_to_remove;
+
+        RL_Remove(h_to_remove);
+        table_.Remove(h_to_remove->key(), h_to_remove->hash);
+        if (Unref(h_to_remove)) {
+          h_to_remove->next = to_remove_head;
+          to_remove_head = h_to_remove;
+        }
+        ++invalid_entry_count;
       }
-      ++invalid_entry_count;
     }
   }
   // Once removed from the lookup table and the recency list, the entries
@@ -693,6 +768,12 @@ Cache* NewCache<Cache::EvictionPolicy::LRU,
   return new ShardedCache<Cache::EvictionPolicy::LRU>(capacity, id);
 }
 
+template<>
+Cache* NewCache<Cache::EvictionPolicy::SLRU,
+                Cache::MemoryType::DRAM>(size_t capacity, const std::string& id) {
+  return new ShardedCache<Cache::EvictionPolicy::SLRU>(capacity, id);
+}
+
 std::ostream& operator<<(std::ostream& os, Cache::MemoryType mem_type) {
   switch (mem_type) {
     case Cache::MemoryType::DRAM:
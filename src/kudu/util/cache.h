@@ -49,6 +49,12 @@ class Cache {
 
     // The least-recently-used items are evicted.
     LRU,
+
+    // Segmented LRU: items enter a probationary segment, and are promoted to
+    // a protected segment once they're looked up again. Items of the
+    // probationary segment are evicted first, so items used only once (e.g.
+    // by a large scan) don't displace those which are used repeatedly.
+    SLRU,
   };
 
   // Callback interface which is called when an entry is evicted from the
@@ -357,6 +363,13 @@ template<>
 Cache* NewCache<Cache::EvictionPolicy::LRU,
                 Cache::MemoryType::DRAM>(size_t capacity, const std::string& id);
 
+// Create a new segmented LRU cache with a fixed size capacity. This
+// implementation of Cache uses the segmented least-recently-used eviction
+// policy and stored in DRAM.
+template<>
+Cache* NewCache<Cache::EvictionPolicy::SLRU,
+                Cache::MemoryType::DRAM>(size_t capacity, const std::string& id);
+
 // A helper method to output cache memory type into ostream.
 std::ostream& operator<<(std::ostream& os, Cache::MemoryType mem_type);
 
@@ -28,6 +28,7 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include "kudu/gutil/strings/substitute.h"
 #include "kudu/util/compression/compression.pb.h"
 #include "kudu/util/compression/compression_codec.h"
 #include "kudu/util/random.h"
@@ -148,14 +149,67 @@ TEST_F(TestCompression, TestNoCompressionCodec) {
 }
 
 TEST_F(TestCompression, TestSnappyCompressionCodec) {
-  for (auto type : { SNAPPY, LZ4, ZLIB }) {
+  for (auto type : { SNAPPY, LZ4, ZLIB, ZSTD }) {
     NO_FATALS(TestCompressionCodec(type));
   }
 }
 
+TEST_F(TestCompression, TestDictionaryUnsupported) {
+  for (auto type : { SNAPPY, LZ4, ZLIB }) {
+    const CompressionCodec* codec;
+    ASSERT_OK(GetCompressionCodec(type, &codec));
+    ASSERT_FALSE(codec->SupportsDictionary());
+    string dictionary;
+    ASSERT_TRUE(codec->TrainDictionary({}, 1024, &dictionary).IsNotSupported());
+  }
+}
+
+TEST_F(TestCompression, TestZstdDictionary) {
+  const CompressionCodec* codec;
+  ASSERT_OK(GetCompressionCodec(ZSTD, &codec));
+  ASSERT_TRUE(codec->SupportsDictionary());
+
+  // Small, similar records are what dictionaries help the most with.
+  Random r(SeedRandom());
+  vector<string> records;
+  for (int i = 0; i < 2000; i++) {
+    records.emplace_back(strings::Substitute(
+        "{\"host\": \"server-$0.example.com\", \"status\": $1, \"latency_ms\": $2}",
+        r.Uniform(100), 200 + r.Uniform(4) * 100, r.Uniform(1000)));
+  }
+  vector<Slice> samples(records.begin(), records.end());
+  string dictionary;
+  ASSERT_OK(codec->TrainDictionary(samples, 4096, &dictionary));
+  ASSERT_FALSE(dictionary.empty());
+  ASSERT_LE(dictionary.size(), 4096);
+
+  unique_ptr<CompressionCodec> dict_codec;
+  ASSERT_OK(codec->CreateDictionaryCodec(dictionary, &dict_codec));
+  ASSERT_EQ(ZSTD, dict_codec->type());
+
+  const Slice& input = samples[0];
+  size_t max_compressed = dict_codec->MaxCompressedLength(input.size());
+  unique_ptr<uint8_t[]> plain(new uint8_t[max_compressed]);
+  unique_ptr<uint8_t[]> cbuffer(new uint8_t[max_compressed]);
+  size_t plain_size;
+  size_t compressed;
+  ASSERT_OK(codec->Compress(input, plain.get(), &plain_size));
+  ASSERT_OK(dict_codec->Compress(input, cbuffer.get(), &compressed));
+  ASSERT_LT(compressed, plain_size);
+
+  unique_ptr<uint8_t[]> ubuffer(new uint8_t[input.size()]);
+  ASSERT_OK(dict_codec->Uncompress(Slice(cbuffer.get(), compressed),
+                                   ubuffer.get(), input.size()));
+  ASSERT_EQ(input, Slice(ubuffer.get(), input.size()));
+
+  // The data can't be read back without the dictionary.
+  ASSERT_TRUE(codec->Uncompress(Slice(cbuffer.get(), compressed),
+                                ubuffer.get(), input.size()).IsCorruption());
+}
+
 TEST_F(TestCompression, TestSimpleBenchmark) {
   Random r(SeedRandom());
-  for (auto type : { SNAPPY, LZ4, ZLIB }) {
+  for (auto type : { SNAPPY, LZ4, ZLIB, ZSTD }) {
     NO_FATALS(Benchmark(r, type));
   }
 }
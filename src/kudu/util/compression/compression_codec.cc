@@ -17,25 +17,51 @@
 
 #include "kudu/util/compression/compression_codec.h"
 
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <lz4.h>
 #include <snappy-sinksource.h>
 #include <snappy.h>
+#include <zdict.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include "kudu/gutil/port.h"
 #include "kudu/gutil/singleton.h"
 #include "kudu/gutil/stringprintf.h"
+#include "kudu/gutil/strings/substitute.h"
 #include "kudu/util/faststring.h"
+#include "kudu/util/flag_tags.h"
 #include "kudu/util/logging.h"
 #include "kudu/util/string_case.h"
 
+DEFINE_int32(zstd_compression_level, 3,
+             "Compression level used by the ZSTD codec. Higher levels compress "
+             "better but more slowly; negative levels trade compression ratio "
+             "for speed. Decompression speed is mostly unaffected by the level.");
+TAG_FLAG(zstd_compression_level, experimental);
+TAG_FLAG(zstd_compression_level, runtime);
+
+static bool ValidateZstdCompressionLevel(const char* flagname, int32_t value) {
+  if (value < ZSTD_minCLevel() || value > ZSTD_maxCLevel()) {
+    LOG(ERROR) << strings::Substitute("$0 must be between $1 and $2, value $3 is invalid",
+                                      flagname, ZSTD_minCLevel(), ZSTD_maxCLevel(), value);
+    return false;
+  }
+  return true;
+}
+DEFINE_validator(zstd_compression_level, &ValidateZstdCompressionLevel);
+
 namespace kudu {
 
+using std::string;
+using std::unique_ptr;
 using std::vector;
 
 CompressionCodec::CompressionCodec() {
@@ -43,6 +69,19 @@ CompressionCodec::CompressionCodec() {
 CompressionCodec::~CompressionCodec() {
 }
 
+Status CompressionCodec::TrainDictionary(const vector<Slice>& /*samples*/,
+                                         size_t /*max_size*/,
+                                         string* /*dictionary*/) const {
+  return Status::NotSupported("compression codec does not support dictionaries",
+                              CompressionType_Name(type()));
+}
+
+Status CompressionCodec::CreateDictionaryCodec(const Slice& /*dictionary*/,
+                                               unique_ptr<CompressionCodec>* /*codec*/) const {
+  return Status::NotSupported("compression codec does not support dictionaries",
+                              CompressionType_Name(type()));
+}
+
 class SlicesSource : public snappy::Source {
  public:
   explicit SlicesSource(const std::vector<Slice>& slices)
@@ -244,6 +283,164 @@ class ZlibCodec : public CompressionCodec {
   }
 };
 
+class ZstdCodec : public CompressionCodec {
+ public:
+  static ZstdCodec *GetSingleton() {
+    return Singleton<ZstdCodec>::get();
+  }
+
+  Status Compress(const Slice& input,
+                  uint8_t *compressed, size_t *compressed_length) const OVERRIDE {
+    const size_t capacity = MaxCompressedLength(input.size());
+    size_t n;
+    if (has_dictionary()) {
+      RETURN_NOT_OK(InitCDict());
+      n = ZSTD_compress_usingCDict(ThreadLocalCCtx(), compressed, capacity,
+                                   input.data(), input.size(), cdict_.get());
+    } else {
+      n = ZSTD_compressCCtx(ThreadLocalCCtx(), compressed, capacity,
+                            input.data(), input.size(), FLAGS_zstd_compression_level);
+    }
+    if (ZSTD_isError(n)) {
+      return Status::RuntimeError("unable to compress the buffer", ZSTD_getErrorName(n));
+    }
+    *compressed_length = n;
+    return Status::OK();
+  }
+
+  Status Compress(const vector<Slice>& input_slices,
+                  uint8_t *compressed, size_t *compressed_length) const OVERRIDE {
+    if (input_slices.size() == 1) {
+      return Compress(input_slices[0], compressed, compressed_length);
+    }
+
+    SlicesSource source(input_slices);
+    faststring buffer;
+    source.Dump(&buffer);
+    return Compress(Slice(buffer.data(), buffer.size()), compressed, compressed_length);
+  }
+
+  Status Uncompress(const Slice& compressed,
+                    uint8_t *uncompressed, size_t uncompressed_length) const OVERRIDE {
+    size_t n;
+    if (has_dictionary()) {
+      n = ZSTD_decompress_usingDDict(ThreadLocalDCtx(), uncompressed, uncompressed_length,
+                                     compressed.data(), compressed.size(), ddict_.get());
+    } else {
+      n = ZSTD_decompressDCtx(ThreadLocalDCtx(), uncompressed, uncompressed_length,
+                              compressed.data(), compressed.size());
+    }
+    if (ZSTD_isError(n)) {
+      return Status::Corruption("unable to uncompress the buffer", ZSTD_getErrorName(n));
+    }
+    if (n != uncompressed_length) {
+      return Status::Corruption(StringPrintf(
+          "unable to uncompress the buffer: expected %zu bytes, got %zu",
+          uncompressed_length, n));
+    }
+    return Status::OK();
+  }
+
+  size_t MaxCompressedLength(size_t source_bytes) const OVERRIDE {
+    return ZSTD_compressBound(source_bytes);
+  }
+
+  CompressionType type() const override {
+    return ZSTD;
+  }
+
+  bool SupportsDictionary() const override {
+    return true;
+  }
+
+  Status TrainDictionary(const vector<Slice>& samples,
+                         size_t max_size,
+                         string* dictionary) const override {
+    SlicesSource source(samples);
+    faststring buffer;
+    source.Dump(&buffer);
+    vector<size_t> sample_sizes;
+    sample_sizes.reserve(samples.size());
+    for (const Slice& sample : samples) {
+      sample_sizes.push_back(sample.size());
+    }
+    dictionary->resize(max_size);
+    size_t n = ZDICT_trainFromBuffer(&(*dictionary)[0], max_size,
+                                     buffer.data(), sample_sizes.data(), sample_sizes.size());
+    if (ZDICT_isError(n)) {
+      dictionary->clear();
+      return Status::RuntimeError("unable to train a compression dictionary",
+                                  ZDICT_getErrorName(n));
+    }
+    dictionary->resize(n);
+    return Status::OK();
+  }
+
+  Status CreateDictionaryCodec(const Slice& dictionary,
+                               unique_ptr<CompressionCodec>* codec) const override {
+    unique_ptr<ZstdCodec> ret(new ZstdCodec(dictionary));
+    ret->ddict_.reset(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+    if (!ret->ddict_) {
+      return Status::Corruption("invalid compression dictionary");
+    }
+    *codec = std::move(ret);
+    return Status::OK();
+  }
+
+ private:
+  friend class Singleton<ZstdCodec>;
+
+  struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* cctx) const { ZSTD_freeCCtx(cctx); }
+  };
+  struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* dctx) const { ZSTD_freeDCtx(dctx); }
+  };
+  struct CDictDeleter {
+    void operator()(ZSTD_CDict* cdict) const { ZSTD_freeCDict(cdict); }
+  };
+  struct DDictDeleter {
+    void operator()(ZSTD_DDict* ddict) const { ZSTD_freeDDict(ddict); }
+  };
+
+  ZstdCodec() = default;
+
+  explicit ZstdCodec(const Slice& dictionary)
+      : dictionary_(dictionary.ToString()) {
+  }
+
+  bool has_dictionary() const {
+    return ddict_ != nullptr;
+  }
+
+  // The compression form of the dictionary is only needed by writers and is
+  // comparatively expensive to build, so it's built on first use.
+  Status InitCDict() const {
+    std::call_once(cdict_once_, [this] {
+      cdict_.reset(ZSTD_createCDict(dictionary_.data(), dictionary_.size(),
+                                    FLAGS_zstd_compression_level));
+    });
+    return cdict_ ? Status::OK() : Status::RuntimeError("unable to load compression dictionary");
+  }
+
+  // Compression and decompression contexts are expensive to create but can
+  // be reused for any number of operations, so each thread keeps one of each.
+  static ZSTD_CCtx* ThreadLocalCCtx() {
+    static thread_local unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx(ZSTD_createCCtx());
+    return cctx.get();
+  }
+  static ZSTD_DCtx* ThreadLocalDCtx() {
+    static thread_local unique_ptr<ZSTD_DCtx, DCtxDeleter> dctx(ZSTD_createDCtx());
+    return dctx.get();
+  }
+
+  // Set only for codecs created by CreateDictionaryCodec().
+  const string dictionary_;
+  unique_ptr<ZSTD_DDict, DDictDeleter> ddict_;
+  mutable std::once_flag cdict_once_;
+  mutable unique_ptr<ZSTD_CDict, CDictDeleter> cdict_;
+};
+
 Status GetCompressionCodec(CompressionType compression,
                            const CompressionCodec** codec) {
   switch (compression) {
@@ -259,6 +456,9 @@ Status GetCompressionCodec(CompressionType compression,
     case ZLIB:
       *codec = ZlibCodec::GetSingleton();
       break;
+    case ZSTD:
+      *codec = ZstdCodec::GetSingleton();
+      break;
     default:
       return Status::NotFound("bad compression type");
   }
@@ -275,6 +475,8 @@ CompressionType GetCompressionCodecType(const std::string& name) {
     return LZ4;
   if (uname == "ZLIB")
     return ZLIB;
+  if (uname == "ZSTD")
+    return ZSTD;
   if (uname == "NO_COMPRESSION")
     return NO_COMPRESSION;
 
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,29 @@ class CompressionCodec {
 
   // Return the type of compression implemented by this codec.
   virtual CompressionType type() const = 0;
+
+  // Returns true if the codec supports compressing with a dictionary trained
+  // on samples of the data, see TrainDictionary().
+  virtual bool SupportsDictionary() const {
+    return false;
+  }
+
+  // Trains a dictionary of at most 'max_size' bytes on 'samples', which
+  // should be representative of the data to be compressed with it.
+  //
+  // Returns NotSupported if the codec doesn't support dictionaries, and an
+  // error if no useful dictionary could be trained, e.g. because there are
+  // too few samples.
+  virtual Status TrainDictionary(const std::vector<Slice>& samples,
+                                 size_t max_size,
+                                 std::string* dictionary) const;
+
+  // Creates a codec of the same type which compresses and uncompresses using
+  // 'dictionary'. Data compressed with a dictionary can only be uncompressed
+  // by a codec created with the same dictionary. 'dictionary' is copied.
+  virtual Status CreateDictionaryCodec(const Slice& dictionary,
+                                       std::unique_ptr<CompressionCodec>* codec) const;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CompressionCodec);
 };
@@ -64,6 +64,7 @@ METRIC_DEFINE_histogram(test, maintenance_op_duration,
 
 DECLARE_bool(enable_maintenance_manager);
 DECLARE_int64(log_target_replay_size_mb);
+DECLARE_int32(maintenance_manager_io_budget_mb_per_sec);
 DECLARE_double(maintenance_op_multiplier);
 DECLARE_int32(max_priority_range);
 namespace kudu {
@@ -117,7 +118,9 @@ class TestMaintenanceOp : public MaintenanceOp {
     : MaintenanceOp(name, io_usage),
       ram_anchored_(500),
       logs_retained_bytes_(0),
+      data_retained_bytes_(0),
       perf_improvement_(0),
+      io_bytes_(0),
       metric_entity_(METRIC_ENTITY_test.Instantiate(&metric_registry_, "test")),
       maintenance_op_duration_(METRIC_maintenance_op_duration.Instantiate(metric_entity_)),
       maintenance_ops_running_(METRIC_maintenance_ops_running.Instantiate(metric_entity_, 0)),
@@ -160,7 +163,9 @@ class TestMaintenanceOp : public MaintenanceOp {
     stats->set_runnable(remaining_runs_ > 0);
     stats->set_ram_anchored(ram_anchored_);
     stats->set_logs_retained_bytes(logs_retained_bytes_);
+    stats->set_data_retained_bytes(data_retained_bytes_);
     stats->set_perf_improvement(perf_improvement_);
+    stats->set_io_bytes(io_bytes_);
     stats->set_workload_score(workload_score_);
   }
 
@@ -184,11 +189,21 @@ class TestMaintenanceOp : public MaintenanceOp {
     logs_retained_bytes_ = logs_retained_bytes;
   }
 
+  void set_data_retained_bytes(int64_t data_retained_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    data_retained_bytes_ = data_retained_bytes;
+  }
+
   void set_perf_improvement(uint64_t perf_improvement) {
     std::lock_guard<Mutex> guard(lock_);
     perf_improvement_ = perf_improvement;
   }
 
+  void set_io_bytes(int64_t io_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    io_bytes_ = io_bytes;
+  }
+
   void set_workload_score(uint64_t workload_score) {
     std::lock_guard<Mutex> guard(lock_);
     workload_score_ = workload_score;
@@ -216,7 +231,9 @@ class TestMaintenanceOp : public MaintenanceOp {
 
   uint64_t ram_anchored_;
   uint64_t logs_retained_bytes_;
+  int64_t data_retained_bytes_;
   uint64_t perf_improvement_;
+  int64_t io_bytes_;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -625,4 +642,74 @@ TEST_F(MaintenanceManagerTest, TestPriorityOpLaunch) {
   }
 }
 
+// Test that once high IO ops have used up the IO budget, further ones are
+// deferred unless they free memory, and that the decisions are reported.
+TEST_F(MaintenanceManagerTest, TestIoBudget) {
+  StopManager();
+  FLAGS_maintenance_manager_io_budget_mb_per_sec = 1;
+  StartManager(2);
+
+  // Each run of this op costs about ten seconds' worth of budget.
+  TestMaintenanceOp op("op", MaintenanceOp::HIGH_IO_USAGE);
+  op.set_ram_anchored(0);
+  op.set_perf_improvement(10);
+  op.set_io_bytes(10 * 1024 * 1024);
+  op.set_remaining_runs(2);
+  manager_->RegisterOp(&op);
+  SCOPED_CLEANUP({ manager_->UnregisterOp(&op); });
+
+  ASSERT_EVENTUALLY([&]() {
+    ASSERT_EQ(1, op.DurationHistogram()->TotalCount());
+  });
+  SleepFor(MonoDelta::FromMilliseconds(500));
+  ASSERT_EQ(1, op.DurationHistogram()->TotalCount());
+  ASSERT_EQ(1, op.remaining_runs());
+
+  MaintenanceManagerStatusPB status_pb;
+  manager_->GetMaintenanceManagerStatusDump(&status_pb);
+  ASSERT_LT(status_pb.io_budget_available_bytes(), 0);
+  ASSERT_EQ(1, status_pb.completed_operations_size());
+  ASSERT_EQ("perf score=10.000000", status_pb.completed_operations(0).note());
+
+  // Ops that free memory under memory pressure aren't deferred.
+  TestMaintenanceOp mem_op("mem_op", MaintenanceOp::HIGH_IO_USAGE);
+  mem_op.set_io_bytes(10 * 1024 * 1024);
+  manager_->RegisterOp(&mem_op);
+  SCOPED_CLEANUP({ manager_->UnregisterOp(&mem_op); });
+  indicate_memory_pressure_ = true;
+  ASSERT_EVENTUALLY([&]() {
+    ASSERT_EQ(1, mem_op.DurationHistogram()->TotalCount());
+  });
+  ASSERT_EQ(1, op.DurationHistogram()->TotalCount());
+}
+
+// Test that a GC op that frees a lot of disk space, but only charges the I/O
+// budget for the blocks it deletes, doesn't hold back a compaction.
+TEST_F(MaintenanceManagerTest, TestLargeDataGcDoesntStarveCompaction) {
+  StopManager();
+  FLAGS_maintenance_manager_io_budget_mb_per_sec = 1;
+  StartManager(2);
+
+  // Deleting 10GiB worth of blocks, at a few KiB of I/O per block.
+  TestMaintenanceOp gc_op("gc_op", MaintenanceOp::HIGH_IO_USAGE);
+  gc_op.set_ram_anchored(0);
+  gc_op.set_data_retained_bytes(10L * 1024 * 1024 * 1024);
+  gc_op.set_io_bytes(64 * 4096);
+  manager_->RegisterOp(&gc_op);
+  SCOPED_CLEANUP({ manager_->UnregisterOp(&gc_op); });
+  ASSERT_EVENTUALLY([&]() {
+    ASSERT_EQ(1, gc_op.DurationHistogram()->TotalCount());
+  });
+
+  TestMaintenanceOp compaction_op("compaction_op", MaintenanceOp::HIGH_IO_USAGE);
+  compaction_op.set_ram_anchored(0);
+  compaction_op.set_perf_improvement(10);
+  compaction_op.set_io_bytes(512 * 1024);
+  manager_->RegisterOp(&compaction_op);
+  SCOPED_CLEANUP({ manager_->UnregisterOp(&compaction_op); });
+  ASSERT_EVENTUALLY([&]() {
+    ASSERT_EQ(1, compaction_op.DurationHistogram()->TotalCount());
+  });
+}
+
 } // namespace kudu
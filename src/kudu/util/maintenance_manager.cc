@@ -111,6 +111,16 @@ TAG_FLAG(max_priority_range, advanced);
 TAG_FLAG(max_priority_range, experimental);
 TAG_FLAG(max_priority_range, runtime);
 
+DEFINE_int32(maintenance_manager_io_budget_mb_per_sec, 0,
+             "Approximate number of mebibytes per second of disk I/O that the "
+             "maintenance manager may spend on high I/O operations, such as "
+             "compactions, which only free disk space or improve performance. "
+             "Operations that free memory or WAL retention aren't deferred, but "
+             "their I/O counts against the budget. If 0, there is no budget.");
+TAG_FLAG(maintenance_manager_io_budget_mb_per_sec, advanced);
+TAG_FLAG(maintenance_manager_io_budget_mb_per_sec, experimental);
+TAG_FLAG(maintenance_manager_io_budget_mb_per_sec, runtime);
+
 DEFINE_int32(maintenance_manager_inject_latency_ms, 0,
              "Injects latency into maintenance thread. For use in tests only.");
 TAG_FLAG(maintenance_manager_inject_latency_ms, runtime);
@@ -129,6 +139,7 @@ void MaintenanceOpStats::Clear() {
   logs_retained_bytes_ = 0;
   data_retained_bytes_ = 0;
   perf_improvement_ = 0;
+  io_bytes_ = 0;
   workload_score_ = 0;
   last_modified_ = MonoTime();
 }
@@ -159,6 +170,9 @@ MaintenanceManagerStatusPB_OpInstancePB OpInstance::DumpToPB() const {
   }
   MonoDelta delta(MonoTime::Now() - start_mono_time);
   pb.set_millis_since_start(static_cast<int32_t>(delta.ToMilliseconds()));
+  if (!note.empty()) {
+    pb.set_note(note);
+  }
   return pb;
 }
 
@@ -181,6 +195,8 @@ MaintenanceManager::MaintenanceManager(const Options& options,
     running_ops_(0),
     completed_ops_count_(0),
     rand_(GetRandomSeed32()),
+    io_budget_bytes_(0),
+    io_budget_refill_time_(MonoTime::Now()),
     memory_pressure_func_(&process_memory::UnderMemoryPressure) {
   CHECK_OK(ThreadPoolBuilder("MaintenanceMgr")
                .set_min_threads(num_threads_)
@@ -336,10 +352,14 @@ bool MaintenanceManager::FindAndLaunchOp(std::unique_lock<Mutex>* guard) {
     return true;
   }
 
+  if (FLAGS_maintenance_manager_io_budget_mb_per_sec > 0) {
+    io_budget_bytes_ -= FindOrDie(ops_, op).io_bytes();
+  }
+
   LOG_AND_TRACE_WITH_PREFIX("maintenance", INFO)
       << Substitute("Scheduling $0: $1", op->name(), note);
   // Run the maintenance operation.
-  CHECK_OK(thread_pool_->Submit([this, op]() { this->LaunchOp(op); }));
+  CHECK_OK(thread_pool_->Submit([this, op, note]() { this->LaunchOp(op, note); }));
   return true;
 }
 
@@ -361,6 +381,10 @@ bool MaintenanceManager::FindAndLaunchOp(std::unique_lock<Mutex>* guard) {
 // we hold onto. Low IO ops that free WAL disk space are preferred, followed by
 // ops that free memory, then ops that free data disk space, then ops that
 // improve performance.
+//
+// If --maintenance_manager_io_budget_mb_per_sec is set and recently launched
+// ops have used up the budget, high IO ops are only considered when they free
+// memory or WAL retention; the others wait until the budget refills.
 pair<MaintenanceOp*, string> MaintenanceManager::FindBestOp() {
   TRACE_EVENT0("maintenance", "MaintenanceManager::FindBestOp");
 
@@ -368,6 +392,9 @@ pair<MaintenanceOp*, string> MaintenanceManager::FindBestOp() {
     return {nullptr, "no free threads"};
   }
 
+  RefillIoBudget();
+  const bool io_budget_exhausted = IoBudgetExhausted();
+
   int64_t low_io_most_logs_retained_bytes = 0;
   MaintenanceOp* low_io_most_logs_retained_bytes_op = nullptr;
 
@@ -412,6 +439,12 @@ pair<MaintenanceOp*, string> MaintenanceManager::FindBestOp() {
       most_logs_retained_bytes_ram_anchored = ram_anchored;
     }
 
+    if (io_budget_exhausted && op->io_usage() == MaintenanceOp::HIGH_IO_USAGE) {
+      VLOG_AND_TRACE_WITH_PREFIX("maintenance", 2)
+          << Substitute("Deferring op $0 until the I/O budget refills", op->name());
+      continue;
+    }
+
     const auto data_retained_bytes = stats.data_retained_bytes();
     if (data_retained_bytes > most_data_retained_bytes) {
       most_data_retained_bytes_op = op;
@@ -483,9 +516,32 @@ pair<MaintenanceOp*, string> MaintenanceManager::FindBestOp() {
     string note = StringPrintf("perf score=%.6f", best_perf_improvement);
     return {best_perf_improvement_op, std::move(note)};
   }
+  if (io_budget_exhausted) {
+    return {nullptr, "I/O budget exhausted"};
+  }
   return {nullptr, "no ops with positive improvement"};
 }
 
+void MaintenanceManager::RefillIoBudget() {
+  const MonoTime now = MonoTime::Now();
+  const int64_t budget_bytes_per_sec =
+      static_cast<int64_t>(FLAGS_maintenance_manager_io_budget_mb_per_sec) * 1024 * 1024;
+  if (budget_bytes_per_sec <= 0) {
+    io_budget_bytes_ = 0;
+  } else {
+    // Allow bursts of up to one second's worth of budget.
+    const double elapsed_sec = (now - io_budget_refill_time_).ToSeconds();
+    io_budget_bytes_ = std::min(
+        budget_bytes_per_sec,
+        io_budget_bytes_ + static_cast<int64_t>(elapsed_sec * budget_bytes_per_sec));
+  }
+  io_budget_refill_time_ = now;
+}
+
+bool MaintenanceManager::IoBudgetExhausted() const {
+  return FLAGS_maintenance_manager_io_budget_mb_per_sec > 0 && io_budget_bytes_ <= 0;
+}
+
 double MaintenanceManager::AdjustedPerfScore(double perf_improvement,
                                              double workload_score,
                                              int32_t priority) {
@@ -502,12 +558,13 @@ double MaintenanceManager::AdjustedPerfScore(double perf_improvement,
   return perf_score * std::pow(FLAGS_maintenance_op_multiplier, priority);
 }
 
-void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
+void MaintenanceManager::LaunchOp(MaintenanceOp* op, const string& note) {
   int64_t thread_id = Thread::CurrentThreadId();
   OpInstance op_instance;
   op_instance.thread_id = thread_id;
   op_instance.name = op->name();
   op_instance.start_mono_time = MonoTime::Now();
+  op_instance.note = note;
   op->RunningGauge()->Increment();
   {
     std::lock_guard<Mutex> lock(running_instances_lock_);
@@ -563,15 +620,21 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
       op_pb->set_logs_retained_bytes(stats.logs_retained_bytes());
       op_pb->set_perf_improvement(stats.perf_improvement());
       op_pb->set_workload_score(stats.workload_score());
+      op_pb->set_io_bytes(stats.io_bytes());
     } else {
       op_pb->set_runnable(false);
       op_pb->set_ram_anchored_bytes(0);
       op_pb->set_logs_retained_bytes(0);
       op_pb->set_perf_improvement(0.0);
       op_pb->set_workload_score(0.0);
+      op_pb->set_io_bytes(0);
     }
   }
 
+  if (FLAGS_maintenance_manager_io_budget_mb_per_sec > 0) {
+    out_pb->set_io_budget_available_bytes(io_budget_bytes_);
+  }
+
   {
     std::lock_guard<Mutex> lock(running_instances_lock_);
     for (const auto& running_instance : running_instances_) {
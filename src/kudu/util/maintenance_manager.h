@@ -106,6 +106,16 @@ class MaintenanceOpStats {
     perf_improvement_ = perf_improvement;
   }
 
+  int64_t io_bytes() const {
+    DCHECK(valid_);
+    return io_bytes_;
+  }
+
+  void set_io_bytes(int64_t io_bytes) {
+    UpdateLastModified();
+    io_bytes_ = io_bytes;
+  }
+
   double workload_score() const {
     DCHECK(valid_);
     return workload_score_;
@@ -159,6 +169,10 @@ class MaintenanceOpStats {
   // absolute scale (yet TBD).
   double perf_improvement_;
 
+  // Approximate number of bytes this operation would read and write on disk,
+  // charged against the maintenance manager's I/O budget. May be 0.
+  int64_t io_bytes_;
+
   double workload_score_;
 
   // The last time that the stats were modified.
@@ -175,6 +189,8 @@ struct OpInstance {
   MonoDelta duration;
   // The time at which the operation was launched.
   MonoTime start_mono_time;
+  // Why the scheduler chose to run the operation.
+  std::string note;
 
   MaintenanceManagerStatusPB_OpInstancePB DumpToPB() const;
 };
@@ -349,7 +365,15 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   // and the table's priority.
   static double AdjustedPerfScore(double perf_improvement, double workload_score, int32_t priority);
 
-  void LaunchOp(MaintenanceOp* op);
+  void LaunchOp(MaintenanceOp* op, const std::string& note);
+
+  // Add the I/O budget accrued since the last refill, if a budget is set.
+  void RefillIoBudget();
+
+  // Return true if the I/O budget has been used up by recently launched ops,
+  // in which case high I/O ops that only free disk space or improve
+  // performance are deferred.
+  bool IoBudgetExhausted() const;
 
   std::string LogPrefix() const;
 
@@ -376,6 +400,11 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   int64_t completed_ops_count_;
   Random rand_;
 
+  // Bytes of I/O that may be charged before --maintenance_manager_io_budget_mb_per_sec
+  // defers optional high I/O ops. Negative if recently launched ops overran it.
+  int64_t io_budget_bytes_;
+  MonoTime io_budget_refill_time_;
+
   // Function which should return true if the server is under global memory pressure.
   // This is indirected for testing purposes.
   std::function<bool(double*)> memory_pressure_func_;
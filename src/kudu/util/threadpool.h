@@ -215,6 +215,11 @@ class ThreadPool {
     return num_threads_ + num_threads_pending_start_;
   }
 
+  // Return the maximum number of threads this thread pool may run.
+  int max_threads() const {
+    return max_threads_;
+  }
+
  private:
   FRIEND_TEST(ThreadPoolTest, TestThreadPoolWithNoMinimum);
   FRIEND_TEST(ThreadPoolTest, TestVariableSizeThreadPool);